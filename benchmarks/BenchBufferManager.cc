@@ -0,0 +1,331 @@
+/*****************************************************************************
+ *                                                                           *
+ *  Copyright 2018 Rice University                                           *
+ *                                                                           *
+ *  Licensed under the Apache License, Version 2.0 (the "License");          *
+ *  you may not use this file except in compliance with the License.         *
+ *  You may obtain a copy of the License at                                  *
+ *                                                                           *
+ *      http://www.apache.org/licenses/LICENSE-2.0                           *
+ *                                                                           *
+ *  Unless required by applicable law or agreed to in writing, software      *
+ *  distributed under the License is distributed on an "AS IS" BASIS,        *
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. *
+ *  See the License for the specific language governing permissions and      *
+ *  limitations under the License.                                           *
+ *                                                                           *
+ *****************************************************************************/
+
+#include <benchmark/benchmark.h>
+#include <random>
+
+#include "PDBBufferManagerChecksum.h"
+#include "PDBBufferManagerImpl.h"
+
+using namespace pdb;
+
+/**
+ * The buffer manager all the benchmarks share
+ */
+static PDBBufferManagerImpl *bufferManager = nullptr;
+
+/**
+ * The set we are grabbing the pages from
+ */
+static PDBSetPtr benchSet = nullptr;
+
+/**
+ * The number of pages of the set we keep pinned
+ */
+static const int NUM_SET_PAGES = 256;
+
+/**
+ * The pages of the set we keep pinned for the whole run
+ */
+static std::vector<PDBPageHandle> pinnedPages;
+
+/**
+ * The page size of the buffer manager
+ */
+static const size_t PAGE_SIZE = 4096;
+
+/**
+ * Every thread grabs random pages of a set that is already pinned, this is what the pipelines do when they are
+ * working on the same set, reported is the number of pages per second
+ */
+static void BenchGetPinnedSetPage(benchmark::State& state) {
+
+  // each thread has its own random generator
+  std::mt19937 gen(state.thread_index());
+  std::uniform_int_distribution<int> dist(0, NUM_SET_PAGES - 1);
+
+  // bench
+  for (auto _ : state) {
+
+    // grab the page
+    auto page = bufferManager->getPage(benchSet, dist(gen));
+
+    // do not optimize out the value
+    benchmark::DoNotOptimize(page->getBytes());
+  }
+
+  // the number of pages we processed
+  state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * Every thread grabs a small anonymous page writes to it, unpins it and then frees it
+ */
+static void BenchAnonymousPageChurn(benchmark::State& state) {
+
+  // bench
+  for (auto _ : state) {
+
+    // grab the page
+    auto page = bufferManager->getPage(PAGE_SIZE / 4);
+
+    // write something to it
+    memset(page->getBytes(), state.thread_index(), PAGE_SIZE / 4);
+
+    // unpin the page, the handle going out of scope frees it
+    page->unpin();
+  }
+
+  // the number of pages we processed
+  state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * Keeps a lot of small anonymous pages alive and replaces a random one in every iteration, this is what the sinks of a
+ * shuffle or a broadcast do, reported is the number of pages per second
+ */
+static void BenchSmallAnonymousPages(benchmark::State& state) {
+
+  // the number of pages we keep alive
+  const size_t numAlive = 8192;
+
+  // grab the pages
+  std::mt19937 gen(0);
+  std::vector<PDBPageHandle> pages;
+  for(size_t i = 0; i < numAlive; ++i) {
+    pages.emplace_back(bufferManager->getPage(16u << (i % 4)));
+  }
+
+  // bench
+  for (auto _ : state) {
+
+    // free a random page and grab a new one of a random size
+    auto &page = pages[gen() % numAlive];
+    page = nullptr;
+    page = bufferManager->getPage(16u << (gen() % 4));
+    benchmark::DoNotOptimize(page->getBytes());
+  }
+
+  // the number of pages we processed
+  state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * A sequential scan over a set that is much larger than the buffer pool that is interleaved with accesses to a small
+ * set of anonymous pages that are reused, like the pages of a hash table that is probed by the scan.
+ * The argument selects the eviction policy 0 is the LRU and 1 is the 2Q, reported is the fraction of the accesses
+ * to the reused pages that had to go to the disk
+ */
+static void BenchScanWithHotSet(benchmark::State& state) {
+
+  // the number of pages in the buffer pool, the number of reused pages and the size of the scanned set
+  const size_t numPages = 64;
+  const size_t numHotPages = 16;
+  const size_t numScanPages = 1024;
+
+  // create a buffer manager with the requested policy
+  PDBBufferManagerImpl myMgr;
+  myMgr.initialize("tempBenchEviction", PAGE_SIZE, numPages, "metadataBenchEviction", ".");
+  myMgr.setEvictionPolicy(PDBBufferManagerEvictionPolicy::create(state.range(0) == 0 ? "lru" : "2q", numPages));
+
+  // write the set we are scanning
+  auto scanSet = make_shared<PDBSet>("db", "scanSet");
+  for(size_t i = 0; i < numScanPages; ++i) {
+    auto page = myMgr.getPage(scanSet, i);
+    memset(page->getBytes(), (int) i, PAGE_SIZE);
+    page->setDirty();
+  }
+
+  // create the reused pages
+  std::vector<PDBPageHandle> hot;
+  for(size_t i = 0; i < numHotPages; ++i) {
+    hot.emplace_back(myMgr.getPage());
+    memset(hot.back()->getBytes(), (int) i, PAGE_SIZE);
+    hot.back()->unpin();
+  }
+
+  // bench
+  size_t scanned = 0;
+  size_t hotAccesses = 0;
+  size_t hotMisses = 0;
+  for (auto _ : state) {
+
+    // grab the next page of the scan
+    auto page = myMgr.getPage(scanSet, scanned++ % numScanPages);
+    benchmark::DoNotOptimize(((char*) page->getBytes())[0]);
+
+    // every fourth page of the scan probes one of the reused pages
+    if(scanned % 4 == 0) {
+
+      // an unpinned page that was evicted has no memory
+      auto &h = hot[hotAccesses++ % numHotPages];
+      hotMisses += h->getBytes() == nullptr ? 1 : 0;
+
+      // use the page
+      h->repin();
+      benchmark::DoNotOptimize(((char*) h->getBytes())[0]);
+      h->unpin();
+    }
+  }
+
+  // the number of pages we processed and the miss rate of the reused pages
+  state.SetItemsProcessed(state.iterations());
+  state.counters["hotMissRate"] = hotAccesses == 0 ? 0.0 : (double) hotMisses / hotAccesses;
+
+  // clear the set
+  hot.clear();
+  myMgr.clearSet(scanSet);
+}
+
+/**
+ * Random 8 byte reads all over a buffer pool full of pinned pages, like the probes of a large hash table.
+ * The argument selects whether the pool is backed by huge pages 0 is no and 1 is yes, reported is the number of
+ * probes per second and the huge page mode we actually got
+ */
+static void BenchRandomProbe(benchmark::State& state) {
+
+  // the pool is 256MB so the regular pages do not fit into the TLB
+  const size_t pageSize = 1024 * 1024;
+  const size_t numPages = 256;
+
+  // create a buffer manager with or without the huge pages
+  PDBBufferManagerImpl myMgr;
+  myMgr.setHugePages(state.range(0) != 0);
+  myMgr.initialize("tempBenchHugePages", pageSize, numPages, "metadataBenchHugePages", ".");
+
+  // fill the whole pool with pinned anonymous pages
+  std::vector<PDBPageHandle> pages;
+  for(size_t i = 0; i < numPages; ++i) {
+    pages.emplace_back(myMgr.getPage(pageSize));
+    memset(pages.back()->getBytes(), (int) i, pageSize);
+  }
+
+  // we probe random words
+  std::mt19937_64 gen(0);
+  std::uniform_int_distribution<size_t> pageDist(0, numPages - 1);
+  std::uniform_int_distribution<size_t> wordDist(0, pageSize / sizeof(uint64_t) - 1);
+
+  // bench
+  uint64_t sum = 0;
+  for (auto _ : state) {
+    sum += ((uint64_t*) pages[pageDist(gen)]->getBytes())[wordDist(gen)];
+  }
+  benchmark::DoNotOptimize(sum);
+
+  // the number of probes and the huge page mode
+  state.SetItemsProcessed(state.iterations());
+  state.counters["hugePageMode"] = myMgr.getHugePageMode();
+}
+
+/**
+ * Computes the checksum of a page, the argument is the size of the page, reported is the number of bytes per second
+ * and whether the crc32 instruction of the CPU was used
+ */
+static void BenchPageChecksum(benchmark::State& state) {
+
+  // fill the page with something
+  std::vector<char> page((size_t) state.range(0));
+  std::mt19937 gen(0);
+  for(auto &c : page) {
+    c = (char) gen();
+  }
+
+  // bench
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(PDBBufferManagerChecksum::crc32c(page.data(), page.size()));
+  }
+
+  // the number of bytes we processed
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+  state.counters["hardware"] = PDBBufferManagerChecksum::isHardwareAccelerated();
+}
+
+/**
+ * A sequential scan over a set that is much larger than the buffer pool, so every page is read from the file. The file
+ * is in the page cache so the reads are as fast as they get and the checksums are as expensive as they get.
+ * The argument selects whether the checksums are verified 0 is no and 1 is yes, reported is the number of bytes
+ * scanned per second
+ */
+static void BenchScanChecksums(benchmark::State& state) {
+
+  // the size of a page, the number of pages in the buffer pool and the size of the scanned set
+  const size_t pageSize = 256 * 1024;
+  const size_t numPages = 16;
+  const size_t numScanPages = 256;
+
+  // create a buffer manager that does or does not verify the checksums
+  PDBBufferManagerImpl myMgr;
+  myMgr.initialize("tempBenchChecksums", pageSize, numPages, "metadataBenchChecksums", ".");
+  myMgr.setVerifyChecksums(state.range(0) != 0);
+
+  // write the set we are scanning
+  auto scanSet = make_shared<PDBSet>("db", "checksumSet");
+  for(size_t i = 0; i < numScanPages; ++i) {
+    auto page = myMgr.getPage(scanSet, i);
+    memset(page->getBytes(), (int) i, pageSize);
+    page->setDirty();
+  }
+
+  // bench
+  size_t scanned = 0;
+  for (auto _ : state) {
+    auto page = myMgr.getPage(scanSet, scanned++ % numScanPages);
+    benchmark::DoNotOptimize(((char*) page->getBytes())[0]);
+  }
+
+  // the number of bytes we scanned
+  state.SetBytesProcessed(state.iterations() * pageSize);
+  state.counters["checksumFailures"] = myMgr.getNumChecksumFailures();
+
+  // clear the set
+  myMgr.clearSet(scanSet);
+}
+
+// Register the function as a benchmark
+BENCHMARK(BenchGetPinnedSetPage)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK(BenchAnonymousPageChurn)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK(BenchSmallAnonymousPages);
+BENCHMARK(BenchScanWithHotSet)->Arg(0)->Arg(1);
+BENCHMARK(BenchRandomProbe)->Arg(0)->Arg(1);
+BENCHMARK(BenchPageChecksum)->Arg(4 * 1024)->Arg(1024 * 1024);
+BENCHMARK(BenchScanChecksums)->Arg(0)->Arg(1);
+
+int main(int argc, char** argv) {
+
+  // create the buffer manager
+  bufferManager = new PDBBufferManagerImpl();
+  bufferManager->initialize("tempBenchBufferManager", PAGE_SIZE, 1024, "metadataBenchBufferManager", ".");
+
+  // create the set pages and keep them pinned
+  benchSet = make_shared<PDBSet>("db", "benchSet");
+  for(int i = 0; i < NUM_SET_PAGES; ++i) {
+    pinnedPages.emplace_back(bufferManager->getPage(benchSet, i));
+  }
+
+  // run the benchmarks
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+
+  // clear the set
+  pinnedPages.clear();
+  bufferManager->clearSet(benchSet);
+
+  // remove the buffer manager
+  delete bufferManager;
+  return 0;
+}
@@ -0,0 +1,205 @@
+/*****************************************************************************
+ *                                                                           *
+ *  Copyright 2018 Rice University                                           *
+ *                                                                           *
+ *  Licensed under the Apache License, Version 2.0 (the "License");          *
+ *  you may not use this file except in compliance with the License.         *
+ *  You may obtain a copy of the License at                                  *
+ *                                                                           *
+ *      http://www.apache.org/licenses/LICENSE-2.0                           *
+ *                                                                           *
+ *  Unless required by applicable law or agreed to in writing, software      *
+ *  distributed under the License is distributed on an "AS IS" BASIS,        *
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. *
+ *  See the License for the specific language governing permissions and      *
+ *  limitations under the License.                                           *
+ *                                                                           *
+ *****************************************************************************/
+
+#include <benchmark/benchmark.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <atomic>
+
+#include <GenericWork.h>
+#include <HeapRequest.h>
+#include <PDBConnectionPool.h>
+#include <PDBWorker.h>
+#include <SimpleRequestResult.h>
+
+using namespace pdb;
+
+/**
+ * The logger of the benchmarks
+ */
+static PDBLoggerPtr logger = std::make_shared<PDBLogger>("benchHeapRequest.log");
+
+/**
+ * The workers of the server, every connection is served by its own worker
+ */
+static PDBWorkerQueuePtr workers = nullptr;
+
+/**
+ * The socket the server listens to and its port
+ */
+static int listenFD = -1;
+static int serverPort = 0;
+
+/**
+ * Answers every SimpleRequestResult that comes over the connection with the same message
+ */
+static void serve(const PDBCommunicatorPtr &communicator) {
+
+  while (communicator->getObjectTypeID() == SimpleRequestResult_TYPEID) {
+
+    // grab the request
+    bool success;
+    std::string errMsg;
+    std::unique_ptr<char[]> memory(new char[communicator->getSizeOfNextObject()]);
+    auto request = communicator->getNextObject<SimpleRequestResult>(memory.get(), success, errMsg);
+    if (!success) {
+      break;
+    }
+
+    // send back the same message
+    const UseTemporaryAllocationBlock tempBlock{1024};
+    Handle<SimpleRequestResult> response = makeObject<SimpleRequestResult>(true, request->getRes().second);
+    if (!communicator->sendObject(response, errMsg)) {
+      break;
+    }
+  }
+}
+
+/**
+ * Starts the server on the loopback interface
+ */
+static void startServer(const PDBBuzzerPtr &buzzer) {
+
+  // listen on a port the system picks
+  listenFD = socket(AF_INET, SOCK_STREAM, 0);
+  struct sockaddr_in serverAddress{};
+  serverAddress.sin_family = AF_INET;
+  serverAddress.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  serverAddress.sin_port = 0;
+  if (::bind(listenFD, (struct sockaddr *) &serverAddress, sizeof(serverAddress)) != 0 || ::listen(listenFD, 100) != 0) {
+    std::cerr << "Could not start the server\n";
+    exit(1);
+  }
+
+  // figure out the port
+  socklen_t length = sizeof(serverAddress);
+  getsockname(listenFD, (struct sockaddr *) &serverAddress, &length);
+  serverPort = ntohs(serverAddress.sin_port);
+
+  // accept the connections until the socket is closed
+  auto acceptWork = std::make_shared<GenericWork>([](const PDBBuzzerPtr &callerBuzzer) {
+
+    while (true) {
+
+      std::string errMsg;
+      auto communicator = std::make_shared<PDBCommunicator>();
+      if (!communicator->pointToInternet(logger, listenFD, errMsg)) {
+        break;
+      }
+
+      // serve it, the worker is done once the client closes the connection
+      auto serveWork = std::make_shared<GenericWork>([communicator](const PDBBuzzerPtr &callerBuzzer) {
+        serve(communicator);
+      });
+      workers->getWorker()->execute(serveWork, callerBuzzer);
+    }
+
+    callerBuzzer->buzz(PDBAlarm::WorkAllDone);
+  });
+  workers->getWorker()->execute(acceptWork, buzzer);
+}
+
+/**
+ * Every request opens its own connection, sends the request, reads the response and closes the connection, this is
+ * what the heap requests did before they had a pool, reported is the number of requests per second
+ */
+static void BenchConnectPerRequest(benchmark::State& state) {
+
+  // bench
+  for (auto _ : state) {
+
+    // connect
+    std::string errMsg;
+    PDBCommunicator communicator;
+    if (!communicator.connectToInternetServer(logger, serverPort, "127.0.0.1", errMsg)) {
+      state.SkipWithError(errMsg.c_str());
+      break;
+    }
+
+    // send the request
+    {
+      const UseTemporaryAllocationBlock tempBlock{1024};
+      Handle<SimpleRequestResult> request = makeObject<SimpleRequestResult>(true, "ping");
+      if (!communicator.sendObject(request, errMsg)) {
+        state.SkipWithError(errMsg.c_str());
+        break;
+      }
+    }
+
+    // read the response
+    bool success;
+    std::unique_ptr<char[]> memory(new char[communicator.getSizeOfNextObject()]);
+    auto response = communicator.getNextObject<SimpleRequestResult>(memory.get(), success, errMsg);
+    benchmark::DoNotOptimize(response->getRes().first);
+  }
+
+  // the number of requests we made
+  state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * Every request is a heap request that goes over a connection from the pool, reported is the number of requests per
+ * second
+ */
+static void BenchPooledHeapRequest(benchmark::State& state) {
+
+  auto numConnects = PDBConnectionPool::getDefault().getNumConnects();
+
+  // bench
+  for (auto _ : state) {
+
+    auto success = RequestFactory::heapRequest<SimpleRequestResult, SimpleRequestResult, bool>(
+        logger, serverPort, "127.0.0.1", false, 1024,
+        [](Handle<SimpleRequestResult> result) { return result->getRes().first; },
+        true, "ping");
+    if (!success) {
+      state.SkipWithError("the request failed");
+      break;
+    }
+  }
+
+  // the number of requests we made and the connections we needed for them
+  state.SetItemsProcessed(state.iterations());
+  state.counters["connects"] = PDBConnectionPool::getDefault().getNumConnects() - numConnects;
+}
+
+// Register the function as a benchmark
+BENCHMARK(BenchConnectPerRequest)->UseRealTime();
+BENCHMARK(BenchPooledHeapRequest)->UseRealTime();
+
+int main(int argc, char** argv) {
+
+  // start the server
+  workers = std::make_shared<PDBWorkerQueue>(logger, 16);
+  auto buzzer = std::make_shared<PDBBuzzer>([](PDBAlarm myAlarm) {});
+  startServer(buzzer);
+
+  // run the benchmarks
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+
+  // close the pooled connections and stop the server
+  PDBConnectionPool::getDefault().clear();
+  shutdown(listenFD, SHUT_RDWR);
+  close(listenFD);
+  buzzer->wait();
+
+  return 0;
+}
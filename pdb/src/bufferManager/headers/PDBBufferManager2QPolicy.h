@@ -0,0 +1,80 @@
+#ifndef PDB_PDBBUFFERMANAGER2QPOLICY_H
+#define PDB_PDBBUFFERMANAGER2QPOLICY_H
+
+#include <list>
+#include <unordered_map>
+#include <unordered_set>
+#include "PDBBufferManagerEvictionPolicy.h"
+
+namespace pdb {
+
+/**
+ * A scan resistant eviction policy based on 2Q. Full pages that become evictable for the first time since they were
+ * filled go to a FIFO probation queue, full pages that were pinned again while they were buffered or that hold a page
+ * that was repinned after being evicted go to a protected LRU queue. We evict from the probation queue as long as it
+ * holds at least a quarter of the buffer pool, so a large sequential scan only recycles its own pages and can not
+ * flush the pages that are reused, like the pages of a join hash table or an aggregation.
+ *
+ * Since the policy works on physical pages there is no ghost queue, a repin of an evicted page takes its place.
+ */
+class PDBBufferManager2QPolicy : public PDBBufferManagerEvictionPolicy {
+
+ public:
+
+  /**
+   * Creates the policy
+   * @param numPages - the number of full pages in the buffer pool, used to size the probation queue
+   */
+  explicit PDBBufferManager2QPolicy(size_t numPages);
+
+  void unpinned(void *page) override;
+
+  void pinned(void *page) override;
+
+  void reloaded(void *page) override;
+
+  void freed(void *page) override;
+
+  void *evict() override;
+
+  std::vector<void *> getNextVictims(size_t numPages) override;
+
+  size_t numEvictable() override;
+
+ private:
+
+  /**
+   * removes the page from the queue it is in if it is in one
+   * @param page - the address of the full page
+   */
+  void remove(void *page);
+
+  /**
+   * the full pages that were not reused since they were filled, in FIFO order
+   */
+  std::list<void *> probation;
+
+  /**
+   * the full pages that were reused, in LRU order
+   */
+  std::list<void *> protectedPages;
+
+  /**
+   * for each page in a queue, whether it is in the protected queue and where it is located in the queue
+   */
+  std::unordered_map<void *, std::pair<bool, std::list<void *>::iterator>> positions;
+
+  /**
+   * the full pages that were pinned again since they were filled
+   */
+  std::unordered_set<void *> reused;
+
+  /**
+   * the maximum number of pages we keep in the probation queue before we start evicting from it
+   */
+  size_t maxProbation;
+};
+
+}
+
+#endif //PDB_PDBBUFFERMANAGER2QPOLICY_H
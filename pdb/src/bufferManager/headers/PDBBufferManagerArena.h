@@ -0,0 +1,36 @@
+#ifndef PDB_PDBBUFFERMANAGERARENA_H
+#define PDB_PDBBUFFERMANAGERARENA_H
+
+#include <vector>
+#include "PDBBufferManagerSlab.h"
+
+namespace pdb {
+
+/**
+ * A contiguous part of the buffer pool whose memory is placed on one NUMA node. Every arena keeps its own free
+ * full pages and the slabs of its full pages that have free mini pages, so that a thread can grab memory from the
+ * node it is running on. On a single node
+ * machine there is only one arena that covers the whole pool.
+ */
+struct PDBBufferManagerArena {
+
+  /**
+   * the NUMA node the memory of this arena is placed on
+   */
+  size_t node = 0;
+
+  /**
+   * all of the full pages of this arena that are currently not being used
+   */
+  std::vector<void *> emptyFullPages;
+
+  /**
+   * the first slab of the list of the slabs of this arena that have free mini pages, for each size. The first entry
+   * has the slabs with mini pages of size MIN_PAGE_SIZE, the second the ones of size MIN_PAGE_SIZE * 2, and so on
+   */
+  std::vector<PDBBufferManagerSlab *> freeSlabs;
+};
+
+}
+
+#endif //PDB_PDBBUFFERMANAGERARENA_H
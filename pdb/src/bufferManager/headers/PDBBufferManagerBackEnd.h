@@ -30,10 +30,23 @@
 #include <condition_variable>
 #include "PDBBufferManagerInterface.h"
 #include "PDBPageCompare.h"
+#include "PDBBufferManagerRing.h"
+#include "PDBBufferManagerLeases.h"
+#include "PDBNUMATopology.h"
 
 // this is needed so we can declare friend tests here
 #include <gtest/gtest_prod.h>
 
+// the maximum number of pages we pin or unpin with a single request, so that the request fits into 1024 bytes
+#ifndef PDB_BUFFER_MANAGER_MAX_BATCH
+#define PDB_BUFFER_MANAGER_MAX_BATCH 32u
+#endif
+
+// the maximum number of pages we get with a single request, the response has to fit into a slot of the ring
+#ifndef PDB_BUFFER_MANAGER_MAX_GET_BATCH
+#define PDB_BUFFER_MANAGER_MAX_GET_BATCH 16u
+#endif
+
 namespace pdb {
 
 #ifndef DEBUG_BUFFER_MANAGER
@@ -51,7 +64,15 @@ class PDBBufferManagerBackEnd : public PDBBufferManagerInterface {
 
 public:
 
-  explicit PDBBufferManagerBackEnd(const PDBSharedMemory &sharedMemory);
+  /**
+   * Makes the backend
+   * @param sharedMemory - the buffer pool we share with the frontend
+   * @param ring - the ring we send the requests through, if there is none we connect to the frontend for each request
+   * @param leases - the leases the frontend grants us on the frames, if there are none every pin and unpin is a request
+   */
+  explicit PDBBufferManagerBackEnd(const PDBSharedMemory &sharedMemory,
+                                   const PDBBufferManagerRingPtr &ring = nullptr,
+                                   const PDBBufferManagerLeasesPtr &leases = nullptr);
 
   ~PDBBufferManagerBackEnd() override = default;
 
@@ -78,6 +99,41 @@ public:
    */
   PDBPageHandle getPage(size_t minBytes) override;
 
+  /**
+   * Returns a page that will be guaranteed to have at least minBytes size, the frontend charges its memory to the job
+   * Calling this method is thread safe.
+   * @param jobID - the id of the job, this is the id of the computation the job belongs to
+   * @param minBytes - the minimum bytes required
+   * @return - the handle to an anonymous page
+   */
+  PDBPageHandle getJobPage(uint64_t jobID, size_t minBytes) override;
+
+  /**
+   * Returns the pages of the set with the specified numbers. The pages that are not pinned on the backend are requested
+   * with a request per batch of pages instead of a request per page.
+   * @param whichSet - the set the pages belong to
+   * @param pageNums - the numbers of the pages
+   * @return - the page handles in the same order as the page numbers
+   */
+  std::vector<PDBPageHandle> getPages(PDBSetPtr whichSet, const std::vector<uint64_t> &pageNums) override;
+
+  /**
+   * Returns numPages anonymous pages that are each at least minBytes in size, with a request per batch of pages
+   * @param numPages - the number of pages
+   * @param minBytes - the minimum bytes required
+   * @return - the handles to the anonymous pages
+   */
+  std::vector<PDBPageHandle> getAnonymousPages(size_t numPages, size_t minBytes) override;
+
+  /**
+   * Returns numPages anonymous pages that are each at least minBytes in size, the frontend charges their memory to the job
+   * @param jobID - the id of the job, this is the id of the computation the job belongs to
+   * @param numPages - the number of pages
+   * @param minBytes - the minimum bytes required
+   * @return - the handles to the anonymous pages
+   */
+  std::vector<PDBPageHandle> getJobPages(uint64_t jobID, size_t numPages, size_t minBytes) override;
+
   /**
    *
    * @param communicator
@@ -85,6 +141,19 @@ public:
    */
   PDBPageHandle expectPage(std::shared_ptr<PDBCommunicator> &communicator) PDB_BACKEND_EXPECT_POSTFIX;
 
+  /**
+   * Repins all the pages. The pages that are not pinned on the backend are pinned with a request per batch of
+   * pages of the same set instead of a request per page.
+   * @param pages - the pages we want to repin
+   */
+  void repinAll(std::vector<PDBPageHandle> &pages) override;
+
+  /**
+   * Unpins all the pages with a request per batch of pages of the same set
+   * @param pages - the pages we want to unpin
+   */
+  void unpinAll(std::vector<PDBPageHandle> &pages) override;
+
 
   /**
    * Returns the maximum page size as set in the configuration
@@ -92,6 +161,12 @@ public:
    */
   size_t getMaxPageSize() override;
 
+  /**
+   * Returns the number of pages the frontend can still pin as of the last time it published it through the ring
+   * @return - the value, there is no limit if we don't share a ring with the frontend
+   */
+  size_t getNumAvailablePages() override;
+
   void registerHandlers(PDBServer &forMe) override;
 
 protected:
@@ -139,6 +214,56 @@ protected:
    */
   void repin(PDBPagePtr me) override;
 
+  /**
+   * Requests an anonymous page from the frontend
+   * @param minBytes - the minimum bytes required
+   * @param jobID - the job the page is charged to, -1 if it is not charged to any
+   * @return - the handle to an anonymous page
+   */
+  PDBPageHandle getAnonymousPage(size_t minBytes, int64_t jobID);
+
+  /**
+   * Requests anonymous pages from the frontend with a request per batch of PDB_BUFFER_MANAGER_MAX_GET_BATCH pages
+   * @param numPages - the number of pages
+   * @param minBytes - the minimum bytes required
+   * @param jobID - the job the pages are charged to, -1 if they are not charged to any
+   * @return - the handles to the anonymous pages
+   */
+  std::vector<PDBPageHandle> getAnonymousPages(size_t numPages, size_t minBytes, int64_t jobID);
+
+  /**
+   * Sends a request to the frontend and processes the response, works like the heapRequest of the request factory
+   * @return whatever is returned from processResponse or onErr in case of failure
+   */
+  template <class RequestType, class ResponseType, class ReturnType, class... RequestTypeParams>
+  ReturnType sendRequest(ReturnType onErr,
+                         const std::function<ReturnType(Handle<ResponseType>)> &processResponse,
+                         RequestTypeParams &&... args);
+
+  /**
+   * Sends the pages to the function in batches of at most maxBatchSize pages of the same set
+   * @param pages - the pages
+   * @param process - called with the set and the pages of each batch
+   * @param maxBatchSize - the maximum number of pages in a batch
+   */
+  static void forEachBatch(std::vector<PDBPagePtr> &pages,
+                           const std::function<void(const PDBSetPtr &, std::vector<PDBPagePtr> &)> &process,
+                           size_t maxBatchSize = PDB_BUFFER_MANAGER_MAX_BATCH);
+
+  /**
+   * Pins the page through the lease we have on its frame, the pages have to be locked
+   * @param me - the page
+   * @return - true if it is pinned, false if the lease was revoked and we have to ask the frontend for the page
+   */
+  bool pinLeased(const PDBPagePtr &me);
+
+  /**
+   * Unpins the page through the lease we have on its frame, the pages have to be locked
+   * @param me - the page
+   * @return - true if it is unpinned, false if we have no lease and have to ask the frontend to unpin it
+   */
+  bool unpinLeased(const PDBPagePtr &me);
+
   // conditional variable to prevent multiple pages at the same time
   std::condition_variable cv;
 
@@ -154,12 +279,22 @@ protected:
   // Logger to debug information
   PDBLoggerPtr myLogger;
 
+  // the ring we share with the frontend
+  PDBBufferManagerRingPtr ring;
+
+  // the leases we share with the frontend
+  PDBBufferManagerLeasesPtr leases;
+
+  // the NUMA nodes of the machine, we tell the frontend which one we run on so it gives us memory from it
+  PDBNUMATopology numaTopology;
+
   // mark the tests for the backend
   FRIEND_TEST(BufferManagerBackendTest, Test1);
   FRIEND_TEST(BufferManagerBackendTest, Test2);
   FRIEND_TEST(BufferManagerBackendTest, Test3);
   FRIEND_TEST(BufferManagerBackendTest, Test4);
   FRIEND_TEST(BufferManagerBackendTest, Test5);
+  FRIEND_TEST(BufferManagerBackendTest, Test6);
 };
 
 }
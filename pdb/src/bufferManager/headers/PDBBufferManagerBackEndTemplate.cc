@@ -8,24 +8,58 @@
 #include <BufForwardPageRequest.h>
 #include <BufGetPageResult.h>
 #include <BufGetAnonymousPageRequest.h>
+#include <BufGetPagesRequest.h>
+#include <BufGetAnonymousPagesRequest.h>
+#include <BufGetPagesResult.h>
 #include <BufReturnPageRequest.h>
 #include <BufReturnAnonPageRequest.h>
 #include <BufFreezeSizeRequest.h>
 #include <BufUnpinPageRequest.h>
 #include <BufPinPageRequest.h>
 #include <BufPinPageResult.h>
+#include <BufPinPagesRequest.h>
+#include <BufPinPagesResult.h>
+#include <BufUnpinPagesRequest.h>
 #include <mutex>
+#include <algorithm>
 #include <BufFreezeRequestResult.h>
 
 namespace pdb {
 
 template <class T>
-pdb::PDBBufferManagerBackEnd<T>::PDBBufferManagerBackEnd(const PDBSharedMemory &sharedMemory) : sharedMemory(sharedMemory) {
+pdb::PDBBufferManagerBackEnd<T>::PDBBufferManagerBackEnd(const PDBSharedMemory &sharedMemory,
+                                                        const PDBBufferManagerRingPtr &ring,
+                                                        const PDBBufferManagerLeasesPtr &leases) : sharedMemory(sharedMemory),
+                                                                                                   ring(ring),
+                                                                                                   leases(leases) {
 
   // make a logger
   myLogger = make_shared<pdb::PDBLogger>("storageLog");
 }
 
+template <class T>
+template <class RequestType, class ResponseType, class ReturnType, class... RequestTypeParams>
+ReturnType pdb::PDBBufferManagerBackEnd<T>::sendRequest(ReturnType onErr,
+                                                        const std::function<ReturnType(Handle<ResponseType>)> &processResponse,
+                                                        RequestTypeParams &&... args) {
+
+  // if we share a ring with the frontend send the request through it
+  if (ring != nullptr) {
+
+    // tell the subscribers about the memory pressure of the frontend before we ask it for more memory
+    memoryPressure.signal(ring->getMemoryPressure());
+
+    return ring->template request<RequestType, ResponseType, ReturnType>(myLogger, onErr, processResponse, std::forward<RequestTypeParams>(args)...);
+  }
+
+  // grab the address of the frontend
+  auto port = getConfiguration()->port;
+  auto address = getConfiguration()->address;
+
+  // otherwise connect to it
+  return T::template heapRequest<RequestType, ResponseType, ReturnType>(myLogger, port, address, onErr, 1024, processResponse, std::forward<RequestTypeParams>(args)...);
+}
+
 template <class T>
 pdb::PDBPageHandle pdb::PDBBufferManagerBackEnd<T>::getPage(pdb::PDBSetPtr whichSet, uint64_t i) {
 
@@ -62,7 +96,7 @@ pdb::PDBPageHandle pdb::PDBBufferManagerBackEnd<T>::getPage(pdb::PDBSetPtr which
       }
 
       // grab the status
-      auto status = it->second->status;
+      PDBPageStatus status = it->second->status;
 
       // are we working on it if so wait a bit?
       return !(status == PDB_PAGE_LOADING || status == PDB_PAGE_UNLOADING || status == PDB_PAGE_FREEZING);
@@ -79,8 +113,8 @@ pdb::PDBPageHandle pdb::PDBBufferManagerBackEnd<T>::getPage(pdb::PDBSetPtr which
     /// 2. At this point it is safe to assume we are the only one with access to the page. Now check if it is already
     /// on the backend
 
-    // do we have the page return it!
-    if (pageHandle->getBytes() != nullptr) {
+    // do we have the page or can we pin it through the lease, return it!
+    if (pageHandle->getBytes() != nullptr || pinLeased(pageHandle->page)) {
 
       // mark the page as loaded
       pageHandle->page->status = PDB_PAGE_LOADED;
@@ -97,14 +131,9 @@ pdb::PDBPageHandle pdb::PDBBufferManagerBackEnd<T>::getPage(pdb::PDBSetPtr which
 
   /// 3. Request the page from the frontend since we don't have it...
 
-  // grab the address of the frontend
-  auto port = getConfiguration()->port;
-  auto address = getConfiguration()->address;
-
   // ok we don't have the page loaded, make a request to get it...
-  auto res = T::template heapRequest<BufGetPageRequest, BufGetPageResult, pdb::PDBPageHandle>(
-      myLogger, port, address, nullptr, 1024,
-      [&](Handle<BufGetPageResult> result) {
+  auto res = sendRequest<BufGetPageRequest, BufGetPageResult, pdb::PDBPageHandle>(
+      nullptr, [&](Handle<BufGetPageResult> result) {
 
         if (result != nullptr) {
 
@@ -122,6 +151,7 @@ pdb::PDBPageHandle pdb::PDBBufferManagerBackEnd<T>::getPage(pdb::PDBSetPtr which
             returnVal->location.startPos = result->startPos;
             returnVal->location.numBytes = result->numBytes;
             returnVal->bytes = (void *) (((uint64_t) this->sharedMemory.memory) + (uint64_t) result->offset);
+            returnVal->lease = result->lease;
             returnVal->status = PDB_PAGE_LOADED;
           }
 
@@ -144,12 +174,247 @@ pdb::PDBPageHandle pdb::PDBBufferManagerBackEnd<T>::getPage(pdb::PDBSetPtr which
         exit(-1);
 
       },
-      whichSet, i);
+      whichSet, i, (int64_t) numaTopology.getCurrentNode());
 
   // return the page
   return std::move(res);
 }
 
+template <class T>
+std::vector<pdb::PDBPageHandle> pdb::PDBBufferManagerBackEnd<T>::getPages(pdb::PDBSetPtr whichSet, const std::vector<uint64_t> &pageNums) {
+
+  // the handles we return, in the same order as the page numbers
+  std::vector<PDBPageHandle> pages(pageNums.size());
+
+  // the indices of the pages we still have to get
+  std::vector<size_t> toGet(pageNums.size());
+  for (size_t idx = 0; idx < pageNums.size(); ++idx) {
+    toGet[idx] = idx;
+  }
+
+  // lock the pages
+  unique_lock<std::mutex> lck(m);
+
+  while (!toGet.empty()) {
+
+    /// 1. Mark the pages nobody is working on as loading, if somebody is working on a page we come back to it later
+
+    std::vector<size_t> busy;
+    std::vector<PDBPagePtr> loading;
+    for (auto idx : toGet) {
+
+      // find the page
+      pair<PDBSetPtr, long> key = std::make_pair(whichSet, pageNums[idx]);
+      auto it = allPages.find(key);
+
+      // if it does not exist create it
+      if (it == allPages.end()) {
+
+        // make a page
+        PDBPagePtr returnVal = make_shared<PDBPage>(*this);
+        returnVal->setBytes(nullptr);
+        returnVal->setMe(returnVal);
+        returnVal->setSet(whichSet);
+        returnVal->setPageNum(pageNums[idx]);
+        returnVal->status = PDB_PAGE_NOT_LOADED;
+
+        // insert the page
+        it = allPages.insert(std::make_pair(key, returnVal)).first;
+      }
+
+      // is somebody working on it
+      auto &me = it->second;
+      if (me->status == PDB_PAGE_LOADING || me->status == PDB_PAGE_UNLOADING || me->status == PDB_PAGE_FREEZING) {
+        busy.emplace_back(idx);
+        continue;
+      }
+
+      // make a page handle
+      pages[idx] = make_shared<PDBPageHandleBase>(me);
+
+      // do we have the page or can we pin it through the lease, if so no need to ask the frontend
+      if (me->bytes != nullptr || pinLeased(me)) {
+        continue;
+      }
+
+      // update status
+      me->status = PDB_PAGE_LOADING;
+      loading.emplace_back(me);
+    }
+
+    // unlock while we talk to the frontend
+    lck.unlock();
+
+    /// 2. Make a request for each batch of pages
+
+    forEachBatch(loading, [&](const PDBSetPtr &set, std::vector<PDBPagePtr> &batch) {
+
+      // the page numbers
+      std::vector<uint64_t> pageNumbers;
+      for (auto &me : batch) {
+        pageNumbers.emplace_back(me->pageNum);
+      }
+
+      // make a request
+      auto res = sendRequest<BufGetPagesRequest, BufGetPagesResult, bool>(
+          false, [&](Handle<BufGetPagesResult> result) {
+
+            // return the result
+            if (result != nullptr && result->success && result->offsets.size() == batch.size()) {
+
+              {
+                // lock the pages
+                unique_lock<std::mutex> lock(m);
+
+                // fill in the stuff
+                for (int i = 0; i < batch.size(); ++i) {
+                  batch[i]->isAnon = false;
+                  batch[i]->pinned = true;
+                  batch[i]->dirty = false;
+                  batch[i]->location.startPos = result->startPositions[i];
+                  batch[i]->location.numBytes = result->numBytes[i];
+                  batch[i]->bytes = (void *) ((uint64_t) this->sharedMemory.memory + (uint64_t) result->offsets[i]);
+                  batch[i]->lease = result->leases[i];
+                  batch[i]->status = PDB_PAGE_LOADED;
+                }
+              }
+
+              // notify all threads that the state has changed
+              cv.notify_all();
+
+              // we succeeded
+              return true;
+            }
+
+            // set the error since we failed
+            myLogger->error("Could not get the requested pages of (" + set->getDBName() + ", " + set->getSetName() + ")");
+
+            return false;
+          },
+          set, pageNumbers, (int64_t) numaTopology.getCurrentNode());
+
+      // did we succeed in getting the pages
+      if (!res) {
+
+        // something strange happened kill the backend!
+        exit(-1);
+      }
+    }, PDB_BUFFER_MANAGER_MAX_GET_BATCH);
+
+    /// 3. Wait for the pages somebody else was working on
+
+    lck.lock();
+
+    // notify all threads about the pages we pinned through the leases
+    cv.notify_all();
+
+    // if there are none we are done
+    if (busy.empty()) {
+      break;
+    }
+
+    // wait till one of them is free and try them again
+    cv.wait(lck, [&] {
+      return std::any_of(busy.begin(), busy.end(), [&](size_t idx) {
+        auto it = allPages.find(std::make_pair(whichSet, pageNums[idx]));
+        return it == allPages.end() || !(it->second->status == PDB_PAGE_LOADING ||
+                                         it->second->status == PDB_PAGE_UNLOADING ||
+                                         it->second->status == PDB_PAGE_FREEZING);
+      });
+    });
+    toGet = std::move(busy);
+  }
+
+  return pages;
+}
+
+template <class T>
+std::vector<pdb::PDBPageHandle> pdb::PDBBufferManagerBackEnd<T>::getAnonymousPages(size_t numPages, size_t minBytes) {
+  return getAnonymousPages(numPages, minBytes, -1);
+}
+
+template <class T>
+std::vector<pdb::PDBPageHandle> pdb::PDBBufferManagerBackEnd<T>::getJobPages(uint64_t jobID, size_t numPages, size_t minBytes) {
+  return getAnonymousPages(numPages, minBytes, (int64_t) jobID);
+}
+
+template <class T>
+std::vector<pdb::PDBPageHandle> pdb::PDBBufferManagerBackEnd<T>::getAnonymousPages(size_t numPages, size_t minBytes, int64_t jobID) {
+
+  // the handles we return
+  std::vector<PDBPageHandle> pages;
+  pages.reserve(numPages);
+
+  if (minBytes > sharedMemory.pageSize) {
+    std::cerr << minBytes << " is larger than the system page size of " << sharedMemory.pageSize << "\n";
+    pages.resize(numPages);
+    return pages;
+  }
+
+  /// 1. We simply request the pages a batch at a time, it is safe since they are new anonymous pages
+
+  while (pages.size() < numPages) {
+
+    // the number of pages in this batch
+    size_t batchSize = std::min<size_t>(numPages - pages.size(), PDB_BUFFER_MANAGER_MAX_GET_BATCH);
+
+    // make a request
+    auto res = sendRequest<BufGetAnonymousPagesRequest, BufGetPagesResult, bool>(
+        false, [&](Handle<BufGetPagesResult> result) {
+
+          if (result != nullptr && result->success && result->offsets.size() == batchSize) {
+
+            {
+              // lock all pages to add the pages there
+              unique_lock<std::mutex> lck(m);
+
+              for (int i = 0; i < batchSize; ++i) {
+
+                // make the page
+                PDBPagePtr returnVal = make_shared<PDBPage>(*this);
+                returnVal->setMe(returnVal);
+                returnVal->isAnon = true;
+                returnVal->pinned = true;
+                returnVal->dirty = false;
+                returnVal->pageNum = result->pageNums[i];
+                returnVal->location.startPos = result->startPositions[i];
+                returnVal->location.numBytes = result->numBytes[i];
+                returnVal->bytes = (char *) this->sharedMemory.memory + result->offsets[i];
+                returnVal->lease = result->leases[i];
+
+                // mark the page as loaded
+                returnVal->status = PDB_PAGE_LOADED;
+
+                // insert the page
+                allPages[std::make_pair(returnVal->whichSet, returnVal->pageNum)] = returnVal;
+
+                // store the handle
+                pages.emplace_back(make_shared<PDBPageHandleBase>(returnVal));
+              }
+            }
+
+            // notify all threads that the state has changed
+            cv.notify_all();
+
+            return true;
+          }
+
+          // set the error since we failed
+          myLogger->error("Could not get the requested anonymous pages of size " + std::to_string(minBytes));
+
+          return false;
+        },
+        batchSize, minBytes, jobID, (int64_t) numaTopology.getCurrentNode());
+
+    // if we failed the rest of the pages are null like the ones of getPage
+    if (!res) {
+      pages.resize(numPages);
+    }
+  }
+
+  return pages;
+}
+
 template <class T>
 pdb::PDBPageHandle pdb::PDBBufferManagerBackEnd<T>::getPage() {
   return getPage(getConfiguration()->pageSize);
@@ -157,25 +422,30 @@ pdb::PDBPageHandle pdb::PDBBufferManagerBackEnd<T>::getPage() {
 
 template <class T>
 pdb::PDBPageHandle pdb::PDBBufferManagerBackEnd<T>::getPage(size_t minBytes) {
+  return getAnonymousPage(minBytes, -1);
+}
+
+template <class T>
+pdb::PDBPageHandle pdb::PDBBufferManagerBackEnd<T>::getJobPage(uint64_t jobID, size_t minBytes) {
+  return getAnonymousPage(minBytes, (int64_t) jobID);
+}
+
+template <class T>
+pdb::PDBPageHandle pdb::PDBBufferManagerBackEnd<T>::getAnonymousPage(size_t minBytes, int64_t jobID) {
 
   if (minBytes > sharedMemory.pageSize) {
     std::cerr << minBytes << " is larger than the system page size of " << sharedMemory.pageSize << "\n";
     return nullptr;
   }
 
-  // grab the address of the frontend
-  auto port = getConfiguration()->port;
-  auto address = getConfiguration()->address;
-
   // somewhere to put the message.
   std::string errMsg;
 
   /// 1. We simply request the page it is safe since it is a new anonymous page
 
   // make a request
-  auto res = T::template heapRequest<BufGetAnonymousPageRequest, BufGetPageResult, pdb::PDBPageHandle>(
-      myLogger, port, address, nullptr, 1024,
-      [&](Handle<BufGetPageResult> result) {
+  auto res = sendRequest<BufGetAnonymousPageRequest, BufGetPageResult, pdb::PDBPageHandle>(
+      nullptr, [&](Handle<BufGetPageResult> result) {
 
         if (result != nullptr) {
 
@@ -188,6 +458,7 @@ pdb::PDBPageHandle pdb::PDBBufferManagerBackEnd<T>::getPage(size_t minBytes) {
           returnVal->location.startPos = result->startPos;
           returnVal->location.numBytes = result->numBytes;
           returnVal->bytes = (char *) this->sharedMemory.memory + result->offset;
+          returnVal->lease = result->lease;
 
           // this an anonymous page if it is not set the database and set name
           if (!result->isAnonymous) {
@@ -218,7 +489,7 @@ pdb::PDBPageHandle pdb::PDBBufferManagerBackEnd<T>::getPage(size_t minBytes) {
 
         return (pdb::PDBPageHandle) nullptr;
       },
-      minBytes);
+      minBytes, jobID, (int64_t) numaTopology.getCurrentNode());
 
   // return the page
   return std::move(res);
@@ -301,7 +572,7 @@ PDBPageHandle PDBBufferManagerBackEnd<T>::expectPage(std::shared_ptr<PDBCommunic
       }
 
       // grab the status
-      auto status = it->second->status;
+      PDBPageStatus status = it->second->status;
 
       // are we working on it if so wait a bit?
       return !(status == PDB_PAGE_LOADING || status == PDB_PAGE_UNLOADING || status == PDB_PAGE_FREEZING);
@@ -331,6 +602,7 @@ PDBPageHandle PDBBufferManagerBackEnd<T>::expectPage(std::shared_ptr<PDBCommunic
       page->location.startPos = result->startPos;
       page->location.numBytes = result->numBytes;
       page->bytes = (void *) (((uint64_t) this->sharedMemory.memory) + (uint64_t) result->offset);
+      page->lease = -1;
       page->status = PDB_PAGE_LOADED;
 
       lock.unlock();
@@ -365,6 +637,17 @@ size_t pdb::PDBBufferManagerBackEnd<T>::getMaxPageSize() {
   return getConfiguration()->pageSize;
 }
 
+template <class T>
+size_t pdb::PDBBufferManagerBackEnd<T>::getNumAvailablePages() {
+
+  // the frontend publishes it through the ring
+  if (ring != nullptr) {
+    return ring->getNumAvailablePages();
+  }
+
+  return PDBBufferManagerInterface::getNumAvailablePages();
+}
+
 template <class T>
 void pdb::PDBBufferManagerBackEnd<T>::freeAnonymousPage(pdb::PDBPagePtr me) {
 
@@ -382,16 +665,11 @@ void pdb::PDBBufferManagerBackEnd<T>::freeAnonymousPage(pdb::PDBPagePtr me) {
     allPages.erase(key);
   }
 
-  // grab the address of the frontend
-  auto port = getConfiguration()->port;
-  auto address = getConfiguration()->address;
-
   /// 2. We make a request to return it to the other side
 
   // make a request
-  auto res = T::template heapRequest<BufReturnAnonPageRequest, SimpleRequestResult, bool>(
-      myLogger, port, address, false, 1024,
-      [&](Handle<SimpleRequestResult> result) {
+  auto res = sendRequest<BufReturnAnonPageRequest, SimpleRequestResult, bool>(
+      false, [&](Handle<SimpleRequestResult> result) {
 
         // return the result
         if (result != nullptr && result->getRes().first) {
@@ -455,14 +733,9 @@ void pdb::PDBBufferManagerBackEnd<T>::downToZeroReferences(pdb::PDBPagePtr me) {
 
   /// 2. We need to notify the frontend that we are returning this page
 
-  // grab the address of the frontend
-  auto port = getConfiguration()->port;
-  auto address = getConfiguration()->address;
-
   // make a request
-  auto res = T::template heapRequest<BufReturnPageRequest, SimpleRequestResult, bool>(
-      myLogger, port, address, false, 1024,
-      [&](Handle<SimpleRequestResult> result) {
+  auto res = sendRequest<BufReturnPageRequest, SimpleRequestResult, bool>(
+      false, [&](Handle<SimpleRequestResult> result) {
 
         // return the result
         if (result != nullptr && result->getRes().first) {
@@ -475,8 +748,9 @@ void pdb::PDBBufferManagerBackEnd<T>::downToZeroReferences(pdb::PDBPagePtr me) {
             // remove the page
             allPages.erase(std::make_pair(me->whichSet, me->whichPage()));
 
-            // set the bytes to null
+            // set the bytes to null, the frontend ended the lease
             me->bytes = nullptr;
+            me->lease = -1;
 
             // mark it as unloaded
             me->status = PDB_PAGE_NOT_LOADED;
@@ -520,19 +794,14 @@ void pdb::PDBBufferManagerBackEnd<T>::freezeSize(pdb::PDBPagePtr me, size_t numB
     me->status = PDB_PAGE_FREEZING;
   }
 
-  // grab the address of the frontend
-  auto port = getConfiguration()->port;
-  auto address = getConfiguration()->address;
-
   // somewhere to put the message.
   std::string errMsg;
 
   /// 2. Make the request to freeze it
 
   // make a request
-  auto res = T::template heapRequest<BufFreezeSizeRequest, BufFreezeRequestResult, bool>(
-      myLogger, port, address, false, 1024,
-      [&](Handle<BufFreezeRequestResult> result) {
+  auto res = sendRequest<BufFreezeSizeRequest, BufFreezeRequestResult, bool>(
+      false, [&](Handle<BufFreezeRequestResult> result) {
 
         // return the result
         if (result != nullptr && result->res) {
@@ -581,8 +850,8 @@ void pdb::PDBBufferManagerBackEnd<T>::unpin(pdb::PDBPagePtr me) {
     // update status
     me->status = PDB_PAGE_UNLOADING;
 
-    // are we already unpinned if so just return no need to send messages around
-    if(me->bytes == nullptr) {
+    // are we already unpinned or can we unpin it through the lease, if so just return no need to send messages around
+    if(me->bytes == nullptr || unpinLeased(me)) {
 
       // mark the page as unloaded
       me->status = PDB_PAGE_NOT_LOADED;
@@ -598,17 +867,12 @@ void pdb::PDBBufferManagerBackEnd<T>::unpin(pdb::PDBPagePtr me) {
     }
   }
 
-  // grab the address of the frontend
-  auto port = getConfiguration()->port;
-  auto address = getConfiguration()->address;
-
   // somewhere to put the message.
   std::string errMsg;
 
   // make a request
-  auto res = T::template heapRequest<BufUnpinPageRequest, SimpleRequestResult, bool>(
-      myLogger, port, address, false, 1024,
-      [&](Handle<SimpleRequestResult> result) {
+  auto res = sendRequest<BufUnpinPageRequest, SimpleRequestResult, bool>(
+      false, [&](Handle<SimpleRequestResult> result) {
 
         // return the result
         if (result != nullptr && result->getRes().first) {
@@ -635,7 +899,7 @@ void pdb::PDBBufferManagerBackEnd<T>::unpin(pdb::PDBPagePtr me) {
         // yeah we could not
         return false;
       },
-      me->whichSet, me->pageNum, me->isDirty());
+      me->whichSet, me->pageNum, me->isDirty(), me->getAccessHint());
 
   // did we succeed in returning the page
   if (!res) {
@@ -668,19 +932,27 @@ void pdb::PDBBufferManagerBackEnd<T>::repin(pdb::PDBPagePtr me) {
       // finish
       return;
     }
-  }
 
-  // grab the address of the frontend
-  auto port = getConfiguration()->port;
-  auto address = getConfiguration()->address;
+    // if we still have the lease on the frame we pin it through it
+    if(pinLeased(me)) {
+
+      // unlock
+      lck.unlock();
+
+      // notify all threads that the state has changed
+      cv.notify_all();
+
+      // finish
+      return;
+    }
+  }
 
   // somewhere to put the message.
   std::string errMsg;
 
   // make a request
-  auto res = T::template heapRequest<BufPinPageRequest, BufPinPageResult, bool>(
-      myLogger, port, address, false, 1024,
-      [&](Handle<BufPinPageResult> result) {
+  auto res = sendRequest<BufPinPageRequest, BufPinPageResult, bool>(
+      false, [&](Handle<BufPinPageResult> result) {
 
         // return the result
         if (result != nullptr && result->success) {
@@ -691,6 +963,7 @@ void pdb::PDBBufferManagerBackEnd<T>::repin(pdb::PDBPagePtr me) {
 
             // figure out the pointer for the offset and update status
             me->bytes = (void *) ((uint64_t) this->sharedMemory.memory + (uint64_t) result->offset);
+            me->lease = result->lease;
             me->status = PDB_PAGE_LOADED;
           }
 
@@ -716,6 +989,307 @@ void pdb::PDBBufferManagerBackEnd<T>::repin(pdb::PDBPagePtr me) {
   }
 }
 
+template <class T>
+void pdb::PDBBufferManagerBackEnd<T>::repinAll(std::vector<PDBPageHandle> &pages) {
+
+  // grab the pages
+  std::vector<PDBPagePtr> toPin;
+  toPin.reserve(pages.size());
+  for (auto &page : pages) {
+    toPin.emplace_back(page->page);
+  }
+
+  // lock the pages
+  unique_lock<std::mutex> lck(m);
+
+  while (!toPin.empty()) {
+
+    /// 1. Mark the pages nobody is working on as loading, if somebody is working on a page we come back to it later
+
+    std::vector<PDBPagePtr> busy;
+    std::vector<PDBPagePtr> loading;
+    for (auto &me : toPin) {
+
+      // is somebody working on it
+      if (me->status == PDB_PAGE_LOADING || me->status == PDB_PAGE_UNLOADING || me->status == PDB_PAGE_FREEZING) {
+        busy.emplace_back(me);
+        continue;
+      }
+
+      // check whether the page is already pinned or we can pin it through the lease, if so no need to ask the frontend
+      if (me->bytes != nullptr || pinLeased(me)) {
+        continue;
+      }
+
+      // update status
+      me->status = PDB_PAGE_LOADING;
+      loading.emplace_back(me);
+    }
+
+    // unlock while we talk to the frontend
+    lck.unlock();
+
+    /// 2. Make a request for each batch of pages
+
+    forEachBatch(loading, [&](const PDBSetPtr &set, std::vector<PDBPagePtr> &batch) {
+
+      // the page numbers
+      std::vector<uint64_t> pageNumbers;
+      for (auto &me : batch) {
+        pageNumbers.emplace_back(me->pageNum);
+      }
+
+      // make a request
+      auto res = sendRequest<BufPinPagesRequest, BufPinPagesResult, bool>(
+          false, [&](Handle<BufPinPagesResult> result) {
+
+            // return the result
+            if (result != nullptr && result->success && result->offsets.size() == batch.size()) {
+
+              {
+                // lock the pages
+                unique_lock<std::mutex> lock(m);
+
+                // figure out the pointers for the offsets, grab the leases and update the status
+                for (int i = 0; i < batch.size(); ++i) {
+                  batch[i]->bytes = (void *) ((uint64_t) this->sharedMemory.memory + (uint64_t) result->offsets[i]);
+                  batch[i]->lease = result->leases.size() == batch.size() ? result->leases[i] : -1;
+                  batch[i]->status = PDB_PAGE_LOADED;
+                }
+              }
+
+              // notify all threads that the state has changed
+              cv.notify_all();
+
+              // we succeeded
+              return true;
+            }
+
+            // set the error since we failed
+            myLogger->error("Could not pin the requested pages");
+
+            return false;
+          },
+          set, pageNumbers);
+
+      // did we succeed in pinning the pages
+      if (!res) {
+
+        // ok something is wrong kill the backend...
+        exit(-1);
+      }
+    });
+
+    /// 3. Wait for the pages somebody else was working on
+
+    lck.lock();
+
+    // if there are none we are done
+    if (busy.empty()) {
+      break;
+    }
+
+    // wait till one of them is free and try them again
+    cv.wait(lck, [&] {
+      return std::any_of(busy.begin(), busy.end(), [](const PDBPagePtr &me) {
+        return !(me->status == PDB_PAGE_LOADING || me->status == PDB_PAGE_UNLOADING || me->status == PDB_PAGE_FREEZING);
+      });
+    });
+    toPin = std::move(busy);
+  }
+}
+
+template <class T>
+void pdb::PDBBufferManagerBackEnd<T>::unpinAll(std::vector<PDBPageHandle> &pages) {
+
+  // grab the pages
+  std::vector<PDBPagePtr> toUnpin;
+  toUnpin.reserve(pages.size());
+  for (auto &page : pages) {
+    toUnpin.emplace_back(page->page);
+  }
+
+  // lock the pages
+  unique_lock<std::mutex> lck(m);
+
+  while (!toUnpin.empty()) {
+
+    /// 1. Mark the pages nobody is working on as unloading, if somebody is working on a page we come back to it later
+
+    std::vector<PDBPagePtr> busy;
+    std::vector<PDBPagePtr> unloading;
+    for (auto &me : toUnpin) {
+
+      // is somebody working on it
+      if (me->status == PDB_PAGE_LOADING || me->status == PDB_PAGE_UNLOADING || me->status == PDB_PAGE_FREEZING) {
+        busy.emplace_back(me);
+        continue;
+      }
+
+      // are we already unpinned or can we unpin it through the lease, if so just mark it, no need to send messages around
+      if (me->bytes == nullptr || unpinLeased(me)) {
+        me->status = PDB_PAGE_NOT_LOADED;
+        continue;
+      }
+
+      // update status
+      me->status = PDB_PAGE_UNLOADING;
+      unloading.emplace_back(me);
+    }
+
+    // unlock while we talk to the frontend
+    lck.unlock();
+
+    /// 2. Make a request for each batch of pages
+
+    forEachBatch(unloading, [&](const PDBSetPtr &set, std::vector<PDBPagePtr> &batch) {
+
+      // the page numbers, the dirty bits and the hints
+      std::vector<uint64_t> pageNumbers;
+      std::vector<bool> isDirty;
+      std::vector<PDBPageAccessHint> accessHints;
+      for (auto &me : batch) {
+        pageNumbers.emplace_back(me->pageNum);
+        isDirty.emplace_back(me->isDirty());
+        accessHints.emplace_back(me->getAccessHint());
+      }
+
+      // make a request
+      auto res = sendRequest<BufUnpinPagesRequest, SimpleRequestResult, bool>(
+          false, [&](Handle<SimpleRequestResult> result) {
+
+            // return the result
+            if (result != nullptr && result->getRes().first) {
+
+              {
+                // lock the pages
+                unique_lock<std::mutex> lock(m);
+
+                // invalidate the pages
+                for (auto &me : batch) {
+                  me->bytes = nullptr;
+                  me->status = PDB_PAGE_NOT_LOADED;
+                }
+              }
+
+              // notify all threads that the state has changed
+              cv.notify_all();
+
+              // so it worked
+              return true;
+            }
+
+            // set the error since we failed
+            myLogger->error("Could not unpin the requested pages");
+
+            return false;
+          },
+          set, pageNumbers, isDirty, accessHints);
+
+      // did we succeed in unpinning the pages
+      if (!res) {
+
+        // ok something is wrong kill the backend...
+        exit(-1);
+      }
+    });
+
+    /// 3. Wait for the pages somebody else was working on
+
+    lck.lock();
+
+    // notify all threads about the pages we marked as not loaded
+    cv.notify_all();
+
+    // if there are none we are done
+    if (busy.empty()) {
+      break;
+    }
+
+    // wait till one of them is free and try them again
+    cv.wait(lck, [&] {
+      return std::any_of(busy.begin(), busy.end(), [](const PDBPagePtr &me) {
+        return !(me->status == PDB_PAGE_LOADING || me->status == PDB_PAGE_UNLOADING || me->status == PDB_PAGE_FREEZING);
+      });
+    });
+    toUnpin = std::move(busy);
+  }
+}
+
+template <class T>
+bool pdb::PDBBufferManagerBackEnd<T>::pinLeased(const PDBPagePtr &me) {
+
+  // do we have a lease on the frame
+  if (leases == nullptr || me->lease == -1) {
+    return false;
+  }
+
+  // try to pin it, if the frontend revoked the lease it is gone for good
+  uint64_t offset;
+  if (!leases->pin(me->lease, offset)) {
+    me->lease = -1;
+    return false;
+  }
+
+  // the frame is ours again
+  me->bytes = (void *) ((uint64_t) this->sharedMemory.memory + offset);
+  me->status = PDB_PAGE_LOADED;
+
+  return true;
+}
+
+template <class T>
+bool pdb::PDBBufferManagerBackEnd<T>::unpinLeased(const PDBPagePtr &me) {
+
+  // do we have a lease on the frame
+  if (leases == nullptr || me->lease == -1) {
+    return false;
+  }
+
+  // unpin it, the frontend keeps the frame until it revokes the lease
+  if (!leases->unpin(me->lease, me->isDirty(), me->hint)) {
+    me->lease = -1;
+    return false;
+  }
+
+  // invalidate the page
+  me->bytes = nullptr;
+  me->status = PDB_PAGE_NOT_LOADED;
+
+  return true;
+}
+
+template <class T>
+void pdb::PDBBufferManagerBackEnd<T>::forEachBatch(std::vector<PDBPagePtr> &pages,
+                                                   const std::function<void(const PDBSetPtr &, std::vector<PDBPagePtr> &)> &process,
+                                                   size_t maxBatchSize) {
+
+  // two pages go into the same request if they are both anonymous or are of the same set
+  auto sameSet = [](const PDBSetPtr &lhs, const PDBSetPtr &rhs) {
+    if (lhs == nullptr || rhs == nullptr) {
+      return lhs == rhs;
+    }
+    return lhs->getDBName() == rhs->getDBName() && lhs->getSetName() == rhs->getSetName();
+  };
+
+  std::vector<PDBPagePtr> batch;
+  for (auto &page : pages) {
+
+    // if the page does not fit into the current batch send it
+    if (!batch.empty() && (batch.size() == maxBatchSize || !sameSet(batch.front()->whichSet, page->whichSet))) {
+      process(batch.front()->whichSet, batch);
+      batch.clear();
+    }
+
+    batch.emplace_back(page);
+  }
+
+  // send the last one
+  if (!batch.empty()) {
+    process(batch.front()->whichSet, batch);
+  }
+}
+
 template <class T>
 void pdb::PDBBufferManagerBackEnd<T>::registerHandlers(pdb::PDBServer &forMe) {}
 
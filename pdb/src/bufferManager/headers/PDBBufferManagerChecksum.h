@@ -0,0 +1,42 @@
+#ifndef PDB_PDBBUFFERMANAGERCHECKSUM_H
+#define PDB_PDBBUFFERMANAGERCHECKSUM_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace pdb {
+
+/**
+ * Computes the CRC32C checksums of the pages the buffer manager writes to disk, so it can tell if what it reads back
+ * is what it wrote. If the CPU has SSE4.2 we use its crc32 instruction, otherwise we fall back to a table based
+ * implementation. Both give the same checksums so a file written on one machine can be read on another.
+ */
+class PDBBufferManagerChecksum {
+
+ public:
+
+  /**
+   * Returns the CRC32C checksum of the bytes
+   * @param bytes - the bytes
+   * @param numBytes - the number of bytes
+   * @return - the checksum
+   */
+  static uint32_t crc32c(const void *bytes, size_t numBytes);
+
+  /**
+   * Returns the CRC32C checksum of the bytes computed without the crc32 instruction
+   * @param bytes - the bytes
+   * @param numBytes - the number of bytes
+   * @return - the checksum
+   */
+  static uint32_t crc32cSoftware(const void *bytes, size_t numBytes);
+
+  /**
+   * Returns true if the checksums are computed with the crc32 instruction of the CPU
+   */
+  static bool isHardwareAccelerated();
+};
+
+}
+
+#endif //PDB_PDBBUFFERMANAGERCHECKSUM_H
@@ -0,0 +1,86 @@
+#ifndef PDB_PDBBUFFERMANAGERCOMPRESSION_H
+#define PDB_PDBBUFFERMANAGERCOMPRESSION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace pdb {
+
+/**
+ * The codecs the pages can be compressed with when they are written to disk, the values are stored in the page
+ * directories and the catalog so they must not change
+ */
+enum PDBPageCompression : uint32_t {
+
+  PDB_PAGE_COMPRESSION_NONE = 0,    // the pages are written as they are
+  PDB_PAGE_COMPRESSION_SNAPPY = 1,  // always available
+  PDB_PAGE_COMPRESSION_LZ4 = 2,     // only if we were built with lz4, otherwise snappy is used
+  PDB_PAGE_COMPRESSION_ZSTD = 3     // only if we were built with zstd, otherwise snappy is used
+};
+
+/**
+ * Compresses and decompresses the pages with the codec of their set. The buffer manager does this outside of its lock
+ * right before it writes a page and right after it reads one, so the disk only sees the compressed bytes.
+ */
+class PDBBufferManagerCompression {
+
+ public:
+
+  /**
+   * Returns the codec with the name, "none", "snappy", "lz4" or "zstd"
+   * @param name - the name of the codec
+   * @param compression - the codec is stored here
+   * @return - false if there is no codec with the name
+   */
+  static bool fromString(const std::string &name, PDBPageCompression &compression);
+
+  /**
+   * Returns the name of the codec
+   */
+  static std::string toString(PDBPageCompression compression);
+
+  /**
+   * Returns true if we were built with the codec
+   */
+  static bool isSupported(PDBPageCompression compression);
+
+  /**
+   * Returns the codec we actually use for the requested one, if we were not built with it we use snappy and say so
+   * the first time the codec is asked for
+   */
+  static PDBPageCompression getSupported(PDBPageCompression compression);
+
+  /**
+   * Returns the largest number of bytes the codec can compress the bytes to
+   * @param compression - the codec
+   * @param numBytes - the number of uncompressed bytes
+   */
+  static size_t getMaxCompressedSize(PDBPageCompression compression, size_t numBytes);
+
+  /**
+   * Compresses the bytes
+   * @param compression - the codec, it must be supported
+   * @param in - the bytes we compress
+   * @param inSize - the number of bytes we compress
+   * @param out - where the compressed bytes go, it has room for at least getMaxCompressedSize bytes
+   * @param outSize - the size of out
+   * @return - the number of compressed bytes or 0 if we failed
+   */
+  static size_t compress(PDBPageCompression compression, const char *in, size_t inSize, char *out, size_t outSize);
+
+  /**
+   * Decompresses the bytes
+   * @param compression - the codec the bytes were compressed with
+   * @param in - the compressed bytes
+   * @param inSize - the number of compressed bytes
+   * @param out - where the uncompressed bytes go
+   * @param outSize - the size of out
+   * @return - true if it worked and the bytes fit into out
+   */
+  static bool decompress(PDBPageCompression compression, const char *in, size_t inSize, char *out, size_t outSize);
+};
+
+}
+
+#endif //PDB_PDBBUFFERMANAGERCOMPRESSION_H
@@ -8,6 +8,8 @@
 #include "SimpleRequestResult.h"
 #include "BufFreezeRequestResult.h"
 #include "BufPinPageResult.h"
+#include "BufPinPagesResult.h"
+#include "BufGetPagesResult.h"
 #include "PDBPageHandle.h"
 #include "PDBSharedMemory.h"
 #include "PDBBufferManagerBackEnd.h"
@@ -32,10 +34,11 @@ public:
                                         size_t bytesForRequest,
                                         const std::function<pdb::PDBPageHandle(pdb::Handle<pdb::BufGetPageResult>)> &processResponse,
                                         const pdb::PDBSetPtr set,
-                                        uint64_t pageNum) {
+                                        uint64_t pageNum,
+                                        int64_t numaNode) {
 
     // init the request
-    Handle<RequestType> request = makeObject<RequestType>(set, pageNum);
+    Handle<RequestType> request = makeObject<RequestType>(set, pageNum, numaNode);
 
     // log the get page
     instance->logGetPage(set, pageNum, request->currentID);
@@ -58,10 +61,12 @@ public:
                                         pdb::PDBPageHandle onErr,
                                         size_t bytesForRequest,
                                         const std::function<pdb::PDBPageHandle(pdb::Handle<pdb::BufGetPageResult>)> &processResponse,
-                                        size_t minSize) {
+                                        size_t minSize,
+                                        int64_t jobID,
+                                        int64_t numaNode) {
 
     // init the request
-    Handle<RequestType> request = makeObject<RequestType>(minSize);
+    Handle<RequestType> request = makeObject<RequestType>(minSize, jobID, numaNode);
 
     // log the get page, we don't care about the page number since it will be linked to the requested page
     instance->logGetPage(minSize, 0, request->currentID);
@@ -76,6 +81,67 @@ public:
                                                                               request);
   }
 
+  // the get pages request
+  template <class RequestType, class ResponseType, class ReturnType>
+  static bool heapRequest(pdb::PDBLoggerPtr &myLogger,
+                          int port,
+                          const std::string &address,
+                          bool onErr,
+                          size_t bytesForRequest,
+                          const std::function<bool(pdb::Handle<pdb::BufGetPagesResult>)> &processResponse,
+                          const pdb::PDBSetPtr &set,
+                          const std::vector<uint64_t> &pageNums,
+                          int64_t numaNode) {
+
+    // init the request
+    Handle<RequestType> request = makeObject<RequestType>(set, pageNums, numaNode);
+
+    // log a get page for each page
+    for(auto pageNum : pageNums) {
+      instance->logGetPage(set, pageNum, request->currentID);
+    }
+
+    // make a request
+    return RequestFactory::heapRequest<RequestType, ResponseType, ReturnType>(myLogger,
+                                                                              port,
+                                                                              address,
+                                                                              onErr,
+                                                                              bytesForRequest,
+                                                                              processResponse,
+                                                                              request);
+  }
+
+  // the get anonymous pages request
+  template <class RequestType, class ResponseType, class ReturnType>
+  static bool heapRequest(pdb::PDBLoggerPtr &myLogger,
+                          int port,
+                          const std::string &address,
+                          bool onErr,
+                          size_t bytesForRequest,
+                          const std::function<bool(pdb::Handle<pdb::BufGetPagesResult>)> &processResponse,
+                          size_t numPages,
+                          size_t minSize,
+                          int64_t jobID,
+                          int64_t numaNode) {
+
+    // init the request
+    Handle<RequestType> request = makeObject<RequestType>(numPages, minSize, jobID, numaNode);
+
+    // log a get page for each page, we don't care about the page numbers since they will be linked to the requested pages
+    for(size_t i = 0; i < numPages; ++i) {
+      instance->logGetPage(minSize, 0, request->currentID);
+    }
+
+    // make a request
+    return RequestFactory::heapRequest<RequestType, ResponseType, ReturnType>(myLogger,
+                                                                              port,
+                                                                              address,
+                                                                              onErr,
+                                                                              bytesForRequest,
+                                                                              processResponse,
+                                                                              request);
+  }
+
   // return anonymous page
   template <class RequestType, class ResponseType, class ReturnType>
   static bool heapRequest(pdb::PDBLoggerPtr &myLogger,
@@ -140,10 +206,11 @@ public:
                           const std::function<bool(pdb::Handle<pdb::SimpleRequestResult>)> &processResponse,
                           PDBSetPtr &set,
                           size_t pageNum,
-                          bool isDirty) {
+                          bool isDirty,
+                          PDBPageAccessHint accessHint) {
 
     // init the request
-    Handle<RequestType> request = makeObject<RequestType>(set, pageNum, isDirty);
+    Handle<RequestType> request = makeObject<RequestType>(set, pageNum, isDirty, accessHint);
 
     // log the unpin
     instance->logUnpin(set, pageNum, request->currentID);
@@ -213,6 +280,66 @@ public:
                                                                               request);
   }
 
+  // pin pages
+  template <class RequestType, class ResponseType, class ReturnType>
+  static bool heapRequest(pdb::PDBLoggerPtr &myLogger,
+                          int port,
+                          const std::string &address,
+                          bool onErr,
+                          size_t bytesForRequest,
+                          const std::function<bool(pdb::Handle<pdb::BufPinPagesResult>)> &processResponse,
+                          const pdb::PDBSetPtr &setPtr,
+                          const std::vector<uint64_t> &pageNums) {
+
+    // init the request
+    Handle<RequestType> request = makeObject<RequestType>(setPtr, pageNums);
+
+    // log a repin for each page
+    for(auto pageNum : pageNums) {
+      instance->logRepin(setPtr, pageNum, request->currentID);
+    }
+
+    // make a request
+    return RequestFactory::heapRequest<RequestType, ResponseType, ReturnType>(myLogger,
+                                                                              port,
+                                                                              address,
+                                                                              onErr,
+                                                                              bytesForRequest,
+                                                                              processResponse,
+                                                                              request);
+  }
+
+  // unpin pages
+  template <class RequestType, class ResponseType, class ReturnType>
+  static bool heapRequest(pdb::PDBLoggerPtr &myLogger,
+                          int port,
+                          const std::string &address,
+                          bool onErr,
+                          size_t bytesForRequest,
+                          const std::function<bool(pdb::Handle<pdb::SimpleRequestResult>)> &processResponse,
+                          const pdb::PDBSetPtr &setPtr,
+                          const std::vector<uint64_t> &pageNums,
+                          const std::vector<bool> &isDirty,
+                          const std::vector<PDBPageAccessHint> &accessHints) {
+
+    // init the request
+    Handle<RequestType> request = makeObject<RequestType>(setPtr, pageNums, isDirty, accessHints);
+
+    // log an unpin for each page
+    for(auto pageNum : pageNums) {
+      instance->logUnpin(setPtr, pageNum, request->currentID);
+    }
+
+    // make a request
+    return RequestFactory::heapRequest<RequestType, ResponseType, ReturnType>(myLogger,
+                                                                              port,
+                                                                              address,
+                                                                              onErr,
+                                                                              bytesForRequest,
+                                                                              processResponse,
+                                                                              request);
+  }
+
   static PDBBufferManagerInterface* instance;
 };
 
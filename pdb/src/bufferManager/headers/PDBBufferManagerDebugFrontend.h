@@ -89,6 +89,9 @@ protected:
 
  protected:
 
+  // the timeline we log contains the state of the whole buffer manager
+  bool logsBufferManagerState() override { return true; }
+
   void initDebug(const std::string &timelineDebugFile,
                  const std::string &debugSymbols,
                  const std::string &stackTraces);
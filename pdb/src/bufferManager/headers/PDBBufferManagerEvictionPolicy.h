@@ -0,0 +1,84 @@
+#ifndef PDB_PDBBUFFERMANAGEREVICTIONPOLICY_H
+#define PDB_PDBBUFFERMANAGEREVICTIONPOLICY_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace pdb {
+
+class PDBBufferManagerEvictionPolicy;
+typedef std::shared_ptr<PDBBufferManagerEvictionPolicy> PDBBufferManagerEvictionPolicyPtr;
+
+/**
+ * The eviction policy decides which full page of the buffer pool is recycled when the buffer manager runs out of
+ * memory. A full page is evictable when none of the mini pages located on it are pinned. The buffer manager tells the
+ * policy every time a full page becomes evictable, stops being evictable or is returned to the free pages and asks
+ * the policy for a victim when it needs space.
+ *
+ * All the methods are called with the buffer manager locked, so the policies do not need to do any locking.
+ */
+class PDBBufferManagerEvictionPolicy {
+
+ public:
+
+  virtual ~PDBBufferManagerEvictionPolicy() = default;
+
+  /**
+   * Called when the last pinned mini page on the full page is unpinned, the page can now be evicted
+   * @param page - the address of the full page
+   */
+  virtual void unpinned(void *page) = 0;
+
+  /**
+   * Called when a mini page on an evictable full page is pinned again, the page can not be evicted anymore
+   * @param page - the address of the full page
+   */
+  virtual void pinned(void *page) = 0;
+
+  /**
+   * Called when a page that was evicted is repinned into a mini page of the full page, this means that the data on the
+   * full page is being reused
+   * @param page - the address of the full page
+   */
+  virtual void reloaded(void *page) = 0;
+
+  /**
+   * Called when the full page is returned to the free pages of the buffer manager, the policy should forget about it
+   * @param page - the address of the full page
+   */
+  virtual void freed(void *page) = 0;
+
+  /**
+   * Selects an evictable page and removes it from the policy
+   * @return - the address of the full page, nullptr if there are no evictable pages
+   */
+  virtual void *evict() = 0;
+
+  /**
+   * Returns the pages that would be evicted next, in the order they would be evicted, without removing them from the
+   * policy. The background flusher uses this to write the pages that are about to be evicted before they are needed
+   * @param numPages - the maximum number of pages we want
+   * @return - the addresses of the full pages
+   */
+  virtual std::vector<void *> getNextVictims(size_t numPages) = 0;
+
+  /**
+   * Returns the number of pages that can be evicted right now, the buffer manager uses it to figure out the memory
+   * pressure
+   * @return - the number of pages
+   */
+  virtual size_t numEvictable() = 0;
+
+  /**
+   * Creates an eviction policy by its name
+   * @param name - "lru" for the least recently used policy or "2q" for the scan resistant 2Q policy
+   * @param numPages - the number of full pages in the buffer pool
+   * @return - the policy
+   */
+  static PDBBufferManagerEvictionPolicyPtr create(const std::string &name, size_t numPages);
+};
+
+}
+
+#endif //PDB_PDBBUFFERMANAGEREVICTIONPOLICY_H
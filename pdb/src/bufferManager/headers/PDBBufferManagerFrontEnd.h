@@ -11,13 +11,21 @@
 #include <queue>
 #include <set>
 #include <PDBBufferManagerImpl.h>
+#include <PDBBufferManagerRing.h>
+#include <PDBBufferManagerLeases.h>
+#include <PDBBuzzer.h>
 #include <BufGetPageRequest.h>
 #include <BufGetAnonymousPageRequest.h>
+#include <BufGetPagesRequest.h>
+#include <BufGetAnonymousPagesRequest.h>
 #include <BufReturnPageRequest.h>
 #include <BufReturnAnonPageRequest.h>
 #include <BufFreezeSizeRequest.h>
 #include <BufPinPageRequest.h>
+#include <BufPinPagesRequest.h>
+#include <BufUnpinPagesRequest.h>
 #include <BufUnpinPageRequest.h>
+#include <BufGetStatsRequest.h>
 
 // this is needed so we can declare friend tests here
 #include <gtest/gtest_prod.h>
@@ -74,7 +82,7 @@ public:
 
   PDBBufferManagerFrontEnd(std::string tempFileIn, size_t pageSizeIn, size_t numPagesIn, std::string metaFile, std::string storageLocIn);
 
-  ~PDBBufferManagerFrontEnd() override = default;
+  ~PDBBufferManagerFrontEnd() override;
 
   // forwards the page to the backend
   bool forwardPage(pdb::PDBPageHandle &page,  PDBCommunicatorPtr &communicator, std::string &error);
@@ -85,9 +93,15 @@ public:
   // register the handlers
   void registerHandlers(PDBServer &forMe) override;
 
+  // stops serving the ring
+  void cleanup() override;
+
   // returns the backend
   virtual PDBBufferManagerInterfacePtr getBackEnd();
 
+  // returns the counters of the buffer manager together with the leases and the pages of the backend
+  PDBBufferManagerStats getStats() override;
+
 protected:
 
   // init the forwarding
@@ -96,6 +110,25 @@ protected:
   // finish the forwarding
   void finishForwarding(pdb::PDBPageHandle &page);
 
+  // handles the requests the backend sends through the ring until the ring is closed
+  void serveRing();
+
+  // grants the backend a lease on the frame of the page we are sending it, returns -1 if there is no lease left
+  int64_t grantLease(const pdb::PDBPageHandle &page);
+
+  // ends the lease the backend has on the page if it has one, if the backend unpinned the page through the lease we
+  // unpin it here unless we are told to keep it pinned
+  void endLease(const std::pair<PDBSetPtr, size_t> &key, bool keepPinned = false);
+
+  // takes back the frames of the pages the backend unpinned through their leases
+  bool revokeLeases(unique_lock<mutex> &lock) override;
+
+  // counts the full pages that are only pinned because of the leases of pages the backend unpinned
+  size_t getNumLeasedReusablePages() override;
+
+  // tells the subscribers about the memory pressure and publishes it to the backend through the ring
+  void signalMemoryPressure() override;
+
   // handles the get page request from the backend
   template <class T>
   std::pair<bool, std::string> handleGetPageRequest(pdb::Handle<pdb::BufGetPageRequest> &request, std::shared_ptr<T> &sendUsingMe);
@@ -104,6 +137,14 @@ protected:
   template <class T>
   std::pair<bool, std::string> handleGetAnonymousPageRequest(pdb::Handle<pdb::BufGetAnonymousPageRequest> &request, std::shared_ptr<T> &sendUsingMe);
 
+  // handles the request from the backend to get a batch of pages of a set
+  template <class T>
+  std::pair<bool, std::string> handleGetPagesRequest(pdb::Handle<pdb::BufGetPagesRequest> &request, std::shared_ptr<T> &sendUsingMe);
+
+  // handles the request from the backend to get a batch of anonymous pages
+  template <class T>
+  std::pair<bool, std::string> handleGetAnonymousPagesRequest(pdb::Handle<pdb::BufGetAnonymousPagesRequest> &request, std::shared_ptr<T> &sendUsingMe);
+
   // handles the return page request from the backend
   template <class T>
   std::pair<bool, std::string> handleReturnPageRequest(pdb::Handle<pdb::BufReturnPageRequest> &request, std::shared_ptr<T> &sendUsingMe);
@@ -124,6 +165,18 @@ protected:
   template <class T>
   std::pair<bool, std::string> handleUnpinPageRequest(pdb::Handle<pdb::BufUnpinPageRequest> &request, std::shared_ptr<T> &sendUsingMe);
 
+  // handles the request from the backend to pin a batch of pages
+  template <class T>
+  std::pair<bool, std::string> handlePinPagesRequest(pdb::Handle<pdb::BufPinPagesRequest> &request, std::shared_ptr<T> &sendUsingMe);
+
+  // handles the request from the backend to unpin a batch of pages
+  template <class T>
+  std::pair<bool, std::string> handleUnpinPagesRequest(pdb::Handle<pdb::BufUnpinPagesRequest> &request, std::shared_ptr<T> &sendUsingMe);
+
+  // handles the request for the counters of the buffer manager
+  template <class T>
+  std::pair<bool, std::string> handleGetStatsRequest(pdb::Handle<pdb::BufGetStatsRequest> &request, std::shared_ptr<T> &sendUsingMe);
+
   // handles the logic for the forwarding
   template <class T>
   bool handleForwardPage(pdb::PDBPageHandle &page, std::shared_ptr<T> &communicator, std::string &error);
@@ -137,11 +190,16 @@ protected:
   FRIEND_TEST(BufferManagerFrontendTest, Test6);
   FRIEND_TEST(BufferManagerFrontendTest, Test7);
   FRIEND_TEST(BufferManagerFrontendTest, Test8);
+  FRIEND_TEST(BufferManagerFrontendTest, Test9);
 
   // sends a page to the backend via the communicator
   template <class T>
   bool sendPageToBackend(PDBPageHandle page, std::shared_ptr<T> &sendUsingMe, std::string &error);
 
+  // sends a batch of pages to the backend with a single response
+  template <class T>
+  bool sendPagesToBackend(std::vector<PDBPageHandle> &pages, std::shared_ptr<T> &sendUsingMe, std::string &error);
+
   // Logger to debug information
   PDBLoggerPtr logger;
 
@@ -164,6 +222,48 @@ protected:
    * Used to sync page forwarding
    */
   std::condition_variable cv;
+
+  /**
+   * The ring the backend sends the requests through, it is made before we fork the backend so both processes share it
+   */
+  PDBBufferManagerRingPtr ring = std::make_shared<PDBBufferManagerRing>();
+
+  /**
+   * The leases the backend has on the frames of the pages we sent it, they are shared with the backend like the ring
+   */
+  PDBBufferManagerLeasesPtr leases = std::make_shared<PDBBufferManagerLeases>();
+
+  /**
+   * The lease and the page for every page the backend holds a lease on
+   */
+  map <std::pair<PDBSetPtr, size_t>, std::pair<int64_t, PDBPagePtr>, PDBPageCompare> leasedPages;
+
+  /**
+   * Protects the leased pages, if we also need the lock of the buffer manager it has to be locked first
+   */
+  std::mutex leaseMutex;
+
+  /**
+   * The number of leases we granted to the backend and the number of them we took back after the backend unpinned
+   * the page through the lease
+   */
+  std::atomic<uint64_t> numLeasesGranted{0};
+  std::atomic<uint64_t> numLeasesRevoked{0};
+
+  /**
+   * The number of workers that handle the requests from the ring, they are only started in the process of the frontend
+   */
+  int numRingWorkers = 0;
+
+  /**
+   * The number of workers that stopped handling the requests from the ring
+   */
+  std::atomic_int numRingWorkersDone{0};
+
+  /**
+   * Buzzed by a worker when it stops handling the requests from the ring
+   */
+  PDBBuzzerPtr ringBuzzer;
 };
 
 }
@@ -7,16 +7,23 @@
 
 #include <SimpleRequestResult.h>
 #include <BufPinPageResult.h>
+#include <BufPinPagesResult.h>
 #include <BufGetPageResult.h>
+#include <BufGetPagesResult.h>
 #include <BufFreezeRequestResult.h>
+#include <BufGetStatsResult.h>
 #include <BufForwardPageRequest.h>
 #include "assert.h"
 
 template <class T>
 std::pair<bool, std::string> pdb::PDBBufferManagerFrontEnd::handleGetPageRequest(pdb::Handle<pdb::BufGetPageRequest> &request, std::shared_ptr<T> &sendUsingMe) {
 
-  // grab the page
-  auto page = this->getPage(make_shared<pdb::PDBSet>(request->dbName, request->setName), request->pageNumber);
+  // the backend does not have the page so it can not have a lease on it either
+  auto set = make_shared<pdb::PDBSet>(request->dbName, request->setName);
+  endLease(std::make_pair(set, request->pageNumber));
+
+  // grab the page, its memory comes from the NUMA node of the backend thread that asked for it
+  auto page = this->getPage(set, request->pageNumber, request->numaNode);
 
   // send the page to the backend
   string error;
@@ -28,8 +35,9 @@ std::pair<bool, std::string> pdb::PDBBufferManagerFrontEnd::handleGetPageRequest
 template <class T>
 std::pair<bool, std::string> pdb::PDBBufferManagerFrontEnd::handleGetAnonymousPageRequest(pdb::Handle<pdb::BufGetAnonymousPageRequest> &request, std::shared_ptr<T> &sendUsingMe) {
 
-  // grab an anonymous page
-  auto page = getPage(request->size);
+  // grab an anonymous page, charged to the job of the backend if it has one and placed on the NUMA node of the backend
+  // thread that asked for it
+  auto page = getAnonymousPage(request->size, request->jobID, request->numaNode);
 
   // send the page to the backend
   std::string error;
@@ -38,12 +46,51 @@ std::pair<bool, std::string> pdb::PDBBufferManagerFrontEnd::handleGetAnonymousPa
   return make_pair(res, error);
 }
 
+template <class T>
+std::pair<bool, std::string> pdb::PDBBufferManagerFrontEnd::handleGetPagesRequest(pdb::Handle<pdb::BufGetPagesRequest> &request, std::shared_ptr<T> &sendUsingMe) {
+
+  // copy the page numbers, the backend does not have the pages so it can not have a lease on them either
+  auto set = make_shared<pdb::PDBSet>(*request->databaseName, *request->setName);
+  std::vector<uint64_t> pageNumbers;
+  pageNumbers.reserve(request->pageNumbers.size());
+  for(int i = 0; i < request->pageNumbers.size(); ++i) {
+    pageNumbers.emplace_back(request->pageNumbers[i]);
+    endLease(std::make_pair(set, request->pageNumbers[i]));
+  }
+
+  // grab the pages at once, their memory comes from the NUMA node of the backend thread that asked for them
+  auto pages = this->getPages(set, pageNumbers, request->numaNode);
+
+  // send the pages to the backend
+  string error;
+  bool res = this->sendPagesToBackend(pages, sendUsingMe, error);
+
+  return make_pair(res, error);
+}
+
+template <class T>
+std::pair<bool, std::string> pdb::PDBBufferManagerFrontEnd::handleGetAnonymousPagesRequest(pdb::Handle<pdb::BufGetAnonymousPagesRequest> &request, std::shared_ptr<T> &sendUsingMe) {
+
+  // grab the anonymous pages at once, charged to the job of the backend if it has one and placed on the NUMA node of
+  // the backend thread that asked for them
+  auto pages = getAnonymousPages(request->numPages, request->size, request->jobID, request->numaNode);
+
+  // send the pages to the backend
+  std::string error;
+  bool res = sendPagesToBackend(pages, sendUsingMe, error);
+
+  return make_pair(res, error);
+}
+
 template <class T>
 std::pair<bool, std::string> pdb::PDBBufferManagerFrontEnd::handleReturnPageRequest(pdb::Handle<pdb::BufReturnPageRequest> &request, std::shared_ptr<T> &sendUsingMe) {
 
   // create the page key
   auto key = std::make_pair(std::make_shared<PDBSet>(request->databaseName, request->setName), request->pageNumber);
 
+  // the backend is done with the page so it does not need the lease anymore
+  endLease(key);
+
   // do the bookkeeping of the sent pages
   bool res = false;
   {
@@ -91,6 +138,9 @@ std::pair<bool, std::string> pdb::PDBBufferManagerFrontEnd::handleReturnAnonPage
   // create the page key
   auto key = std::make_pair((PDBSetPtr) nullptr, request->pageNumber);
 
+  // the backend is done with the page so it does not need the lease anymore
+  endLease(key);
+
   // remove the anonymous page
   bool res;
   {
@@ -211,17 +261,24 @@ std::pair<bool, std::string> pdb::PDBBufferManagerFrontEnd::handlePinPageRequest
   }
 
   // if we did find it, if so pin it
+  int64_t lease = -1;
   if(res) {
 
+    // the backend asks us for the page so whatever lease it had on it is gone
+    endLease(std::make_pair(set, request->pageNumber));
+
     // pin it
     handle->repin();
+
+    // give the backend a lease on it
+    lease = grantLease(handle);
   }
 
   // create an allocation block to hold the response
   const UseTemporaryAllocationBlock tempBlock{1024};
 
   // create the response
-  Handle<BufPinPageResult> response = makeObject<BufPinPageResult>((uint64_t) handle->page->bytes - (uint64_t) sharedMemory.memory, res);
+  Handle<BufPinPageResult> response = makeObject<BufPinPageResult>((uint64_t) handle->page->bytes - (uint64_t) sharedMemory.memory, res, lease);
 
   // sends result to requester
   std::string errMsg;
@@ -264,10 +321,14 @@ std::pair<bool, std::string> pdb::PDBBufferManagerFrontEnd::handleUnpinPageReque
   // if we did find it, if so unpin it
   if(res) {
 
-    // update the dirty bit
+    // the backend unpins it through us so it does not use the lease anymore
+    endLease(std::make_pair(set, request->pageNumber));
+
+    // update the dirty bit and the hint
     if(request->isDirty) {
       handle->setDirty();
     }
+    handle->setAccessHint(request->accessHint);
 
     // unpin it
     handle->unpin();
@@ -287,6 +348,160 @@ std::pair<bool, std::string> pdb::PDBBufferManagerFrontEnd::handleUnpinPageReque
   return make_pair(res, errMsg);
 }
 
+template <class T>
+std::pair<bool, std::string> pdb::PDBBufferManagerFrontEnd::handlePinPagesRequest(pdb::Handle<pdb::BufPinPagesRequest> &request, std::shared_ptr<T> &sendUsingMe) {
+
+  // if these are anonymous pages the set is a null ptr
+  PDBSetPtr set = nullptr;
+
+  // if these are not anonymous pages create a set
+  if(!request->isAnonymous) {
+    set = make_shared<PDBSet>(*request->databaseName, *request->setName);
+  }
+
+  bool res = true;
+  std::vector<PDBPageHandle> handles;
+  {
+    // lock the thing
+    unique_lock<mutex> lck(m);
+
+    // find all the pages
+    for(int i = 0; i < request->pageNumbers.size(); ++i) {
+
+      // find if the thing exists
+      auto it = sentPages.find(std::make_pair(set, request->pageNumbers[i]));
+      if(it == sentPages.end()) {
+        res = false;
+        break;
+      }
+
+      // grab a handle
+      handles.emplace_back(it->second);
+    }
+  }
+
+  // if we found all of them pin them at once
+  std::vector<uint64_t> offsets;
+  std::vector<int64_t> pageLeases;
+  if(res) {
+
+    // the backend asks us for the pages so whatever leases it had on them are gone
+    for(auto &handle : handles) {
+      endLease(std::make_pair(set, handle->whichPage()));
+    }
+
+    // pin them
+    repinAll(handles);
+
+    // figure out the offsets and give the backend leases on the pages
+    offsets.reserve(handles.size());
+    pageLeases.reserve(handles.size());
+    for(auto &handle : handles) {
+      offsets.emplace_back((uint64_t) handle->page->bytes - (uint64_t) sharedMemory.memory);
+      pageLeases.emplace_back(grantLease(handle));
+    }
+  }
+
+  // create an allocation block to hold the response
+  const UseTemporaryAllocationBlock tempBlock{1024};
+
+  // create the response
+  Handle<BufPinPagesResult> response = makeObject<BufPinPagesResult>(offsets, pageLeases, res);
+
+  // sends result to requester
+  std::string errMsg;
+  res = sendUsingMe->sendObject(response, errMsg) && res;
+
+  // return
+  return make_pair(res, errMsg);
+}
+
+template <class T>
+std::pair<bool, std::string> pdb::PDBBufferManagerFrontEnd::handleUnpinPagesRequest(pdb::Handle<pdb::BufUnpinPagesRequest> &request, std::shared_ptr<T> &sendUsingMe) {
+
+  // if these are anonymous pages the set is a null ptr
+  PDBSetPtr set = nullptr;
+
+  // if these are not anonymous pages create a set
+  if(!request->isAnonymous) {
+    set = make_shared<PDBSet>(*request->databaseName, *request->setName);
+  }
+
+  bool res = true;
+  std::vector<PDBPageHandle> handles;
+  {
+    // lock the thing
+    unique_lock<mutex> lck(m);
+
+    // find all the pages
+    for(int i = 0; i < request->pageNumbers.size(); ++i) {
+
+      // find if the thing exists
+      auto it = sentPages.find(std::make_pair(set, request->pageNumbers[i]));
+      if(it == sentPages.end()) {
+        res = false;
+        break;
+      }
+
+      // grab a handle
+      handles.emplace_back(it->second);
+    }
+  }
+
+  // if we found all of them unpin them at once
+  if(res) {
+
+    // the backend unpins them through us so it does not use the leases anymore
+    for(auto &handle : handles) {
+      endLease(std::make_pair(set, handle->whichPage()));
+    }
+
+    // update the dirty bits and the hints
+    for(int i = 0; i < handles.size(); ++i) {
+      if(request->isDirty[i]) {
+        handles[i]->setDirty();
+      }
+      handles[i]->setAccessHint((PDBPageAccessHint) request->accessHints[i]);
+    }
+
+    // unpin them
+    unpinAll(handles);
+  }
+
+  // create an allocation block to hold the response
+  const UseTemporaryAllocationBlock tempBlock{1024};
+
+  // create the response
+  Handle<SimpleRequestResult> response = makeObject<SimpleRequestResult>(res, res ? std::string("") : std::string("Could not find the pages to unpin!"));
+
+  // sends result to requester
+  std::string errMsg;
+  res = sendUsingMe->sendObject(response, errMsg) && res;
+
+  // return
+  return make_pair(res, errMsg);
+}
+
+template <class T>
+std::pair<bool, std::string> pdb::PDBBufferManagerFrontEnd::handleGetStatsRequest(pdb::Handle<pdb::BufGetStatsRequest> &request, std::shared_ptr<T> &sendUsingMe) {
+
+  // grab the counters
+  auto stats = getStats();
+
+  // create an allocation block to hold the response, the size classes need a few vectors so we give it a bit more
+  const UseTemporaryAllocationBlock tempBlock{16 * 1024};
+
+  // create the response
+  Handle<BufGetStatsResult> response = makeObject<BufGetStatsResult>(stats);
+
+  // sends result to requester
+  std::string errMsg;
+  bool res = sendUsingMe->sendObject(response, errMsg);
+
+  // return
+  return make_pair(res, errMsg);
+}
+
 template<class T>
 bool pdb::PDBBufferManagerFrontEnd::handleForwardPage(pdb::PDBPageHandle &page, shared_ptr<T> &communicator, std::string &error) {
 
@@ -296,6 +511,9 @@ bool pdb::PDBBufferManagerFrontEnd::handleForwardPage(pdb::PDBPageHandle &page,
   // init the forwarding process
   initForwarding(page);
 
+  // the backend gets the page pinned without a lease, so if it had one it is over, we keep the page pinned
+  endLease(std::make_pair(page->getSet(), page->whichPage()), true);
+
   /// 1. Sent the request
 
   auto offset = (uint64_t) page->page->bytes - (uint64_t) sharedMemory.memory;
@@ -403,8 +621,11 @@ bool pdb::PDBBufferManagerFrontEnd::sendPageToBackend(pdb::PDBPageHandle page, s
   std::string setName = isAnonymous ? "" : page->getSet()->getSetName();
   std::string dbName = isAnonymous ? "" : page->getSet()->getDBName();
 
+  // give the backend a lease on the frame so it can unpin and repin the page without asking us
+  auto lease = grantLease(page);
+
   // create the object
-  Handle<pdb::BufGetPageResult> objectToSend = pdb::makeObject<BufGetPageResult>(offset, pageNumber, isAnonymous, sizeFrozen, startPos, numBytes, setName, dbName);
+  Handle<pdb::BufGetPageResult> objectToSend = pdb::makeObject<BufGetPageResult>(offset, pageNumber, isAnonymous, sizeFrozen, startPos, numBytes, setName, dbName, lease);
 
   {
     // lock so we can mark the page as sent
@@ -425,11 +646,67 @@ bool pdb::PDBBufferManagerFrontEnd::sendPageToBackend(pdb::PDBPageHandle page, s
 
     // erase the stuff that failed
     sentPages.erase(std::make_pair(page->getSet(), pageNumber));
+    lck.unlock();
+
+    // the backend never got the lease
+    endLease(std::make_pair(page->getSet(), pageNumber));
   }
 
   // return the result
   return res;
 }
 
+template <class T>
+bool pdb::PDBBufferManagerFrontEnd::sendPagesToBackend(std::vector<pdb::PDBPageHandle> &pages, std::shared_ptr<T> &sendUsingMe, std::string &error) {
+
+  // make an allocation block
+  const UseTemporaryAllocationBlock tempBlock{1024};
+
+  // create the object, give the backend a lease on the frame of each page so it can unpin and repin them without asking us
+  Handle<pdb::BufGetPagesResult> objectToSend = pdb::makeObject<BufGetPagesResult>(pages.size());
+  for(auto &page : pages) {
+    objectToSend->addPage((uint64_t) page->page->bytes - (uint64_t) sharedMemory.memory,
+                          page->whichPage(),
+                          page->page->location.startPos,
+                          page->page->location.numBytes,
+                          grantLease(page));
+  }
+  objectToSend->success = true;
+
+  {
+    // lock so we can mark the pages as sent
+    unique_lock<mutex> lck(m);
+
+    // mark that we have sent the pages, store the handles so that we keep the reference counts
+    for(auto &page : pages) {
+      sentPages[std::make_pair(page->getSet(), page->whichPage())] = page;
+    }
+  }
+
+  // send the thing
+  bool res = sendUsingMe->sendObject(objectToSend, error);
+
+  // did we fail?
+  if(!res) {
+
+    {
+      // if we failed do a cleanup
+      unique_lock<mutex> lck(m);
+
+      // erase the stuff that failed
+      for(auto &page : pages) {
+        sentPages.erase(std::make_pair(page->getSet(), page->whichPage()));
+      }
+    }
+
+    // the backend never got the leases
+    for(auto &page : pages) {
+      endLease(std::make_pair(page->getSet(), page->whichPage()));
+    }
+  }
+
+  // return the result
+  return res;
+}
 
 #endif //PDB_PDBSTORAGEMANAGERFRONTENDTEMPLATE_H
@@ -0,0 +1,92 @@
+#ifndef PDB_PDBBUFFERMANAGERHINTEDPOLICY_H
+#define PDB_PDBBUFFERMANAGERHINTEDPOLICY_H
+
+#include <list>
+#include <unordered_map>
+#include "PDBBufferManagerEvictionPolicy.h"
+#include "PDBPageAccessHint.h"
+
+namespace pdb {
+
+class PDBBufferManagerHintedPolicy;
+typedef std::shared_ptr<PDBBufferManagerHintedPolicy> PDBBufferManagerHintedPolicyPtr;
+
+/**
+ * Wraps the eviction policy of the buffer manager so that it honors the access hints of the pages. A full page gets
+ * the hint of the mini page on it we want to keep the longest. The pages without a hint are left to the wrapped policy,
+ * the rest are kept in a queue per hint. We evict the pages that were scanned once first, then the spilled pages, then
+ * whatever the wrapped policy picks and only if there is nothing else the hot pages, each queue from its oldest page.
+ *
+ * The wrapped policy is still told about every page that is pinned, reloaded or freed, so that policies like 2Q that
+ * remember the reused pages still see everything.
+ */
+class PDBBufferManagerHintedPolicy : public PDBBufferManagerEvictionPolicy {
+
+ public:
+
+  /**
+   * Wraps the policy
+   * @param policy - the policy that decides about the pages without a hint
+   */
+  explicit PDBBufferManagerHintedPolicy(PDBBufferManagerEvictionPolicyPtr policy);
+
+  void unpinned(void *page) override;
+
+  /**
+   * Called when the last pinned mini page on the full page is unpinned, the page can now be evicted
+   * @param page - the address of the full page
+   * @param hint - the hint of the full page
+   */
+  void unpinned(void *page, PDBPageAccessHint hint);
+
+  void pinned(void *page) override;
+
+  void reloaded(void *page) override;
+
+  void freed(void *page) override;
+
+  void *evict() override;
+
+  std::vector<void *> getNextVictims(size_t numPages) override;
+
+  size_t numEvictable() override;
+
+  /**
+   * Returns the policy we wrap
+   */
+  const PDBBufferManagerEvictionPolicyPtr &getPolicy();
+
+ private:
+
+  /**
+   * Removes the page from the queue of its hint if it is in one
+   * @param page - the address of the full page
+   */
+  void remove(void *page);
+
+  /**
+   * Returns the queue of the hint
+   */
+  std::list<void *> &getQueue(PDBPageAccessHint hint);
+
+  /**
+   * the policy that decides about the pages without a hint
+   */
+  PDBBufferManagerEvictionPolicyPtr policy;
+
+  /**
+   * the pages that were scanned once, the pages that were spilled and the hot pages, oldest first
+   */
+  std::list<void *> sequential;
+  std::list<void *> spilled;
+  std::list<void *> hot;
+
+  /**
+   * the hint of each page that is in one of the queues and its position in the queue
+   */
+  std::unordered_map<void *, std::pair<PDBPageAccessHint, std::list<void *>::iterator>> positions;
+};
+
+}
+
+#endif //PDB_PDBBUFFERMANAGERHINTEDPOLICY_H
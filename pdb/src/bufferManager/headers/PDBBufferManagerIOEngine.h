@@ -0,0 +1,157 @@
+#ifndef PDB_PDBBUFFERMANAGERIOENGINE_H
+#define PDB_PDBBUFFERMANAGERIOENGINE_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <sys/types.h>
+#include "PDBBufferManagerCompression.h"
+
+namespace pdb {
+
+class PDBBufferManagerIOEngine;
+typedef std::shared_ptr<PDBBufferManagerIOEngine> PDBBufferManagerIOEnginePtr;
+
+/**
+ * A read or a write of a page the buffer manager wants to do
+ */
+struct PDBBufferManagerIORequest {
+
+  PDBBufferManagerIORequest(int fd, void *bytes, size_t numBytes, size_t offset, bool isWrite);
+
+  /**
+   * the file we are reading from or writing to
+   */
+  int fd;
+
+  /**
+   * the memory we are reading into or writing from
+   */
+  void *bytes;
+
+  /**
+   * the number of bytes
+   */
+  size_t numBytes;
+
+  /**
+   * the offset in the file
+   */
+  size_t offset;
+
+  /**
+   * true if this is a write, false if it is a read
+   */
+  bool isWrite;
+
+  /**
+   * the storage directory, and so the drive, the file is on
+   */
+  size_t device = 0;
+
+  /**
+   * the codec of a compressed page, the buffer manager compresses the page into the buffer before the write and
+   * decompresses the buffer into the page after the read, so the engine only sees the compressed bytes
+   */
+  PDBPageCompression compression = PDB_PAGE_COMPRESSION_NONE;
+
+  /**
+   * the memory of a compressed page and its size
+   */
+  void *page = nullptr;
+  size_t pageSize = 0;
+
+  /**
+   * the compressed bytes of the page
+   */
+  std::vector<char> buffer;
+
+  /**
+   * the CRC32C checksum of the bytes, the buffer manager computes it before a write and checks it after a read
+   */
+  uint32_t checksum = 0;
+
+  /**
+   * once the request is done it has the number of bytes that were transferred or -1 if it failed, a read that hits the
+   * end of the file transfers fewer bytes than requested
+   */
+  ssize_t result = 0;
+
+  /**
+   * the errno if the request failed
+   */
+  int error = 0;
+
+  /**
+   * Returns true if the request transferred all of its bytes
+   */
+  bool isComplete() const;
+
+  /**
+   * Describes why the request did not transfer all of its bytes
+   */
+  std::string getError() const;
+};
+
+/**
+ * The I/O engine does all the disk reads and writes of the buffer manager. The buffer manager hands it a batch of
+ * requests, for example all the dirty mini pages of a full page it is evicting, and the engine returns once all of
+ * them are done. The engines that do the requests in parallel let the disk work on the whole batch at once instead of
+ * one page at a time. The engines must be thread safe since the buffer manager calls them without holding its lock.
+ */
+class PDBBufferManagerIOEngine {
+
+ public:
+
+  virtual ~PDBBufferManagerIOEngine() = default;
+
+  /**
+   * Does all the requests and returns once all of them are done
+   * @param requests - the requests, their result and error are set by this method
+   */
+  virtual void execute(std::vector<PDBBufferManagerIORequest> &requests) = 0;
+
+  /**
+   * Reads the bytes from the file
+   * @return - the number of bytes read or -1 if the read failed, in that case errno is set
+   */
+  ssize_t read(int fd, void *bytes, size_t numBytes, size_t offset);
+
+  /**
+   * Writes the bytes to the file
+   * @return - the number of bytes written or -1 if the write failed, in that case errno is set
+   */
+  ssize_t write(int fd, void *bytes, size_t numBytes, size_t offset);
+
+  /**
+   * Creates an I/O engine by its name, if io_uring is not supported by the kernel we fall back to the thread pool
+   * @param name - "sync" does the requests one by one in the calling thread, "threads" uses a thread pool and
+   * "io_uring" submits them to the kernel through io_uring
+   * @param numThreads - the number of threads of the thread pool
+   * @param numDevices - the number of drives the files are striped over, if there is more than one each of them gets
+   * its own engine
+   * @return - the engine
+   */
+  static PDBBufferManagerIOEnginePtr create(const std::string &name, size_t numThreads, size_t numDevices = 1);
+
+ protected:
+
+  /**
+   * Does the request with pread or pwrite in the calling thread and sets its result and error. Both of them can
+   * transfer fewer bytes than asked for, so we keep going until all the bytes are transferred, the request fails or
+   * a read hits the end of the file.
+   * @param request - the request
+   */
+  static void transfer(PDBBufferManagerIORequest &request);
+
+ private:
+
+  /**
+   * executes a single request and sets the errno if it failed
+   */
+  ssize_t executeOne(PDBBufferManagerIORequest request);
+};
+
+}
+
+#endif //PDB_PDBBUFFERMANAGERIOENGINE_H
@@ -0,0 +1,162 @@
+#ifndef PDB_PDBBUFFERMANAGERIOURINGENGINE_H
+#define PDB_PDBBUFFERMANAGERIOURINGENGINE_H
+
+#include <condition_variable>
+#include <mutex>
+#include <sys/uio.h>
+#include "PDBBufferManagerIOEngine.h"
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+namespace pdb {
+
+/**
+ * Submits the requests to the kernel through io_uring, the whole batch is submitted with a single system call and the
+ * kernel does the requests in parallel. We talk to the rings directly so that we don't depend on liburing.
+ *
+ * Multiple threads can execute batches at the same time, they submit under a lock and one of them at a time waits
+ * for the completions in the kernel and hands them out to the batches they belong to. A request that completes with
+ * fewer bytes than it asked for is submitted again for the rest of its bytes.
+ */
+class PDBBufferManagerIOUringEngine : public PDBBufferManagerIOEngine {
+
+ public:
+
+  /**
+   * Sets up the io_uring
+   * @param numEntries - the size of the submission queue
+   */
+  explicit PDBBufferManagerIOUringEngine(unsigned numEntries);
+
+  /**
+   * Tears down the io_uring
+   */
+  ~PDBBufferManagerIOUringEngine() override;
+
+  /**
+   * Returns true if the io_uring was successfully set up, the kernel might not support it
+   * @return - true if we can use it
+   */
+  bool isValid();
+
+  void execute(std::vector<PDBBufferManagerIORequest> &requests) override;
+
+ private:
+
+  /**
+   * A request that was submitted, the number of requests of its batch that are not done yet, the memory the kernel
+   * is reading into or writing from and the number of bytes that were already transferred
+   */
+  struct PDBSubmittedRequest {
+    PDBBufferManagerIORequest *request;
+    size_t *numPending;
+    struct iovec iov;
+    size_t done;
+  };
+
+  /**
+   * Puts the rest of the request in the submission queue, must be called with the lock held and a free entry
+   * @param s - the request
+   */
+  void queue(PDBSubmittedRequest &s);
+
+  /**
+   * Waits till there is a free submission entry and the completion queue can not overflow
+   * @param lck - the lock
+   */
+  void waitForEntry(std::unique_lock<std::mutex> &lck);
+
+  /**
+   * Submits the rest of the requests that were cut short
+   * @param lck - the lock
+   */
+  void resubmitPartial(std::unique_lock<std::mutex> &lck);
+
+  /**
+   * Submits everything that is in the submission queue, must be called with the lock held
+   */
+  void submit();
+
+  /**
+   * Waits for at least one completion, the lock is released while waiting
+   * @param lck - the lock
+   */
+  void waitForCompletions(std::unique_lock<std::mutex> &lck);
+
+  /**
+   * Hands out all the completions that are in the completion queue, must be called with the lock held
+   */
+  void reapCompletions();
+
+  /**
+   * the file descriptor of the io_uring, -1 if the setup failed
+   */
+  int ringFD = -1;
+
+  /**
+   * the mapped submission and completion rings and the submission queue entries
+   */
+  void *sqRing = nullptr;
+  void *cqRing = nullptr;
+  io_uring_sqe *sqes = nullptr;
+
+  /**
+   * the sizes of the mappings
+   */
+  size_t sqRingSize = 0;
+  size_t cqRingSize = 0;
+  size_t sqesSize = 0;
+
+  /**
+   * the fields of the submission ring
+   */
+  unsigned *sqHead = nullptr;
+  unsigned *sqTail = nullptr;
+  unsigned *sqMask = nullptr;
+  unsigned *sqArray = nullptr;
+  unsigned sqEntries = 0;
+
+  /**
+   * the fields of the completion ring
+   */
+  unsigned *cqHead = nullptr;
+  unsigned *cqTail = nullptr;
+  unsigned *cqMask = nullptr;
+  io_uring_cqe *cqes = nullptr;
+  unsigned cqEntries = 0;
+
+  /**
+   * the number of entries we put in the submission queue that are not submitted yet
+   */
+  unsigned numToSubmit = 0;
+
+  /**
+   * the number of requests that are submitted and not completed, we never go above the size of the completion queue
+   */
+  unsigned numInFlight = 0;
+
+  /**
+   * the requests that completed with fewer bytes than they asked for and need to be submitted again
+   */
+  std::vector<PDBSubmittedRequest *> partial;
+
+  /**
+   * true if a thread is waiting in the kernel for completions
+   */
+  bool isWaiting = false;
+
+  /**
+   * locks the rings
+   */
+  std::mutex m;
+
+  /**
+   * the threads wait here for their batch to finish or for a free entry
+   */
+  std::condition_variable cv;
+};
+
+}
+
+#endif //PDB_PDBBUFFERMANAGERIOURINGENGINE_H
@@ -3,7 +3,13 @@
 #ifndef STORAGE_MGR_H
 #define STORAGE_MGR_H
 
-#include "PDBBufferManagerCheckLRU.h"
+#include "PDBBufferManagerArena.h"
+#include "PDBBufferManagerEvictionPolicy.h"
+#include "PDBBufferManagerHintedPolicy.h"
+#include "PDBBufferManagerIOEngine.h"
+#include "PDBBufferManagerPageDirectory.h"
+#include "PDBBufferManagerPageShard.h"
+#include "PDBBufferManagerStats.h"
 #include "PDBPage.h"
 #include "PDBPageHandle.h"
 #include "PDBSet.h"
@@ -12,12 +18,16 @@
 #include "PDBSharedMemory.h"
 #include "PDBBufferManagerInterface.h"
 #include "NodeConfig.h"
+#include "PDBNUMATopology.h"
 
 #include <map>
 #include <memory>
+#include <atomic>
 #include <condition_variable>
+#include <functional>
 #include <queue>
 #include <set>
+#include <thread>
 
 /**
  * This is the class that implements PC's per-node storage manager.
@@ -68,6 +78,26 @@
 
 using namespace std;
 
+// the size of a huge page we use to back the buffer pool
+#ifndef PDB_HUGE_PAGE_SIZE
+#define PDB_HUGE_PAGE_SIZE (2u * 1024u * 1024u)
+#endif
+
+// the alignment of the memory, the size and the file offset a page needs to have to be read and written with O_DIRECT
+#ifndef PDB_DIRECT_IO_ALIGNMENT
+#define PDB_DIRECT_IO_ALIGNMENT 4096u
+#endif
+
+// how often the background flusher checks the buffer pool if nobody wakes it up, in milliseconds
+#ifndef PDB_FLUSHER_INTERVAL_MS
+#define PDB_FLUSHER_INTERVAL_MS 10u
+#endif
+
+// how many free full pages every arena keeps ready for new set pages, so they can be created without the global lock
+#ifndef PDB_BUFFER_MANAGER_RESERVED_PAGES
+#define PDB_BUFFER_MANAGER_RESERVED_PAGES 8u
+#endif
+
 namespace pdb {
 
 class PDBBufferManagerImpl : public PDBBufferManagerInterface {
@@ -111,6 +141,102 @@ class PDBBufferManagerImpl : public PDBBufferManagerInterface {
    */
   void initialize(std::string metaDataFile);
 
+  /**
+   * sets the policy that selects the full page to evict when we run out of memory, it must be called
+   * right after the storage manager is initialized before any page is requested. The policy only decides about the
+   * pages without an access hint, @see PDBBufferManagerHintedPolicy
+   * @param policy - the eviction policy
+   */
+  void setEvictionPolicy(const PDBBufferManagerEvictionPolicyPtr &policy);
+
+  /**
+   * sets the engine that does the disk reads and writes, it must be called right after the storage manager
+   * is initialized before any page is requested
+   * @param engine - the I/O engine
+   */
+  void setIOEngine(const PDBBufferManagerIOEnginePtr &engine);
+
+  /**
+   * enables or disables direct I/O for the set files and the temporary file, with direct I/O the pages bypass the
+   * page cache of the kernel so they are not cached twice. Only pages whose memory, size and file offset are aligned
+   * to PDB_DIRECT_IO_ALIGNMENT can be done directly, the rest and files that don't support it use buffered I/O
+   * @param enable - true to enable it
+   */
+  void setDirectIO(bool enable);
+
+  /**
+   * asks the storage manager to back the buffer pool with huge pages, it must be called before the storage manager
+   * is initialized. We first try MAP_HUGETLB, if there are not enough huge pages reserved we fall back to
+   * transparent huge pages with madvise(MADV_HUGEPAGE)
+   * @param enable - true to use huge pages
+   */
+  void setHugePages(bool enable);
+
+  /**
+   * sets the directories the files of the sets and the temporary file are striped over, usually one for each drive,
+   * it must be called before the storage manager is initialized. Every set gets a file in each directory and its
+   * pages go to them round robin, the anonymous pages are spread over a temporary file in each directory. The page
+   * directories and the metadata stay in the storage location. If it is not called everything goes to the storage
+   * location. An existing storage keeps the directories it was created with
+   * @param dirs - the directories, at most PDB_BUFFER_MANAGER_MAX_STORAGE_DIRS of them
+   */
+  void setStorageDirectories(const std::vector<std::string> &dirs);
+
+  /**
+   * returns what kind of pages back the buffer pool
+   * @return - the mode we ended up with
+   */
+  PDBHugePageMode getHugePageMode();
+
+  /**
+   * sets the NUMA topology the buffer pool is split by, it must be called before the storage manager is initialized.
+   * If it is not called the topology of the machine is detected when the storage manager is initialized
+   * @param topology - the topology
+   */
+  void setNUMATopology(const PDBNUMATopologyPtr &topology);
+
+  /**
+   * returns the number of arenas the buffer pool is split into, there is one arena for each NUMA node
+   * unless the pool is too small to split
+   * @return - the number of arenas
+   */
+  size_t getNumArenas();
+
+  /**
+   * returns the arena the memory of the page belongs to
+   * @param page - the memory of a full page or a mini page
+   * @return - the index of the arena
+   */
+  size_t getArena(void *page);
+
+  /**
+   * starts the thread that writes the unpinned dirty pages in the background, so that when we run out of memory the
+   * full page we evict is usually clean and nobody has to wait for a write. Once the fraction of the buffer pool we can
+   * reuse without writing, the free full pages and the clean ones that are evicted next, drops below the low watermark,
+   * the pages that are evicted next are written until the fraction reaches the high watermark
+   * @param lowWatermark - the fraction of the buffer pool at which we start writing
+   * @param highWatermark - the fraction of the buffer pool at which we stop writing
+   */
+  void startFlusher(double lowWatermark, double highWatermark);
+
+  /**
+   * stops the background writes, the pages that are being written are finished first
+   */
+  void stopFlusher();
+
+  /**
+   * returns the number of pages that were written because a thread needed memory and the full page it evicted
+   * was dirty
+   * @return - the number of writes
+   */
+  uint64_t getNumForegroundWrites();
+
+  /**
+   * returns the number of pages that were written in the background by the flusher
+   * @return - the number of writes
+   */
+  uint64_t getNumBackgroundWrites();
+
   /**
    * gets the i^th page in the table whichSet... note that if the page
    * is currently being used (that is, the page is current buffered) a handle
@@ -129,6 +255,16 @@ class PDBBufferManagerImpl : public PDBBufferManagerInterface {
    */
   PDBPageHandle getPage(PDBSetPtr whichSet, uint64_t i) override;
 
+  /**
+   * gets the i-th page of the set like the method above, but if the page is not in RAM its memory is preferably taken
+   * from the given NUMA node, the frontend uses this to place the page on the node of the backend thread that asked for it
+   * @param whichSet - the set the page belongs to
+   * @param i - the i-th page of the set
+   * @param numaNode - the NUMA node we prefer the memory from, -1 if it is the node of the calling thread
+   * @return - a page handle to the requested page, it is guaranteed to be pinned
+   */
+  PDBPageHandle getPage(PDBSetPtr whichSet, uint64_t i, int64_t numaNode);
+
   /**
    * gets a temporary page that will no longer exist (1) after the buffer manager
    * has been destroyed, or (2) there are no more references to it anywhere in the
@@ -149,12 +285,141 @@ class PDBBufferManagerImpl : public PDBBufferManagerInterface {
    */
   PDBPageHandle getPage(size_t minBytes) override;
 
+  /**
+   * gets the pages with the given numbers from the set. The buffer manager is locked once for all of them and the
+   * pages that have to be read from disk are read with a single batch of I/O requests
+   * @param whichSet - this is the set identifier to which the pages belong to (databaseName, setName)
+   * @param pageNums - the numbers of the pages
+   * @return - the page handles in the same order as the page numbers, they are guaranteed to be pinned
+   */
+  std::vector<PDBPageHandle> getPages(PDBSetPtr whichSet, const std::vector<uint64_t> &pageNums) override;
+
+  /**
+   * gets the pages with the given numbers from the set like the method above, but the memory of the pages that are not
+   * in RAM is preferably taken from the given NUMA node, the frontend uses this for the batches the backend asks for
+   * @param whichSet - this is the set identifier to which the pages belong to (databaseName, setName)
+   * @param pageNums - the numbers of the pages
+   * @param numaNode - the NUMA node we prefer the memory from, -1 if it is the node of the calling thread
+   * @return - the page handles in the same order as the page numbers, they are guaranteed to be pinned
+   */
+  std::vector<PDBPageHandle> getPages(PDBSetPtr whichSet, const std::vector<uint64_t> &pageNums, int64_t numaNode);
+
+  /**
+   * gets a number of temporary pages while locking the buffer manager only once
+   * @param numPages - the number of pages
+   * @param minBytes - the minimum bytes each page needs to have
+   * @return - the page handles, they are guaranteed to be pinned
+   */
+  std::vector<PDBPageHandle> getAnonymousPages(size_t numPages, size_t minBytes) override;
+
+  /**
+   * gets a temporary page that is at least minBytes in size, the memory of the page is charged to the job
+   * @param jobID - the id of the job, this is the id of the computation the job belongs to
+   * @param minBytes - the minimum bytes the page needs to have
+   * @return - a page handle to an anonymous page, it is guaranteed to be pinned and have a size of at least minBytes
+   */
+  PDBPageHandle getJobPage(uint64_t jobID, size_t minBytes) override;
+
+  /**
+   * gets a number of temporary pages while locking the buffer manager only once, their memory is charged to the job
+   * @param jobID - the id of the job, this is the id of the computation the job belongs to
+   * @param numPages - the number of pages
+   * @param minBytes - the minimum bytes each page needs to have
+   * @return - the page handles, they are guaranteed to be pinned
+   */
+  std::vector<PDBPageHandle> getJobPages(uint64_t jobID, size_t numPages, size_t minBytes) override;
+
+  /**
+   * sets the budgets of the job. When we have to evict we first look for the pages of the jobs that are over their
+   * soft budget, a job that is over its hard budget recycles its own unpinned pages before it takes any free memory
+   * @param jobID - the id of the job
+   * @param softLimit - the soft budget in bytes
+   * @param hardLimit - the hard budget in bytes
+   */
+  void setJobBudget(uint64_t jobID, size_t softLimit, size_t hardLimit) override;
+
+  /**
+   * sets the budgets of all the jobs that did not get their own
+   * @param softLimit - the soft budget in bytes
+   * @param hardLimit - the hard budget in bytes
+   */
+  void setDefaultJobBudget(size_t softLimit, size_t hardLimit);
+
+  /**
+   * returns how much memory the job uses, the most it ever used and how often its pages were evicted
+   * @param jobID - the id of the job
+   * @return - the stats
+   */
+  PDBBufferManagerJobStats getJobStats(uint64_t jobID) override;
+
+  /**
+   * Sets the codec the pages of the set are compressed with when they are written, the pages that are already on
+   * disk keep their codec until they are written again. If we were not built with the codec snappy is used
+   * @param whichSet - the set
+   * @param compression - the codec
+   */
+  void setCompression(const PDBSetPtr &whichSet, PDBPageCompression compression) override;
+
+  /**
+   * Sets the codec the anonymous pages are compressed with when they are spilled to the temporary file
+   * @param compression - the codec
+   */
+  void setTempFileCompression(PDBPageCompression compression);
+
+  /**
+   * enables or disables the verification of the checksums of the pages we read from disk, the checksums are always
+   * computed when the pages are written so the verification can be enabled at any time
+   * @param enable - true to verify the checksums
+   */
+  void setVerifyChecksums(bool enable);
+
+  /**
+   * returns the number of pages we read from disk whose checksum did not match, including the ones that were fine
+   * once we read them again
+   * @return - the number of failures
+   */
+  uint64_t getNumChecksumFailures();
+
+  /**
+   * returns a snapshot of the counters of the buffer manager and of how the buffer pool is used right now, the
+   * counters are updated without taking the lock of the buffer manager
+   * @return - the stats
+   */
+  virtual PDBBufferManagerStats getStats();
+
+  /**
+   * returns the number of full pages we can hand out right away, the free ones and the ones we can evict, this is
+   * much cheaper than getting the stats
+   * @return - the number of full pages
+   */
+  size_t getNumReusablePages();
+
+  /**
+   * repins all the pages while locking the buffer manager only once, the pages that are not in RAM are read with a
+   * single batch of I/O requests
+   * @param pages - the pages we want to repin
+   */
+  void repinAll(std::vector<PDBPageHandle> &pages) override;
+
+  /**
+   * unpins all the pages while locking the buffer manager only once
+   * @param pages - the pages we want to unpin
+   */
+  void unpinAll(std::vector<PDBPageHandle> &pages) override;
+
   /**
    * Returns the maximum page size this buffer manager can give.
    * @return - the maximum page size
    */
   size_t getMaxPageSize() override;
 
+  /**
+   * Returns the number of full pages that are neither pinned nor leased to the backend, as of the last time a full page
+   * was taken, freed or became evictable
+   * @return - the number of pages
+   */
+  size_t getNumAvailablePages() override;
+
   /**
    * the storage manager does not have any server functionalities, they will be defined in the frontend (makes testing easier)
    * @param forMe - this is a reference to the PDBServer for which we want to register the handles for
@@ -176,11 +441,250 @@ protected:
   void checkIfOpen(PDBSetPtr &whichSet);
 
   /**
-   * Returns the file descriptor for a particular set
-   * @param whichSet - the set we are looking up the file descriptor
+   * Returns the page directory of the set, opens it if it is not open. The directory locks itself so it can be used
+   * without locking the buffer manager
+   * @param whichSet - the set we want the directory for
+   * @return - the directory
+   */
+  PDBBufferManagerPageDirectoryPtr getPageDirectory(const PDBSetPtr &whichSet);
+
+  /**
+   * Returns the file the page directory of the set is stored in
+   * @param whichSet - the set
+   * @return - the path to the file
+   */
+  std::string getPageDirectoryFile(const PDBSetPtr &whichSet);
+
+  /**
+   * Returns the file of the set in the storage directory
+   * @param whichSet - the set
+   * @param device - the index of the storage directory
+   * @return - the path to the file
+   */
+  std::string getSetFile(const PDBSetPtr &whichSet, size_t device);
+
+  /**
+   * Returns the file descriptor we should use to read or write a page of a set, if we are using direct I/O and the page
+   * is aligned this is the file descriptor opened with O_DIRECT
+   * @param whichSet - the set of the page
+   * @param device - the storage directory the page is in
+   * @param bytes - the memory of the page
+   * @param numBytes - the size of the page
+   * @param offset - the offset of the page in the file
    * @return - the file descriptor
    */
-  int getFileDescriptor(const PDBSetPtr &whichSet);
+  int getFileDescriptor(const PDBSetPtr &whichSet, size_t device, void *bytes, size_t numBytes, size_t offset);
+
+  /**
+   * Returns the file descriptor we should use to read or write an anonymous page to the temporary file
+   * @param device - the storage directory of the temporary file
+   * @param bytes - the memory of the page
+   * @param numBytes - the size of the page
+   * @param offset - the offset of the page in the temporary file
+   * @return - the file descriptor
+   */
+  int getTempFileDescriptor(size_t device, void *bytes, size_t numBytes, size_t offset);
+
+  /**
+   * Checks whether the page can be read or written with direct I/O
+   * @param bytes - the memory of the page, nullptr if the request does not use it, like the compressed pages
+   * @param numBytes - the size of the page
+   * @param offset - the offset of the page in the file
+   * @return - true if it can
+   */
+  bool canUseDirectIO(void *bytes, size_t numBytes, size_t offset);
+
+  /**
+   * Figures out where in a file we put a new page, if we are using direct I/O pages that have an aligned size get an
+   * aligned offset
+   * @param endOfFile - the first free position in the file
+   * @param numBytes - the size of the page
+   * @return - the position of the page
+   */
+  size_t getFilePosition(size_t endOfFile, size_t numBytes);
+
+  /**
+   * Gives the set page a location in the file of its storage directory if it does not have one yet and stores it in
+   * the page directory of the set. The pages of a set go to the storage directories round robin
+   * @param page - the page
+   */
+  void placeSetPage(const PDBPagePtr &page);
+
+  /**
+   * Gives the anonymous page a location in one of the temporary files if it does not have one yet, the pages go to
+   * the storage directories round robin and reuse the free locations of their directory first
+   * @param page - the page
+   */
+  void placeAnonymousPage(const PDBPagePtr &page);
+
+  /**
+   * Maps the memory of the buffer pool, with huge pages if we were asked to, and sets the memory, the mapped size and
+   * the huge page mode of the shared memory
+   */
+  void mapSharedMemory();
+
+  /**
+   * Splits the buffer pool into one arena per NUMA node and asks the kernel to place the memory of each arena on its
+   * node. The arenas are aligned to the huge page size so that a huge page never spans two nodes
+   */
+  void createArenas();
+
+  /**
+   * Returns the arena of the NUMA node the page is for
+   * @param numaNode - the node of the thread that asked for the page, if it is -1 we use the node the calling thread is
+   * running on, the frontend gets it from the backend since its own thread might run on any node
+   * @return - the index of the arena
+   */
+  size_t getLocalArena(int64_t numaNode = -1);
+
+  /**
+   * Returns the slab of the full page the memory belongs to
+   * @param memory - the memory of a full page or a mini page
+   * @return - the slab
+   */
+  PDBBufferManagerSlab &getSlab(void *memory);
+
+  /**
+   * Splits a free full page into mini pages of the given size and makes them available in the arena of the full page
+   * @param fullPage - the full page
+   * @param whichSize - the log of the size of the mini pages
+   */
+  void splitFullPage(void *fullPage, int64_t whichSize);
+
+  /**
+   * Gives back a mini page that is no longer used to the slab of its full page
+   * @param fullPage - the full page the mini page is on
+   * @param miniPage - the mini page
+   */
+  void freeMiniPage(void *fullPage, void *miniPage);
+
+  /**
+   * Gives back a full page that is no longer used, all of its mini pages are forgotten
+   * @param fullPage - the full page
+   */
+  void freeFullPage(void *fullPage);
+
+  /**
+   * Figures out the memory pressure from the number of full pages we can not reuse, it is called every time a full
+   * page is pinned or becomes evictable, this does not need the lock of the buffer manager
+   */
+  void updateMemoryPressure();
+
+  /**
+   * Returns the number of pinned mini pages on the full page, FULL_PAGE_FREE if the full page is not used and
+   * FULL_PAGE_EVICTING once it was picked to be evicted. It is changed without the lock of the buffer manager
+   * @param fullPage - the full page
+   * @return - the counter
+   */
+  std::atomic<long> &getNumPinned(void *fullPage);
+
+  /**
+   * Remembers that the full page stopped or started being evictable while the buffer manager was not locked, the
+   * eviction policy hears about it the next time @see syncEvictionPolicy is called
+   * @param fullPage - the full page
+   */
+  void fullPageChanged(void *fullPage);
+
+  /**
+   * Tells the eviction policy about the full pages that stopped or started being evictable since the last time it was
+   * called. This is called with the buffer manager locked before the policy is asked anything
+   */
+  void syncEvictionPolicy();
+
+  /**
+   * Marks a full page the eviction policy gave us as being evicted, this fails if somebody pinned one of its mini
+   * pages since the last time we synced the policy. This is called with the buffer manager locked
+   * @param fullPage - the full page
+   * @return - true if we can evict it, false otherwise
+   */
+  bool claimVictim(void *fullPage);
+
+  /**
+   * Takes a free full page from the reserve of the arena, the page is split into a single mini page that is already
+   * taken. This does not need the lock of the buffer manager
+   * @param whichArena - the arena we want the page from
+   * @return - the full page, nullptr if the reserve is empty
+   */
+  void *takeReservedPage(size_t whichArena);
+
+  /**
+   * Moves free full pages of the arenas to their reserves until they are full. This is called with the buffer manager
+   * locked
+   */
+  void refillReservedPages();
+
+  /**
+   * Gives the full pages of the reserves back to their arenas, we do this before we evict a page. This is called with
+   * the buffer manager locked
+   */
+  void releaseReservedPages();
+
+  /**
+   * Returns the number of full pages in the reserves of the arenas
+   */
+  size_t getNumReservedPages();
+
+  /**
+   * Tells the subscribers about the memory pressure if it changed, it is called without any locks at the start of
+   * the methods that need memory, so they hear about the pressure the previous requests left us with
+   */
+  virtual void signalMemoryPressure();
+
+  /**
+   * makes a temporary page that is at least maxBytes in size and charges it to the job
+   * @param maxBytes - the minimum bytes the page needs to have
+   * @param job - the id of the job, -1 if the page is not charged to any
+   * @param numaNode - the NUMA node we prefer the memory from, -1 if it is the node of the calling thread
+   * @return - a page handle to an anonymous page, it is pinned
+   */
+  PDBPageHandle getAnonymousPage(size_t maxBytes, int64_t job, int64_t numaNode = -1);
+
+
+  /**
+   * gets a number of temporary pages while locking the buffer manager only once
+   * @param numPages - the number of pages
+   * @param minBytes - the minimum bytes each page needs to have
+   * @param job - the job the pages are charged to, -1 if they don't belong to a job
+   * @param numaNode - the NUMA node we prefer the memory from, -1 if it is the node of the calling thread
+   * @return - the page handles, they are guaranteed to be pinned
+   */
+  std::vector<PDBPageHandle> getAnonymousPages(size_t numPages, size_t minBytes, int64_t job, int64_t numaNode = -1);
+
+  /**
+   * selects the full page we evict next and removes it from the eviction policy. The pages the backend unpinned through
+   * their leases are taken back first so that the policy can weigh them like any other page. If some jobs are over
+   * their soft budget we look for their pages among the next PDB_BUFFER_MANAGER_JOB_VICTIMS victims first
+   * @param lock - the lock of the buffer manager, it has to be held
+   * @return - the full page, nullptr if there is nothing to evict
+   */
+  void *selectVictim(unique_lock<mutex> &lock);
+
+  /**
+   * looks for a full page with a page of the job among the next PDB_BUFFER_MANAGER_JOB_VICTIMS victims, if there is
+   * one it is removed from the eviction policy
+   * @param job - the id of the job
+   * @param overSoftLimit - if true we look for a page of any job that is over its soft budget instead
+   * @return - the full page, nullptr if there is none
+   */
+  void *findJobVictim(int64_t job, bool overSoftLimit);
+
+  /**
+   * writes out the dirty pages that live on the full page and returns it to the free full pages of its arena, the page
+   * must have been removed from the eviction policy. The buffer manager is unlocked while we write.
+   * @param page - the full page
+   * @param lock - the lock holding the locked mutex of the buffer manager
+   */
+  void evictFullPage(void *page, unique_lock<mutex> &lock);
+
+  /**
+   * charges the memory of the page to its job, if it has one
+   */
+  void chargeJob(const PDBPagePtr &page);
+
+  /**
+   * gives back the memory of the page to its job, if it has one
+   */
+  void releaseJob(const PDBPagePtr &page);
 
   /**
    * Returns the nearest log of page size that can accommodate the requested number of bytes
@@ -189,6 +693,14 @@ protected:
    */
   size_t getLogPageSize(size_t numBytes);
 
+  /**
+   * Returns the shard of the page table the page of the given set with the given number belongs to
+   * @param whichSet - the set of the page
+   * @param pageNum - the number of the page in the set
+   * @return - the shard
+   */
+  PDBBufferManagerPageShard &getPageShard(const PDBSetPtr &whichSet, size_t pageNum);
+
   /**
    * "registers" a min-page.  That is, do record-keeping so that we can link the mini-page
    * to the full page that it is located on top of.  Since this is called when a page is created
@@ -207,13 +719,18 @@ protected:
    * If the page is not anonymous, it is written back (it must already have a spot to be
    * written to, because it has to have been unpinned) and then if there are no references to
    * it, it is destroyed.
+   * The mini pages are created in the preferred arena if it has a free full page, otherwise we use the mini pages or
+   * the full pages of the other arenas before we evict a page.
    * @param whichSize
+   * @param preferredArena - the arena we would like to get the mini pages from
    * @param lock
+   * @return - the arena that has the mini pages of the requested size
    */
-  void createAdditionalMiniPages(int64_t whichSize, unique_lock<mutex> &lock);
+  size_t createAdditionalMiniPages(int64_t whichSize, size_t preferredArena, unique_lock<mutex> &lock);
 
   /**
-   * tell the buffer manager that the given page can be truncated at the indicated size
+   * tell the buffer manager that the given page can be truncated at the indicated size. Only the page is locked
+   * unless the page is charged to a job or its full page has to be split
    * @param me - the page we want to freeze
    * @param numBytes - the number of bytes we want to freeze it to. (rounded up to the nearest base 2 exponent)
    */
@@ -223,7 +740,8 @@ protected:
    * The same as @see freezeSize but it takes in the unique_lock holding the locked mutex of the buffer manager
    * @param me - the page we want to freeze
    * @param numBytes - the number of bytes we want to freeze it to. (rounded up to the nearest base 2 exponent)
-   * @param lock - the lock holding the locked mutex of the buffer manager
+   * @param lock - the lock holding the locked mutex of the buffer manager, or of the page if the page is not charged
+   *               to a job and its full page does not have to be split
    */
   void freezeSize(PDBPagePtr me, size_t numBytes, unique_lock<mutex> &lock);
 
@@ -232,7 +750,8 @@ protected:
    * and then decrements the number of pinned pages on this pages' full parent page.  If this
    * page is not anonymous, we determine where its actual location on disk will be (for an
    * anonymous page, we wait until the page has to be written back to determine its location,
-   * because unlike non-anonymous pages, anonymous pages will often never make it to disk)
+   * because unlike non-anonymous pages, anonymous pages will often never make it to disk).
+   * Only the shard of the page is locked, the eviction policy hears about the full page later
    * @param me - the page we want to unpin
    */
   void unpin(PDBPagePtr me) override;
@@ -244,16 +763,53 @@ protected:
    */
   void unpin(PDBPagePtr me, unique_lock<mutex> &lock);
 
+  /**
+   * The same as @see unpin but the caller holds the lock of the shard the page belongs to, the buffer manager does
+   * not have to be locked
+   * @param me - the page we want to unpin
+   * @param shard - the locked shard of the page, nullptr if the page is anonymous
+   */
+  void unpin(PDBPagePtr me, PDBBufferManagerPageShard *shard);
+
   /**
    * pins the page that is the parent of a mini-page.  The "parent" is the page that contains
    * the physical bits for the mini-page.  To pin the parent, we first determine the parent,
-   * then we increment the number of pinned pages in the parent.  If the parent is not currently
-   * pinned, we remove it from the LRU queue (its current LRU number is the negative of the
-   * number of pinned pages in this case)
+   * then we increment the number of pinned pages in the parent.  If the parent was evictable the
+   * eviction policy forgets about it the next time it is synced. This does not need the lock of
+   * the buffer manager
    * @param me - the page whose parent page (physical page) we want to pin
-   * that were removed out of use when the parent was, inserted into the LRU.
+   * @return - false if the parent is being evicted and could not be pinned, true otherwise
+   */
+  bool pinParent(const PDBPagePtr& me);
+
+  /**
+   * decrements the number of pinned pages on the full page, if it drops to zero the full page becomes evictable
+   * the next time the eviction policy is synced. This does not need the lock of the buffer manager
+   * @param fullPage - the full page
+   * @return - true if this was the last pinned page on the full page
+   */
+  bool unpinParent(void *fullPage);
+
+  /**
+   * Waits on the pagesCV until the condition is true and adds the time we waited to the stats
+   * @param lock - the lock holding the locked mutex of the buffer manager
+   * @param isDone - the condition
+   */
+  void waitForPages(unique_lock<mutex> &lock, const std::function<bool()> &isDone);
+
+  /**
+   * Waits on the spaceCV until the condition is true and adds the time we waited to the stats
+   * @param lock - the lock holding the locked mutex of the buffer manager
+   * @param isDone - the condition
+   */
+  void waitForSpace(unique_lock<mutex> &lock, const std::function<bool()> &isDone);
+
+  /**
+   * Returns the access hint of the full page, this is the hint of the mini page on it we want to keep the longest
+   * @param fullPage - the address of the full page
+   * @return - the hint
    */
-  void pinParent(const PDBPagePtr& me);
+  PDBPageAccessHint getFullPageHint(void *fullPage);
 
   /**
    * repins a page (it is called "repin" because by definition, each page is pinned upon
@@ -274,6 +830,38 @@ protected:
    */
   void repin(PDBPagePtr me, unique_lock<mutex> &lock);
 
+  /**
+   * Repins the page if it is loaded, this only locks the shard of the page and the page
+   * @param me - the page we want to repin
+   * @return - true if the page is pinned, false if it has to be repinned with the buffer manager locked
+   */
+  bool repinLoaded(const PDBPagePtr &me);
+
+  /**
+   * Repins the pages while the buffer manager is locked. If one of the pages is being loaded or unloaded by somebody
+   * else we repin the other ones first and then wait for it, the pages that are not in RAM are read in batches
+   * @param pages - the pages we want to repin
+   * @param lock - the lock holding the locked mutex of the buffer manager
+   */
+  void repinPages(std::vector<PDBPagePtr> pages, unique_lock<mutex> &lock);
+
+  /**
+   * Does everything a repin does except for reading the page. If the page has to be read it gets memory, is marked
+   * as loading and added to the pages we need to load
+   * @param me - the page we want to repin
+   * @param lock - the lock holding the locked mutex of the buffer manager
+   * @param toLoad - the pages that need to be read from disk
+   */
+  void startRepin(const PDBPagePtr &me, unique_lock<mutex> &lock, std::vector<PDBPagePtr> &toLoad);
+
+  /**
+   * Reads the pages that have memory assigned to them from disk with a single batch of I/O requests and marks them
+   * as loaded. The buffer manager is unlocked while the pages are read.
+   * @param pages - the pages we want to read
+   * @param lock - the lock holding the locked mutex of the buffer manager
+   */
+  void loadPages(std::vector<PDBPagePtr> &pages, unique_lock<mutex> &lock);
+
   /**
    * this is called when there are no more external references to an anonymous page, and so
    * it can be destroyed.  To do this, we first unpin it (if it is pinned) and then remove it
@@ -294,79 +882,234 @@ protected:
    * So since we don't lock the buffer manager every time we update the reference count on a page but rather a
    * lock local to the page, it can happen that the request to freeAnonymousPage or downToZeroReferences
    * is stale and we ended up doing something else with the page in the mean time. This method checks if something
-   * happened to the page in the mean time.
+   * happened to the page in the mean time. If the page is not anonymous the shard of the page has to be locked.
    * @param me - the page we are supposed to remove
    * @return true if it is, false otherwise
    */
   bool isRemovalStillValid(PDBPagePtr me);
 
+  /**
+   * Called before we pick a page to evict, the frontend uses it to take back the pages it leased to the backend that
+   * the backend is not using
+   * @param lock - the lock of the buffer manager, it has to be held
+   * @return true if some pages were unpinned, false otherwise
+   */
+  virtual bool revokeLeases(unique_lock<mutex> &lock) { return false; }
+
+  /**
+   * Returns the number of full pages that are only pinned by the leases of the pages the backend unpinned, they can be
+   * reused even though we have them pinned. This only locks the leases
+   */
+  virtual size_t getNumLeasedReusablePages() { return 0; }
+
+#ifdef DEBUG_BUFFER_MANAGER
+  /**
+   * Whether the log methods read the state of the whole buffer manager, if they do the buffer manager has to be
+   * locked when they are called
+   * @return true if they do, false otherwise
+   */
+  virtual bool logsBufferManagerState() { return false; }
+#endif
+
   /**
    * this method finds free memory for a page of the specified size
    * @param pageSize - the size of the page
+   * @param job - the job the page is charged to, if it is over its hard budget it recycles its own memory first
+   * @param numaNode - the NUMA node we prefer the memory from, -1 if it is the node of the calling thread
    * @return - a void pointer pointing to a memory of exactly the specified size
    */
-  void *getEmptyMemory(int64_t pageSize, unique_lock<mutex> &lock);
+  void *getEmptyMemory(int64_t pageSize, unique_lock<mutex> &lock, int64_t job = -1, int64_t numaNode = -1);
+
+  /**
+   * makes a new anonymous page, it finds the memory for it and gives it a free page number
+   * @param bytesRequired - the log size of the page
+   * @param lock - the lock holding the locked mutex of the buffer manager
+   * @param job - the job the page is charged to, -1 if it is not charged to any
+   * @param numaNode - the NUMA node we prefer the memory from, -1 if it is the node of the calling thread
+   * @return - the page, it is pinned
+   */
+  PDBPagePtr makeAnonymousPage(size_t bytesRequired, unique_lock<mutex> &lock, int64_t job = -1, int64_t numaNode = -1);
+
+  /**
+   * adds the write of the page to the batch of writes, if the page is anonymous and does not have a location in the
+   * temporary file yet it gets one. If the page has a codec the write is marked to be compressed
+   * @param page - the page we want to write
+   * @param writes - the batch of writes
+   * @param written - the page is added here, in the same order as the writes, @see recordWrites
+   */
+  void addWrite(const PDBPagePtr &page, std::vector<PDBBufferManagerIORequest> &writes, std::vector<PDBPagePtr> &written);
+
+  /**
+   * adds the read of the page to the batch of reads, the page has to have its memory and location set. If the page
+   * is compressed on disk only the compressed bytes are read into the buffer of the request
+   * @param page - the page we want to read
+   * @param reads - the batch of reads
+   */
+  void addRead(const PDBPagePtr &page, std::vector<PDBBufferManagerIORequest> &reads);
+
+  /**
+   * compresses the pages of the writes that have a codec into their buffers, this is called without holding the lock.
+   * If a page does not get smaller it is written as it is
+   * @param writes - the batch of writes
+   */
+  static void compressWrites(std::vector<PDBBufferManagerIORequest> &writes);
+
+  /**
+   * decompresses the buffers of the reads that have a codec into their pages, this is called without holding the lock
+   * @param reads - the batch of reads, they have to be done
+   */
+  static void decompressReads(std::vector<PDBBufferManagerIORequest> &reads);
+
+  /**
+   * computes the checksums of the bytes the writes are going to write, this is called without holding the lock
+   * after the pages are compressed
+   * @param writes - the batch of writes
+   */
+  static void checksumWrites(std::vector<PDBBufferManagerIORequest> &writes);
+
+  /**
+   * checks that the bytes of the reads match the checksums they were written with, this is called without holding
+   * the lock before the pages are decompressed. A read that does not match is done once more, if it still does not
+   * match the page is corrupted and we give up
+   * @param pages - the pages in the same order as the reads
+   * @param reads - the batch of reads, they have to be done
+   */
+  void verifyReads(const std::vector<PDBPagePtr> &pages, std::vector<PDBBufferManagerIORequest> &reads);
+
+  /**
+   * once the writes are done stores how many bytes each page was compressed to and their checksum in its location,
+   * and in the page directory if it is a set page. This is called while holding the lock
+   * @param written - the pages in the same order as the writes
+   * @param writes - the batch of writes
+   */
+  void recordWrites(const std::vector<PDBPagePtr> &written, const std::vector<PDBBufferManagerIORequest> &writes);
+
+  /**
+   * returns the codec the page is compressed with when it is written
+   * @param page - the page
+   * @return - the codec of its set or the codec of the temporary file if it is anonymous
+   */
+  PDBPageCompression getCompression(const PDBPagePtr &page);
+
+  /**
+   * returns the codec of the temporary file from the configuration
+   * @param config - the configuration of the node
+   * @return - the codec, if there is no codec with the name we throw an exception
+   */
+  static PDBPageCompression getTempFileCompression(const pdb::NodeConfigPtr &config);
+
+  /**
+   * the loop of the background flusher, it runs until the flusher is stopped
+   */
+  void flush();
+
+  /**
+   * if we are below the low watermark writes the dirty pages of the full pages that are evicted next in one batch,
+   * the buffer manager is unlocked while they are written
+   * @param lock - the lock holding the locked mutex of the buffer manager
+   * @return - true if something was written
+   */
+  bool flushPages(unique_lock<mutex> &lock);
+
+  /**
+   * the page table split into independently locked shards, each shard has the set pages that are currently
+   * in existence
+   */
+  PDBBufferManagerPageShard pageShards[PDB_BUFFER_MANAGER_NUM_SHARDS];
+
+  /**
+   * the page directories of the sets that are open, they tell us where each of the set pages is physically located
+   * and the last used location in the file of the set
+   */
+  map<PDBSetPtr, PDBBufferManagerPageDirectoryPtr, PDBSetCompare> pageDirectories;
+
+  /**
+   * selects the full page we evict when we run out of memory, it wraps the configured policy so the hints are honored
+   */
+  PDBBufferManagerHintedPolicyPtr evictionPolicy;
+
+  /**
+   * does all the disk reads and writes of the pages
+   */
+  PDBBufferManagerIOEnginePtr ioEngine;
+
+  /**
+   * the number of pinned mini pages on a full page that is not used, on a full page that is being evicted and on a
+   * full page the flusher is writing, none of its pages can be pinned while it is written
+   */
+  static const long FULL_PAGE_FLUSHING = -3;
+  static const long FULL_PAGE_FREE = -2;
+  static const long FULL_PAGE_EVICTING = -1;
+
+  /**
+   * tells us how many of the minipages constructed from each full page are pinned, by the number of the full page.
+   * A used full page is evictable once it drops to zero, it is changed without locking the buffer manager
+   */
+  std::unique_ptr<std::atomic<long>[]> numPinned;
+
+  /**
+   * the number of full pages that have pinned mini pages
+   */
+  std::atomic<size_t> numPinnedFullPages{0};
 
   /**
-   * list of ALL of the page objects that are currently in existence
+   * true for the full pages the eviction policy currently knows about, by the number of the full page
    */
-  map<pair<PDBSetPtr, size_t>, PDBPagePtr, PDBPageCompare> allPages;
+  std::vector<bool> inEvictionPolicy;
 
   /**
-   * tells us, for each set, where each of the various pages are physically located.  The i^th entry in the
-   * vector tells us where to find the i^th entry in the set
+   * the full pages that stopped or started being evictable since we last synced the eviction policy, we did not
+   * hold the lock of the buffer manager when it happened
    */
-  map<pair<PDBSetPtr, size_t>, PDBPageInfo, PDBPageCompare> pageLocations;
+  std::vector<void *> changedFullPages;
 
   /**
-   * this tells us, for each set, the last used location in the file
+   * locks the changedFullPages, it is never held while another lock is acquired
    */
-  map<PDBSetPtr, size_t, PDBSetCompare> endOfFiles;
+  std::mutex changedLck;
 
   /**
-   * this keeps the LRU numbers sorted so that we can quickly evict a parent page
+   * the free full pages every arena keeps ready for new set pages, by arena. They are split into a single mini page
+   * that is already taken, so the page only has to be put on them
    */
-  set<pair<void *, size_t>, PDBBufferManagerCheckLRU> lastUsed;
+  vector<vector<void *>> reservedPages;
 
   /**
-   * tells us how many of the minipages constructed from each page are pinned if the long is a negative value, it gives us the LRU number
+   * locks the reservedPages, it is never held while another lock is acquired
    */
-  map<void *, long> numPinned;
+  std::mutex reserveLck;
 
   /**
-   * lists the FDs for all of the files
+   * lists the FDs for all of the files, a set has a file in each storage directory
    */
-  map<PDBSetPtr, int, PDBSetCompare> fds;
+  map<PDBSetPtr, vector<int>, PDBSetCompare> fds;
 
   /**
-   * all of the full pages that are currently not being used
+   * the buffer pool split by the NUMA nodes, each arena has the full pages and the mini pages of its part of the
+   * pool that are currently not being used
    */
-  vector<void *> emptyFullPages;
+  vector<PDBBufferManagerArena> arenas;
 
   /**
-   * all of the mini-pages that make up a page
+   * the number of full pages in an arena, the last arena also gets the pages that are left over
    */
-  map<void *, vector<PDBPagePtr>> constituentPages;
+  size_t pagesPerArena = 0;
 
   /**
-   * all of the locations from which we are currently allocating minipages.  The first
-   * entry in this vector is used to allocated minipages of size MIN_PAGE_SIZE, the
-   * second minipages of size MIN_PAGE_SIZE * 2, and so on.  Each entry in the vector
-   * is a pair containing a pointer to the full page that is being used to allocate
-   * minipages, and a pointer to the next slot that we'll allocate from on the minipage
+   * the NUMA topology of the machine we split the buffer pool by
    */
-  vector<vector<void *>> emptyMiniPages;
+  PDBNUMATopologyPtr numaTopology;
 
   /**
-   * for a given full physical page maps all the mini pages it is split into but are not used
-   * we have to keep track of this so that when we evict a page we know which pages to remove from the emptyMiniPages
+   * the slab of every full page, it tells us the mini pages the full page is split into, which of them are free
+   * and all of the pages that live on it. The slab of a full page is found by the number of the full page
    */
-  map<void *, std::pair<vector<void *>, int64_t >> unusedMiniPages;
+  vector<PDBBufferManagerSlab> slabs;
 
   /**
-   * all of the positions in the temporary file that are currently not in use
+   * all of the positions in the temporary files that are currently not in use, by storage directory and page size
    */
-  vector<vector<int64_t>> availablePositions;
+  vector<vector<vector<int64_t>>> availablePositions;
 
   /**
    * info about the shared memory of this storage manager contains the page size, number of pages and a pointer to
@@ -375,24 +1118,93 @@ protected:
   PDBSharedMemory sharedMemory{};
 
   /**
-   * the time tick associated with the MRU page
+   * the last position in the temporary file of each storage directory
    */
-  long lastTimeTick = 1;
+  vector<size_t> lastTempPos;
 
   /**
-   * the last position in the temporary file
+   * the storage directory the next anonymous page that needs a location goes to
    */
-  size_t lastTempPos = 0;
+  size_t nextTempDevice = 0;
 
   /**
-   * where we write the data
+   * where we write the data, this is the temporary file of the first storage directory
    */
   string tempFile;
 
   /**
-   * the descriptor of the temporary file
+   * the temporary files of the storage directories
+   */
+  vector<string> tempFiles;
+
+  /**
+   * the descriptors of the temporary files
+   */
+  vector<int32_t> tempFileFDs;
+
+  /**
+   * the temporary files opened with O_DIRECT, -1 if we are not using direct I/O or the file system does not support it
+   */
+  vector<int32_t> tempFileDirectFDs;
+
+  /**
+   * lists the FDs opened with O_DIRECT for the files that support it, -1 for the ones that don't
+   */
+  map<PDBSetPtr, vector<int>, PDBSetCompare> directFds;
+
+  /**
+   * whether we are using direct I/O
+   */
+  bool useDirectIO = false;
+
+  /**
+   * the codecs of the sets whose pages are compressed when they are written
+   */
+  map<PDBSetPtr, PDBPageCompression, PDBSetCompare> setCompressions;
+
+  /**
+   * the codec of the anonymous pages we spill to the temporary file
+   */
+  PDBPageCompression tempFileCompression = PDB_PAGE_COMPRESSION_NONE;
+
+  /**
+   * whether we verify the checksums of the pages we read
+   */
+  bool verifyChecksums = true;
+
+  /**
+   * the number of pages whose checksum did not match when we read them
    */
-  int32_t tempFileFD = 0;
+  std::atomic<uint64_t> numChecksumFailures{0};
+
+  /**
+   * the number of times a set page or an unpinned page was requested and how many of those we read from disk
+   */
+  std::atomic<uint64_t> numPageRequests{0};
+  std::atomic<uint64_t> numPageReads{0};
+
+  /**
+   * the number of pages we wrote and the bytes that went to and came from the disk
+   */
+  std::atomic<uint64_t> numPageWrites{0};
+  std::atomic<uint64_t> numBytesRead{0};
+  std::atomic<uint64_t> numBytesWritten{0};
+
+  /**
+   * the number of full pages we evicted
+   */
+  std::atomic<uint64_t> numEvictions{0};
+
+  /**
+   * the time the threads waited on the pagesCV and the spaceCV in nanoseconds
+   */
+  std::atomic<uint64_t> pagesWaitNanos{0};
+  std::atomic<uint64_t> spaceWaitNanos{0};
+
+  /**
+   * whether we want to back the buffer pool with huge pages
+   */
+  bool useHugePages = false;
 
   /**
    * this is the log of pageSize / MIN_PAGE_SIZE
@@ -409,13 +1221,25 @@ protected:
    */
   string storageLoc;
 
+  /**
+   * the directories the files of the sets and the temporary files are striped over
+   */
+  vector<string> storageDirs;
+
   /**
    * whether the storage manager has been initialized
    */
   bool initialized = false;
 
   /**
-   * locks the whole buffer manager
+   * true if we were restarted from the meta data file, then the page directories of the sets have the pages we stored
+   * before, otherwise they were left behind by an old storage and we start them over the first time we open them
+   */
+  bool reusePageDirectories = false;
+
+  /**
+   * locks the physical memory of the buffer manager (the full pages, the mini pages and the LRU), the page table
+   * is locked separately by the shards in pageShards and the pin counts of the full pages are atomic
    */
   std::mutex m;
 
@@ -438,6 +1262,21 @@ protected:
    */
   std::vector<bool> isCreatingSpace;
 
+  /**
+   * the memory pressure as of the last time a full page was taken, freed or became evictable
+   */
+  std::atomic<uint32_t> memoryPressureLevel{PDB_MEMORY_PRESSURE_NONE};
+
+  /**
+   * the number of full pages that can still be pinned, it is updated together with the memory pressure
+   */
+  std::atomic<size_t> numAvailablePages{0};
+
+  /**
+   * how much memory the anonymous pages of each job use and their budgets
+   */
+  PDBBufferManagerJobBudgets jobBudgets;
+
   /**
    * this vector holds all the free page numbers we can assign to an anonymous page.
    */
@@ -447,13 +1286,45 @@ protected:
    * so we assign a unique number to each anonymous page so we can identify them, if we already assigned
    * a all available numbers to anonymous pages this number will tell us what is the next number we need to generate
    */
-  int lastFreeAnonPageNumber = 0;
+  uint64_t lastFreeAnonPageNumber = 0;
 
   /**
    * this locks the file descriptor structure
    */
   std::mutex fdLck;
 
+  /**
+   * the thread that writes the unpinned dirty pages in the background
+   */
+  std::thread flusher;
+
+  /**
+   * wakes up the flusher when a full page is taken or the flusher is stopped
+   */
+  std::condition_variable flusherCV;
+
+  /**
+   * true while the flusher should keep running
+   */
+  bool isFlusherRunning = false;
+
+  /**
+   * true while the flusher is writing, the full pages it is writing are marked in their slabs
+   */
+  bool isFlushing = false;
+
+  /**
+   * the fractions of the buffer pool we can reuse without writing at which the flusher starts and stops writing
+   */
+  double flushLowWatermark = 0;
+  double flushHighWatermark = 0;
+
+  /**
+   * the number of pages written by the threads that needed memory and the number written by the flusher
+   */
+  std::atomic<uint64_t> numForegroundWrites{0};
+  std::atomic<uint64_t> numBackgroundWrites{0};
+
   friend class PDBPage;
 };
 
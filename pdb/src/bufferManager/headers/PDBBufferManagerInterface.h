@@ -3,8 +3,12 @@
 #ifndef STORAGE_MGR_IFC_H
 #define STORAGE_MGR_IFC_H
 
+#include <vector>
+#include <limits>
 #include <BufForwardPageRequest.h>
 #include "PDBPage.h"
+#include "PDBBufferManagerMemoryPressure.h"
+#include "PDBBufferManagerJobBudgets.h"
 #include "PDBPageHandle.h"
 #include "PDBSet.h"
 #include "PDBCommunicator.h"
@@ -102,11 +106,114 @@ public:
   // gets the page size
   virtual size_t getMaxPageSize() = 0;
 
+  // the batched versions of the methods above and of the pin/unpin methods of the page handle. They do the
+  // same thing as calling the single page method for each of the pages, but an implementation can do them
+  // all while holding its lock once (or with a single request to the front end), and read all the pages
+  // that are not in RAM with one batch of I/O requests.  By default they simply loop.
+
+  // gets the pages with the given numbers from the set whichSet, in the same order
+  virtual std::vector<PDBPageHandle> getPages(PDBSetPtr whichSet, const std::vector<uint64_t> &pageNums) {
+    std::vector<PDBPageHandle> pages;
+    pages.reserve(pageNums.size());
+    for (auto i : pageNums) {
+      pages.emplace_back(getPage(whichSet, i));
+    }
+    return pages;
+  }
+
+  // gets numPages temporary pages that are each at least minBytes in size
+  virtual std::vector<PDBPageHandle> getAnonymousPages(size_t numPages, size_t minBytes) {
+    std::vector<PDBPageHandle> pages;
+    pages.reserve(numPages);
+    for (size_t i = 0; i < numPages; ++i) {
+      pages.emplace_back(getPage(minBytes));
+    }
+    return pages;
+  }
+
+  // pins all the pages, the ones that are already pinned are left alone
+  virtual void repinAll(std::vector<PDBPageHandle> &pages) {
+    for (auto &page : pages) {
+      page->repin();
+    }
+  }
+
+  // unpins all the pages, the ones that are not pinned are left alone
+  virtual void unpinAll(std::vector<PDBPageHandle> &pages) {
+    for (auto &page : pages) {
+      page->unpin();
+    }
+  }
+
+  // the memory pressure.  The buffer manager tells the subscribers how close it is to running out of
+  // memory, so that the operators that keep growing can flush, spill or shrink before the node stalls.
+  // A callback is called with the new level every time the level changes, by the thread that is using
+  // the buffer manager when the change is noticed, so it should be quick.  The buffer manager holds
+  // none of its locks while calling it.
+
+  // subscribes the callback to the memory pressure, returns the id of the subscription
+  virtual uint64_t subscribeToMemoryPressure(const PDBMemoryPressureCallback &callback) {
+    return memoryPressure.subscribe(callback);
+  }
+
+  // removes the subscription with the given id
+  virtual void unsubscribeFromMemoryPressure(uint64_t id) {
+    memoryPressure.unsubscribe(id);
+  }
+
+  // returns the current level of the memory pressure
+  virtual PDBMemoryPressure getMemoryPressure() {
+    return memoryPressure.getLevel();
+  }
+
+  // the memory budgets of the jobs.  An anonymous page can be charged to a job (the id of the computation
+  // it belongs to) and the buffer manager keeps track of how much of the buffer pool each job uses.  When
+  // it has to evict it first looks for the pages of the jobs that are over their soft budget, and a job
+  // that is over its hard budget recycles its own unpinned pages before it takes any free memory.  Only
+  // the front end keeps the budgets, by default the job is ignored.
+
+  // gets a temporary page that is at least minBytes in size and charges it to the job
+  virtual PDBPageHandle getJobPage (uint64_t jobID, size_t minBytes) {
+    return getPage(minBytes);
+  }
+
+  // gets numPages temporary pages that are each at least minBytes in size and charges them to the job
+  virtual std::vector<PDBPageHandle> getJobPages (uint64_t jobID, size_t numPages, size_t minBytes) {
+    std::vector<PDBPageHandle> pages;
+    pages.reserve(numPages);
+    for (size_t i = 0; i < numPages; ++i) {
+      pages.emplace_back(getJobPage(jobID, minBytes));
+    }
+    return pages;
+  }
+
+  // returns how many pages of the maximum size can still be pinned without waiting for other pages to be
+  // unpinned.  It is only a hint, it is used to keep a batch of pinned pages from taking more memory than
+  // there is.  By default there is no limit.
+  virtual size_t getNumAvailablePages () {
+    return std::numeric_limits<size_t>::max();
+  }
+
+  // sets the soft and the hard budget of the job in bytes
+  virtual void setJobBudget (uint64_t jobID, size_t softLimit, size_t hardLimit) {}
+
+  // returns how much memory the job uses and how often its pages were evicted
+  virtual PDBBufferManagerJobStats getJobStats (uint64_t jobID) {
+    return PDBBufferManagerJobStats();
+  }
+
+  // sets the codec the pages of the set are compressed with when they are written to disk.  Only the
+  // front end writes the pages, by default the codec is ignored.
+  virtual void setCompression (const PDBSetPtr &whichSet, PDBPageCompression compression) {}
+
   // simply loop through and write back any dirty pages.  
   virtual ~PDBBufferManagerInterface () = default;
 
 protected:
 
+  // the subscribers to the memory pressure and the last level they were told about
+  PDBBufferManagerMemoryPressure memoryPressure;
+
   // note that these methods are all going to be called by the PDBPage object when
   // an application programmer perfoms operations on the object.
 
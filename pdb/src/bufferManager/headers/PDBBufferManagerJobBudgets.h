@@ -0,0 +1,158 @@
+#ifndef PDB_PDBBUFFERMANAGERJOBBUDGETS_H
+#define PDB_PDBBUFFERMANAGERJOBBUDGETS_H
+
+#include <cstdint>
+#include <cstddef>
+#include <limits>
+#include <unordered_map>
+
+// the number of pages that are about to be evicted we look at when we look for the pages of a job
+#ifndef PDB_BUFFER_MANAGER_JOB_VICTIMS
+#define PDB_BUFFER_MANAGER_JOB_VICTIMS 32u
+#endif
+
+namespace pdb {
+
+/**
+ * What the buffer manager knows about the memory of a job
+ */
+struct PDBBufferManagerJobStats {
+
+  // the budgets of the job in bytes
+  size_t softLimit = std::numeric_limits<size_t>::max();
+  size_t hardLimit = std::numeric_limits<size_t>::max();
+
+  // the bytes of the buffer pool the pages of the job use right now, and the most they ever used
+  size_t numBytes = 0;
+  size_t peakBytes = 0;
+
+  // the number of pages of the job that were evicted, and how many of them were picked because the job was over budget
+  uint64_t numEvicted = 0;
+  uint64_t numEvictedOverBudget = 0;
+
+  // the number of times the job had to recycle its own memory because it was over its hard budget
+  uint64_t numRecycled = 0;
+};
+
+/**
+ * Keeps track of how much of the buffer pool the anonymous pages of each job use. A job is identified by the id of the
+ * computation it belongs to. Every job gets the default budgets unless somebody sets its own, a job with the default
+ * budgets is forgotten once its pages don't use any memory.
+ *
+ * It is only used while the buffer manager is locked.
+ */
+class PDBBufferManagerJobBudgets {
+
+ public:
+
+  /**
+   * Sets the budgets of the jobs that did not get their own
+   * @param softLimit - the soft budget in bytes
+   * @param hardLimit - the hard budget in bytes
+   */
+  void setDefaultBudget(size_t softLimit, size_t hardLimit);
+
+  /**
+   * Sets the budgets of the job, it keeps them until it is removed
+   * @param job - the id of the job
+   * @param softLimit - the soft budget in bytes
+   * @param hardLimit - the hard budget in bytes
+   */
+  void setBudget(int64_t job, size_t softLimit, size_t hardLimit);
+
+  /**
+   * Forgets the job
+   */
+  void remove(int64_t job);
+
+  /**
+   * Called when a page of the job gets memory
+   * @param job - the id of the job
+   * @param numBytes - the size of the page
+   */
+  void charge(int64_t job, size_t numBytes);
+
+  /**
+   * Called when a page of the job gives back its memory
+   * @param job - the id of the job
+   * @param numBytes - the size of the page
+   */
+  void release(int64_t job, size_t numBytes);
+
+  /**
+   * Called when a page of the job is evicted
+   * @param job - the id of the job
+   * @param overBudget - true if the page was picked because the job is over its soft budget
+   */
+  void evicted(int64_t job, bool overBudget);
+
+  /**
+   * Called when the job recycles its own memory since it is over its hard budget
+   */
+  void recycled(int64_t job);
+
+  /**
+   * Returns true if the job uses more than its soft budget
+   */
+  bool isOverSoftLimit(int64_t job);
+
+  /**
+   * Returns true if the job uses more than its hard budget
+   */
+  bool isOverHardLimit(int64_t job);
+
+  /**
+   * Returns true if any job uses more than its soft budget, this is cheap
+   */
+  bool anyOverSoftLimit();
+
+  /**
+   * Returns the stats of the job, if we don't know the job it has no memory and the default budgets
+   */
+  PDBBufferManagerJobStats getStats(int64_t job);
+
+ private:
+
+  /**
+   * The bookkeeping of one job
+   */
+  struct Job {
+
+    // the stats of the job, they have the budgets
+    PDBBufferManagerJobStats stats;
+
+    // true if the job has its own budgets
+    bool hasOwnBudget = false;
+  };
+
+  /**
+   * Returns the job, if we don't know it yet it gets the default budgets
+   */
+  Job &getJob(int64_t job);
+
+  /**
+   * Updates the number of jobs over their soft budget after the job changed
+   * @param wasOver - true if the job was over its soft budget before the change
+   */
+  void updateOverSoftLimit(const Job &job, bool wasOver);
+
+  /**
+   * The jobs we know about
+   */
+  std::unordered_map<int64_t, Job> jobs;
+
+  /**
+   * The default budgets
+   */
+  size_t defaultSoftLimit = std::numeric_limits<size_t>::max();
+  size_t defaultHardLimit = std::numeric_limits<size_t>::max();
+
+  /**
+   * The number of jobs that are over their soft budget
+   */
+  size_t numOverSoftLimit = 0;
+};
+
+}
+
+#endif //PDB_PDBBUFFERMANAGERJOBBUDGETS_H
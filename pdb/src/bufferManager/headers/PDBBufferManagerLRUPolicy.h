@@ -0,0 +1,58 @@
+#ifndef PDB_PDBBUFFERMANAGERLRUPOLICY_H
+#define PDB_PDBBUFFERMANAGERLRUPOLICY_H
+
+#include <map>
+#include <set>
+#include "PDBBufferManagerEvictionPolicy.h"
+#include "PDBBufferManagerCheckLRU.h"
+
+namespace pdb {
+
+/**
+ * Evicts the full page that became evictable the longest time ago.
+ */
+class PDBBufferManagerLRUPolicy : public PDBBufferManagerEvictionPolicy {
+
+ public:
+
+  void unpinned(void *page) override;
+
+  void pinned(void *page) override;
+
+  void reloaded(void *page) override;
+
+  void freed(void *page) override;
+
+  void *evict() override;
+
+  std::vector<void *> getNextVictims(size_t numPages) override;
+
+  size_t numEvictable() override;
+
+ private:
+
+  /**
+   * removes the page from the LRU if it is there
+   * @param page - the address of the full page
+   */
+  void remove(void *page);
+
+  /**
+   * this keeps the LRU numbers sorted so that we can quickly evict a parent page
+   */
+  set<pair<void *, size_t>, PDBBufferManagerCheckLRU> lastUsed;
+
+  /**
+   * the LRU number of each page that is in the LRU
+   */
+  map<void *, size_t> timeTicks;
+
+  /**
+   * the time tick associated with the MRU page
+   */
+  size_t lastTimeTick = 1;
+};
+
+}
+
+#endif //PDB_PDBBUFFERMANAGERLRUPOLICY_H
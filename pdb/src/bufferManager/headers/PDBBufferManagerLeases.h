@@ -0,0 +1,170 @@
+#ifndef PDB_PDBBUFFERMANAGERLEASES_H
+#define PDB_PDBBUFFERMANAGERLEASES_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "PDBPageAccessHint.h"
+
+// the number of pages the backend can hold a lease on at the same time
+#ifndef PDB_BUFFER_MANAGER_LEASES
+#define PDB_BUFFER_MANAGER_LEASES 4096u
+#endif
+
+namespace pdb {
+
+class PDBBufferManagerLeases;
+typedef std::shared_ptr<PDBBufferManagerLeases> PDBBufferManagerLeasesPtr;
+
+/**
+ * The leases the frontend grants the backend on the frames of the pages it sends it. While the backend holds a lease
+ * on a page the frontend keeps the page pinned, so the backend can unpin and repin the page without asking the
+ * frontend, it just flips the state of the lease. The frontend only takes the frame back when it has nothing else to
+ * evict, it revokes the leases of the pages the backend unpinned and unpins them for real. If the backend then wants the
+ * page back it finds the lease revoked and asks the frontend like it would without the lease.
+ *
+ * Like @see PDBBufferManagerRing the leases live in a small shared mapping the frontend creates before the fork. Every
+ * lease has a generation that is bumped every time the lease is revoked or released, so the backend can never pin a
+ * frame through a lease that was in the meantime given to another page.
+ *
+ * A lease is identified by its slot in the lower 32 bits and its generation in the upper bits, -1 means no lease.
+ */
+class PDBBufferManagerLeases {
+
+ public:
+
+  /**
+   * Maps the memory of the leases, it is shared with the processes we fork after this
+   */
+  PDBBufferManagerLeases();
+
+  /**
+   * Unmaps the memory of the leases
+   */
+  ~PDBBufferManagerLeases();
+
+  /**
+   * Grants a lease on a pinned frame, this is called by the frontend
+   * @param offset - the offset of the frame in the shared memory
+   * @return - the lease or -1 if all the leases are taken
+   */
+  int64_t grant(uint64_t offset);
+
+  /**
+   * Revokes the lease if the backend has the page unpinned, this is called by the frontend
+   * @param lease - the lease
+   * @param isDirty - set to whether the backend wrote to the page while it had it pinned
+   * @return - true if we revoked it, false if the backend has the page pinned
+   */
+  bool revoke(int64_t lease, bool &isDirty);
+
+  /**
+   * The same as @see revoke but it also gives us the access hint the backend had on the page when it unpinned it
+   * @param lease - the lease
+   * @param isDirty - set to whether the backend wrote to the page while it had it pinned
+   * @param hint - set to the access hint of the page
+   * @return - true if we revoked it, false if the backend has the page pinned
+   */
+  bool revoke(int64_t lease, bool &isDirty, PDBPageAccessHint &hint);
+
+  /**
+   * Ends the lease no matter what the backend is doing with it, this is called by the frontend when the backend returns
+   * the page or the frontend grants a new lease on the same page
+   * @param lease - the lease
+   */
+  void release(int64_t lease);
+
+  /**
+   * Pins the frame of the lease if it was not revoked, this is called by the backend
+   * @param lease - the lease
+   * @param offset - set to the offset of the frame in the shared memory
+   * @return - true if we have the frame, false if the backend has to ask the frontend for the page
+   */
+  bool pin(int64_t lease, uint64_t &offset);
+
+  /**
+   * Unpins the frame of the lease, this is called by the backend
+   * @param lease - the lease
+   * @param isDirty - whether the backend wrote to the page
+   * @param hint - the access hint of the page, the frontend uses it when it revokes the lease
+   * @return - true if it worked, false if the lease is gone and the backend has to ask the frontend to unpin the page
+   */
+  bool unpin(int64_t lease, bool isDirty, PDBPageAccessHint hint = PDB_PAGE_HINT_NORMAL);
+
+  /**
+   * Checks whether the backend has the page of the lease unpinned, the answer can be stale by the time we look at it
+   * @param lease - the lease
+   * @return - true if it does
+   */
+  bool isUnpinned(int64_t lease);
+
+  /**
+   * Returns the number of leases the backend has unpinned, so the frontend does not have to look at them if there are
+   * none. While the state of a lease is changing it can be one too high, never too low
+   */
+  uint32_t getNumUnpinned();
+
+ private:
+
+  /**
+   * The states of a lease, they are in the lower two bits of the state word, the generation is in the rest
+   */
+  enum LeaseState : uint32_t {
+    LEASE_FREE,
+    LEASE_PINNED,
+    LEASE_UNPINNED
+  };
+
+  /**
+   * One lease
+   */
+  struct Lease {
+
+    // the generation and the state of the lease
+    std::atomic<uint32_t> state;
+
+    // set by the backend if it wrote to the page
+    std::atomic<uint32_t> dirty;
+
+    // the access hint of the page when the backend last unpinned it
+    std::atomic<uint32_t> hint;
+
+    // the offset of the frame
+    uint64_t offset;
+  };
+
+  /**
+   * Moves the lease from one state into the other if it has the right generation
+   */
+  bool transition(int64_t lease, LeaseState from, LeaseState to);
+
+  /**
+   * the leases, in the shared memory
+   */
+  Lease *leases = nullptr;
+
+  /**
+   * the number of leases in the unpinned state, it is in the shared memory right after the leases
+   */
+  std::atomic<uint32_t> *numUnpinned = nullptr;
+
+  /**
+   * the size of the mapping
+   */
+  size_t mappedSize = 0;
+
+  /**
+   * The slots of the leases that are free, this is only used by the frontend
+   */
+  std::vector<uint32_t> freeSlots;
+
+  /**
+   * Protects the free slots
+   */
+  std::mutex m;
+};
+
+}
+
+#endif //PDB_PDBBUFFERMANAGERLEASES_H
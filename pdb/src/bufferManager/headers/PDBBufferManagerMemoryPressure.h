@@ -0,0 +1,106 @@
+#ifndef PDB_PDBBUFFERMANAGERMEMORYPRESSURE_H
+#define PDB_PDBBUFFERMANAGERMEMORYPRESSURE_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+
+// the percentage of the buffer pool that has to be pinned for each level of memory pressure
+#ifndef PDB_MEMORY_PRESSURE_MODERATE_PERCENT
+#define PDB_MEMORY_PRESSURE_MODERATE_PERCENT 75u
+#endif
+
+#ifndef PDB_MEMORY_PRESSURE_HIGH_PERCENT
+#define PDB_MEMORY_PRESSURE_HIGH_PERCENT 90u
+#endif
+
+#ifndef PDB_MEMORY_PRESSURE_CRITICAL_PERCENT
+#define PDB_MEMORY_PRESSURE_CRITICAL_PERCENT 97u
+#endif
+
+namespace pdb {
+
+/**
+ * How close the buffer manager is to running out of memory, the levels are ordered so they can be compared
+ */
+enum PDBMemoryPressure : uint32_t {
+
+  PDB_MEMORY_PRESSURE_NONE,      // there is plenty of memory
+  PDB_MEMORY_PRESSURE_MODERATE,  // stop growing if you can
+  PDB_MEMORY_PRESSURE_HIGH,      // flush or spill what you can
+  PDB_MEMORY_PRESSURE_CRITICAL   // the next page might not be there
+};
+
+/**
+ * The callback of a subscriber, it is called with the new level
+ */
+using PDBMemoryPressureCallback = std::function<void(PDBMemoryPressure)>;
+
+/**
+ * Keeps the subscribers to the memory pressure of a buffer manager and tells them when the level changes
+ */
+class PDBBufferManagerMemoryPressure {
+
+ public:
+
+  /**
+   * Figures out the level of the memory pressure
+   * @param numPinned - the number of full pages that can not be evicted
+   * @param numPages - the number of full pages in the buffer pool
+   * @return - the level
+   */
+  static PDBMemoryPressure getLevel(size_t numPinned, size_t numPages);
+
+  /**
+   * Adds a subscriber
+   * @param callback - called every time the level changes
+   * @return - the id of the subscription
+   */
+  uint64_t subscribe(const PDBMemoryPressureCallback &callback);
+
+  /**
+   * Removes a subscriber, once this returns the callback is not called anymore
+   * @param id - the id of the subscription
+   */
+  void unsubscribe(uint64_t id);
+
+  /**
+   * Returns the last level we signaled
+   */
+  PDBMemoryPressure getLevel() const;
+
+  /**
+   * Tells the subscribers about the level if it changed, it must not be called while holding any lock of the buffer
+   * manager since the subscribers might use it
+   * @param level - the current level
+   */
+  void signal(PDBMemoryPressure level);
+
+ private:
+
+  /**
+   * The last level we signaled
+   */
+  std::atomic<uint32_t> level{PDB_MEMORY_PRESSURE_NONE};
+
+  /**
+   * The subscribers by the id of their subscription
+   */
+  std::map<uint64_t, PDBMemoryPressureCallback> subscribers;
+
+  /**
+   * The id of the next subscription
+   */
+  uint64_t nextID = 0;
+
+  /**
+   * Protects the subscribers, it is held while we call them so that nobody is called after it unsubscribed
+   */
+  std::recursive_mutex m;
+};
+
+}
+
+#endif //PDB_PDBBUFFERMANAGERMEMORYPRESSURE_H
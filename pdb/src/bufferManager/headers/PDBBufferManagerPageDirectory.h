@@ -0,0 +1,187 @@
+#ifndef PDB_PDBBUFFERMANAGERPAGEDIRECTORY_H
+#define PDB_PDBBUFFERMANAGERPAGEDIRECTORY_H
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include "PDBPage.h"
+
+// the largest number of storage directories the files of a set can be striped over
+#ifndef PDB_BUFFER_MANAGER_MAX_STORAGE_DIRS
+#define PDB_BUFFER_MANAGER_MAX_STORAGE_DIRS 16u
+#endif
+
+namespace pdb {
+
+class PDBBufferManagerPageDirectory;
+typedef std::shared_ptr<PDBBufferManagerPageDirectory> PDBBufferManagerPageDirectoryPtr;
+
+/**
+ * The page directory of a set tells us where each page of the set is located in the files of the set and where each
+ * file ends, the set has one file in every storage directory. It is a memory mapped file that is stored next to the file of the set, with a fixed size entry for every
+ * page number, so giving a page a location only writes one entry and looking it up only reads one entry.
+ *
+ * When a node restarts nothing is read until the set is used, and then the kernel only brings in the parts of the
+ * directory we touch, so the restart time does not depend on the amount of data we have.
+ *
+ * The directory locks itself, so the buffer manager can place a page while it only holds the lock of the shard of
+ * the page.
+ */
+class PDBBufferManagerPageDirectory {
+
+ public:
+
+  /**
+   * Opens the directory in the file or creates a new one if the file does not exist
+   * @param fileName - the file of the directory
+   * @param truncate - if true we start a new directory even if the file exists, the old one was left behind by a
+   * storage we are not restarting from
+   */
+  explicit PDBBufferManagerPageDirectory(const std::string &fileName, bool truncate = false);
+
+  /**
+   * Syncs and unmaps the directory
+   */
+  ~PDBBufferManagerPageDirectory();
+
+  /**
+   * Returns the location of the page if it has one
+   * @param pageNum - the number of the page
+   * @param location - the location is stored here
+   * @return - true if the page has a location, false otherwise
+   */
+  bool getPageLocation(size_t pageNum, PDBPageInfo &location);
+
+  /**
+   * Stores the location of the page, grows the directory if the page number does not fit
+   * @param pageNum - the number of the page
+   * @param location - the location
+   */
+  void setPageLocation(size_t pageNum, const PDBPageInfo &location);
+
+  /**
+   * Gives the page a location at the end of the file of its storage directory if it does not have one yet, and moves
+   * the end of the file past it
+   * @param pageNum - the number of the page
+   * @param location - the location of the page, it has to have the size and the storage directory, the position is
+   *                   set if the page gets a new location
+   * @param alignment - the position is rounded up to a multiple of this
+   * @return - true if the page got a new location, false if it already had one
+   */
+  bool placePage(size_t pageNum, PDBPageInfo &location, size_t alignment);
+
+  /**
+   * Returns the position where the file of the set in the storage directory ends
+   * @param device - the index of the storage directory
+   */
+  size_t getEndOfFile(size_t device);
+
+  /**
+   * Sets the position where the file of the set in the storage directory ends
+   * @param device - the index of the storage directory
+   * @param endOfFile - the position
+   */
+  void setEndOfFile(size_t device, size_t endOfFile);
+
+  /**
+   * Writes the directory to the disk
+   */
+  void sync();
+
+ private:
+
+  /**
+   * The header at the beginning of the file
+   */
+  struct Header {
+
+    // tells us that this is a page directory
+    uint64_t magic;
+
+    // the number of entries in the directory
+    uint64_t numEntries;
+
+    // where the file of the set in each storage directory ends
+    uint64_t endOfFile[PDB_BUFFER_MANAGER_MAX_STORAGE_DIRS];
+  };
+
+  /**
+   * The entry of a page
+   */
+  struct Entry {
+
+    // where the page starts in the file of the set
+    uint64_t startPos;
+
+    // the log of the size of the page as in PDBPageInfo
+    uint32_t numBytes;
+
+    // one if the page has a location, the file is zero filled when it grows, so new entries don't have one
+    uint32_t used;
+
+    // the number of bytes the page is compressed to and the codec, zero if it is not compressed
+    uint32_t compressedBytes;
+    uint32_t compression;
+
+    // the checksum of the bytes of the page on disk
+    uint32_t checksum;
+
+    // the storage directory the page is in
+    uint32_t device;
+  };
+
+  /**
+   * Maps the whole file
+   */
+  void map();
+
+  /**
+   * Grows the directory so it has an entry for the page
+   * @param pageNum - the number of the page
+   */
+  void grow(size_t pageNum);
+
+  /**
+   * Returns the entry of the page
+   */
+  Entry *getEntry(size_t pageNum);
+
+  /**
+   * the magic number at the beginning of the file
+   */
+  static const uint64_t MAGIC = 0x5044424449523034ul;
+
+  /**
+   * the number of entries a new directory has
+   */
+  static const size_t INITIAL_NUM_ENTRIES = 1024;
+
+  /**
+   * the file of the directory
+   */
+  std::string fileName;
+
+  /**
+   * the file descriptor of the directory
+   */
+  int fd = -1;
+
+  /**
+   * locks the directory
+   */
+  std::mutex m;
+
+  /**
+   * the mapped file
+   */
+  Header *header = nullptr;
+
+  /**
+   * the size of the mapped file
+   */
+  size_t mappedSize = 0;
+};
+
+}
+
+#endif //PDB_PDBBUFFERMANAGERPAGEDIRECTORY_H
@@ -0,0 +1,40 @@
+#ifndef PDB_PDBBUFFERMANAGERPAGESHARD_H
+#define PDB_PDBBUFFERMANAGERPAGESHARD_H
+
+#include <map>
+#include <mutex>
+#include "PDBPage.h"
+#include "PDBPageCompare.h"
+
+// the number of partitions the page table of the buffer manager is split into, this can be supplied by the make file
+#ifndef PDB_BUFFER_MANAGER_NUM_SHARDS
+#define PDB_BUFFER_MANAGER_NUM_SHARDS 16u
+#endif
+
+namespace pdb {
+
+/**
+ * One partition of the page table of the buffer manager. A set page is assigned to a shard by hashing
+ * the set and the page number, so that looking up a page that is already pinned, creating a page on a reserved
+ * full page and unpinning or repinning a page that is in RAM only need to lock the shard it lives in instead of
+ * the whole buffer manager.
+ *
+ * If both are needed the global lock of the buffer manager is always acquired before the lock of the shard,
+ * and the shard lock is always acquired before the lock of a page.
+ */
+struct PDBBufferManagerPageShard {
+
+  /**
+   * locks this shard of the page table
+   */
+  std::mutex m;
+
+  /**
+   * all the set pages of this shard that are currently in existence
+   */
+  map<pair<PDBSetPtr, size_t>, PDBPagePtr, PDBPageCompare> allPages;
+};
+
+}
+
+#endif //PDB_PDBBUFFERMANAGERPAGESHARD_H
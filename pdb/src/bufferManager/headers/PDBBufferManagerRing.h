@@ -0,0 +1,307 @@
+#ifndef PDB_PDBBUFFERMANAGERRING_H
+#define PDB_PDBBUFFERMANAGERRING_H
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include "PDBLogger.h"
+#include "Handle.h"
+#include "PDBBufferManagerMemoryPressure.h"
+
+// the number of requests that can be in the ring at the same time, it has to be a power of two
+#ifndef PDB_BUFFER_MANAGER_RING_SLOTS
+#define PDB_BUFFER_MANAGER_RING_SLOTS 64u
+#endif
+
+// the maximum size of a request or a response, the same as the allocation block we use for them over TCP
+#ifndef PDB_BUFFER_MANAGER_RING_SLOT_SIZE
+#define PDB_BUFFER_MANAGER_RING_SLOT_SIZE 1024u
+#endif
+
+// the number of workers of the frontend that handle the requests from the ring
+#ifndef PDB_BUFFER_MANAGER_RING_THREADS
+#define PDB_BUFFER_MANAGER_RING_THREADS 4u
+#endif
+
+// how many times the backend checks for the response before it goes to sleep
+#ifndef PDB_BUFFER_MANAGER_RING_SPINS
+#define PDB_BUFFER_MANAGER_RING_SPINS 1000u
+#endif
+
+namespace pdb {
+
+class PDBBufferManagerRing;
+typedef std::shared_ptr<PDBBufferManagerRing> PDBBufferManagerRingPtr;
+
+class PDBBufferManagerRingResponder;
+typedef std::shared_ptr<PDBBufferManagerRingResponder> PDBBufferManagerRingResponderPtr;
+
+/**
+ * The channel the backend buffer manager uses to send the page requests to the frontend. It lives in a small shared
+ * mapping the frontend creates before the fork, so both processes see it. The ring has a fixed number of slots, every
+ * slot has room for one request and its response. The backend takes a free slot, builds the request right in the slot
+ * and puts the number of the slot into a lock free queue of requests, one of the threads of the frontend takes it out,
+ * handles the request and writes the response into the same slot.
+ *
+ * Nobody spins for long, the threads that have nothing to do sleep on a futex and are only woken up if somebody is
+ * actually sleeping, so a request costs no system call when the frontend is busy and at most two when it is idle,
+ * instead of a connect, an accept and a couple of reads and writes on a socket.
+ *
+ * The requests and the responses are the same objects we send over TCP, so the frontend handles them with the same
+ * methods, it just answers through a @see PDBBufferManagerRingResponder instead of a communicator.
+ */
+class PDBBufferManagerRing {
+
+ public:
+
+  /**
+   * Maps the memory of the ring, it is shared with the processes we fork after this
+   */
+  PDBBufferManagerRing();
+
+  /**
+   * Unmaps the memory of the ring
+   */
+  ~PDBBufferManagerRing();
+
+  /**
+   * Sends a request to the frontend and waits for the response, this is called by the backend. It works like the
+   * heapRequest of the RequestFactory.
+   * @tparam RequestType - the type of object we send
+   * @tparam ResponseType - the type of object we expect to get back
+   * @tparam ReturnType - the type we return to the caller
+   * @tparam RequestTypeParams - the types of the params of the constructor of the request
+   * @param logger - the logger we write the errors to
+   * @param onErr - the value we return if something goes wrong
+   * @param processResponse - the function that processes the response
+   * @param args - the arguments for the constructor of the request
+   * @return whatever is returned from processResponse or onErr in case of failure
+   */
+  template <class RequestType, class ResponseType, class ReturnType, class... RequestTypeParams>
+  ReturnType request(PDBLoggerPtr &logger,
+                     ReturnType onErr,
+                     std::function<ReturnType(Handle<ResponseType>)> processResponse,
+                     RequestTypeParams &&... args);
+
+  /**
+   * Waits until there is a request, this is called by the frontend
+   * @return - the slot of the request or -1 if the ring was closed
+   */
+  int64_t waitForRequest();
+
+  /**
+   * Returns the type id of the request in the slot
+   */
+  int16_t getRequestType(int64_t slot);
+
+  /**
+   * Returns the request in the slot, it is valid until we respond to it
+   */
+  template <class RequestType>
+  Handle<RequestType> getRequest(int64_t slot);
+
+  /**
+   * Returns the object the handler of the request sends the response with
+   */
+  PDBBufferManagerRingResponderPtr getResponder(int64_t slot);
+
+  /**
+   * Hands the response in the slot back to the backend
+   */
+  void respond(int64_t slot);
+
+  /**
+   * Wakes up all the threads of the frontend that are waiting for requests, after this they get no more requests
+   */
+  void close();
+
+  /**
+   * Publishes the memory pressure of the frontend, so the backend can tell its subscribers about it
+   */
+  void setMemoryPressure(PDBMemoryPressure level);
+
+  /**
+   * Returns the last memory pressure the frontend published
+   */
+  PDBMemoryPressure getMemoryPressure();
+
+  /**
+   * Publishes how many pages the frontend can still pin, so the backend can size its batches
+   */
+  void setNumAvailablePages(uint64_t numPages);
+
+  /**
+   * Returns the last number of available pages the frontend published
+   */
+  uint64_t getNumAvailablePages();
+
+ private:
+
+  /**
+   * The states of a slot
+   */
+  enum SlotState : uint32_t {
+    SLOT_FREE,
+    SLOT_REQUEST,
+    SLOT_WAITING,
+    SLOT_RESPONSE
+  };
+
+  /**
+   * One request and its response
+   */
+  struct Slot {
+
+    // the state of the slot, the backend sleeps on it while it waits for the response, if it does the state is
+    // SLOT_WAITING so the frontend knows it has to wake it up
+    std::atomic<uint32_t> state;
+
+    // the type ids of the objects in the slot, the response type is -1 until the frontend sends one
+    int16_t requestType;
+    int16_t responseType;
+
+    // the records of the request and the response
+    alignas(64) char request[PDB_BUFFER_MANAGER_RING_SLOT_SIZE];
+    alignas(64) char response[PDB_BUFFER_MANAGER_RING_SLOT_SIZE];
+  };
+
+  /**
+   * A bounded lock free queue of slot numbers, every cell has a sequence number that tells us whether it was written
+   * or read in the current lap of the queue
+   */
+  struct Queue {
+
+    struct Cell {
+      std::atomic<uint64_t> sequence;
+      uint32_t slot;
+    };
+
+    // where we push and where we pop, on different cache lines
+    alignas(64) std::atomic<uint64_t> pushPosition;
+    alignas(64) std::atomic<uint64_t> popPosition;
+
+    // the cells of the queue
+    alignas(64) Cell cells[PDB_BUFFER_MANAGER_RING_SLOTS];
+  };
+
+  /**
+   * Everything that is in the shared memory
+   */
+  struct Ring {
+
+    // the slots that are not used, and the slots that have a request in them
+    Queue freeSlots;
+    Queue requests;
+
+    // bumped every time a slot is freed or a request is pushed, the threads that wait for them sleep on these
+    alignas(64) std::atomic<uint32_t> freeSequence;
+    alignas(64) std::atomic<uint32_t> requestSequence;
+
+    // the number of threads sleeping on the sequences, if there are none we don't wake anybody up
+    std::atomic<uint32_t> numWaitingForSlot;
+    std::atomic<uint32_t> numWaitingForRequest;
+
+    // set once the ring is closed
+    std::atomic<uint32_t> closed;
+
+    // the memory pressure of the frontend
+    std::atomic<uint32_t> memoryPressure;
+
+    // the number of pages the frontend can still pin
+    std::atomic<uint64_t> numAvailablePages;
+
+    // the slots
+    Slot slots[PDB_BUFFER_MANAGER_RING_SLOTS];
+  };
+
+  /**
+   * Takes a free slot, waits if there is none
+   */
+  uint32_t takeSlot();
+
+  /**
+   * Publishes the request in the slot to the frontend
+   */
+  void pushRequest(uint32_t slot);
+
+  /**
+   * Waits until the frontend responded to the request in the slot
+   */
+  void waitForResponse(uint32_t slot);
+
+  /**
+   * Gives back the slot
+   */
+  void releaseSlot(uint32_t slot);
+
+  /**
+   * Pushes the slot number into the queue, there is always room since there are as many cells as slots
+   */
+  static void push(Queue &queue, uint32_t slot);
+
+  /**
+   * Pops a slot number from the queue
+   * @return - false if the queue is empty
+   */
+  static bool pop(Queue &queue, uint32_t &slot);
+
+  /**
+   * Sleeps as long as the word has the expected value, the futex is not private since the word is shared between
+   * the frontend and the backend process
+   */
+  static void futexWait(std::atomic<uint32_t> &word, uint32_t expected);
+
+  /**
+   * Wakes up the threads that sleep on the word
+   */
+  static void futexWake(std::atomic<uint32_t> &word, int numThreads);
+
+  /**
+   * the shared memory
+   */
+  Ring *ring = nullptr;
+
+  /**
+   * the size of the mapping
+   */
+  size_t mappedSize = 0;
+};
+
+/**
+ * Writes the response of a request into the slot of the request, it has the sendObject of a communicator so the
+ * request handlers of the frontend can use it
+ */
+class PDBBufferManagerRingResponder {
+
+ public:
+
+  PDBBufferManagerRingResponder(char *response, int16_t &responseType) : response(response), responseType(responseType) {}
+
+  /**
+   * Copies the object into the slot
+   * @param sendMe - the object we send, it has to be in the current allocation block
+   * @param errMsg - the error if we fail
+   * @return - true if it fit into the slot
+   */
+  template <class ObjType>
+  bool sendObject(Handle<ObjType> &sendMe, std::string &errMsg);
+
+ private:
+
+  /**
+   * where the response goes
+   */
+  char *response;
+
+  /**
+   * where the type of the response goes
+   */
+  int16_t &responseType;
+};
+
+}
+
+#include "PDBBufferManagerRingTemplate.cc"
+
+#endif //PDB_PDBBUFFERMANAGERRING_H
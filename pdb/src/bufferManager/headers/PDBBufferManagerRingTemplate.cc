@@ -0,0 +1,103 @@
+#ifndef PDB_PDBBUFFERMANAGERRINGTEMPLATE_CC
+#define PDB_PDBBUFFERMANAGERRINGTEMPLATE_CC
+
+#include <cstring>
+#include "InterfaceFunctions.h"
+#include "UseTemporaryAllocationBlock.h"
+
+namespace pdb {
+
+template <class RequestType, class ResponseType, class ReturnType, class... RequestTypeParams>
+ReturnType PDBBufferManagerRing::request(PDBLoggerPtr &logger,
+                                         ReturnType onErr,
+                                         std::function<ReturnType(Handle<ResponseType>)> processResponse,
+                                         RequestTypeParams &&... args) {
+
+  // grab a slot
+  auto slot = takeSlot();
+  auto &s = ring->slots[slot];
+
+  {
+    // make the request right in the slot
+    const UseTemporaryAllocationBlock tempBlock{s.request, PDB_BUFFER_MANAGER_RING_SLOT_SIZE};
+    Handle<RequestType> request = makeObject<RequestType>(args...);
+
+    // if it does not fit we are done
+    auto *record = request == nullptr ? nullptr : getRecord(request);
+    if (record == nullptr) {
+
+      // log what happened
+      logger->error("The request does not fit into a slot of the buffer manager ring.");
+
+      // give back the slot
+      releaseSlot(slot);
+      return onErr;
+    }
+
+    // the frontend expects the record at the start of the slot
+    if ((char *) record != s.request) {
+      memmove(s.request, record, record->numBytes());
+    }
+  }
+
+  // hand it to the frontend and wait for it to respond
+  s.requestType = getTypeID<RequestType>();
+  s.responseType = -1;
+  pushRequest(slot);
+  waitForResponse(slot);
+
+  // check if we got what we expected
+  if (s.responseType != getTypeID<ResponseType>()) {
+
+    // log what happened
+    logger->error("The frontend did not respond to the request sent through the buffer manager ring.");
+
+    // give back the slot
+    releaseSlot(slot);
+    return onErr;
+  }
+
+  // process the response
+  ReturnType finalResult;
+  {
+    Handle<ResponseType> result = ((Record<ResponseType> *) s.response)->getRootObject();
+    finalResult = processResponse(result);
+  }
+
+  // give back the slot
+  releaseSlot(slot);
+
+  return finalResult;
+}
+
+template <class RequestType>
+Handle<RequestType> PDBBufferManagerRing::getRequest(int64_t slot) {
+  return ((Record<RequestType> *) ring->slots[slot].request)->getRootObject();
+}
+
+template <class ObjType>
+bool PDBBufferManagerRingResponder::sendObject(Handle<ObjType> &sendMe, std::string &errMsg) {
+
+  // grab the record of the object
+  auto *record = getRecord(sendMe);
+  if (record == nullptr) {
+    errMsg = "Trying to get a record for an object not created by this thread's allocator.";
+    return false;
+  }
+
+  // check if it fits
+  if (record->numBytes() > PDB_BUFFER_MANAGER_RING_SLOT_SIZE) {
+    errMsg = "The response does not fit into a slot of the buffer manager ring.";
+    return false;
+  }
+
+  // copy it
+  memcpy(response, record, record->numBytes());
+  responseType = getTypeID<ObjType>();
+
+  return true;
+}
+
+}
+
+#endif //PDB_PDBBUFFERMANAGERRINGTEMPLATE_CC
@@ -0,0 +1,195 @@
+#ifndef PDB_PDBBUFFERMANAGERSLAB_H
+#define PDB_PDBBUFFERMANAGERSLAB_H
+
+#include <vector>
+#include "PDBPage.h"
+
+namespace pdb {
+
+/**
+ * The bookkeeping of one full page of the buffer pool. A full page is split into mini pages of one size, the free
+ * mini pages are marked in a bitmap and the ones that were handed out and given back are chained in a free list that
+ * is threaded through their own memory, the ones that were never handed out are taken in order. This way taking a mini
+ * page and giving it back both take constant time.
+ *
+ * The slab also knows all the pages that currently live on the full page, so that we can write them out when the full
+ * page is evicted, and it can be linked into the list of the slabs of an arena that have free mini pages.
+ *
+ * The slabs are only used while the buffer manager is locked.
+ */
+class PDBBufferManagerSlab {
+
+ public:
+
+  /**
+   * Splits the full page into mini pages of the given size, all of them are free. The pages that live on the
+   * full page are kept, this is used when a full size page is frozen to a smaller size.
+   * @param fullPageIn - the memory of the full page
+   * @param sizeClassIn - the log of the size of the mini pages, the size is MIN_PAGE_SIZE << sizeClass
+   * @param fullPageSize - the size of the full page
+   */
+  void split(void *fullPageIn, int64_t sizeClassIn, size_t fullPageSize);
+
+  /**
+   * Forgets the split, after this the full page is free
+   */
+  void reset();
+
+  /**
+   * Takes a free mini page, there must be one
+   * @return - the memory of the mini page
+   */
+  void *allocate();
+
+  /**
+   * Gives back the mini page
+   * @param miniPage - the memory of the mini page
+   */
+  void free(void *miniPage);
+
+  /**
+   * Returns true if the slab has a free mini page
+   */
+  bool hasFree();
+
+  /**
+   * Returns true if none of the mini pages are used
+   */
+  bool isUnused();
+
+  /**
+   * Returns the log of the size of the mini pages
+   */
+  int64_t getSizeClass();
+
+  /**
+   * Returns the number of mini pages the full page is split into
+   */
+  size_t getNumMiniPages();
+
+  /**
+   * Returns the memory of the i-th mini page
+   */
+  void *getMiniPage(size_t i);
+
+  /**
+   * Returns true if the i-th mini page is free
+   */
+  bool isFree(size_t i);
+
+  /**
+   * Adds a page that lives on the full page
+   */
+  void addPage(const PDBPagePtr &page);
+
+  /**
+   * Removes a page that lives on the full page
+   */
+  void removePage(const PDBPagePtr &page);
+
+  /**
+   * Returns the pages that live on the full page
+   */
+  std::vector<PDBPagePtr> &getPages();
+
+  /**
+   * Links the slab at the front of the list
+   * @param head - the first slab of the list
+   */
+  void link(PDBBufferManagerSlab *&head);
+
+  /**
+   * Removes the slab from the list if it is linked
+   * @param head - the first slab of the list
+   */
+  void unlink(PDBBufferManagerSlab *&head);
+
+  /**
+   * Marks whether the pages of the full page are being written in the background, while they are the full page can not
+   * be evicted or freed
+   */
+  void setFlushing(bool flushingIn);
+
+  /**
+   * Returns true if the pages of the full page are being written in the background
+   */
+  bool isFlushing();
+
+ private:
+
+  /**
+   * Returns true if the address is a mini page of this slab that is free
+   */
+  bool isFreeMiniPage(void *miniPage);
+
+  /**
+   * Rebuilds the free list from the bitmap. The free list lives in the memory of the free mini pages, so if somebody
+   * writes to a mini page after it was given back the list is damaged, the bitmap is not
+   */
+  void rebuildFreeList();
+
+  /**
+   * the memory of the full page
+   */
+  char *fullPage = nullptr;
+
+  /**
+   * the log of the size of the mini pages
+   */
+  int64_t sizeClass = 0;
+
+  /**
+   * the size of the mini pages in bytes
+   */
+  size_t miniPageSize = 0;
+
+  /**
+   * the number of mini pages the full page is split into
+   */
+  size_t numMiniPages = 0;
+
+  /**
+   * the number of mini pages that were ever handed out, the rest are taken in order
+   */
+  size_t numCarved = 0;
+
+  /**
+   * the number of free mini pages
+   */
+  size_t numFree = 0;
+
+  /**
+   * the first mini page that was given back, each one stores the pointer to the next one
+   */
+  void *freeList = nullptr;
+
+  /**
+   * one bit for every mini page, it is set if the mini page is free
+   */
+  std::vector<uint64_t> freeBitmap;
+
+  /**
+   * the pages that live on the full page, each page knows its position here so we can remove it right away
+   */
+  std::vector<PDBPagePtr> pages;
+
+  /**
+   * the previous and the next slab in the list the slab is linked into
+   */
+  PDBBufferManagerSlab *prev = nullptr;
+  PDBBufferManagerSlab *next = nullptr;
+
+  /**
+   * true if the slab is linked into a list
+   */
+  bool isLinked = false;
+
+  /**
+   * true if the pages of the full page are being written in the background
+   */
+  bool flushing = false;
+};
+
+}
+
+#endif //PDB_PDBBUFFERMANAGERSLAB_H
@@ -0,0 +1,89 @@
+#ifndef PDB_PDBBUFFERMANAGERSTATS_H
+#define PDB_PDBBUFFERMANAGERSTATS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace pdb {
+
+/**
+ * How the full pages that are split into the mini pages of one size are used
+ */
+struct PDBBufferManagerSizeClassStats {
+
+  // the size of the mini pages
+  uint64_t miniPageSize = 0;
+
+  // the number of full pages split into mini pages of this size
+  uint64_t numFullPages = 0;
+
+  // the number of mini pages on those full pages and how many of them hold a page
+  uint64_t numMiniPages = 0;
+  uint64_t numUsedMiniPages = 0;
+};
+
+/**
+ * A snapshot of the counters of a buffer manager, it is used to figure out how big the buffer pool and the pages of
+ * a node should be. The counters only go up, the rest describes the buffer pool at the time of the snapshot
+ */
+struct PDBBufferManagerStats {
+
+  // the size of a full page and the number of full pages in the buffer pool
+  uint64_t pageSize = 0;
+  uint64_t numPages = 0;
+
+  // the number of times a set page or an unpinned page was requested and how many of those had to be read from disk
+  uint64_t numPageRequests = 0;
+  uint64_t numPageReads = 0;
+
+  // the number of pages written to disk and the bytes that went to and came from the disk
+  uint64_t numPageWrites = 0;
+  uint64_t numBytesRead = 0;
+  uint64_t numBytesWritten = 0;
+
+  // the number of full pages that were evicted
+  uint64_t numEvictions = 0;
+
+  // the time the threads spent waiting for the pages somebody else was loading or writing and for the space somebody
+  // else was making, in nanoseconds
+  uint64_t pagesWaitNanos = 0;
+  uint64_t spaceWaitNanos = 0;
+
+  // the full pages that are free, the ones with a pinned page on them and the ones that can be evicted
+  uint64_t numFreeFullPages = 0;
+  uint64_t numPinnedFullPages = 0;
+  uint64_t numEvictableFullPages = 0;
+
+  // the use of the full pages of each size class, the first one is for mini pages of MIN_PAGE_SIZE
+  std::vector<PDBBufferManagerSizeClassStats> sizeClasses;
+
+  // the frontend only, the leases it granted to the backend and the ones it took back and the pages the backend has
+  uint64_t numLeasesGranted = 0;
+  uint64_t numLeasesRevoked = 0;
+  uint64_t numBackEndPages = 0;
+
+  // the frontend only, the pages it compressed and sent as they are over the wire, the bytes before and after the
+  // compression and the time it spent compressing and decompressing them, in nanoseconds
+  uint64_t numWireCompressed = 0;
+  uint64_t numWireBypassed = 0;
+  uint64_t numWireBytesIn = 0;
+  uint64_t numWireBytesOut = 0;
+  uint64_t wireCompressNanos = 0;
+  uint64_t wireDecompressNanos = 0;
+
+  /**
+   * Returns the fraction of the requested pages that did not have to be read from disk
+   */
+  double getHitRatio() const;
+
+  /**
+   * Returns the counters in a human readable form, one per line
+   */
+  std::string toString() const;
+};
+
+}
+
+#endif //PDB_PDBBUFFERMANAGERSTATS_H
@@ -0,0 +1,88 @@
+#ifndef PDB_PDBBUFFERMANAGERSTRIPEDIOENGINE_H
+#define PDB_PDBBUFFERMANAGERSTRIPEDIOENGINE_H
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include "PDBBufferManagerIOEngine.h"
+
+namespace pdb {
+
+/**
+ * Used when the files of the buffer manager are striped over multiple storage directories, usually one per drive.
+ * Every device gets its own engine so the requests of one drive never wait in the queue of another. A batch is split
+ * by the device of the requests, the calling thread does the part of the first device and each of the other parts
+ * is handed to the thread of its device, so all the drives work on the batch at the same time.
+ */
+class PDBBufferManagerStripedIOEngine : public PDBBufferManagerIOEngine {
+
+ public:
+
+  /**
+   * Starts a thread for each device
+   * @param engines - the engine of each device
+   */
+  explicit PDBBufferManagerStripedIOEngine(std::vector<PDBBufferManagerIOEnginePtr> engines);
+
+  /**
+   * Stops the threads
+   */
+  ~PDBBufferManagerStripedIOEngine() override;
+
+  void execute(std::vector<PDBBufferManagerIORequest> &requests) override;
+
+  /**
+   * Returns the number of devices
+   */
+  size_t getNumDevices();
+
+ private:
+
+  /**
+   * The part of a batch that goes to one device and the number of parts of its batch that are not done yet
+   */
+  struct PDBDeviceBatch {
+    std::vector<PDBBufferManagerIORequest> *requests;
+    size_t *numPending;
+  };
+
+  /**
+   * A device, its engine and the parts of the batches that are waiting for its thread
+   */
+  struct PDBDevice {
+    PDBBufferManagerIOEnginePtr engine;
+    std::deque<PDBDeviceBatch> queue;
+    std::condition_variable queueCV;
+    std::thread thread;
+  };
+
+  /**
+   * The loop of the thread of the device, it takes the parts of the batches from the queue and does them
+   */
+  void run(PDBDevice &device);
+
+  /**
+   * the devices, the engines and their threads
+   */
+  std::vector<std::unique_ptr<PDBDevice>> devices;
+
+  /**
+   * set to true when the threads need to finish
+   */
+  bool shutdown = false;
+
+  /**
+   * locks the queues
+   */
+  std::mutex m;
+
+  /**
+   * the callers wait here for their batch to finish
+   */
+  std::condition_variable doneCV;
+};
+
+}
+
+#endif //PDB_PDBBUFFERMANAGERSTRIPEDIOENGINE_H
@@ -0,0 +1,20 @@
+#ifndef PDB_PDBBUFFERMANAGERSYNCIOENGINE_H
+#define PDB_PDBBUFFERMANAGERSYNCIOENGINE_H
+
+#include "PDBBufferManagerIOEngine.h"
+
+namespace pdb {
+
+/**
+ * Does the requests one by one with pread and pwrite in the calling thread
+ */
+class PDBBufferManagerSyncIOEngine : public PDBBufferManagerIOEngine {
+
+ public:
+
+  void execute(std::vector<PDBBufferManagerIORequest> &requests) override;
+};
+
+}
+
+#endif //PDB_PDBBUFFERMANAGERSYNCIOENGINE_H
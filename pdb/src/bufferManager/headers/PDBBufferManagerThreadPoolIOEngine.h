@@ -0,0 +1,81 @@
+#ifndef PDB_PDBBUFFERMANAGERTHREADPOOLIOENGINE_H
+#define PDB_PDBBUFFERMANAGERTHREADPOOLIOENGINE_H
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include "PDBBufferManagerIOEngine.h"
+
+namespace pdb {
+
+/**
+ * Does the requests with pread and pwrite on a pool of threads so that the requests of a batch and the requests of
+ * different batches are done in parallel
+ */
+class PDBBufferManagerThreadPoolIOEngine : public PDBBufferManagerIOEngine {
+
+ public:
+
+  /**
+   * Starts the threads
+   * @param numThreads - the number of threads
+   */
+  explicit PDBBufferManagerThreadPoolIOEngine(size_t numThreads);
+
+  /**
+   * Stops the threads
+   */
+  ~PDBBufferManagerThreadPoolIOEngine() override;
+
+  void execute(std::vector<PDBBufferManagerIORequest> &requests) override;
+
+ private:
+
+  /**
+   * A request waiting in the queue and the number of requests of its batch that are not done yet
+   */
+  struct PDBQueuedRequest {
+    PDBBufferManagerIORequest *request;
+    size_t *numPending;
+  };
+
+  /**
+   * The loop of the threads, they take requests from the queue and do them
+   */
+  void run();
+
+  /**
+   * the threads that do the requests
+   */
+  std::vector<std::thread> threads;
+
+  /**
+   * the requests that are waiting for a thread
+   */
+  std::deque<PDBQueuedRequest> queue;
+
+  /**
+   * set to true when the threads need to finish
+   */
+  bool shutdown = false;
+
+  /**
+   * locks the queue
+   */
+  std::mutex m;
+
+  /**
+   * the threads wait here for requests
+   */
+  std::condition_variable queueCV;
+
+  /**
+   * the callers wait here for their batch to finish
+   */
+  std::condition_variable doneCV;
+};
+
+}
+
+#endif //PDB_PDBBUFFERMANAGERTHREADPOOLIOENGINE_H
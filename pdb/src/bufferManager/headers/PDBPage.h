@@ -2,6 +2,8 @@
 
 #include <memory>
 #include "PDBSet.h"
+#include "PDBBufferManagerCompression.h"
+#include "PDBPageAccessHint.h"
 #include <string>
 #include <mutex>
 #include <atomic>
@@ -26,6 +28,17 @@ typedef weak_ptr <PDBPage> PDBPageWeakPtr;
 struct PDBPageInfo {
   int64_t startPos = 0;
   int64_t numBytes = 0;
+
+  // if the page is compressed on disk the number of compressed bytes and the codec, the page still has room for
+  // all of its bytes at startPos so it can be written again
+  int64_t compressedBytes = 0;
+  PDBPageCompression compression = PDB_PAGE_COMPRESSION_NONE;
+
+  // the CRC32C checksum of the bytes that were written to disk, checked when the page is read back
+  uint32_t checksum = 0;
+
+  // the storage directory the page is written to, startPos is the position in the file in that directory
+  int64_t device = 0;
 };
 
 enum PDBPageStatus {
@@ -81,6 +94,11 @@ class PDBPage {
   // RAM may have changed
   void repin ();
 
+  // tells the buffer manager how the page is going to be used, the hint is taken into account the next time the
+  // page is unpinned
+  void setAccessHint (PDBPageAccessHint hint);
+  PDBPageAccessHint getAccessHint ();
+
   // create a page
   explicit PDBPage (PDBBufferManagerInterface &);
 
@@ -90,7 +108,7 @@ class PDBPage {
   void setSet (PDBSetPtr);
   unsigned numRefs ();
   PDBPageInfo &getLocation ();
-  PDBPageStatus &getStatus();
+  std::atomic<PDBPageStatus> &getStatus();
   void setPageNum (size_t);
   void setAnonymous (bool);
   bool isAnonymous ();
@@ -108,11 +126,11 @@ class PDBPage {
   // a pointer to the raw bytes
   void *bytes;
 
-  // the status of the page
-  PDBPageStatus status;
+  // the status of the page, this is atomic since the buffer manager checks it without holding its global lock
+  std::atomic<PDBPageStatus> status;
 
   // these are all pretty self-explanatory!
-  bool pinned = false;
+  std::atomic_bool pinned;
   std::atomic_bool dirty;
   unsigned refCount = 0;
   size_t pageNum = 0;
@@ -122,6 +140,18 @@ class PDBPage {
   PDBSetPtr whichSet = nullptr;
   PDBPageWeakPtr me;
 
+  // the position of the page in the pages of the slab of the full page it lives on
+  size_t slabPosition = 0;
+
+  // the lease the backend holds on the frame of the page, -1 if it has none
+  int64_t lease = -1;
+
+  // the job the memory of the page is charged to, -1 if it is not charged to any
+  int64_t job = -1;
+
+  // how the page is going to be used, decides how soon the full page it lives on is evicted
+  std::atomic<PDBPageAccessHint> hint;
+
   // pointer to the parent buffer manager
   PDBBufferManagerInterface& parent;
 
@@ -130,6 +160,7 @@ class PDBPage {
 
   friend class PDBPageHandleBase;
   friend class PDBBufferManagerImpl;
+  friend class PDBBufferManagerSlab;
   friend class PDBBufferManagerFrontEnd;
 
   template <class T>
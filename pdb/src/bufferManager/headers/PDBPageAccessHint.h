@@ -0,0 +1,23 @@
+#ifndef PDB_PDBPAGEACCESSHINT_H
+#define PDB_PDBPAGEACCESSHINT_H
+
+#include <cstdint>
+
+namespace pdb {
+
+/**
+ * Tells the buffer manager how a page is going to be used, so that it knows which pages to evict first. The hints
+ * are ordered from the pages we evict first to the pages we evict last. The values are sent from the backend to the
+ * frontend so they must not change
+ */
+enum PDBPageAccessHint : uint32_t {
+
+  PDB_PAGE_HINT_SEQUENTIAL_ONCE = 0,  // the page is read once by a scan, once it is unpinned nobody needs it
+  PDB_PAGE_HINT_TEMP_SPILL = 1,       // the page is written once and read back much later, it can go to disk
+  PDB_PAGE_HINT_NORMAL = 2,           // we know nothing about the page, the eviction policy decides
+  PDB_PAGE_HINT_HOT_REUSE = 3         // the page is accessed over and over, like the pages of a hash table
+};
+
+}
+
+#endif //PDB_PDBPAGEACCESSHINT_H
@@ -14,6 +14,7 @@
 #define PAGE_HANDLE_H
 
 #include <memory>
+#include <vector>
 #include "PDBPage.h"
 #include "PDBSet.h"
 #include <string>
@@ -78,6 +79,23 @@ class PDBPageHandleBase {
     page->repin();
   }
 
+  // tells the buffer manager how the page is going to be used, so it knows which pages to evict first. The hint
+  // is taken into account the next time the page is unpinned
+  void setAccessHint(PDBPageAccessHint hint) {
+    page->setAccessHint(hint);
+  }
+
+  PDBPageAccessHint getAccessHint() {
+    return page->getAccessHint();
+  }
+
+  // pins all the pages with a single call to the buffer manager they come from, this is cheaper than
+  // calling repin on each of them. All of the pages have to come from the same buffer manager
+  static void repinAll(std::vector<PDBPageHandle> &pages);
+
+  // unpins all the pages with a single call to the buffer manager they come from
+  static void unpinAll(std::vector<PDBPageHandle> &pages);
+
   // returns the size of the page. If this is frozen it will return the frozen size, if not it will return
   size_t getSize() {
     return page->getSize();
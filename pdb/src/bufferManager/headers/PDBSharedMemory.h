@@ -7,6 +7,19 @@
 
 #include <memory>
 
+// what kind of pages back the shared memory
+enum PDBHugePageMode {
+
+  // regular pages
+  PDB_REGULAR_PAGES,
+
+  // huge pages we got from MAP_HUGETLB
+  PDB_HUGETLB_PAGES,
+
+  // regular pages we asked the kernel to merge into transparent huge pages with madvise
+  PDB_TRANSPARENT_HUGE_PAGES
+};
+
 struct PDBSharedMemory {
 
   // pointer to the shared memory
@@ -18,6 +31,12 @@ struct PDBSharedMemory {
   // the number of pages of RAM in the buffer
   size_t numPages;
 
+  // the size of the mapping, it might be bigger than pageSize * numPages since huge pages need to be mapped whole
+  size_t mappedSize;
+
+  // what kind of pages back the shared memory
+  PDBHugePageMode hugePageMode;
+
 };
 
 #endif //PDB_PDBSTORAGE_H
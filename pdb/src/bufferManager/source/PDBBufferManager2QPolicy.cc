@@ -0,0 +1,102 @@
+#include <algorithm>
+#include "PDBBufferManager2QPolicy.h"
+
+namespace pdb {
+
+PDBBufferManager2QPolicy::PDBBufferManager2QPolicy(size_t numPages) : maxProbation(std::max<size_t>(numPages / 4, 1)) {}
+
+void PDBBufferManager2QPolicy::unpinned(void *page) {
+
+  // pages that were reused go to the protected queue the rest to the probation queue
+  bool isReused = reused.find(page) != reused.end();
+  auto &queue = isReused ? protectedPages : probation;
+
+  // add it to the end of the queue
+  queue.push_back(page);
+  positions[page] = std::make_pair(isReused, std::prev(queue.end()));
+}
+
+void PDBBufferManager2QPolicy::pinned(void *page) {
+
+  // the page is not evictable anymore
+  remove(page);
+
+  // mark it as reused
+  reused.insert(page);
+}
+
+void PDBBufferManager2QPolicy::reloaded(void *page) {
+
+  // the page is pinned so it is not in a queue, just mark it as reused
+  reused.insert(page);
+}
+
+void PDBBufferManager2QPolicy::freed(void *page) {
+
+  // forget the page
+  remove(page);
+  reused.erase(page);
+}
+
+void *PDBBufferManager2QPolicy::evict() {
+
+  // evict from the probation queue if it is full or if there is nothing protected, the pages that are being loaded
+  // are pinned and not in the queue yet so a full probation queue has to give up a page to make room for them
+  auto &queue = (probation.size() >= maxProbation || protectedPages.empty()) ? probation : protectedPages;
+
+  // if there are no pages we are done here
+  if (queue.empty()) {
+    return nullptr;
+  }
+
+  // grab the oldest page of the queue
+  auto page = queue.front();
+
+  // forget the page since it is going to be recycled
+  freed(page);
+
+  return page;
+}
+
+std::vector<void *> PDBBufferManager2QPolicy::getNextVictims(size_t numPages) {
+
+  // walk both queues the way evict would take the pages from them
+  std::vector<void *> victims;
+  size_t probationSize = probation.size();
+  auto probationIt = probation.begin();
+  auto protectedIt = protectedPages.begin();
+  while (victims.size() < numPages) {
+
+    // take from the probation queue if it is full or if there is nothing protected left
+    if (probationIt != probation.end() && (probationSize >= maxProbation || protectedIt == protectedPages.end())) {
+      victims.push_back(*probationIt++);
+      probationSize--;
+    } else if (protectedIt != protectedPages.end()) {
+      victims.push_back(*protectedIt++);
+    } else {
+      break;
+    }
+  }
+
+  return victims;
+}
+
+size_t PDBBufferManager2QPolicy::numEvictable() {
+  return positions.size();
+}
+
+void PDBBufferManager2QPolicy::remove(void *page) {
+
+  // check if the page is in a queue
+  auto it = positions.find(page);
+  if (it == positions.end()) {
+    return;
+  }
+
+  // remove it from the queue
+  auto &queue = it->second.first ? protectedPages : probation;
+  queue.erase(it->second.second);
+  positions.erase(it);
+}
+
+}
@@ -0,0 +1,254 @@
+#include <cstring>
+#include "PDBBufferManagerChecksum.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <nmmintrin.h>
+#define PDB_HAS_SSE42_CRC32
+#endif
+
+namespace pdb {
+
+namespace {
+
+// the reversed CRC32C (Castagnoli) polynomial
+const uint32_t CRC32C_POLYNOMIAL = 0x82F63B78u;
+
+// the hardware implementation checksums three blocks of these sizes at the same time and then combines the checksums
+const size_t CRC32C_LONG_BLOCK = 8192;
+const size_t CRC32C_SHORT_BLOCK = 256;
+
+/**
+ * Multiplies the 32x32 bit matrix over GF(2) with the vector
+ */
+uint32_t gf2MatrixTimes(const uint32_t *matrix, uint32_t vector) {
+
+  uint32_t sum = 0;
+  while (vector != 0) {
+    if (vector & 1u) {
+      sum ^= *matrix;
+    }
+    vector >>= 1;
+    matrix++;
+  }
+  return sum;
+}
+
+/**
+ * Squares the 32x32 bit matrix over GF(2)
+ */
+void gf2MatrixSquare(uint32_t *square, const uint32_t *matrix) {
+  for (int n = 0; n < 32; ++n) {
+    square[n] = gf2MatrixTimes(matrix, matrix[n]);
+  }
+}
+
+/**
+ * The tables of the software implementation, it processes eight bytes at a time so it needs one table per byte.
+ * The shift tables move a checksum over a block of zeros so the checksums of the blocks can be combined
+ */
+struct CRC32CTables {
+
+  CRC32CTables() {
+
+    // the table of a single byte
+    for (uint32_t i = 0; i < 256; ++i) {
+      uint32_t crc = i;
+      for (int j = 0; j < 8; ++j) {
+        crc = (crc >> 1) ^ ((crc & 1u) ? CRC32C_POLYNOMIAL : 0);
+      }
+      table[0][i] = crc;
+    }
+
+    // the tables of the byte k positions back
+    for (uint32_t i = 0; i < 256; ++i) {
+      for (int k = 1; k < 8; ++k) {
+        table[k][i] = (table[k - 1][i] >> 8) ^ table[0][table[k - 1][i] & 0xFFu];
+      }
+    }
+
+    // the tables that shift over the blocks
+    makeShiftTable(longShift, CRC32C_LONG_BLOCK);
+    makeShiftTable(shortShift, CRC32C_SHORT_BLOCK);
+  }
+
+  /**
+   * Makes the table that shifts a checksum over the number of zero bytes, it has to be a power of two
+   */
+  static void makeShiftTable(uint32_t shift[4][256], size_t numBytes) {
+
+    // the operator for a single zero bit
+    uint32_t odd[32];
+    uint32_t even[32];
+    odd[0] = CRC32C_POLYNOMIAL;
+    for (int n = 1; n < 32; ++n) {
+      odd[n] = 1u << (n - 1);
+    }
+
+    // square it to get the operators for two and four zero bits
+    gf2MatrixSquare(even, odd);
+    gf2MatrixSquare(odd, even);
+
+    // keep squaring it, the first square gives us the operator for one zero byte
+    uint32_t *op = odd;
+    for (;;) {
+      gf2MatrixSquare(even, odd);
+      op = even;
+      numBytes >>= 1;
+      if (numBytes == 0) {
+        break;
+      }
+      gf2MatrixSquare(odd, even);
+      op = odd;
+      numBytes >>= 1;
+      if (numBytes == 0) {
+        break;
+      }
+    }
+
+    // apply the operator to every byte of the checksum
+    for (uint32_t n = 0; n < 256; ++n) {
+      shift[0][n] = gf2MatrixTimes(op, n);
+      shift[1][n] = gf2MatrixTimes(op, n << 8);
+      shift[2][n] = gf2MatrixTimes(op, n << 16);
+      shift[3][n] = gf2MatrixTimes(op, n << 24);
+    }
+  }
+
+  /**
+   * Shifts the checksum with the table
+   */
+  static uint32_t shift(const uint32_t table[4][256], uint32_t crc) {
+    return table[0][crc & 0xFFu] ^ table[1][(crc >> 8) & 0xFFu] ^ table[2][(crc >> 16) & 0xFFu] ^ table[3][crc >> 24];
+  }
+
+  uint32_t table[8][256];
+  uint32_t longShift[4][256];
+  uint32_t shortShift[4][256];
+};
+
+const CRC32CTables tables;
+
+#ifdef PDB_HAS_SSE42_CRC32
+
+/**
+ * Checksums three blocks of the size at the same time, the crc32 instruction takes three cycles but a new one can
+ * start every cycle, so this is about three times faster than going through the bytes one block after the other
+ */
+__attribute__((target("sse4.2")))
+uint64_t crc32cBlocks(uint64_t crc, const unsigned char *&data, size_t &numBytes, size_t blockSize, const uint32_t shift[4][256]) {
+
+  while (numBytes >= blockSize * 3) {
+
+    uint64_t crc1 = 0;
+    uint64_t crc2 = 0;
+    const unsigned char *end = data + blockSize;
+    do {
+      uint64_t word0, word1, word2;
+      memcpy(&word0, data, sizeof(uint64_t));
+      memcpy(&word1, data + blockSize, sizeof(uint64_t));
+      memcpy(&word2, data + blockSize * 2, sizeof(uint64_t));
+      crc = _mm_crc32_u64(crc, word0);
+      crc1 = _mm_crc32_u64(crc1, word1);
+      crc2 = _mm_crc32_u64(crc2, word2);
+      data += sizeof(uint64_t);
+    } while (data < end);
+
+    // combine them
+    crc = CRC32CTables::shift(shift, (uint32_t) crc) ^ (uint32_t) crc1;
+    crc = CRC32CTables::shift(shift, (uint32_t) crc) ^ (uint32_t) crc2;
+    data += blockSize * 2;
+    numBytes -= blockSize * 3;
+  }
+
+  return crc;
+}
+
+__attribute__((target("sse4.2")))
+uint32_t crc32cHardware(const void *bytes, size_t numBytes) {
+
+  auto *data = (const unsigned char *) bytes;
+  uint64_t crc = 0xFFFFFFFFu;
+
+  // the pages are large so most of the bytes go through the interleaved blocks
+  crc = crc32cBlocks(crc, data, numBytes, CRC32C_LONG_BLOCK, tables.longShift);
+  crc = crc32cBlocks(crc, data, numBytes, CRC32C_SHORT_BLOCK, tables.shortShift);
+
+  // then eight bytes at a time
+  while (numBytes >= sizeof(uint64_t)) {
+    uint64_t word;
+    memcpy(&word, data, sizeof(word));
+    crc = _mm_crc32_u64(crc, word);
+    data += sizeof(uint64_t);
+    numBytes -= sizeof(uint64_t);
+  }
+
+  // the rest one byte at a time
+  auto crc32 = (uint32_t) crc;
+  while (numBytes-- > 0) {
+    crc32 = _mm_crc32_u8(crc32, *data++);
+  }
+
+  return crc32 ^ 0xFFFFFFFFu;
+}
+
+bool detectHardwareCRC32() {
+
+  // the features might not be detected yet if we are initialized before the constructors of the runtime
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("sse4.2");
+}
+
+const bool hasHardwareCRC32 = detectHardwareCRC32();
+
+#else
+
+const bool hasHardwareCRC32 = false;
+
+#endif
+
+}
+
+uint32_t PDBBufferManagerChecksum::crc32c(const void *bytes, size_t numBytes) {
+
+#ifdef PDB_HAS_SSE42_CRC32
+  if (hasHardwareCRC32) {
+    return crc32cHardware(bytes, numBytes);
+  }
+#endif
+
+  return crc32cSoftware(bytes, numBytes);
+}
+
+uint32_t PDBBufferManagerChecksum::crc32cSoftware(const void *bytes, size_t numBytes) {
+
+  auto *data = (const unsigned char *) bytes;
+  uint32_t crc = 0xFFFFFFFFu;
+
+  // go eight bytes at a time, each byte is looked up in its own table
+  while (numBytes >= 8) {
+    uint32_t low = crc ^ ((uint32_t) data[0] | (uint32_t) data[1] << 8 | (uint32_t) data[2] << 16 | (uint32_t) data[3] << 24);
+    crc = tables.table[7][low & 0xFFu] ^
+          tables.table[6][(low >> 8) & 0xFFu] ^
+          tables.table[5][(low >> 16) & 0xFFu] ^
+          tables.table[4][low >> 24] ^
+          tables.table[3][data[4]] ^
+          tables.table[2][data[5]] ^
+          tables.table[1][data[6]] ^
+          tables.table[0][data[7]];
+    data += 8;
+    numBytes -= 8;
+  }
+
+  // the rest one byte at a time
+  while (numBytes-- > 0) {
+    crc = (crc >> 8) ^ tables.table[0][(crc ^ *data++) & 0xFFu];
+  }
+
+  return crc ^ 0xFFFFFFFFu;
+}
+
+bool PDBBufferManagerChecksum::isHardwareAccelerated() {
+  return hasHardwareCRC32;
+}
+
+}
@@ -0,0 +1,146 @@
+#include <atomic>
+#include <iostream>
+#include <snappy.h>
+#include "PDBBufferManagerCompression.h"
+
+// lz4 and zstd are optional, the build defines these if it found them
+#ifdef PDB_HAS_LZ4
+#include <lz4.h>
+#endif
+
+#ifdef PDB_HAS_ZSTD
+#include <zstd.h>
+#endif
+
+// the level we compress with zstd, the pages are compressed on the eviction path so we favour speed
+#ifndef PDB_ZSTD_COMPRESSION_LEVEL
+#define PDB_ZSTD_COMPRESSION_LEVEL 1
+#endif
+
+namespace pdb {
+
+bool PDBBufferManagerCompression::fromString(const std::string &name, PDBPageCompression &compression) {
+
+  if (name == "none") {
+    compression = PDB_PAGE_COMPRESSION_NONE;
+  } else if (name == "snappy") {
+    compression = PDB_PAGE_COMPRESSION_SNAPPY;
+  } else if (name == "lz4") {
+    compression = PDB_PAGE_COMPRESSION_LZ4;
+  } else if (name == "zstd") {
+    compression = PDB_PAGE_COMPRESSION_ZSTD;
+  } else {
+    return false;
+  }
+
+  return true;
+}
+
+std::string PDBBufferManagerCompression::toString(PDBPageCompression compression) {
+
+  switch (compression) {
+    case PDB_PAGE_COMPRESSION_NONE: return "none";
+    case PDB_PAGE_COMPRESSION_SNAPPY: return "snappy";
+    case PDB_PAGE_COMPRESSION_LZ4: return "lz4";
+    case PDB_PAGE_COMPRESSION_ZSTD: return "zstd";
+  }
+
+  return "unknown";
+}
+
+bool PDBBufferManagerCompression::isSupported(PDBPageCompression compression) {
+
+  switch (compression) {
+    case PDB_PAGE_COMPRESSION_NONE:
+    case PDB_PAGE_COMPRESSION_SNAPPY: return true;
+#ifdef PDB_HAS_LZ4
+    case PDB_PAGE_COMPRESSION_LZ4: return true;
+#endif
+#ifdef PDB_HAS_ZSTD
+    case PDB_PAGE_COMPRESSION_ZSTD: return true;
+#endif
+    default: return false;
+  }
+}
+
+PDBPageCompression PDBBufferManagerCompression::getSupported(PDBPageCompression compression) {
+
+  // do we have the codec
+  if (isSupported(compression)) {
+    return compression;
+  }
+
+  // say that we use snappy instead, but only once for each codec since it is asked for every set
+  static std::atomic<uint32_t> warned{0};
+  uint32_t bit = 1u << (uint32_t) compression;
+  if ((warned.fetch_or(bit) & bit) == 0) {
+    std::cerr << "We were not built with the " << toString(compression) << " codec, the pages are compressed with snappy instead.\n";
+  }
+
+  return PDB_PAGE_COMPRESSION_SNAPPY;
+}
+
+size_t PDBBufferManagerCompression::getMaxCompressedSize(PDBPageCompression compression, size_t numBytes) {
+
+  switch (compression) {
+    case PDB_PAGE_COMPRESSION_SNAPPY: return snappy::MaxCompressedLength(numBytes);
+#ifdef PDB_HAS_LZ4
+    case PDB_PAGE_COMPRESSION_LZ4: return (size_t) LZ4_compressBound((int) numBytes);
+#endif
+#ifdef PDB_HAS_ZSTD
+    case PDB_PAGE_COMPRESSION_ZSTD: return ZSTD_compressBound(numBytes);
+#endif
+    default: return numBytes;
+  }
+}
+
+size_t PDBBufferManagerCompression::compress(PDBPageCompression compression, const char *in, size_t inSize, char *out, size_t outSize) {
+
+  switch (compression) {
+
+    case PDB_PAGE_COMPRESSION_SNAPPY: {
+      size_t compressedSize = 0;
+      snappy::RawCompress(in, inSize, out, &compressedSize);
+      return compressedSize;
+    }
+#ifdef PDB_HAS_LZ4
+    case PDB_PAGE_COMPRESSION_LZ4: {
+      int compressedSize = LZ4_compress_default(in, out, (int) inSize, (int) outSize);
+      return compressedSize > 0 ? (size_t) compressedSize : 0;
+    }
+#endif
+#ifdef PDB_HAS_ZSTD
+    case PDB_PAGE_COMPRESSION_ZSTD: {
+      size_t compressedSize = ZSTD_compress(out, outSize, in, inSize, PDB_ZSTD_COMPRESSION_LEVEL);
+      return ZSTD_isError(compressedSize) ? 0 : compressedSize;
+    }
+#endif
+    default: return 0;
+  }
+}
+
+bool PDBBufferManagerCompression::decompress(PDBPageCompression compression, const char *in, size_t inSize, char *out, size_t outSize) {
+
+  switch (compression) {
+
+    case PDB_PAGE_COMPRESSION_SNAPPY: {
+      size_t uncompressedSize = 0;
+      return snappy::GetUncompressedLength(in, inSize, &uncompressedSize) &&
+             uncompressedSize <= outSize &&
+             snappy::RawUncompress(in, inSize, out);
+    }
+#ifdef PDB_HAS_LZ4
+    case PDB_PAGE_COMPRESSION_LZ4: {
+      return LZ4_decompress_safe(in, out, (int) inSize, (int) outSize) >= 0;
+    }
+#endif
+#ifdef PDB_HAS_ZSTD
+    case PDB_PAGE_COMPRESSION_ZSTD: {
+      return !ZSTD_isError(ZSTD_decompress(out, outSize, in, inSize));
+    }
+#endif
+    default: return false;
+  }
+}
+
+}
@@ -60,10 +60,10 @@ void PDBBufferManagerDebugFrontend::logTimeline(const uint64_t &tick) {
 
   // write out the number of pages
   uint64_t numPages = 0;
-  for(const auto &pages : constituentPages) {
+  for(auto &slab : slabs) {
 
     // go through the mini pages on the page
-    for(const auto &page : pages.second) {
+    for(const auto &page : slab.getPages()) {
 
       // if it is not unloading add it
       if(page->getBytes() != nullptr) {
@@ -74,10 +74,10 @@ void PDBBufferManagerDebugFrontend::logTimeline(const uint64_t &tick) {
   write(debugTimelineFile, &numPages, sizeof(numPages));
 
   // write out the page info
-  for(const auto &pages : constituentPages) {
+  for(auto &slab : slabs) {
 
     // write out all the mini pages
-    for(const auto &page : pages.second) {
+    for(const auto &page : slab.getPages()) {
 
       // if the page is not unloading we skip it
       if(page->getBytes() == nullptr) {
@@ -118,32 +118,42 @@ void PDBBufferManagerDebugFrontend::logTimeline(const uint64_t &tick) {
   }
 
   // write out the number of empty pages
-  uint64_t numEmptyPages = emptyFullPages.size();
-  for(const auto &miniPages : emptyMiniPages) { numEmptyPages += miniPages.size();}
+  uint64_t numEmptyPages = 0;
+  for(const auto &arena : arenas) { numEmptyPages += arena.emptyFullPages.size(); }
+  for(auto &slab : slabs) {
+    for(size_t i = 0; i < slab.getNumMiniPages(); ++i) { numEmptyPages += slab.isFree(i) ? 1 : 0; }
+  }
   write(debugTimelineFile, &numEmptyPages, sizeof(numEmptyPages));
 
   // write out the empty full pages
-  for(const auto &emptyFullPage : emptyFullPages) {
+  for(const auto &arena : arenas) {
+    for(const auto &emptyFullPage : arena.emptyFullPages) {
 
-    // figure out the offset
-    uint64_t offset = (uint64_t)emptyFullPage - (uint64_t)sharedMemory.memory;
-    write(debugTimelineFile, &offset, sizeof(offset));
+      // figure out the offset
+      uint64_t offset = (uint64_t)emptyFullPage - (uint64_t)sharedMemory.memory;
+      write(debugTimelineFile, &offset, sizeof(offset));
 
-    // empty full page has the maximum page size
-    write(debugTimelineFile, &sharedMemory.pageSize, sizeof(sharedMemory.pageSize));
+      // empty full page has the maximum page size
+      write(debugTimelineFile, &sharedMemory.pageSize, sizeof(sharedMemory.pageSize));
+    }
   }
 
   // write out the empty mini pages
-  for(auto i = 0; i < emptyMiniPages.size(); ++i) {
+  for(auto &slab : slabs) {
 
     // figure out the size of the page
-    uint64_t pageSize = MIN_PAGE_SIZE << i;
+    uint64_t pageSize = MIN_PAGE_SIZE << slab.getSizeClass();
 
-    // write out the mini pages of this size
-    for(const auto &emptyPage : emptyMiniPages[i]) {
+    // write out the free mini pages of the slab
+    for(size_t i = 0; i < slab.getNumMiniPages(); ++i) {
+
+      // skip the used ones
+      if(!slab.isFree(i)) {
+        continue;
+      }
 
       // figure out the offset
-      uint64_t offset = (uint64_t)emptyPage - (uint64_t)sharedMemory.memory;
+      uint64_t offset = (uint64_t)slab.getMiniPage(i) - (uint64_t)sharedMemory.memory;
       write(debugTimelineFile, &offset, sizeof(offset));
 
       // empty full page has the maximum page size
@@ -461,6 +471,74 @@ void PDBBufferManagerDebugFrontend::registerHandlers(PDBServer &forMe) {
             return ret;
           }));
 
+  forMe.registerHandler(BufGetPagesRequest_TYPEID,
+      make_shared<pdb::HeapRequestHandler<BufGetPagesRequest>>(
+          [&](Handle<BufGetPagesRequest> request, PDBCommunicatorPtr sendUsingMe) {
+
+            // call the method to handle it
+            auto ret = handleGetPagesRequest(request, sendUsingMe);
+
+            {
+              // lock the buffer manager to avoid concurrency issues
+              std::unique_lock<std::mutex> bufferLock(PDBBufferManagerImpl::m);
+
+              // lock the timeline file
+              std::unique_lock<std::mutex> lck(m);
+
+              // get these
+              std::string db = *request->databaseName;
+              std::string set = *request->setName;
+
+              // log the operation for each page
+              for(int i = 0; i < request->pageNumbers.size(); ++i) {
+
+                // increment the debug tick
+                uint64_t tick = debugTick++;
+
+                // log the operation
+                logOperation(tick, BufferManagerOperationType::HANDLE_GET_PAGE, db, set, request->pageNumbers[i], 0, request->currentID);
+
+                // log the timeline
+                logTimeline(tick);
+              }
+            }
+
+            // return the result
+            return ret;
+          }));
+
+  forMe.registerHandler(BufGetAnonymousPagesRequest_TYPEID,
+      make_shared<pdb::HeapRequestHandler<BufGetAnonymousPagesRequest>>(
+          [&](Handle<BufGetAnonymousPagesRequest> request, PDBCommunicatorPtr sendUsingMe) {
+
+            // call the method to handle it
+            auto ret = handleGetAnonymousPagesRequest(request, sendUsingMe);
+
+            {
+              // lock the buffer manager to avoid concurrency issues
+              std::unique_lock<std::mutex> bufferLock(PDBBufferManagerImpl::m);
+
+              // lock the timeline file
+              std::unique_lock<std::mutex> lck(m);
+
+              // log the operation for each page
+              for(size_t i = 0; i < request->numPages; ++i) {
+
+                // increment the debug tick
+                uint64_t tick = debugTick++;
+
+                // log the operation
+                logOperation(tick, BufferManagerOperationType::HANDLE_GET_PAGE, "", "", 0, request->size, request->currentID);
+
+                // log the timeline
+                logTimeline(tick);
+              }
+            }
+
+            // return the result
+            return ret;
+          }));
+
   forMe.registerHandler(BufReturnPageRequest_TYPEID,
       make_shared<pdb::HeapRequestHandler<BufReturnPageRequest>>(
           [&](Handle<BufReturnPageRequest> request, PDBCommunicatorPtr sendUsingMe) {
@@ -611,6 +689,85 @@ void PDBBufferManagerDebugFrontend::registerHandlers(PDBServer &forMe) {
           // return the result
           return ret;
       }));
+
+  forMe.registerHandler(BufPinPagesRequest_TYPEID,
+      make_shared<pdb::HeapRequestHandler<BufPinPagesRequest>>(
+          [&](Handle<BufPinPagesRequest> request, PDBCommunicatorPtr sendUsingMe) {
+
+            // call the method to handle it
+            auto ret =  handlePinPagesRequest(request, sendUsingMe);
+
+            {
+              // lock the buffer manager to avoid concurrency issues
+              std::unique_lock<std::mutex> bufferLock(PDBBufferManagerImpl::m);
+
+              // lock the timeline file
+              std::unique_lock<std::mutex> lck(m);
+
+              // grab the database and set
+              std::string db = request->isAnonymous ? "" : *request->databaseName;
+              std::string set = request->isAnonymous ? "" : *request->setName;
+
+              // log the operation for each page
+              for(int i = 0; i < request->pageNumbers.size(); ++i) {
+
+                // increment the debug tick
+                uint64_t tick = debugTick++;
+
+                // log the operation
+                logOperation(tick, BufferManagerOperationType::HANDLE_PIN_PAGE, db, set, request->pageNumbers[i], 0,  request->currentID);
+
+                // log the timeline
+                logTimeline(tick);
+              }
+            }
+
+            // return the result
+            return ret;
+      }));
+
+  forMe.registerHandler(BufUnpinPagesRequest_TYPEID,
+      make_shared<pdb::HeapRequestHandler<BufUnpinPagesRequest>>(
+          [&](Handle<BufUnpinPagesRequest> request, PDBCommunicatorPtr sendUsingMe) {
+
+          // call the method to handle it
+          auto ret =  handleUnpinPagesRequest(request, sendUsingMe);
+          {
+            // lock the buffer manager to avoid concurrency issues
+            std::unique_lock<std::mutex> bufferLock(PDBBufferManagerImpl::m);
+
+            // lock the timeline file
+            std::unique_lock<std::mutex> lck(m);
+
+            // grab the database and set
+            std::string db = request->isAnonymous ? "" : *request->databaseName;
+            std::string set = request->isAnonymous ? "" : *request->setName;
+
+            // log the operation for each page
+            for(int i = 0; i < request->pageNumbers.size(); ++i) {
+
+              // increment the debug tick
+              uint64_t tick = debugTick++;
+
+              // log the operation
+              logOperation(tick, BufferManagerOperationType::HANDLE_UNPIN_PAGE, db, set, request->pageNumbers[i], 0, request->currentID);
+
+              // log the timeline
+              logTimeline(tick);
+            }
+          }
+
+          // return the result
+          return ret;
+      }));
+
+  forMe.registerHandler(BufGetStatsRequest_TYPEID,
+      make_shared<pdb::HeapRequestHandler<BufGetStatsRequest>>(
+          [&](Handle<BufGetStatsRequest> request, PDBCommunicatorPtr sendUsingMe) {
+
+          // the counters are not an operation on a page so there is nothing to log
+          return handleGetStatsRequest(request, sendUsingMe);
+      }));
 }
 
 PDBBufferManagerInterfacePtr PDBBufferManagerDebugFrontend::getBackEnd() {
@@ -0,0 +1,23 @@
+#include <stdexcept>
+#include "PDBBufferManagerEvictionPolicy.h"
+#include "PDBBufferManagerLRUPolicy.h"
+#include "PDBBufferManager2QPolicy.h"
+
+namespace pdb {
+
+PDBBufferManagerEvictionPolicyPtr PDBBufferManagerEvictionPolicy::create(const std::string &name, size_t numPages) {
+
+  // the least recently used policy
+  if (name == "lru") {
+    return std::make_shared<PDBBufferManagerLRUPolicy>();
+  }
+
+  // the scan resistant policy
+  if (name == "2q") {
+    return std::make_shared<PDBBufferManager2QPolicy>(numPages);
+  }
+
+  throw std::runtime_error("Unknown eviction policy " + name + ", the supported policies are lru and 2q");
+}
+
+}
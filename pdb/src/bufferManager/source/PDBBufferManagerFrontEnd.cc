@@ -5,6 +5,8 @@
 #include <BufGetPageRequest.h>
 #include <PDBBufferManagerBackEnd.h>
 #include <BufGetAnonymousPageRequest.h>
+#include <BufGetPagesRequest.h>
+#include <BufGetAnonymousPagesRequest.h>
 #include <PagedRequest.h>
 #include <BufGetPageResult.h>
 #include <SimpleRequestResult.h>
@@ -13,9 +15,14 @@
 #include <BufFreezeSizeRequest.h>
 #include <BufPinPageRequest.h>
 #include <BufUnpinPageRequest.h>
+#include <BufPinPagesRequest.h>
+#include <BufUnpinPagesRequest.h>
 #include <BufPinPageResult.h>
+#include <BufGetStatsRequest.h>
 #include <HeapRequestHandler.h>
 #include <BufForwardPageRequest.h>
+#include <GenericWork.h>
+#include <PDBWireCompression.h>
 
 pdb::PDBBufferManagerFrontEnd::PDBBufferManagerFrontEnd(std::string tempFileIn, size_t pageSizeIn, size_t numPagesIn, std::string metaFile, std::string storageLocIn) {
 
@@ -23,6 +30,15 @@ pdb::PDBBufferManagerFrontEnd::PDBBufferManagerFrontEnd(std::string tempFileIn,
   initialize(std::move(tempFileIn), pageSizeIn, numPagesIn, std::move(metaFile), std::move(storageLocIn));
 }
 
+pdb::PDBBufferManagerFrontEnd::~PDBBufferManagerFrontEnd() {
+
+  // stop serving the ring if we still are
+  cleanup();
+
+  // take back the pages the backend still has, while the leases they update are still around
+  sentPages.clear();
+}
+
 void pdb::PDBBufferManagerFrontEnd::init() {
 
   // init the logger
@@ -30,6 +46,279 @@ void pdb::PDBBufferManagerFrontEnd::init() {
   logger = make_shared<pdb::PDBLogger>("PDBStorageManagerFrontend.log");
 }
 
+void pdb::PDBBufferManagerFrontEnd::cleanup() {
+
+  // if we never started serving the ring we are done, the copy of the frontend in the backend process never does
+  if (numRingWorkers == 0) {
+    return;
+  }
+
+  // close the ring and wait for the workers to finish
+  ring->close();
+  while (numRingWorkersDone < numRingWorkers) {
+    ringBuzzer->wait();
+  }
+  numRingWorkers = 0;
+}
+
+void pdb::PDBBufferManagerFrontEnd::serveRing() {
+
+  int64_t slot;
+  while ((slot = ring->waitForRequest()) != -1) {
+
+    // the responder writes the response into the slot of the request
+    auto responder = ring->getResponder(slot);
+
+    // call the method to handle it
+    std::pair<bool, std::string> res;
+    switch (ring->getRequestType(slot)) {
+
+      case BufGetPageRequest_TYPEID: {
+        auto request = ring->getRequest<BufGetPageRequest>(slot);
+        res = handleGetPageRequest(request, responder);
+        break;
+      }
+      case BufGetAnonymousPageRequest_TYPEID: {
+        auto request = ring->getRequest<BufGetAnonymousPageRequest>(slot);
+        res = handleGetAnonymousPageRequest(request, responder);
+        break;
+      }
+      case BufGetPagesRequest_TYPEID: {
+        auto request = ring->getRequest<BufGetPagesRequest>(slot);
+        res = handleGetPagesRequest(request, responder);
+        break;
+      }
+      case BufGetAnonymousPagesRequest_TYPEID: {
+        auto request = ring->getRequest<BufGetAnonymousPagesRequest>(slot);
+        res = handleGetAnonymousPagesRequest(request, responder);
+        break;
+      }
+      case BufReturnPageRequest_TYPEID: {
+        auto request = ring->getRequest<BufReturnPageRequest>(slot);
+        res = handleReturnPageRequest(request, responder);
+        break;
+      }
+      case BufReturnAnonPageRequest_TYPEID: {
+        auto request = ring->getRequest<BufReturnAnonPageRequest>(slot);
+        res = handleReturnAnonPageRequest(request, responder);
+        break;
+      }
+      case BufFreezeSizeRequest_TYPEID: {
+        auto request = ring->getRequest<BufFreezeSizeRequest>(slot);
+        res = handleFreezeSizeRequest(request, responder);
+        break;
+      }
+      case BufPinPageRequest_TYPEID: {
+        auto request = ring->getRequest<BufPinPageRequest>(slot);
+        res = handlePinPageRequest(request, responder);
+        break;
+      }
+      case BufUnpinPageRequest_TYPEID: {
+        auto request = ring->getRequest<BufUnpinPageRequest>(slot);
+        res = handleUnpinPageRequest(request, responder);
+        break;
+      }
+      case BufPinPagesRequest_TYPEID: {
+        auto request = ring->getRequest<BufPinPagesRequest>(slot);
+        res = handlePinPagesRequest(request, responder);
+        break;
+      }
+      case BufUnpinPagesRequest_TYPEID: {
+        auto request = ring->getRequest<BufUnpinPagesRequest>(slot);
+        res = handleUnpinPagesRequest(request, responder);
+        break;
+      }
+      default: {
+        res = std::make_pair(false, "Unknown request type " + std::to_string(ring->getRequestType(slot)) + " in the buffer manager ring.");
+      }
+    }
+
+    // log the error if there is one
+    if (!res.first) {
+      logger->error(res.second);
+    }
+
+    // hand the response back to the backend
+    ring->respond(slot);
+  }
+}
+
+int64_t pdb::PDBBufferManagerFrontEnd::grantLease(const pdb::PDBPageHandle &page) {
+
+  // the key of the page
+  auto key = std::make_pair(page->getSet(), page->whichPage());
+
+  // lock the leases
+  unique_lock<mutex> lck(leaseMutex);
+
+  // if the page already has a lease the backend is not using it since it asked us for the page, so we release it
+  auto it = leasedPages.find(key);
+  if (it != leasedPages.end()) {
+    leases->release(it->second.first);
+    leasedPages.erase(it);
+  }
+
+  // grant the lease on the frame
+  auto lease = leases->grant((uint64_t) page->page->bytes - (uint64_t) sharedMemory.memory);
+  if (lease != -1) {
+    leasedPages[key] = std::make_pair(lease, page->page);
+    numLeasesGranted.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  return lease;
+}
+
+void pdb::PDBBufferManagerFrontEnd::endLease(const std::pair<PDBSetPtr, size_t> &key, bool keepPinned) {
+
+  PDBPagePtr unpinMe;
+  {
+    // lock the leases
+    unique_lock<mutex> lck(leaseMutex);
+
+    // if there is no lease we are done
+    auto it = leasedPages.find(key);
+    if (it == leasedPages.end()) {
+      return;
+    }
+
+    // if the backend unpinned the page through the lease we have to unpin it, otherwise we just release the lease
+    bool isDirty;
+    PDBPageAccessHint hint;
+    if (leases->revoke(it->second.first, isDirty, hint)) {
+
+      // update the dirty bit and the hint
+      if (isDirty) {
+        it->second.second->setDirty();
+      }
+      it->second.second->setAccessHint(hint);
+
+      unpinMe = it->second.second;
+      numLeasesRevoked.fetch_add(1, std::memory_order_relaxed);
+    } else {
+      leases->release(it->second.first);
+    }
+
+    leasedPages.erase(it);
+  }
+
+  // unpin it, we can not hold the lock of the leases while we do that
+  if (unpinMe != nullptr && !keepPinned) {
+    unpinMe->unpin();
+  }
+}
+
+bool pdb::PDBBufferManagerFrontEnd::revokeLeases(unique_lock<mutex> &lock) {
+
+  // if the backend has all its leases pinned there is nothing to take back
+  if (leases->getNumUnpinned() == 0) {
+    return false;
+  }
+
+  // revoke the leases of all the pages the backend does not use right now
+  std::vector<PDBPagePtr> unpinMe;
+  {
+    // lock the leases, we already hold the lock of the buffer manager
+    unique_lock<mutex> lck(leaseMutex);
+
+    for (auto it = leasedPages.begin(); it != leasedPages.end();) {
+
+      // if the backend has it pinned we leave it alone
+      bool isDirty;
+      PDBPageAccessHint hint;
+      if (!leases->revoke(it->second.first, isDirty, hint)) {
+        ++it;
+        continue;
+      }
+
+      // update the dirty bit and the hint
+      auto &page = it->second.second;
+      if (isDirty) {
+        page->setDirty();
+      }
+      page->setAccessHint(hint);
+
+      unpinMe.emplace_back(page);
+      numLeasesRevoked.fetch_add(1, std::memory_order_relaxed);
+
+      it = leasedPages.erase(it);
+    }
+  }
+
+  // unpin them so that they can be evicted, this looks at the leases again so we can not hold their lock
+  for (auto &page : unpinMe) {
+    unpin(page, lock);
+  }
+
+  return !unpinMe.empty();
+}
+
+size_t pdb::PDBBufferManagerFrontEnd::getNumLeasedReusablePages() {
+
+  // if the backend has all its leases pinned there is nothing to count
+  if (leases->getNumUnpinned() == 0) {
+    return 0;
+  }
+
+  // count the pages on every full page the backend has unpinned through their leases
+  std::map<void *, long> numUnpinned;
+  {
+    // lock the leases, we already hold the lock of the buffer manager
+    unique_lock<mutex> lck(leaseMutex);
+
+    for (auto &leased : leasedPages) {
+      if (leases->isUnpinned(leased.second.first)) {
+        auto offset = (char *) leased.second.second->getBytes() - (char *) sharedMemory.memory;
+        numUnpinned[(char *) sharedMemory.memory + (offset / sharedMemory.pageSize) * sharedMemory.pageSize]++;
+      }
+    }
+  }
+
+  // a full page can be reused if these are the only pages pinned on it
+  size_t numReusable = 0;
+  for (auto &fullPage : numUnpinned) {
+    if (getNumPinned(fullPage.first) == fullPage.second) {
+      numReusable++;
+    }
+  }
+
+  return numReusable;
+}
+
+pdb::PDBBufferManagerStats pdb::PDBBufferManagerFrontEnd::getStats() {
+
+  // the counters of the buffer manager
+  auto stats = PDBBufferManagerImpl::getStats();
+
+  // the leases
+  stats.numLeasesGranted = numLeasesGranted;
+  stats.numLeasesRevoked = numLeasesRevoked;
+
+  // the pages this process sent and received over the wire
+  auto wireStats = PDBWireCompression::getStats();
+  stats.numWireCompressed = wireStats.numCompressed;
+  stats.numWireBypassed = wireStats.numBypassed;
+  stats.numWireBytesIn = wireStats.numBytesIn;
+  stats.numWireBytesOut = wireStats.numBytesOut;
+  stats.wireCompressNanos = wireStats.compressNanos;
+  stats.wireDecompressNanos = wireStats.decompressNanos;
+
+  // the pages the backend has
+  unique_lock<mutex> lck(this->m);
+  stats.numBackEndPages = sentPages.size();
+
+  return stats;
+}
+
+void pdb::PDBBufferManagerFrontEnd::signalMemoryPressure() {
+
+  // tell the subscribers in this process
+  PDBBufferManagerImpl::signalMemoryPressure();
+
+  // the pipelines run in the backend, so it needs to know too
+  ring->setMemoryPressure((PDBMemoryPressure) memoryPressureLevel.load());
+  ring->setNumAvailablePages(numAvailablePages.load());
+}
+
 bool pdb::PDBBufferManagerFrontEnd::forwardPage(pdb::PDBPageHandle &page, pdb::PDBCommunicatorPtr &communicator, std::string &error) {
 
   // handle the page forwarding request
@@ -80,6 +369,22 @@ void pdb::PDBBufferManagerFrontEnd::registerHandlers(pdb::PDBServer &forMe) {
         return handleGetAnonymousPageRequest(request, sendUsingMe);
       }));
 
+  forMe.registerHandler(BufGetPagesRequest_TYPEID,
+      make_shared<pdb::HeapRequestHandler<BufGetPagesRequest>>(
+          [&](Handle<BufGetPagesRequest> request, PDBCommunicatorPtr sendUsingMe) {
+
+        // call the method to handle it
+        return handleGetPagesRequest(request, sendUsingMe);
+      }));
+
+  forMe.registerHandler(BufGetAnonymousPagesRequest_TYPEID,
+      make_shared<pdb::HeapRequestHandler<BufGetAnonymousPagesRequest>>(
+          [&](Handle<BufGetAnonymousPagesRequest> request, PDBCommunicatorPtr sendUsingMe) {
+
+        // call the method to handle it
+        return handleGetAnonymousPagesRequest(request, sendUsingMe);
+      }));
+
   forMe.registerHandler(BufReturnPageRequest_TYPEID,
       make_shared<pdb::HeapRequestHandler<BufReturnPageRequest>>(
           [&](Handle<BufReturnPageRequest> request, PDBCommunicatorPtr sendUsingMe) {
@@ -116,12 +421,57 @@ void pdb::PDBBufferManagerFrontEnd::registerHandlers(pdb::PDBServer &forMe) {
         // call the method to handle it
         return handleUnpinPageRequest(request, sendUsingMe);
       }));
+
+  forMe.registerHandler(BufPinPagesRequest_TYPEID,
+      make_shared<pdb::HeapRequestHandler<BufPinPagesRequest>>([&](Handle<BufPinPagesRequest> request, PDBCommunicatorPtr sendUsingMe) {
+
+        // call the method to handle it
+        return handlePinPagesRequest(request, sendUsingMe);
+      }));
+
+  forMe.registerHandler(BufUnpinPagesRequest_TYPEID,
+      make_shared<pdb::HeapRequestHandler<BufUnpinPagesRequest>>([&](Handle<BufUnpinPagesRequest> request, PDBCommunicatorPtr sendUsingMe) {
+
+        // call the method to handle it
+        return handleUnpinPagesRequest(request, sendUsingMe);
+      }));
+
+  forMe.registerHandler(BufGetStatsRequest_TYPEID,
+      make_shared<pdb::HeapRequestHandler<BufGetStatsRequest>>([&](Handle<BufGetStatsRequest> request, PDBCommunicatorPtr sendUsingMe) {
+
+        // call the method to handle it
+        return handleGetStatsRequest(request, sendUsingMe);
+      }));
+
+  // the buzzer the workers serving the ring buzz when they are done
+  ringBuzzer = make_shared<PDBBuzzer>([&](PDBAlarm myAlarm, std::atomic_int &cnt) {
+    cnt++;
+  });
+
+  // start handling the requests from the ring, they have to be handled by the workers of the server since every
+  // worker has its own allocator to make the responses with
+  for (uint32_t i = 0; i < PDB_BUFFER_MANAGER_RING_THREADS; ++i) {
+
+    // make the work
+    PDBWorkPtr myWork = std::make_shared<pdb::GenericWork>([&](const PDBBuzzerPtr &callerBuzzer) {
+
+      // serve until the ring is closed
+      serveRing();
+
+      // signal that we are done
+      callerBuzzer->buzz(PDBAlarm::WorkAllDone, numRingWorkersDone);
+    });
+
+    // run the work
+    forMe.getWorkerQueue()->getWorker()->execute(myWork, ringBuzzer);
+    numRingWorkers++;
+  }
 }
 
 pdb::PDBBufferManagerInterfacePtr pdb::PDBBufferManagerFrontEnd::getBackEnd() {
 
-  // init the backend storage manager with the shared memory
-  return std::make_shared<PDBBufferManagerBackEnd<RequestFactory>>(sharedMemory);
+  // init the backend storage manager with the shared memory, the ring and the leases
+  return std::make_shared<PDBBufferManagerBackEnd<RequestFactory>>(sharedMemory, ring, leases);
 }
 
 
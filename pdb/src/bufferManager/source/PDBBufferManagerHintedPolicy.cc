@@ -0,0 +1,115 @@
+#include "PDBBufferManagerHintedPolicy.h"
+
+namespace pdb {
+
+PDBBufferManagerHintedPolicy::PDBBufferManagerHintedPolicy(PDBBufferManagerEvictionPolicyPtr policy) : policy(std::move(policy)) {}
+
+void PDBBufferManagerHintedPolicy::unpinned(void *page) {
+  unpinned(page, PDB_PAGE_HINT_NORMAL);
+}
+
+void PDBBufferManagerHintedPolicy::unpinned(void *page, PDBPageAccessHint hint) {
+
+  // the pages without a hint are up to the policy
+  if (hint == PDB_PAGE_HINT_NORMAL) {
+    policy->unpinned(page);
+    return;
+  }
+
+  // add it to the end of the queue of the hint
+  auto &queue = getQueue(hint);
+  queue.push_back(page);
+  positions[page] = std::make_pair(hint, std::prev(queue.end()));
+}
+
+void PDBBufferManagerHintedPolicy::pinned(void *page) {
+  remove(page);
+  policy->pinned(page);
+}
+
+void PDBBufferManagerHintedPolicy::reloaded(void *page) {
+  policy->reloaded(page);
+}
+
+void PDBBufferManagerHintedPolicy::freed(void *page) {
+  remove(page);
+  policy->freed(page);
+}
+
+void *PDBBufferManagerHintedPolicy::evict() {
+
+  // the pages that were scanned once go first, then the spilled pages
+  for (auto *queue : {&sequential, &spilled}) {
+    if (!queue->empty()) {
+      auto page = queue->front();
+      freed(page);
+      return page;
+    }
+  }
+
+  // then whatever the policy picks
+  auto page = policy->evict();
+  if (page != nullptr) {
+    return page;
+  }
+
+  // the hot pages only if there is nothing else
+  if (!hot.empty()) {
+    page = hot.front();
+    freed(page);
+    return page;
+  }
+
+  return nullptr;
+}
+
+std::vector<void *> PDBBufferManagerHintedPolicy::getNextVictims(size_t numPages) {
+
+  // the same order as evict
+  std::vector<void *> victims;
+  for (auto *queue : {&sequential, &spilled}) {
+    for (auto it = queue->begin(); it != queue->end() && victims.size() < numPages; ++it) {
+      victims.push_back(*it);
+    }
+  }
+  if (victims.size() < numPages) {
+    auto next = policy->getNextVictims(numPages - victims.size());
+    victims.insert(victims.end(), next.begin(), next.end());
+  }
+  for (auto it = hot.begin(); it != hot.end() && victims.size() < numPages; ++it) {
+    victims.push_back(*it);
+  }
+
+  return victims;
+}
+
+size_t PDBBufferManagerHintedPolicy::numEvictable() {
+  return positions.size() + policy->numEvictable();
+}
+
+const PDBBufferManagerEvictionPolicyPtr &PDBBufferManagerHintedPolicy::getPolicy() {
+  return policy;
+}
+
+void PDBBufferManagerHintedPolicy::remove(void *page) {
+
+  // check if the page is in a queue
+  auto it = positions.find(page);
+  if (it == positions.end()) {
+    return;
+  }
+
+  // remove it from the queue
+  getQueue(it->second.first).erase(it->second.second);
+  positions.erase(it);
+}
+
+std::list<void *> &PDBBufferManagerHintedPolicy::getQueue(PDBPageAccessHint hint) {
+  switch (hint) {
+    case PDB_PAGE_HINT_SEQUENTIAL_ONCE: return sequential;
+    case PDB_PAGE_HINT_TEMP_SPILL: return spilled;
+    default: return hot;
+  }
+}
+
+}
@@ -0,0 +1,127 @@
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <unistd.h>
+#include "PDBBufferManagerIOEngine.h"
+#include "PDBBufferManagerSyncIOEngine.h"
+#include "PDBBufferManagerThreadPoolIOEngine.h"
+#include "PDBBufferManagerIOUringEngine.h"
+#include "PDBBufferManagerStripedIOEngine.h"
+
+namespace pdb {
+
+PDBBufferManagerIORequest::PDBBufferManagerIORequest(int fd, void *bytes, size_t numBytes, size_t offset, bool isWrite)
+    : fd(fd), bytes(bytes), numBytes(numBytes), offset(offset), isWrite(isWrite) {}
+
+bool PDBBufferManagerIORequest::isComplete() const {
+  return result == (ssize_t) numBytes;
+}
+
+std::string PDBBufferManagerIORequest::getError() const {
+
+  // the request failed
+  if (result == -1) {
+    return "errno: " + std::string(strerror(error));
+  }
+
+  // the read hit the end of the file
+  return "only " + std::to_string(result) + " of " + std::to_string(numBytes) + " bytes were transferred";
+}
+
+void PDBBufferManagerIOEngine::transfer(PDBBufferManagerIORequest &request) {
+
+  size_t done = 0;
+  while (done < request.numBytes) {
+
+    // transfer the bytes that are left
+    char *bytes = (char *) request.bytes + done;
+    size_t numBytes = request.numBytes - done;
+    ssize_t ret = request.isWrite ? pwrite(request.fd, bytes, numBytes, request.offset + done)
+                                  : pread(request.fd, bytes, numBytes, request.offset + done);
+
+    // if we were interrupted try again
+    if (ret == -1 && errno == EINTR) {
+      continue;
+    }
+
+    // the request failed
+    if (ret == -1) {
+      request.result = -1;
+      request.error = errno;
+      return;
+    }
+
+    // we are at the end of the file
+    if (ret == 0) {
+      break;
+    }
+
+    done += ret;
+  }
+
+  request.result = (ssize_t) done;
+  request.error = 0;
+}
+
+ssize_t PDBBufferManagerIOEngine::read(int fd, void *bytes, size_t numBytes, size_t offset) {
+  return executeOne(PDBBufferManagerIORequest(fd, bytes, numBytes, offset, false));
+}
+
+ssize_t PDBBufferManagerIOEngine::write(int fd, void *bytes, size_t numBytes, size_t offset) {
+  return executeOne(PDBBufferManagerIORequest(fd, bytes, numBytes, offset, true));
+}
+
+ssize_t PDBBufferManagerIOEngine::executeOne(PDBBufferManagerIORequest request) {
+
+  // do the request
+  std::vector<PDBBufferManagerIORequest> requests = { request };
+  execute(requests);
+
+  // set the errno if we failed
+  if (requests.front().result == -1) {
+    errno = requests.front().error;
+  }
+
+  return requests.front().result;
+}
+
+PDBBufferManagerIOEnginePtr PDBBufferManagerIOEngine::create(const std::string &name, size_t numThreads, size_t numDevices) {
+
+  // every drive gets its own engine so they each have their own queue
+  if (numDevices > 1) {
+    std::vector<PDBBufferManagerIOEnginePtr> engines;
+    for (size_t i = 0; i < numDevices; ++i) {
+      engines.emplace_back(create(name, numThreads));
+    }
+    return std::make_shared<PDBBufferManagerStripedIOEngine>(engines);
+  }
+
+  // do everything in the calling thread
+  if (name == "sync") {
+    return std::make_shared<PDBBufferManagerSyncIOEngine>();
+  }
+
+  // use a thread pool
+  if (name == "threads") {
+    return std::make_shared<PDBBufferManagerThreadPoolIOEngine>(numThreads);
+  }
+
+  // use io_uring if the kernel supports it
+  if (name == "io_uring") {
+
+    // try to set it up
+    auto engine = std::make_shared<PDBBufferManagerIOUringEngine>(256);
+    if (engine->isValid()) {
+      return engine;
+    }
+
+    // fall back to the thread pool
+    std::cerr << "Could not set up io_uring, using a thread pool for the buffer manager I/O instead.\n";
+    return std::make_shared<PDBBufferManagerThreadPoolIOEngine>(numThreads);
+  }
+
+  throw std::runtime_error("Unknown I/O engine " + name + ", the supported engines are sync, threads and io_uring");
+}
+
+}
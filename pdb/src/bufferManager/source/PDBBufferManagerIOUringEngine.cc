@@ -0,0 +1,317 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include "PDBBufferManagerIOUringEngine.h"
+
+// io_uring is only available on linux with a recent enough kernel header
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#define PDB_HAS_IO_URING
+#endif
+#endif
+
+namespace pdb {
+
+#ifdef PDB_HAS_IO_URING
+
+PDBBufferManagerIOUringEngine::PDBBufferManagerIOUringEngine(unsigned numEntries) {
+
+  // set up the io_uring
+  io_uring_params params{};
+  ringFD = (int) syscall(__NR_io_uring_setup, numEntries, &params);
+  if (ringFD < 0) {
+    ringFD = -1;
+    return;
+  }
+
+  // figure out the sizes of the rings
+  sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+
+  // newer kernels map both rings with a single mapping
+  bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (singleMap) {
+    sqRingSize = cqRingSize = std::max(sqRingSize, cqRingSize);
+  }
+
+  // map the rings
+  sqRing = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFD, IORING_OFF_SQ_RING);
+  cqRing = singleMap ? sqRing : mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFD, IORING_OFF_CQ_RING);
+  void *sqesMemory = mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFD, IORING_OFF_SQES);
+
+  // if anything failed we can not use it
+  if (sqRing == MAP_FAILED || cqRing == MAP_FAILED || sqesMemory == MAP_FAILED) {
+    if (sqRing != MAP_FAILED) { munmap(sqRing, sqRingSize); }
+    if (!singleMap && cqRing != MAP_FAILED) { munmap(cqRing, cqRingSize); }
+    if (sqesMemory != MAP_FAILED) { munmap(sqesMemory, sqesSize); }
+    sqRing = cqRing = nullptr;
+    close(ringFD);
+    ringFD = -1;
+    return;
+  }
+
+  // grab the fields of the submission ring
+  sqes = (io_uring_sqe *) sqesMemory;
+  sqHead = (unsigned *) ((char *) sqRing + params.sq_off.head);
+  sqTail = (unsigned *) ((char *) sqRing + params.sq_off.tail);
+  sqMask = (unsigned *) ((char *) sqRing + params.sq_off.ring_mask);
+  sqArray = (unsigned *) ((char *) sqRing + params.sq_off.array);
+  sqEntries = params.sq_entries;
+
+  // grab the fields of the completion ring
+  cqHead = (unsigned *) ((char *) cqRing + params.cq_off.head);
+  cqTail = (unsigned *) ((char *) cqRing + params.cq_off.tail);
+  cqMask = (unsigned *) ((char *) cqRing + params.cq_off.ring_mask);
+  cqes = (io_uring_cqe *) ((char *) cqRing + params.cq_off.cqes);
+  cqEntries = params.cq_entries;
+}
+
+PDBBufferManagerIOUringEngine::~PDBBufferManagerIOUringEngine() {
+
+  // if we did not set it up we are done
+  if (ringFD == -1) {
+    return;
+  }
+
+  // unmap everything
+  munmap(sqes, sqesSize);
+  if (cqRing != sqRing) {
+    munmap(cqRing, cqRingSize);
+  }
+  munmap(sqRing, sqRingSize);
+
+  // close the ring
+  close(ringFD);
+}
+
+bool PDBBufferManagerIOUringEngine::isValid() {
+  return ringFD != -1;
+}
+
+void PDBBufferManagerIOUringEngine::execute(std::vector<PDBBufferManagerIORequest> &requests) {
+
+  // nothing to do
+  if (requests.empty()) {
+    return;
+  }
+
+  // lock the rings
+  std::unique_lock<std::mutex> lck(m);
+
+  // the kernel points back to these when a request is done
+  size_t numPending = requests.size();
+  std::vector<PDBSubmittedRequest> submitted(requests.size());
+
+  for (size_t i = 0; i < requests.size(); ++i) {
+
+    // make sure we have a free submission entry
+    waitForEntry(lck);
+
+    // put the request in the ring
+    auto &r = requests[i];
+    submitted[i] = PDBSubmittedRequest{&r, &numPending, {r.bytes, r.numBytes}, 0};
+    queue(submitted[i]);
+  }
+
+  // submit what is left
+  submit();
+
+  // wait for the batch to finish, the requests that were cut short go back into the ring
+  while (true) {
+    resubmitPartial(lck);
+    if (numPending == 0) {
+      break;
+    }
+    waitForCompletions(lck);
+  }
+}
+
+void PDBBufferManagerIOUringEngine::queue(PDBSubmittedRequest &s) {
+
+  // we only transfer the bytes that are left
+  auto &r = *s.request;
+  s.iov = {(char *) r.bytes + s.done, r.numBytes - s.done};
+
+  // grab the next submission entry
+  unsigned tail = *sqTail;
+  unsigned index = tail & *sqMask;
+  io_uring_sqe *sqe = &sqes[index];
+
+  // fill it in
+  memset(sqe, 0, sizeof(io_uring_sqe));
+  sqe->opcode = r.isWrite ? IORING_OP_WRITEV : IORING_OP_READV;
+  sqe->fd = r.fd;
+  sqe->addr = (unsigned long) &s.iov;
+  sqe->len = 1;
+  sqe->off = r.offset + s.done;
+  sqe->user_data = (unsigned long) &s;
+
+  // put it in the ring, the kernel only sees it once the tail is updated
+  sqArray[index] = index;
+  __atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+  numToSubmit++;
+}
+
+void PDBBufferManagerIOUringEngine::waitForEntry(std::unique_lock<std::mutex> &lck) {
+
+  // make sure we have a free submission entry and that the completion queue can not overflow
+  while (numToSubmit == sqEntries || numInFlight + numToSubmit >= cqEntries) {
+
+    // if we have something to submit do it, otherwise we have to wait for something to complete
+    if (numToSubmit != 0) {
+      submit();
+    } else {
+      waitForCompletions(lck);
+    }
+  }
+}
+
+void PDBBufferManagerIOUringEngine::resubmitPartial(std::unique_lock<std::mutex> &lck) {
+
+  // nothing was cut short
+  if (partial.empty()) {
+    return;
+  }
+
+  // put the rest of every request back in the ring, waiting for an entry might cut more requests short
+  while (!partial.empty()) {
+    waitForEntry(lck);
+    if (partial.empty()) {
+      break;
+    }
+    auto *s = partial.back();
+    partial.pop_back();
+    queue(*s);
+  }
+
+  // submit them
+  submit();
+}
+
+void PDBBufferManagerIOUringEngine::submit() {
+
+  while (numToSubmit != 0) {
+
+    // hand the entries to the kernel
+    int ret = (int) syscall(__NR_io_uring_enter, ringFD, numToSubmit, 0, 0, nullptr, 0);
+
+    // if we were interrupted or the kernel is busy try again
+    if (ret < 0 && (errno == EINTR || errno == EAGAIN || errno == EBUSY)) {
+      reapCompletions();
+      continue;
+    }
+
+    // this should never happen
+    if (ret < 0) {
+      std::cerr << "io_uring submit failed with errno: " << strerror(errno) << std::endl;
+      exit(1);
+    }
+
+    // these are now in flight
+    numToSubmit -= ret;
+    numInFlight += ret;
+  }
+}
+
+void PDBBufferManagerIOUringEngine::waitForCompletions(std::unique_lock<std::mutex> &lck) {
+
+  // if somebody is already waiting in the kernel wait for them to hand out the completions
+  if (isWaiting) {
+    cv.wait(lck);
+    return;
+  }
+
+  // if there are completions that nobody handed out we don't need to wait
+  if (*cqHead != __atomic_load_n(cqTail, __ATOMIC_ACQUIRE)) {
+    reapCompletions();
+    cv.notify_all();
+    return;
+  }
+
+  // wait in the kernel for at least one completion without holding the lock so others can submit
+  isWaiting = true;
+  lck.unlock();
+  syscall(__NR_io_uring_enter, ringFD, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+  lck.lock();
+  isWaiting = false;
+
+  // hand out the completions and wake up the other threads
+  reapCompletions();
+  cv.notify_all();
+}
+
+void PDBBufferManagerIOUringEngine::reapCompletions() {
+
+  // go through all the completions
+  unsigned head = *cqHead;
+  unsigned tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+  for (; head != tail; ++head) {
+
+    // find the request
+    io_uring_cqe *cqe = &cqes[head & *cqMask];
+    auto *s = (PDBSubmittedRequest *) cqe->user_data;
+
+    int res = cqe->res;
+    numInFlight--;
+
+    // if we were interrupted or the kernel is busy we submit it again
+    if (res == -EINTR || res == -EAGAIN) {
+      partial.emplace_back(s);
+      continue;
+    }
+
+    // if we got fewer bytes than we asked for we submit it again for the rest, a read returns 0 at the end of the file
+    if (res > 0 && s->done + res < s->request->numBytes) {
+      s->done += res;
+      partial.emplace_back(s);
+      continue;
+    }
+
+    // store the result
+    s->request->result = res < 0 ? -1 : (ssize_t) (s->done + res);
+    s->request->error = res < 0 ? -res : 0;
+
+    // one less request
+    (*s->numPending)--;
+  }
+
+  // let the kernel know we consumed the completions
+  __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+}
+
+#else
+
+PDBBufferManagerIOUringEngine::PDBBufferManagerIOUringEngine(unsigned numEntries) {}
+
+PDBBufferManagerIOUringEngine::~PDBBufferManagerIOUringEngine() = default;
+
+bool PDBBufferManagerIOUringEngine::isValid() {
+  return false;
+}
+
+void PDBBufferManagerIOUringEngine::execute(std::vector<PDBBufferManagerIORequest> &requests) {
+  throw std::runtime_error("io_uring is not supported on this platform");
+}
+
+void PDBBufferManagerIOUringEngine::submit() {}
+
+void PDBBufferManagerIOUringEngine::waitForCompletions(std::unique_lock<std::mutex> &lck) {}
+
+void PDBBufferManagerIOUringEngine::reapCompletions() {}
+
+void PDBBufferManagerIOUringEngine::queue(PDBSubmittedRequest &s) {}
+
+void PDBBufferManagerIOUringEngine::waitForEntry(std::unique_lock<std::mutex> &lck) {}
+
+void PDBBufferManagerIOUringEngine::resubmitPartial(std::unique_lock<std::mutex> &lck) {}
+
+#endif
+
+}
@@ -12,6 +12,7 @@
 #define STORAGE_MGR_C
 
 #include "PDBPage.h"
+#include "PDBBufferManagerChecksum.h"
 #include "PDBBufferManagerFileWriter.h"
 #include "PDBBufferManagerImpl.h"
 
@@ -22,6 +23,7 @@
 #include <sys/uio.h>
 #include <unistd.h>
 #include <utility>
+#include <algorithm>
 #include <stdio.h>
 #include <sys/mman.h>
 #include <cstring>
@@ -45,9 +47,27 @@ PDBBufferManagerImpl::PDBBufferManagerImpl(pdb::NodeConfigPtr config) {
     // log what happened
     std::cout << "Using an existing storage!\n";
 
-    // ok we found a previous storage init it with that
+    // ok we found a previous storage init it with that, the huge pages must be requested before we map the memory
+    setHugePages(config->hugePages);
+    setStorageDirectories(config->storageDirectories);
     initialize((dataPath / "metadata.pdb").string());
 
+    // use the eviction policy and the I/O settings from the configuration
+    setEvictionPolicy(PDBBufferManagerEvictionPolicy::create(config->evictionPolicy, sharedMemory.numPages));
+    setIOEngine(PDBBufferManagerIOEngine::create(config->ioEngine, config->ioThreads, storageDirs.size()));
+    setDirectIO(config->directIO);
+    setTempFileCompression(getTempFileCompression(config));
+    setVerifyChecksums(config->verifyChecksums);
+
+    // write the dirty pages in the background if we are asked to
+    if (config->flushLowWatermark > 0) {
+      startFlusher(config->flushLowWatermark, config->flushHighWatermark);
+    }
+
+    // the budgets of the jobs are fractions of the buffer pool
+    setDefaultJobBudget((size_t) (config->jobSoftBudget * sharedMemory.numPages * sharedMemory.pageSize),
+                        (size_t) (config->jobHardBudget * sharedMemory.numPages * sharedMemory.pageSize));
+
     // we are done here
     return;
   }
@@ -72,12 +92,82 @@ PDBBufferManagerImpl::PDBBufferManagerImpl(pdb::NodeConfigPtr config) {
   // figure out the number of pages we have available
   auto numPages = memorySize / pageSize;
 
-  // init the new manager
-  initialize((dataPath / "tempFile___.tmp").string(),
+  // init the new manager, the huge pages must be requested before we map the memory, if we are striping over multiple
+  // storage directories the temporary file goes to the first one
+  setHugePages(config->hugePages);
+  setStorageDirectories(config->storageDirectories);
+  fs::path tempPath = config->storageDirectories.empty() ? dataPath : fs::path(config->storageDirectories.front());
+  initialize((tempPath / "tempFile___.tmp").string(),
              pageSize,
              numPages,
              (dataPath / "metadata").string(),
              dataPath.string());
+
+  // use the eviction policy and the I/O settings from the configuration
+  setEvictionPolicy(PDBBufferManagerEvictionPolicy::create(config->evictionPolicy, numPages));
+  setIOEngine(PDBBufferManagerIOEngine::create(config->ioEngine, config->ioThreads, storageDirs.size()));
+  setDirectIO(config->directIO);
+  setTempFileCompression(getTempFileCompression(config));
+  setVerifyChecksums(config->verifyChecksums);
+
+  // write the dirty pages in the background if we are asked to
+  if (config->flushLowWatermark > 0) {
+    startFlusher(config->flushLowWatermark, config->flushHighWatermark);
+  }
+
+  // the budgets of the jobs are fractions of the buffer pool
+  setDefaultJobBudget((size_t) (config->jobSoftBudget * memorySize), (size_t) (config->jobHardBudget * memorySize));
+}
+
+void PDBBufferManagerImpl::setEvictionPolicy(const PDBBufferManagerEvictionPolicyPtr &policy) {
+
+  // lock the buffer manager
+  unique_lock<mutex> lock(m);
+
+  // set the policy, the pages with a hint are handled before it gets to decide
+  evictionPolicy = std::make_shared<PDBBufferManagerHintedPolicy>(policy);
+}
+
+void PDBBufferManagerImpl::setIOEngine(const PDBBufferManagerIOEnginePtr &engine) {
+
+  // lock the buffer manager
+  unique_lock<mutex> lock(m);
+
+  // set the engine
+  ioEngine = engine;
+}
+
+void PDBBufferManagerImpl::setDirectIO(bool enable) {
+
+  // lock the buffer manager and the file descriptors
+  unique_lock<mutex> lock(m);
+  unique_lock<mutex> blockLck(fdLck);
+
+  // set the flag
+  useDirectIO = enable;
+  if (!useDirectIO) {
+    return;
+  }
+
+  // open the temporary files with O_DIRECT
+  for (size_t i = 0; i < tempFiles.size(); ++i) {
+    if (tempFileDirectFDs[i] == -1) {
+      tempFileDirectFDs[i] = open(tempFiles[i].c_str(), O_RDWR | O_DIRECT);
+      if (tempFileDirectFDs[i] == -1) {
+        std::cerr << "The temporary file " << tempFiles[i] << " does not support direct I/O, using buffered I/O for it.\n";
+      }
+    }
+  }
+
+  // open the files of the sets that are already open with O_DIRECT
+  for (auto &fd : fds) {
+    if (directFds.find(fd.first) == directFds.end()) {
+      auto &direct = directFds[fd.first];
+      for (size_t i = 0; i < fd.second.size(); ++i) {
+        direct.emplace_back(open(getSetFile(fd.first, i).c_str(), O_RDWR | O_DIRECT));
+      }
+    }
+  }
 }
 
 size_t PDBBufferManagerImpl::getMaxPageSize() {
@@ -90,43 +180,55 @@ size_t PDBBufferManagerImpl::getMaxPageSize() {
   return sharedMemory.pageSize;
 }
 
+size_t PDBBufferManagerImpl::getNumAvailablePages() {
+  return numAvailablePages;
+}
+
 
 PDBBufferManagerImpl::~PDBBufferManagerImpl() {
 
   if (!initialized)
     return;
 
-  // loop through all of the pages currently in existence, and write back each of them
-  for (auto &a : allPages) {
+  // the flusher must not touch the pages while we write them out
+  stopFlusher();
 
-    // if the page is not dirty, do not do anything
-    PDBPagePtr &me = a.second;
-    if (!me->isDirty())
-      continue;
+  // loop through all of the pages currently in existence, and write back each of them in one batch
+  std::vector<PDBBufferManagerIORequest> writes;
+  std::vector<PDBPagePtr> written;
+  for (auto &shard : pageShards) {
+    for (auto &a : shard.allPages) {
 
-    pair<PDBSetPtr, long> whichPage = make_pair(me->getSet(), me->whichPage());
+      // if the page is not dirty, do not do anything
+      PDBPagePtr &me = a.second;
+      if (!me->isDirty())
+        continue;
 
-    // if we don't know where to write it, figure it out
-    if (pageLocations.count(whichPage) == 0) {
-      me->getLocation().startPos = endOfFiles[me->getSet()];
-      pair<PDBSetPtr, size_t> myIndex = make_pair(me->getSet(), me->whichPage());
-      pageLocations[myIndex] = me->getLocation();
-      endOfFiles[me->getSet()] += (MIN_PAGE_SIZE << me->getLocation().numBytes);
-    }
-
-    ssize_t write_bytes = pwrite(fds[me->getSet()],
-                                 me->getBytes(),
-                                 MIN_PAGE_SIZE << me->getLocation().numBytes,
-                                 me->getLocation().startPos);
-    if (write_bytes == -1) {
-      std::cerr << "error in PDBBufferManager destructor when writing data to disk with errno: " << strerror(errno)
-                << std::endl;
+      // if we don't know where to write it, figure it out
+      placeSetPage(me);
+      addWrite(me, writes, written);
+    }
+  }
+
+  // write the pages
+  compressWrites(writes);
+  checksumWrites(writes);
+  ioEngine->execute(writes);
+  for (auto &w : writes) {
+    if (!w.isComplete()) {
+      std::cerr << "error in PDBBufferManager destructor when writing data to disk with " << w.getError() << std::endl;
       exit(1);
     }
   }
 
+  // the page directories need to know which pages are compressed
+  recordWrites(written, writes);
+
   // and unmap the RAM
-  munmap(sharedMemory.memory, sharedMemory.pageSize * sharedMemory.numPages);
+  munmap(sharedMemory.memory, sharedMemory.mappedSize);
+
+  // the page directories have the locations of the pages, write them out
+  pageDirectories.clear();
 
   remove(metaDataFile.c_str());
   PDBBufferManagerFileWriter myMetaFile(metaDataFile);
@@ -138,40 +240,9 @@ PDBBufferManagerImpl::~PDBBufferManagerImpl() {
   myMetaFile.putString("tempFile", tempFile);
   myMetaFile.putString("metaDataFile", metaDataFile);
   myMetaFile.putString("storageLoc", storageLoc);
+  myMetaFile.putStringList("storageDirs", storageDirs);
 
-  // get info on each of the sets
-  vector<string> setNames;
-  vector<string> dbNames;
-  vector<string> endPos;
-  for (auto &a : endOfFiles) {
-    setNames.push_back(a.first->getSetName());
-    dbNames.push_back(a.first->getDBName());
-    endPos.push_back(to_string(a.second));
-  }
-
-  myMetaFile.putStringList("setNames", setNames);
-  myMetaFile.putStringList("dbNames", dbNames);
-  myMetaFile.putStringList("endPosForEachFile", endPos);
-
-  // now, for each set, write the list of page positions
-  map<string, vector<string>> allFiles;
-  for (auto &a : pageLocations) {
-    string key = a.first.first->getSetName() + "." + a.first.first->getDBName();
-    string value = to_string(a.first.second) + "." + to_string(a.second.startPos) + "." + to_string(a.second.numBytes);
-    if (allFiles.count(key) == 0) {
-      vector<string> temp;
-      temp.push_back(value);
-      allFiles[key] = temp;
-    } else {
-      allFiles[key].push_back(value);
-    }
-  }
-
-  // and now write out all of the page positions
-  for (auto &a : allFiles) {
-    myMetaFile.putStringList(a.first, a.second);
-  }
-
+  // the locations of the pages are in the page directories of the sets so we are done
   myMetaFile.save();
 }
 
@@ -195,44 +266,29 @@ void PDBBufferManagerImpl::initialize(std::string metaDataFile) {
   sharedMemory.numPages = utemp;
   myMetaFile.getString("tempFile", tempFile);
   myMetaFile.getString("storageLoc", storageLoc);
-  initialize(tempFile, sharedMemory.pageSize, sharedMemory.numPages, metaDataFile, storageLoc);
 
-  // now, get everything that we need for the end positions
-  vector<string> setNames;
-  vector<string> dbNames;
-  vector<string> endPos;
-
-  myMetaFile.getStringList("setNames", setNames);
-  myMetaFile.getStringList("dbNames", dbNames);
-  myMetaFile.getStringList("endPosForEachFile", endPos);
-
-  // and set up the end positions
-  for (int i = 0; i < setNames.size(); i++) {
-    PDBSetPtr mySet = make_shared<PDBSet>(dbNames[i], setNames[i]);
-    size_t end = stoul(endPos[i]);
-    endOfFiles[mySet] = end;
+  // the old format kept the locations of the pages in the meta data file, we don't import them
+  vector<string> oldSetNames;
+  if (myMetaFile.getStringList("setNames", oldSetNames) && !oldSetNames.empty()) {
+    std::cerr << "The meta data file " << metaDataFile << " was written by an older version that does not keep the "
+              << "pages in page directories, restarting from it is not supported.\n";
+    exit(1);
   }
 
-  // now, we need to get the file mappings
-  for (auto &a : endOfFiles) {
-    vector<string> mappings;
-    myMetaFile.getStringList(a.first->getSetName() + "." + a.first->getDBName(), mappings);
-    for (auto &b : mappings) {
-
-      // the format of the string in the list is pageNum.startPos.len
-      stringstream tokenizer(b);
-      string pageNum, startPos, len;
-      getline(tokenizer, pageNum, '.');
-      getline(tokenizer, startPos, '.');
-      getline(tokenizer, len, '.');
+  // the page directories of the sets have the locations of the pages we stored before
+  reusePageDirectories = true;
 
-      size_t page = stoul(pageNum);
-      PDBPageInfo tempInfo;
-      tempInfo.startPos = stoul(startPos);
-      tempInfo.numBytes = stoul(len);
-      pageLocations[make_pair(a.first, page)] = tempInfo;
+  // the pages are where the storage was striped to when it was created
+  vector<string> dirs;
+  if (myMetaFile.getStringList("storageDirs", dirs) && !dirs.empty()) {
+    if (!storageDirs.empty() && storageDirs != dirs) {
+      std::cout << "The storage directories of an existing storage can not be changed, using the ones it was created with.\n";
     }
+    storageDirs = dirs;
   }
+  initialize(tempFile, sharedMemory.pageSize, sharedMemory.numPages, metaDataFile, storageLoc);
+
+  // the locations of the pages are loaded from the page directory of a set once the set is used
 }
 
 void PDBBufferManagerImpl::initialize(std::string tempFileIn, size_t pageSizeIn, size_t numPagesIn,
@@ -242,33 +298,53 @@ void PDBBufferManagerImpl::initialize(std::string tempFileIn, size_t pageSizeIn,
   sharedMemory.pageSize = pageSizeIn;
   tempFile = tempFileIn;
   sharedMemory.numPages = numPagesIn;
+  numAvailablePages = numPagesIn;
   metaDataFile = std::move(metaFile);
 
-  tempFileFD = open(tempFileIn.c_str(), O_CREAT | O_RDWR, 0666);
-  if (tempFileFD == -1) {
-    std::cerr << "Fail to open the temp file at " << tempFile << std::endl;
+  // if we were not given any storage directories everything goes to the storage location
+  if (storageDirs.empty()) {
+    storageDirs.emplace_back(storageLoc);
+  }
+  if (storageDirs.size() > PDB_BUFFER_MANAGER_MAX_STORAGE_DIRS) {
+    std::cerr << "Error: we can stripe over at most " << PDB_BUFFER_MANAGER_MAX_STORAGE_DIRS << " storage directories.\n";
     exit(1);
   }
 
+  // open a temporary file in every storage directory, the first one is the one we were given
+  for (size_t i = 0; i < storageDirs.size(); ++i) {
+
+    // make sure the directory exists
+    if (!fs::exists(storageDirs[i]) && !fs::create_directories(storageDirs[i])) {
+      std::cerr << "Fail to create the storage directory at " << storageDirs[i] << std::endl;
+      exit(1);
+    }
+
+    tempFiles.emplace_back(i == 0 ? tempFile : (fs::path(storageDirs[i]) / fs::path(tempFile).filename()).string());
+    tempFileFDs.emplace_back(open(tempFiles.back().c_str(), O_CREAT | O_RDWR, 0666));
+    tempFileDirectFDs.emplace_back(-1);
+    if (tempFileFDs.back() == -1) {
+      std::cerr << "Fail to open the temp file at " << tempFiles.back() << std::endl;
+      exit(1);
+    }
+  }
+
   // there are no currently available positions
   logOfPageSize = -1;
   size_t curSize;
   for (curSize = MIN_PAGE_SIZE; curSize <= sharedMemory.pageSize; curSize *= 2) {
-    vector<int64_t> temp;
-    vector<void *> tempAgain;
-
-    availablePositions.push_back(temp);
-    emptyMiniPages.push_back(tempAgain);
     isCreatingSpace.push_back(false);
-
     logOfPageSize++;
   }
+  availablePositions.resize(storageDirs.size(), vector<vector<int64_t>>(logOfPageSize + 1));
 
   // but the last used position is zero
-  lastTempPos = 0;
+  lastTempPos.assign(storageDirs.size(), 0);
+
+  // we use the LRU unless somebody sets a different policy
+  evictionPolicy = std::make_shared<PDBBufferManagerHintedPolicy>(PDBBufferManagerEvictionPolicy::create("lru", numPagesIn));
 
-  // as is the last time tick
-  lastTimeTick = 1;
+  // we do the I/O in the calling thread unless somebody sets a different engine
+  ioEngine = PDBBufferManagerIOEngine::create("sync", 1);
 
   if (curSize != sharedMemory.pageSize * 2) {
     std::cerr << "Error: the page size must be a power of two.\n";
@@ -276,465 +352,1090 @@ void PDBBufferManagerImpl::initialize(std::string tempFileIn, size_t pageSizeIn,
   }
 
   // now, allocate the RAM
-  char *mapped;
-  mapped = (char *) mmap(nullptr,
-                         sharedMemory.pageSize * sharedMemory.numPages,
-                         PROT_READ | PROT_WRITE,
-                         MAP_SHARED | MAP_ANONYMOUS,
-                         -1,
-                         0);
+  mapSharedMemory();
 
-  // make sure that it actually worked
-  if (mapped == MAP_FAILED) {
-    std::cerr << "Could not memory map; error is " << strerror(errno);
-    exit(1);
-  }
+  // and split it into arenas
+  createArenas();
+}
 
-  sharedMemory.memory = mapped;
+void PDBBufferManagerImpl::mapSharedMemory() {
 
-  // and create a bunch of pages
-  for (int i = 0; i < sharedMemory.numPages; i++) {
+  // the size of the buffer pool
+  size_t size = sharedMemory.pageSize * sharedMemory.numPages;
 
-    // figure out the address
-    void *address = mapped + (sharedMemory.pageSize * i);
+  // try to get huge pages if we were asked to
+  if (useHugePages) {
 
-    // store the address
-    emptyFullPages.push_back(address);
-  }
+    // huge pages have to be mapped whole so round up the size
+    size_t hugeSize = ((size + PDB_HUGE_PAGE_SIZE - 1) / PDB_HUGE_PAGE_SIZE) * PDB_HUGE_PAGE_SIZE;
+    void *mapped = mmap(nullptr, hugeSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
 
-}
+    // did we get them
+    if (mapped != MAP_FAILED) {
+      sharedMemory.memory = mapped;
+      sharedMemory.mappedSize = hugeSize;
+      sharedMemory.hugePageMode = PDB_HUGETLB_PAGES;
+      std::cout << "The buffer pool is backed by huge pages (MAP_HUGETLB).\n";
+      return;
+    }
 
-void PDBBufferManagerImpl::clearSet(const PDBSetPtr &set) {
+    // we failed probably because there are not enough huge pages reserved
+    std::cout << "Could not get huge pages with MAP_HUGETLB, error is " << strerror(errno) << ".\n";
+  }
 
-  // lock the buffer manager
-  std::unique_lock<std::mutex> lock(m);
+  // map the memory with regular pages
+  void *mapped = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
 
-  // close the file if open
-  auto fd = fds.find(set);
-  if(fd != fds.end()) {
-    close(fd->second);
-    fds.erase(fd);
+  // make sure that it actually worked
+  if (mapped == MAP_FAILED) {
+    std::cerr << "Could not memory map; error is " << strerror(errno);
+    exit(1);
   }
 
-  // remove the pages from all the pages
-  // the pages are sorted, so there is a optimization that once we find a page then every next page has to
-  // be from the target set otherwise we know that there are not pages from the target set left
-  bool found = false;
-  for(auto it = allPages.begin(); it != allPages.end(); ) {
-
-    // if the set does not match got to the next
-    if(*it->first.first != *set) {
+  sharedMemory.memory = mapped;
+  sharedMemory.mappedSize = size;
+  sharedMemory.hugePageMode = PDB_REGULAR_PAGES;
 
-      // if we previously found a page then we can safely
-      // finish searching for pages since they are sorted
-      if(found) {
-        break;
-      }
+  // if we wanted huge pages ask for transparent huge pages instead
+  if (useHugePages) {
 
-      // go to the next page and continue
-      it++;
-      continue;
+    // this only does something if the kernel has transparent huge pages enabled for shared memory
+    if (madvise(mapped, size, MADV_HUGEPAGE) == 0) {
+      sharedMemory.hugePageMode = PDB_TRANSPARENT_HUGE_PAGES;
+      std::cout << "The buffer pool is backed by transparent huge pages (madvise) if the kernel has them enabled for shared memory.\n";
+    } else {
+      std::cout << "Could not get transparent huge pages, error is " << strerror(errno) << ". The buffer pool is backed by regular pages.\n";
     }
+  }
+}
 
-    // find the parent page of this page
-    void *memLoc = (char *) sharedMemory.memory + ((((char *) it->second->getBytes() - (char *) sharedMemory.memory) / sharedMemory.pageSize) * sharedMemory.pageSize);
-
-    // remove the page from the constituentPages
-    auto &siblings = constituentPages[memLoc];
-    auto pagePos = std::find(siblings.begin(), siblings.end(), it->second);
-    siblings.erase(pagePos);
+void PDBBufferManagerImpl::createArenas() {
 
-    // decrease the number of pinned pages
-    numPinned[memLoc]--;
-    if(numPinned[memLoc] == 0) {
+  // if nobody gave us the topology figure it out
+  if (numaTopology == nullptr) {
+    numaTopology = std::make_shared<PDBNUMATopology>();
+  }
 
-      // if by removing the page the constituent pages are empty we can return the whole page back
-      if(siblings.empty()) {
+  // the arenas have to be aligned to the huge pages, figure out how many of our pages are in one
+  size_t alignment = std::max<size_t>(1, PDB_HUGE_PAGE_SIZE / sharedMemory.pageSize);
 
-        // first we need to remove all the mini pages that this page is split into and are not used
-        auto &unused = unusedMiniPages[memLoc];
-        auto &emptyPages = emptyMiniPages[unused.second];
+  // figure out how many pages each arena gets, if the pool is too small to split we use one arena
+  size_t numArenas = numaTopology->getNumNodes();
+  pagesPerArena = ((sharedMemory.numPages / numArenas) / alignment) * alignment;
+  if (pagesPerArena == 0) {
+    numArenas = 1;
+    pagesPerArena = sharedMemory.numPages;
+  }
 
-        // go through each unused mini page and remove it!
-        for (auto const &kt : unused.first) {
-          auto const jt = std::find(emptyPages.begin(), emptyPages.end(), kt);
-          emptyPages.erase(jt);
-        }
+  // every full page has a slab and a counter of its pinned mini pages, none of them are used yet
+  slabs.resize(sharedMemory.numPages);
+  numPinned.reset(new std::atomic<long>[sharedMemory.numPages]);
+  for (size_t i = 0; i < sharedMemory.numPages; ++i) {
+    numPinned[i] = FULL_PAGE_FREE;
+  }
+  inEvictionPolicy.assign(sharedMemory.numPages, false);
 
-        // clear the unused pages
-        unused.first.clear();
+  // create the arenas
+  char *mapped = (char *) sharedMemory.memory;
+  arenas.resize(numArenas);
+  for (size_t i = 0; i < numArenas; ++i) {
 
-        // add back the full page
-        emptyFullPages.push_back(memLoc);
-      }
-      else {
+    // the last arena gets the pages that are left over
+    size_t firstPage = i * pagesPerArena;
+    size_t lastPage = i + 1 == numArenas ? sharedMemory.numPages : firstPage + pagesPerArena;
 
-        // otherwise reinsert it as a free page
-        unusedMiniPages[memLoc].first.emplace_back(it->second->bytes);
-        emptyMiniPages[it->second->location.numBytes].emplace_back(it->second->bytes);
+    // the arena is on the node with the same index, and has a list of slabs with free mini pages for each size
+    arenas[i].node = i;
+    arenas[i].freeSlabs.resize(logOfPageSize + 1, nullptr);
 
-        // add it to the LRU
-        numPinned[memLoc] = -lastTimeTick;
+    // and create a bunch of pages
+    for (size_t page = firstPage; page < lastPage; ++page) {
 
-        // add the physical page to the LRU
-        lastUsed.insert(make_pair(memLoc, lastTimeTick));
+      // figure out the address
+      void *address = mapped + (sharedMemory.pageSize * page);
 
-        // increment the time tick
-        lastTimeTick++;
-      }
+      // store the address
+      arenas[i].emptyFullPages.push_back(address);
     }
 
-    // remove the page from all pages
-    allPages.erase(it++);
+    // if we have more than one arena place the memory on the node, nothing touched it yet so the kernel will listen
+    if (numArenas > 1 && !numaTopology->bindMemory(mapped + firstPage * sharedMemory.pageSize,
+                                                   (lastPage - firstPage) * sharedMemory.pageSize, i)) {
+      std::cout << "Could not place arena " << i << " on the NUMA node " << numaTopology->getNodeID(i)
+                << ", error is " << strerror(errno) << ".\n";
+    }
+  }
 
-    // mark that we have found it
-    found = true;
+  // log what happened
+  if (numArenas > 1) {
+    std::cout << "The buffer pool is split into " << numArenas << " NUMA arenas of " << pagesPerArena << " pages.\n";
   }
 
-  // remove all page locations for that set
-  for(auto it = pageLocations.begin(); it != pageLocations.end(); ) {
+  // keep some full pages ready for the new set pages
+  reservedPages.resize(numArenas);
+  refillReservedPages();
+}
 
-    // check if the set matches
-    if (*it->first.first == *set) {
+size_t PDBBufferManagerImpl::getLocalArena(int64_t numaNode) {
 
-      // remove the location since the set matches
-      pageLocations.erase(it++);
-      continue;
-    }
+  // on a single node we don't need to ask
+  if (arenas.size() == 1) {
+    return 0;
+  }
 
-    // go to next
-    ++it;
+  // if we know the node of the thread that asked for the page we use its arena
+  if (numaNode >= 0 && (size_t) numaNode < arenas.size()) {
+    return (size_t) numaNode;
   }
 
-  // remove the end of files
-  endOfFiles.erase(set);
+  return numaTopology->getCurrentNode();
+}
 
-  // log the clear set
-  logClearSet(set);
+size_t PDBBufferManagerImpl::getArena(void *page) {
+
+  // figure out the number of the full page
+  size_t pageNum = ((char *) page - (char *) sharedMemory.memory) / sharedMemory.pageSize;
+
+  // the last arena also has the pages that are left over
+  return std::min(pageNum / pagesPerArena, arenas.size() - 1);
 }
 
-void PDBBufferManagerImpl::registerMiniPage(const PDBPagePtr& registerMe) {
+PDBBufferManagerSlab &PDBBufferManagerImpl::getSlab(void *memory) {
+  return slabs[((char *) memory - (char *) sharedMemory.memory) / sharedMemory.pageSize];
+}
 
-  // first, compute the page this guy is on
-  void *whichPage = (char *) sharedMemory.memory
-      + ((((char *) registerMe->getBytes() - (char *) sharedMemory.memory) / sharedMemory.pageSize)
-          * sharedMemory.pageSize);
+void PDBBufferManagerImpl::splitFullPage(void *fullPage, int64_t whichSize) {
 
-  // now, add him to the list of constituent pages
-  constituentPages[whichPage].push_back(registerMe);
+  // split it
+  auto &slab = getSlab(fullPage);
+  slab.split(fullPage, whichSize, sharedMemory.pageSize);
 
-  // this guy is now pinned
-  pinParent(registerMe);
+  // and make the mini pages available
+  slab.link(arenas[getArena(fullPage)].freeSlabs[whichSize]);
 }
 
-void PDBBufferManagerImpl::freeAnonymousPage(PDBPagePtr me) {
+void PDBBufferManagerImpl::freeMiniPage(void *fullPage, void *miniPage) {
 
-  // lock the buffer manager
-  std::unique_lock<std::mutex> lock(m);
+  // give it back
+  auto &slab = getSlab(fullPage);
+  bool hadFree = slab.hasFree();
+  slab.free(miniPage);
 
-  // is this removal still valid if it is not we do nothing
-  if (!isRemovalStillValid(me)) {
-    return;
+  // if the slab did not have any free mini pages it is not in the list of its arena
+  if (!hadFree) {
+    slab.link(arenas[getArena(fullPage)].freeSlabs[slab.getSizeClass()]);
   }
+}
 
-  // recycle his location if it had a location assigned to it
-  PDBPageInfo temp = me->getLocation();
-  if (temp.startPos != -1) {
-    availablePositions[temp.numBytes].push_back(temp.startPos);
-  }
+void PDBBufferManagerImpl::freeFullPage(void *fullPage) {
 
-  // return the anonymous page number
-  freeAnonPageNumbers.emplace_back(me->whichPage());
+  // remove the slab from the list of its arena and forget the mini pages
+  auto &slab = getSlab(fullPage);
+  auto &arena = arenas[getArena(fullPage)];
+  slab.unlink(arena.freeSlabs[slab.getSizeClass()]);
+  slab.reset();
 
-  // if this guy as no associated memory, get outta here
-  if (me->getBytes() == nullptr) {
+  // add back the full page, the eviction policy must not know about it anymore
+  arena.emptyFullPages.push_back(fullPage);
+  getNumPinned(fullPage) = FULL_PAGE_FREE;
+  inEvictionPolicy[((char *) fullPage - (char *) sharedMemory.memory) / sharedMemory.pageSize] = false;
+}
 
-    // log free anonymous page set
-    logFreeAnonymousPage(me->whichPage());
+std::atomic<long> &PDBBufferManagerImpl::getNumPinned(void *fullPage) {
+  return numPinned[((char *) fullPage - (char *) sharedMemory.memory) / sharedMemory.pageSize];
+}
 
-    // get out of here
+void PDBBufferManagerImpl::fullPageChanged(void *fullPage) {
+  unique_lock<mutex> lck(changedLck);
+  changedFullPages.push_back(fullPage);
+}
+
+// this is only called with a locked buffer manager
+void PDBBufferManagerImpl::syncEvictionPolicy() {
+
+  // grab the full pages that changed
+  std::vector<void *> changed;
+  {
+    unique_lock<mutex> lck(changedLck);
+    changed.swap(changedFullPages);
+  }
+  if (changed.empty()) {
     return;
   }
 
-  // now, remove him from the set of constituent pages
-  void *parent = (char *) sharedMemory.memory + ((((char *) me->getBytes() - (char *) sharedMemory.memory) / sharedMemory.pageSize) * sharedMemory.pageSize);
+  for (auto page : changed) {
 
-  // remove this page from the mini pages
-  auto &miniPages = constituentPages[parent];
+    // a page that was pinned and unpinned again since the last time was used, so it has to be reinserted
+    size_t pageNum = ((char *) page - (char *) sharedMemory.memory) / sharedMemory.pageSize;
+    if (inEvictionPolicy[pageNum]) {
+      evictionPolicy->pinned(page);
+    }
+
+    // if it has no pinned mini pages right now let the eviction policy know about it
+    inEvictionPolicy[pageNum] = getNumPinned(page) == 0;
+    if (inEvictionPolicy[pageNum]) {
+      evictionPolicy->unpinned(page, getFullPageHint(page));
+    }
+  }
+}
 
-  // remove the mini page
-  auto pagePos = std::find(miniPages.begin(), miniPages.end(), me);
-  miniPages.erase(pagePos);
+// this is only called with a locked buffer manager
+bool PDBBufferManagerImpl::claimVictim(void *fullPage) {
 
-  // reduce the number of pinned pages if pinned
-  numPinned[parent] -= me->pinned ? 1 : 0;
+  // the policy gave it to us so it is not in there anymore
+  inEvictionPolicy[((char *) fullPage - (char *) sharedMemory.memory) / sharedMemory.pageSize] = false;
 
-  // if we don't have any mini pages on the parent page, we can kill the page
-  if(miniPages.empty()) {
+  // if nobody pinned a mini page on it since the last sync, nobody can from now on
+  long expected = 0;
+  return getNumPinned(fullPage).compare_exchange_strong(expected, FULL_PAGE_EVICTING);
+}
 
-    // if the page is already in the LRU remove it from the LRU
-    if (numPinned[parent] < 0) {
-      pair<void *, unsigned> id = make_pair(parent, -numPinned[parent]);
-      lastUsed.erase(id);
-    }
+void *PDBBufferManagerImpl::takeReservedPage(size_t whichArena) {
 
-    // remove the unused pages
-    auto &unused = unusedMiniPages[parent];
-    auto &emptyPages = emptyMiniPages[unused.second];
+  // lock the reserves
+  unique_lock<mutex> lck(reserveLck);
 
-    // go through each unused mini page and remove it!
-    for (auto const &kt : unused.first) {
-      auto const jt = std::find(emptyPages.begin(), emptyPages.end(), kt);
-      emptyPages.erase(jt);
-    }
+  // take one if there is one
+  auto &reserved = reservedPages[whichArena];
+  if (reserved.empty()) {
+    return nullptr;
+  }
+  void *page = reserved.back();
+  reserved.pop_back();
 
-    // clear the unused pages
-    unused.first.clear();
+  return page;
+}
 
-    // add back the empty full page
-    emptyFullPages.push_back(parent);
+// this is only called with a locked buffer manager
+void PDBBufferManagerImpl::refillReservedPages() {
 
-    // log free anonymous page set
-    logFreeAnonymousPage(me->whichPage());
+  // a small buffer pool does not keep any pages ready
+  size_t numReserved = std::min<size_t>(PDB_BUFFER_MANAGER_RESERVED_PAGES, pagesPerArena / 8);
 
-    // finish this
-    return;
-  }
+  // lock the reserves
+  unique_lock<mutex> lck(reserveLck);
 
-  // otherwise just add back
-  unusedMiniPages[parent].first.emplace_back(me->getBytes());
-  emptyMiniPages[unusedMiniPages[parent].second].emplace_back(me->getBytes());
+  // take the free full pages of every arena until its reserve is full
+  for (size_t i = 0; i < arenas.size(); ++i) {
+    auto &emptyFullPages = arenas[i].emptyFullPages;
+    while (reservedPages[i].size() < numReserved && !emptyFullPages.empty()) {
 
-  // log free anonymous page set
-  logFreeAnonymousPage(me->whichPage());
+      // split it into a single mini page and take it, a new page only has to be put on it
+      void *page = emptyFullPages.back();
+      emptyFullPages.pop_back();
+      auto &slab = getSlab(page);
+      slab.split(page, logOfPageSize, sharedMemory.pageSize);
+      slab.allocate();
 
-  // notify that we have created space
-  spaceCV.notify_all();
+      reservedPages[i].push_back(page);
+    }
+  }
 }
 
-void PDBBufferManagerImpl::downToZeroReferences(PDBPagePtr me) {
+// this is only called with a locked buffer manager
+void PDBBufferManagerImpl::releaseReservedPages() {
 
-  // lock the buffer manager
-  std::unique_lock<std::mutex> lock(m);
+  // lock the reserves
+  unique_lock<mutex> lck(reserveLck);
 
-  // is this removal still valid if it is not we do nothing
-  if (!isRemovalStillValid(me)) {
-    return;
+  // give the pages back to their arenas
+  for (size_t i = 0; i < arenas.size(); ++i) {
+    for (auto page : reservedPages[i]) {
+      getSlab(page).reset();
+      arenas[i].emptyFullPages.push_back(page);
+    }
+    reservedPages[i].clear();
   }
+}
 
-  // first, see whether we are actually buffered in RAM
-  if (me->getBytes() == nullptr) {
+size_t PDBBufferManagerImpl::getNumReservedPages() {
 
-    // we are not, so there is no reason to keep this guy around.  Kill him.
-    pair<PDBSetPtr, long> whichPage = make_pair(me->getSet(), me->whichPage());
-    allPages.erase(whichPage);
+  // lock the reserves
+  unique_lock<mutex> lck(reserveLck);
 
-  } else {
-    unpin(me, lock);
+  // count them
+  size_t numReserved = 0;
+  for (auto &reserved : reservedPages) {
+    numReserved += reserved.size();
   }
 
-  // log the down to zero
-  logDownToZeroReferences(me->whichSet, me->whichPage());
+  return numReserved;
 }
 
-bool PDBBufferManagerImpl::isRemovalStillValid(PDBPagePtr me) {
+size_t PDBBufferManagerImpl::getNumReusablePages() {
 
-  // lock the page counter so we can work with it
-  std::unique_lock<std::mutex> page_lck(me->lk);
+  // lock the buffer manager
+  unique_lock<mutex> lock(m);
 
-  // ok if by some chance we made another reference while we were waiting for the lock
-  // do not free it!
-  if (me->refCount != 0) {
-    return false;
-  }
+  // the eviction policy has to know about the pages that were unpinned without the lock
+  syncEvictionPolicy();
 
-  // did we in the mean time started doing something with the page
-  if (me->status == PDB_PAGE_LOADING || me->status == PDB_PAGE_UNLOADING) {
-    return false;
+  // the free full pages, the ones we can evict and the ones the backend is done with
+  size_t numReusable = evictionPolicy->numEvictable() + getNumLeasedReusablePages() + getNumReservedPages();
+  for (auto &arena : arenas) {
+    numReusable += arena.emptyFullPages.size();
   }
 
-  // if the page is anonymous we are done here
-  if (me->isAnonymous()) {
-    return true;
-  }
+  return numReusable;
+}
 
-  pair<PDBSetPtr, long> whichPage = make_pair(me->getSet(), me->whichPage());
-  auto it = allPages.find(whichPage);
+void PDBBufferManagerImpl::updateMemoryPressure() {
 
-  // was the page removed while we were waiting
-  if (it == allPages.end()) {
-    return false;
-  }
+  // the full pages with pinned mini pages can not be reused, unless the backend is done with them
+  size_t numPinnedPages = numPinnedFullPages;
+  size_t numReusable = getNumLeasedReusablePages();
+  numPinnedPages = numReusable < numPinnedPages ? numPinnedPages - numReusable : 0;
 
-  // was the page removed and then replaced by another one while we were waiting
-  // (this is the last check it this works the removal is safe)
-  return it->second.get() == me.get();
+  memoryPressureLevel = PDBBufferManagerMemoryPressure::getLevel(numPinnedPages, sharedMemory.numPages);
+  numAvailablePages = numPinnedPages < sharedMemory.numPages ? sharedMemory.numPages - numPinnedPages : 0;
 }
 
-// this is only called with a locked buffer manager
-void PDBBufferManagerImpl::createAdditionalMiniPages(int64_t whichSize, unique_lock<mutex> &lock) {
+void PDBBufferManagerImpl::signalMemoryPressure() {
+  memoryPressure.signal((PDBMemoryPressure) memoryPressureLevel.load());
+}
 
-  // if somebody else is making a mini page of the requested size wait here
-  spaceCV.wait(lock, [&] { return !isCreatingSpace[whichSize]; });
+// this is only called with a locked buffer manager
+void *PDBBufferManagerImpl::selectVictim(unique_lock<mutex> &lock) {
 
-  // did somebody create them while we were waiting
-  if (!emptyMiniPages[whichSize].empty()) {
-    return;
-  }
+  // the pages the backend is not using go into the policy, so they are not kept around longer than the rest
+  revokeLeases(lock);
 
-  // mark that we are creating the page of the requested size
-  isCreatingSpace[whichSize] = true;
+  // the policy has to know about the pages that were pinned and unpinned without the lock
+  syncEvictionPolicy();
 
-  // first, we see if there is a page that we can break up; if not, then make one
-  if (emptyFullPages.empty()) {
+  // if a job is over its soft budget its pages go first
+  if (jobBudgets.anyOverSoftLimit()) {
+    void *page = findJobVictim(-1, true);
+    if (page != nullptr) {
+      return page;
+    }
+  }
 
-    // if there are no pages, give a fatal error
-    if (lastUsed.empty()) {
-      std::cerr << "This is really bad.  We seem to have run out of RAM in the storage manager.\n";
-      std::cerr << "I suspect that there are too many pages pinned.\n";
-      exit(1);
+  // otherwise the policy decides, we skip the pages somebody pinned since the sync
+  void *page;
+  while ((page = evictionPolicy->evict()) != nullptr) {
+    if (claimVictim(page)) {
+      return page;
     }
+  }
 
-    // find the LRU
-    auto pageIt = lastUsed.begin();
+  return nullptr;
+}
 
-    // we copy the thing so we can erase it from the lastUsed
-    auto page = *pageIt;
+// this is only called with a locked buffer manager
+void *PDBBufferManagerImpl::findJobVictim(int64_t job, bool overSoftLimit) {
 
-    // remove the evicted page from the queue this prevents other threads from using it
-    lastUsed.erase(pageIt);
+  // the policy has to know about the pages that were pinned and unpinned without the lock
+  syncEvictionPolicy();
 
-    // mark all pages as unloading
-    std::for_each(constituentPages[page.first].begin(),
-                  constituentPages[page.first].end(),
-                  [](auto &a) { a->status = PDB_PAGE_UNLOADING; });
+  // we only look at the pages that are about to be evicted anyway, so this stays cheap
+  for (auto page : evictionPolicy->getNextVictims(PDB_BUFFER_MANAGER_JOB_VICTIMS)) {
 
-    // remove the unused pages
-    auto &unused = unusedMiniPages[page.first];
-    auto &emptyPages = emptyMiniPages[unused.second];
+    // check if one of the pages on the full page is one we are looking for
+    auto &pages = getSlab(page).getPages();
+    bool found = std::any_of(pages.begin(), pages.end(), [&](const PDBPagePtr &p) {
+      return overSoftLimit ? jobBudgets.isOverSoftLimit(p->job) : p->job == job;
+    });
 
-    // go through each unused mini page and remove it!
-    for (auto const &kt : unused.first) {
-      auto const jt = std::find(emptyPages.begin(), emptyPages.end(), kt);
-      emptyPages.erase(jt);
+    // if it is the policy has to forget about it, it is going to be recycled unless somebody just pinned it
+    if (found) {
+      evictionPolicy->freed(page);
+      if (claimVictim(page)) {
+        return page;
+      }
     }
+  }
 
-    // clear the unused pages
-    unused.first.clear();
-
-    // now let all of the constituent pages know the RAM is no longer usable
-    // this loop is safe since nobody can access it since we removed the page from lastUsed
-    for (auto &a: constituentPages[page.first]) {
-
-      if (a->isAnonymous() && a->isDirty()) {
+  return nullptr;
+}
 
-        if (availablePositions[a->getLocation().numBytes].empty()) {
+// this is only called with a locked buffer manager
+void PDBBufferManagerImpl::chargeJob(const PDBPagePtr &page) {
+  if (page->job != -1) {
+    jobBudgets.charge(page->job, MIN_PAGE_SIZE << page->getLocation().numBytes);
+  }
+}
 
-          a->getLocation().startPos = lastTempPos;
-          lastTempPos += (MIN_PAGE_SIZE << a->getLocation().numBytes);
+// this is only called with a locked buffer manager
+void PDBBufferManagerImpl::releaseJob(const PDBPagePtr &page) {
+  if (page->job != -1) {
+    jobBudgets.release(page->job, MIN_PAGE_SIZE << page->getLocation().numBytes);
+  }
+}
 
-        } else {
+void PDBBufferManagerImpl::setJobBudget(uint64_t jobID, size_t softLimit, size_t hardLimit) {
 
-          a->getLocation().startPos = availablePositions[a->getLocation().numBytes].back();
-          availablePositions[a->getLocation().numBytes].pop_back();
+  // lock the buffer manager
+  unique_lock<mutex> lock(m);
+  jobBudgets.setBudget((int64_t) jobID, softLimit, hardLimit);
+}
+
+void PDBBufferManagerImpl::setDefaultJobBudget(size_t softLimit, size_t hardLimit) {
+
+  // lock the buffer manager
+  unique_lock<mutex> lock(m);
+  jobBudgets.setDefaultBudget(softLimit, hardLimit);
+}
+
+PDBBufferManagerJobStats PDBBufferManagerImpl::getJobStats(uint64_t jobID) {
+
+  // lock the buffer manager
+  unique_lock<mutex> lock(m);
+  return jobBudgets.getStats((int64_t) jobID);
+}
+
+size_t PDBBufferManagerImpl::getNumArenas() {
+  return arenas.size();
+}
+
+void PDBBufferManagerImpl::setNUMATopology(const PDBNUMATopologyPtr &topology) {
+  numaTopology = topology;
+}
+
+void PDBBufferManagerImpl::setHugePages(bool enable) {
+  useHugePages = enable;
+}
+
+PDBHugePageMode PDBBufferManagerImpl::getHugePageMode() {
+  return sharedMemory.hugePageMode;
+}
+
+void PDBBufferManagerImpl::startFlusher(double lowWatermark, double highWatermark) {
+
+  // lock the buffer manager
+  {
+    unique_lock<mutex> lock(m);
+
+    // if it is already running we are done
+    if (isFlusherRunning) {
+      return;
+    }
+
+    // set the watermarks, the high one can not be below the low one
+    flushLowWatermark = lowWatermark;
+    flushHighWatermark = std::max(lowWatermark, highWatermark);
+    isFlusherRunning = true;
+  }
+
+  // start the thread
+  flusher = std::thread([this] { flush(); });
+}
+
+void PDBBufferManagerImpl::stopFlusher() {
+
+  // tell the flusher to stop
+  {
+    unique_lock<mutex> lock(m);
+    if (!isFlusherRunning) {
+      return;
+    }
+    isFlusherRunning = false;
+  }
+
+  // wake it up and wait for it to finish
+  flusherCV.notify_all();
+  flusher.join();
+}
+
+uint64_t PDBBufferManagerImpl::getNumForegroundWrites() {
+  return numForegroundWrites;
+}
+
+uint64_t PDBBufferManagerImpl::getNumBackgroundWrites() {
+  return numBackgroundWrites;
+}
+
+void PDBBufferManagerImpl::flush() {
+
+  // lock the buffer manager
+  unique_lock<mutex> lock(m);
+
+  while (isFlusherRunning) {
+
+    // if there was nothing to write wait until a full page is taken or some time passes
+    if (!flushPages(lock)) {
+      flusherCV.wait_for(lock, std::chrono::milliseconds(PDB_FLUSHER_INTERVAL_MS));
+    }
+  }
+}
+
+// this is only called with a locked buffer manager
+bool PDBBufferManagerImpl::flushPages(unique_lock<mutex> &lock) {
+
+  // figure out the watermarks in full pages
+  auto lowPages = (size_t) (flushLowWatermark * sharedMemory.numPages);
+  auto highPages = (size_t) (flushHighWatermark * sharedMemory.numPages);
+
+  // the policy has to know about the pages that were unpinned without the lock, and we keep some full pages ready for
+  // the new set pages
+  syncEvictionPolicy();
+  refillReservedPages();
+
+  // the free full pages can be reused without writing, if we have enough of them we are done
+  size_t numClean = getNumReservedPages();
+  for (auto &arena : arenas) {
+    numClean += arena.emptyFullPages.size();
+  }
+  if (numClean >= lowPages) {
+    return false;
+  }
+
+  // so can the full pages that are evicted next if none of their pages are dirty, the dirty ones are candidates to write
+  std::vector<void *> dirtyPages;
+  for (auto page : evictionPolicy->getNextVictims(highPages)) {
+    auto &pages = getSlab(page).getPages();
+    if (std::none_of(pages.begin(), pages.end(), [](auto &a) { return a->isDirty(); })) {
+      numClean++;
+    } else {
+      dirtyPages.push_back(page);
+    }
+  }
+
+  // if we are not below the low watermark or there is nothing we can write we are done
+  if (numClean >= lowPages || dirtyPages.empty()) {
+    return false;
+  }
+
+  // we write the ones that are evicted first until we reach the high watermark
+  dirtyPages.resize(std::min(dirtyPages.size(), highPages - numClean));
+
+  // collect the writes of the dirty pages, nobody can pin a page on a full page while it is written, so the pages are
+  // clean once the write is done
+  std::vector<PDBBufferManagerIORequest> writes;
+  std::vector<PDBPagePtr> written;
+  std::vector<void *> flushedPages;
+  for (auto page : dirtyPages) {
+
+    // skip the full pages somebody pinned a page on since the eviction policy was synced
+    long expected = 0;
+    if (!getNumPinned(page).compare_exchange_strong(expected, FULL_PAGE_FLUSHING)) {
+      continue;
+    }
+
+    // while the pages are written the full page can not be evicted or freed and no new mini page is put on it
+    auto &slab = getSlab(page);
+    slab.setFlushing(true);
+    slab.unlink(arenas[getArena(page)].freeSlabs[slab.getSizeClass()]);
+    flushedPages.push_back(page);
+
+    for (auto &a : slab.getPages()) {
+      if (a->isDirty()) {
+        addWrite(a, writes, written);
+      }
+    }
+  }
+
+  // if all of them were pinned in the mean time there is nothing to write
+  if (flushedPages.empty()) {
+    return false;
+  }
+
+  // compress and write the pages without holding the lock so we don't stall the threads that need memory
+  isFlushing = true;
+  lock.unlock();
+  compressWrites(writes);
+  checksumWrites(writes);
+  ioEngine->execute(writes);
+
+  // check if all the writes were successful
+  for (auto &w : writes) {
+    if (!w.isComplete()) {
+      std::cerr << "error in the flusher when writing page to disk with " << w.getError() << std::endl;
+      exit(1);
+    }
+  }
+
+  // lock it again, the pages are clean and the full pages can now be evicted without writing
+  lock.lock();
+  recordWrites(written, writes);
+  for (auto &a : written) {
+    a->setClean();
+  }
+  for (auto page : flushedPages) {
+
+    // the free mini pages of the full page can be used again
+    auto &slab = getSlab(page);
+    slab.setFlushing(false);
+    if (slab.hasFree()) {
+      slab.link(arenas[getArena(page)].freeSlabs[slab.getSizeClass()]);
+    }
+
+    // the pages can be pinned again, if the eviction policy dropped the full page while it was written it gets it back
+    getNumPinned(page) = 0;
+    if (!inEvictionPolicy[((char *) page - (char *) sharedMemory.memory) / sharedMemory.pageSize]) {
+      fullPageChanged(page);
+    }
+  }
+  isFlushing = false;
+  numBackgroundWrites += writes.size();
+
+  // notify all the threads that are waiting for the writes
+  pagesCV.notify_all();
+
+  return true;
+}
+
+void PDBBufferManagerImpl::clearSet(const PDBSetPtr &set) {
+
+  // lock the buffer manager
+  std::unique_lock<std::mutex> lock(m);
+
+  // the flusher might be writing the pages of the set, wait for it
+  waitForPages(lock, [&] { return !isFlushing; });
+
+  // close the files if open
+  auto fd = fds.find(set);
+  if(fd != fds.end()) {
+    for (auto f : fd->second) {
+      close(f);
+    }
+    fds.erase(fd);
+  }
+  auto directFd = directFds.find(set);
+  if(directFd != directFds.end()) {
+    for (auto f : directFd->second) {
+      if (f != -1) {
+        close(f);
+      }
+    }
+    directFds.erase(directFd);
+  }
+
+  // go through each shard of the page table
+  for (auto &shard : pageShards) {
+
+    // lock the shard
+    std::unique_lock<std::mutex> shardLock(shard.m);
+
+    // remove the pages from all the pages
+    // the pages are sorted, so there is a optimization that once we find a page then every next page has to
+    // be from the target set otherwise we know that there are not pages from the target set left
+    bool found = false;
+    for(auto it = shard.allPages.begin(); it != shard.allPages.end(); ) {
+
+      // if the set does not match got to the next
+      if(*it->first.first != *set) {
+
+        // if we previously found a page then we can safely
+        // finish searching for pages since they are sorted
+        if(found) {
+          break;
         }
 
-        // the page is not unloading unlock the buffer manager so we don't stall
-        lock.unlock();
+        // go to the next page and continue
+        it++;
+        continue;
+      }
+
+      // the pages that are not in memory are not on a full page
+      if (it->second->getBytes() == nullptr) {
+        shard.allPages.erase(it++);
+        found = true;
+        continue;
+      }
+
+      // find the parent page of this page
+      void *memLoc = (char *) sharedMemory.memory + ((((char *) it->second->getBytes() - (char *) sharedMemory.memory) / sharedMemory.pageSize) * sharedMemory.pageSize);
+
+      // remove the page from the pages of the slab
+      auto &slab = getSlab(memLoc);
+      slab.removePage(it->second);
+
+      // decrease the number of pinned pages, if it drops to zero the full page becomes evictable
+      if (it->second->isPinned()) {
+        unpinParent(memLoc);
+      }
+
+      // if by removing the page the constituent pages are empty we can return the whole page back
+      if(slab.getPages().empty()) {
+
+        // add back the full page
+        evictionPolicy->freed(memLoc);
+        freeFullPage(memLoc);
+      }
+      else {
+
+        // otherwise reinsert it as a free page
+        freeMiniPage(memLoc, it->second->bytes);
+      }
+
+      // remove the page from all pages
+      shard.allPages.erase(it++);
+
+      // mark that we have found it
+      found = true;
+    }
+
+  }
+
+  // remove the page directory of the set, so that all the page locations and the end of the file are forgotten
+  {
+    unique_lock<mutex> blockLck(fdLck);
+    pageDirectories.erase(set);
+    remove(getPageDirectoryFile(set).c_str());
+  }
+
+  // log the clear set
+  logClearSet(set);
+}
+
+void PDBBufferManagerImpl::registerMiniPage(const PDBPagePtr& registerMe) {
+
+  // first, compute the page this guy is on
+  void *whichPage = (char *) sharedMemory.memory
+      + ((((char *) registerMe->getBytes() - (char *) sharedMemory.memory) / sharedMemory.pageSize)
+          * sharedMemory.pageSize);
+
+  // now, add him to the pages of the slab of the full page
+  getSlab(whichPage).addPage(registerMe);
+
+  // the memory is used by his job now
+  chargeJob(registerMe);
+
+  // this guy is now pinned
+  pinParent(registerMe);
+}
+
+void PDBBufferManagerImpl::freeAnonymousPage(PDBPagePtr me) {
+
+  // lock the buffer manager
+  std::unique_lock<std::mutex> lock(m);
+
+  // if the flusher is writing the page wait for it, its location in the temporary file can not be reused before that
+  waitForPages(lock, [&] { return me->getBytes() == nullptr || !getSlab(me->getBytes()).isFlushing(); });
+
+  // is this removal still valid if it is not we do nothing
+  if (!isRemovalStillValid(me)) {
+    return;
+  }
+
+  // recycle his location if it had a location assigned to it
+  PDBPageInfo temp = me->getLocation();
+  if (temp.startPos != -1) {
+    availablePositions[temp.device][temp.numBytes].push_back(temp.startPos);
+  }
+
+  // return the anonymous page number
+  freeAnonPageNumbers.emplace_back(me->whichPage());
+
+  // if this guy as no associated memory, get outta here
+  if (me->getBytes() == nullptr) {
+
+    // log free anonymous page set
+    logFreeAnonymousPage(me->whichPage());
+
+    // get out of here
+    return;
+  }
+
+  // now, remove him from the set of constituent pages
+  void *parent = (char *) sharedMemory.memory + ((((char *) me->getBytes() - (char *) sharedMemory.memory) / sharedMemory.pageSize) * sharedMemory.pageSize);
+
+  // remove the mini page from the pages of the slab
+  auto &slab = getSlab(parent);
+  slab.removePage(me);
+
+  // his job does not use the memory anymore
+  releaseJob(me);
+
+  // reduce the number of pinned pages if pinned
+  if (me->isPinned()) {
+    unpinParent(parent);
+  }
+
+  // if we don't have any mini pages on the parent page, we can kill the page
+  if(slab.getPages().empty()) {
+
+    // the page is going back to the empty pages, the eviction policy has to forget about it
+    evictionPolicy->freed(parent);
+
+    // add back the empty full page
+    freeFullPage(parent);
+
+    // log free anonymous page set
+    logFreeAnonymousPage(me->whichPage());
+
+    // finish this
+    return;
+  }
+
+  // otherwise just add back
+  freeMiniPage(parent, me->getBytes());
+
+  // log free anonymous page set
+  logFreeAnonymousPage(me->whichPage());
+
+  // notify that we have created space
+  spaceCV.notify_all();
+}
+
+void PDBBufferManagerImpl::downToZeroReferences(PDBPagePtr me) {
+
+  // lock the buffer manager
+  std::unique_lock<std::mutex> lock(m);
+
+  // lock the shard of the page, we keep it locked until the page is unpinned so that nobody can grab a new
+  // handle to the page in the mean time
+  auto &shard = getPageShard(me->getSet(), me->whichPage());
+  std::unique_lock<std::mutex> shardLock(shard.m);
+
+  // is this removal still valid if it is not we do nothing
+  if (!isRemovalStillValid(me)) {
+    return;
+  }
+
+  // first, see whether we are actually buffered in RAM
+  if (me->getBytes() == nullptr) {
+
+    // we are not, so there is no reason to keep this guy around.  Kill him.
+    pair<PDBSetPtr, long> whichPage = make_pair(me->getSet(), me->whichPage());
+    shard.allPages.erase(whichPage);
+
+  } else {
+    unpin(me, &shard);
+  }
+
+  // we are done with the shard
+  shardLock.unlock();
+
+  // log the down to zero
+  logDownToZeroReferences(me->whichSet, me->whichPage());
+}
+
+bool PDBBufferManagerImpl::isRemovalStillValid(PDBPagePtr me) {
+
+  // lock the page counter so we can work with it
+  std::unique_lock<std::mutex> page_lck(me->lk);
+
+  // ok if by some chance we made another reference while we were waiting for the lock
+  // do not free it!
+  if (me->refCount != 0) {
+    return false;
+  }
+
+  // did we in the mean time started doing something with the page
+  if (me->status == PDB_PAGE_LOADING || me->status == PDB_PAGE_UNLOADING) {
+    return false;
+  }
+
+  // if the page is anonymous we are done here
+  if (me->isAnonymous()) {
+    return true;
+  }
+
+  // the shard of this page is locked by the caller
+  auto &allPages = getPageShard(me->getSet(), me->whichPage()).allPages;
+
+  pair<PDBSetPtr, long> whichPage = make_pair(me->getSet(), me->whichPage());
+  auto it = allPages.find(whichPage);
+
+  // was the page removed while we were waiting
+  if (it == allPages.end()) {
+    return false;
+  }
+
+  // was the page removed and then replaced by another one while we were waiting
+  // (this is the last check it this works the removal is safe)
+  return it->second.get() == me.get();
+}
+
+// this is only called with a locked buffer manager
+size_t PDBBufferManagerImpl::createAdditionalMiniPages(int64_t whichSize, size_t preferredArena, unique_lock<mutex> &lock) {
+
+  // if somebody else is making a mini page of the requested size wait here
+  waitForSpace(lock, [&] { return !isCreatingSpace[whichSize]; });
+
+  // did somebody create them while we were waiting
+  if (arenas[preferredArena].freeSlabs[whichSize] != nullptr) {
+    return preferredArena;
+  }
+
+  // if our arena does not have a full page we can break up we use the memory of the other arenas before evicting
+  size_t whichArena = preferredArena;
+  if (arenas[whichArena].emptyFullPages.empty()) {
+
+    // first we look for the mini pages of the requested size
+    for (size_t i = 0; i < arenas.size(); ++i) {
+      if (arenas[i].freeSlabs[whichSize] != nullptr) {
+        return i;
+      }
+    }
+
+    // then for a full page
+    for (size_t i = 0; i < arenas.size(); ++i) {
+      if (!arenas[i].emptyFullPages.empty()) {
+        whichArena = i;
+        break;
+      }
+    }
+  }
+
+  // mark that we are creating the page of the requested size
+  isCreatingSpace[whichSize] = true;
+
+  // before we evict a page we take back the full pages we keep ready for the new set pages
+  if (arenas[whichArena].emptyFullPages.empty() && getNumReservedPages() != 0) {
+    releaseReservedPages();
+    for (size_t i = 0; i < arenas.size(); ++i) {
+      size_t arena = (preferredArena + i) % arenas.size();
+      if (!arenas[arena].emptyFullPages.empty()) {
+        whichArena = arena;
+        break;
+      }
+    }
+  }
+
+  // first, we see if there is a page that we can break up; if not, then make one
+  if (arenas[whichArena].emptyFullPages.empty()) {
+
+    // pick the page we evict, this removes it from the policy and prevents other threads from using it
+    void *page = selectVictim(lock);
+
+    // if there are no pages, give a fatal error
+    if (page == nullptr) {
+      std::cerr << "This is really bad.  We seem to have run out of RAM in the storage manager.\n";
+      std::cerr << "I suspect that there are too many pages pinned.\n";
+      exit(1);
+    }
+
+    // write out its pages and give it back to its arena
+    evictFullPage(page, lock);
+    whichArena = getArena(page);
+  }
 
-        ssize_t write_bytes = pwrite(tempFileFD, a->getBytes(), MIN_PAGE_SIZE << a->getLocation().numBytes, a->getLocation().startPos);
-        if (write_bytes == -1) {
-          std::cerr << "error in createAdditionalMiniPages when writing anonymous page to disk with errno: "
-                    << strerror(errno)
-                    << std::endl;
-          exit(1);
-        }
-        // lock it again
-        lock.lock();
+  // now, we have a big page, so we can break it up into mini-pages
+  void *fullPage = arenas[whichArena].emptyFullPages.back();
+  arenas[whichArena].emptyFullPages.pop_back();
 
-      } else {
+  // we have one free full page less, let the flusher check if it has to write something
+  flusherCV.notify_one();
+  splitFullPage(fullPage, whichSize);
 
-        if (a->isDirty()) {
+  isCreatingSpace[whichSize] = false;
+  spaceCV.notify_all();
 
-          // the page is not unloading unlock the buffer manager so we don't stall
-          lock.unlock();
+  return whichArena;
+}
 
-          PDBPageInfo myInfo = a->getLocation();
+// this is only called with a locked buffer manager
+void PDBBufferManagerImpl::evictFullPage(void *page, unique_lock<mutex> &lock) {
 
-          ssize_t write_bytes = pwrite(fds[a->getSet()], a->getBytes(), MIN_PAGE_SIZE << myInfo.numBytes, myInfo.startPos);
-          if (write_bytes == -1) {
-            std::cerr << "error in createAdditionalMiniPages when writing page to disk with errno: " << strerror(errno)
-                      << std::endl;
-            exit(1);
-          }
-          // lock the thing again
-          lock.lock();
-        }
+  // the pages that live on the full page we are evicting
+  auto &slab = getSlab(page);
+  auto &evictedPages = slab.getPages();
+  numEvictions.fetch_add(1, std::memory_order_relaxed);
 
-        // lock the page so we can check the references
-        a->lk.lock();
+  // mark all pages as unloading
+  std::for_each(evictedPages.begin(),
+                evictedPages.end(),
+                [](auto &a) { a->status = PDB_PAGE_UNLOADING; });
 
-        // if the number of outstanding references is zero, just kill it
-        if (a->numRefs() == 0) {
+  // nobody can take the free mini pages of the full page we are evicting
+  slab.unlink(arenas[getArena(page)].freeSlabs[slab.getSizeClass()]);
 
-          pair<PDBSetPtr, long> whichPage = make_pair(a->getSet(), a->whichPage());
-          allPages.erase(whichPage);
-        }
+  // if the flusher is writing the pages wait for it, once it is done they are clean
+  waitForPages(lock, [&] { return !slab.isFlushing(); });
 
-        // unlock the page since we are done with checking the references
-        a->lk.unlock();
-      }
+  // collect the writes of all the dirty pages so that the I/O engine can do them in one batch
+  // this loop is safe since nobody can access it since we removed the page from the eviction policy
+  std::vector<PDBBufferManagerIORequest> writes;
+  std::vector<PDBPagePtr> written;
+  for (auto &a: evictedPages) {
 
-      a->setClean();
-      a->setBytes(nullptr);
+    // if the page is not dirty we don't need to write it
+    if (!a->isDirty()) {
+      continue;
     }
 
-    // mark all pages as not loaded
-    std::for_each(constituentPages[page.first].begin(),
-                  constituentPages[page.first].end(),
-                  [](auto &a) { a->status = PDB_PAGE_NOT_LOADED; });
+    addWrite(a, writes, written);
+  }
 
-    // notify all the threads that are paused because of a status
-    pagesCV.notify_all();
+  // if we have something to write do it
+  if (!writes.empty()) {
 
-    // and erase the page
-    constituentPages[page.first].clear();
-    emptyFullPages.push_back(page.first);
-    numPinned.erase(page.first);
-  }
+    // the flusher did not keep up, wake it up
+    numForegroundWrites += writes.size();
+    flusherCV.notify_one();
 
-  // now, we have a big page, so we can break it up into mini-pages
-  size_t inc = MIN_PAGE_SIZE << whichSize;
-  auto &unused = unusedMiniPages[emptyFullPages.back()];
-  unused.second = whichSize;
+    // the pages are unloading unlock the buffer manager so we don't stall
+    lock.unlock();
 
-  for (size_t offset = 0; offset < sharedMemory.pageSize; offset += inc) {
+    // write all the pages
+    compressWrites(writes);
+    checksumWrites(writes);
+    ioEngine->execute(writes);
 
-    // store the empty mini page as a mini page of that size
-    emptyMiniPages[whichSize].push_back(((char *) emptyFullPages.back()) + offset);
+    // check if all the writes were successful
+    for (auto &w : writes) {
+      if (!w.isComplete()) {
+        std::cerr << "error in evictFullPage when writing page to disk with " << w.getError() << std::endl;
+        exit(1);
+      }
+    }
 
-    // store the mini page as unused
-    unused.first.emplace_back(((char *) emptyFullPages.back()) + offset);
+    // lock it again and remember how the pages are stored
+    lock.lock();
+    recordWrites(written, writes);
   }
 
-  // set the number of pinned pages to zero... we will always pin this page subsequently,
-  // so no need to insert into the LRU queue
-  numPinned[emptyFullPages.back()] = 0;
+  // now let all of the constituent pages know the RAM is no longer usable
+  for (auto &a: evictedPages) {
+
+    // lock the shard of the page and the page, so we can check the references and nobody looks at the memory of the
+    // page while we take it away
+    unique_lock<mutex> shardLock;
+    if (!a->isAnonymous()) {
+      shardLock = unique_lock<mutex>(getPageShard(a->getSet(), a->whichPage()).m);
+    }
+    unique_lock<mutex> pageLock(a->lk);
 
-  // and get rid of the empty full page
-  emptyFullPages.pop_back();
+    // if the number of outstanding references is zero, just kill it, anonymous pages are not in the page table
+    if (!a->isAnonymous() && a->numRefs() == 0) {
 
-  isCreatingSpace[whichSize] = false;
-  spaceCV.notify_all();
+      pair<PDBSetPtr, long> whichPage = make_pair(a->getSet(), a->whichPage());
+      getPageShard(a->getSet(), a->whichPage()).allPages.erase(whichPage);
+    }
+
+    // the memory of the page is no longer charged to its job
+    jobBudgets.evicted(a->job, jobBudgets.isOverSoftLimit(a->job));
+    releaseJob(a);
+
+    // mark the page as not loaded
+    a->setClean();
+    a->setBytes(nullptr);
+    a->status = PDB_PAGE_NOT_LOADED;
+  }
+
+  // notify all the threads that are paused because of a status
+  pagesCV.notify_all();
+
+  // and erase the page
+  freeFullPage(page);
 }
 
 void PDBBufferManagerImpl::freezeSize(PDBPagePtr me, size_t numBytes) {
 
-  // lock the buffer manager
-  std::unique_lock<std::mutex> lock(m);
+  // if the page is charged to a job or its full page has to be split we need the buffer manager
+  bool isSplit = me->getLocation().numBytes == logOfPageSize && getLogPageSize(numBytes) < (size_t) logOfPageSize;
+  if (me->job != -1 || isSplit) {
+
+    // lock the buffer manager and do the actual freezing
+    std::unique_lock<std::mutex> lock(m);
+    freezeSize(me, numBytes, lock);
+  } else {
+
+    // otherwise only the page changes, so we only lock the page
+    std::unique_lock<std::mutex> pageLock(me->lk);
+    freezeSize(me, numBytes, pageLock);
+  }
 
-  // do the actual freezing
-  freezeSize(me, numBytes, lock);
+#ifdef DEBUG_BUFFER_MANAGER
+  // if the log reads the state of the whole buffer manager we need to lock it
+  std::unique_lock<std::mutex> lock(m, std::defer_lock);
+  if (logsBufferManagerState()) {
+    lock.lock();
+  }
+#endif
 
   // log the freeze size
   logFreezeSize(me->whichSet, me->whichPage(), numBytes);
@@ -759,36 +1460,53 @@ void PDBBufferManagerImpl::freezeSize(PDBPagePtr me, size_t numBytes, unique_loc
 
   // figure out the size
   size_t bytesRequired = getLogPageSize(numBytes);
-  if(bytesRequired > me->getLocation().numBytes) {
+  if(bytesRequired > (size_t) me->getLocation().numBytes) {
     std::cerr << "You cannot freeze to a size of a page grater than the size you requested!\n";
     exit(-1);
   }
 
-  // set the page size
+  // set the page size, the job of the page is only charged for the frozen size
+  bool isFullPage = me->getLocation().numBytes == logOfPageSize;
+  releaseJob(me);
   me->getLocation().numBytes = bytesRequired;
+  chargeJob(me);
 
-  // since we are freezing we need to break up the large page into smaller pages, so we can use the space
-  size_t inc = MIN_PAGE_SIZE << bytesRequired;
-  auto &unused = unusedMiniPages[me->bytes];
-  unused.second = bytesRequired;
-
-  for (size_t offset = inc; offset < sharedMemory.pageSize; offset += inc) {
+  // a mini page keeps its place in the slab of its full page, there is nothing to break up
+  if (!isFullPage || bytesRequired == (size_t) logOfPageSize) {
+    return;
+  }
 
-    // store the empty mini page as a mini page of that size
-    emptyMiniPages[bytesRequired].push_back(((char *) me->bytes) + offset);
+  // since we are freezing we need to break up the large page into smaller pages, so we can use the space
+  auto &slab = getSlab(me->bytes);
+  slab.split(me->bytes, bytesRequired, sharedMemory.pageSize);
 
-    // store the mini page as unused
-    unused.first.emplace_back(((char *) me->bytes) + offset);
-  }
+  // the first mini page is the page we are freezing, the rest are free
+  slab.allocate();
+  slab.link(arenas[getArena(me->bytes)].freeSlabs[bytesRequired]);
 }
 
 void PDBBufferManagerImpl::unpin(PDBPagePtr me) {
 
-  // lock the buffer manager
-  std::unique_lock<std::mutex> lock(m);
+  // unpin the page
+  if (me->isAnonymous()) {
+
+    // anonymous pages are not in the page table so there is no shard to lock
+    unpin(me, nullptr);
+  } else {
 
-  // unlock the page
-  unpin(me, lock);
+    // lock the shard the page belongs to and unpin it
+    auto &shard = getPageShard(me->getSet(), me->whichPage());
+    unique_lock<mutex> shardLock(shard.m);
+    unpin(me, &shard);
+  }
+
+#ifdef DEBUG_BUFFER_MANAGER
+  // if the log reads the state of the whole buffer manager we need to lock it
+  std::unique_lock<std::mutex> lock(m, std::defer_lock);
+  if (logsBufferManagerState()) {
+    lock.lock();
+  }
+#endif
 
   // log the unpin
   logUnpin(me->whichSet, me->whichPage());
@@ -796,6 +1514,23 @@ void PDBBufferManagerImpl::unpin(PDBPagePtr me) {
 
 void PDBBufferManagerImpl::unpin(PDBPagePtr me, unique_lock<mutex> &lock) {
 
+  // anonymous pages are not in the page table so there is no shard to lock
+  if (me->isAnonymous()) {
+    unpin(me, nullptr);
+    return;
+  }
+
+  // lock the shard the page belongs to and unpin it
+  auto &shard = getPageShard(me->getSet(), me->whichPage());
+  unique_lock<mutex> shardLock(shard.m);
+  unpin(me, &shard);
+}
+
+void PDBBufferManagerImpl::unpin(PDBPagePtr me, PDBBufferManagerPageShard *shard) {
+
+  // lock the page so nobody repins it in the mean time
+  unique_lock<mutex> pageLock(me->lk);
+
   // if it is not pinned no need to unpin it..
   if (!me->isPinned()) {
     return;
@@ -809,72 +1544,176 @@ void PDBBufferManagerImpl::unpin(PDBPagePtr me, unique_lock<mutex> &lock) {
     me->freezeSize();
   }
 
+  // now that the page is unpinned, we find a physical location for it, we do this before the full page can be evicted
+  if (!me->isAnonymous()) {
+
+    // if we don't know where to write it, figure it out and store it in the page directory right away
+    placeSetPage(me);
+  }
+
   // first, we find the parent of this guy
   void *memLoc = (char *) sharedMemory.memory
       + ((((char *) me->getBytes() - (char *) sharedMemory.memory) / sharedMemory.pageSize) * sharedMemory.pageSize);
 
-  // and decrement the number of pinned minipages
-  if (numPinned[memLoc] > 0) {
-    numPinned[memLoc]--;
-  }
+  // and decrement the number of pinned minipages, if it is now zero the page is evictable
+  unpinParent(memLoc);
+}
+
+bool PDBBufferManagerImpl::pinParent(const PDBPagePtr &me) {
 
-  // if the number of pinned minipages is now zero, put into the LRU structure
-  if (numPinned[memLoc] == 0) {
+  // first, we determine the parent of this guy
+  void *whichPage = (char *) sharedMemory.memory
+      + ((((char *) me->getBytes() - (char *) sharedMemory.memory) / sharedMemory.pageSize) * sharedMemory.pageSize);
 
-    // add it to the LRU
-    numPinned[memLoc] = -lastTimeTick;
+  // and increment the number of pinned minipages, unless the full page is being evicted or written by the flusher
+  auto &pins = getNumPinned(whichPage);
+  long current = pins.load();
+  do {
+    if (current == FULL_PAGE_EVICTING || current == FULL_PAGE_FLUSHING) {
+      return false;
+    }
+  } while (!pins.compare_exchange_weak(current, current == FULL_PAGE_FREE ? 1 : current + 1));
 
-    // add the physical page to the LRU
-    lastUsed.insert(make_pair(memLoc, lastTimeTick));
+  // if it was evictable the eviction policy has to forget about it
+  if (current == 0) {
+    fullPageChanged(whichPage);
+  }
 
-    // increment the time tick
-    lastTimeTick++;
+  // if it was not pinned before the memory pressure went up
+  if (current == 0 || current == FULL_PAGE_FREE) {
+    numPinnedFullPages++;
+    updateMemoryPressure();
   }
 
-  // now that the page is unpinned, we find a physical location for it
-  pair<PDBSetPtr, long> whichPage = make_pair(me->getSet(), me->whichPage());
-  if (!me->isAnonymous()) {
+  return true;
+}
 
-    // if we don't know where to write it, figure it out
-    if (pageLocations.find(whichPage) == pageLocations.end()) {
-      me->getLocation().startPos = endOfFiles[me->getSet()];
-      pair<PDBSetPtr, size_t> myIndex = make_pair(me->getSet(), me->whichPage());
-      pageLocations[whichPage] = me->getLocation();
-      endOfFiles[me->getSet()] += (MIN_PAGE_SIZE << me->getLocation().numBytes);
+bool PDBBufferManagerImpl::unpinParent(void *fullPage) {
+
+  // decrement the number of pinned minipages if there are any
+  auto &pins = getNumPinned(fullPage);
+  long current = pins.load();
+  do {
+    if (current <= 0) {
+      return false;
     }
+  } while (!pins.compare_exchange_weak(current, current - 1));
+
+  // if it was the last one the page is evictable, the eviction policy hears about it the next time it is synced
+  if (current == 1) {
+    fullPageChanged(fullPage);
+    numPinnedFullPages--;
+    updateMemoryPressure();
+    return true;
   }
+
+  return false;
 }
 
-void PDBBufferManagerImpl::pinParent(const PDBPagePtr &me) {
+PDBPageAccessHint PDBBufferManagerImpl::getFullPageHint(void *fullPage) {
 
-  // first, we determine the parent of this guy
-  void *whichPage = (char *) sharedMemory.memory
-      + ((((char *) me->getBytes() - (char *) sharedMemory.memory) / sharedMemory.pageSize) * sharedMemory.pageSize);
+  // if there is nothing on the page we know nothing about it
+  auto &pages = getSlab(fullPage).getPages();
+  if (pages.empty()) {
+    return PDB_PAGE_HINT_NORMAL;
+  }
 
-  // and increment the number of pinned minipages
-  if (numPinned[whichPage] < 0) {
-    pair<void *, unsigned> id = make_pair(whichPage, -numPinned[whichPage]);
-    lastUsed.erase(id);
-    numPinned[whichPage] = 1;
-  } else {
-    numPinned[whichPage]++;
+  // the full page is kept as long as the mini page we want to keep the longest
+  auto hint = PDB_PAGE_HINT_SEQUENTIAL_ONCE;
+  for (auto &page : pages) {
+    hint = std::max<PDBPageAccessHint>(hint, page->hint);
   }
+
+  return hint;
 }
 
 void PDBBufferManagerImpl::repin(PDBPagePtr me) {
 
+  // count the request
+  numPageRequests.fetch_add(1, std::memory_order_relaxed);
+
+  // tell the subscribers about the memory pressure the previous requests left us with
+  signalMemoryPressure();
+
+  // if the page is in RAM we don't need the buffer manager
+  if (repinLoaded(me)) {
+    return;
+  }
+
   // lock the buffer manager
   unique_lock<mutex> lock(m);
 
   // wait while the page is loading
-  pagesCV.wait(lock, [&] { return !(me->status == PDB_PAGE_LOADING || me->status == PDB_PAGE_UNLOADING); });
+  waitForPages(lock, [&] { return !(me->status == PDB_PAGE_LOADING || me->status == PDB_PAGE_UNLOADING); });
 
   // call the actual repin function
   repin(me, lock);
 }
 
+bool PDBBufferManagerImpl::repinLoaded(const PDBPagePtr &me) {
+
+  // lock the shard of the page, anonymous pages are not in the page table
+  unique_lock<mutex> shardLock;
+  if (!me->isAnonymous()) {
+    shardLock = unique_lock<mutex>(getPageShard(me->getSet(), me->whichPage()).m);
+  }
+
+  // lock the page, the memory can not be taken away from it while we hold it
+  unique_lock<mutex> pageLock(me->lk);
+
+  // if somebody is loading or unloading it we have to wait for them
+  if (me->status != PDB_PAGE_LOADED || me->getBytes() == nullptr) {
+    return false;
+  }
+
+  // if it is not pinned pin it and its full page, if the full page was just picked to be evicted or the flusher is
+  // writing it we have to wait
+  if (!me->isPinned()) {
+    if (!pinParent(me)) {
+      return false;
+    }
+    me->setPinned();
+  }
+
+  return true;
+}
+
 void PDBBufferManagerImpl::repin(PDBPagePtr me, unique_lock<mutex> &lock) {
 
+  // do the book keeping, if the page is in RAM we are done
+  std::vector<PDBPagePtr> toLoad;
+  startRepin(me, lock, toLoad);
+  if (toLoad.empty()) {
+    return;
+  }
+
+  // read the page from disk
+  loadPages(toLoad, lock);
+
+  // log the repin
+  logRepin(me->whichSet, me->whichPage());
+
+  // notify all waiting conditional variables
+  lock.unlock();
+  pagesCV.notify_all();
+}
+
+void PDBBufferManagerImpl::startRepin(const PDBPagePtr &me, unique_lock<mutex> &lock, std::vector<PDBPagePtr> &toLoad) {
+
+  // lock the page so nobody repins or unpins it without the buffer manager in the mean time
+  unique_lock<mutex> pageLock(me->lk);
+
+  // if the flusher is writing its full page we can only pin it once the write is done, the page might start to unload
+  // while we wait so we wait for that too
+  if (me->getBytes() != nullptr && getSlab(me->getBytes()).isFlushing()) {
+    pageLock.unlock();
+    waitForPages(lock, [&] {
+      return !(me->status == PDB_PAGE_LOADING || me->status == PDB_PAGE_UNLOADING) &&
+             (me->getBytes() == nullptr || !getSlab(me->getBytes()).isFlushing());
+    });
+    pageLock.lock();
+  }
+
   // first, we need to see if this page is currently pinned
   if (me->isPinned()) {
     return;
@@ -889,6 +1728,9 @@ void PDBBufferManagerImpl::repin(PDBPagePtr me, unique_lock<mutex> &lock) {
     return;
   }
 
+  // we must not hold the page while we look for memory, the pages we evict are locked
+  pageLock.unlock();
+
   // it is an anonymous page, so we have to look up its location
   PDBPageInfo myInfo = me->getLocation();
 
@@ -896,57 +1738,150 @@ void PDBBufferManagerImpl::repin(PDBPagePtr me, unique_lock<mutex> &lock) {
   me->status = PDB_PAGE_LOADING;
 
   // grab space from an empty page
-  me->setBytes(getEmptyMemory(myInfo.numBytes, lock));
+  me->setBytes(getEmptyMemory(myInfo.numBytes, lock, me->job));
 
   registerMiniPage(me);
   me->setPinned();
 
-  if (me->isAnonymous()) {
+  // the page was evicted and is used again, let the eviction policy know
+  void *parent = (char *) sharedMemory.memory + ((((char *) me->getBytes() - (char *) sharedMemory.memory) / sharedMemory.pageSize) * sharedMemory.pageSize);
+  evictionPolicy->reloaded(parent);
 
-    // unlock the buffer manager
-    lock.unlock();
+  // the page has to be read from disk
+  toLoad.emplace_back(me);
+}
 
-    // read the page from disk
-    ssize_t read_bytes;
-    read_bytes = pread(tempFileFD, me->getBytes(), MIN_PAGE_SIZE << myInfo.numBytes, myInfo.startPos);
-    if (read_bytes == -1) {
-      std::cerr << "repin error when reading anonymous page from disk with errno: " << strerror(errno) << std::endl;
-      exit(1);
+void PDBBufferManagerImpl::repinPages(std::vector<PDBPagePtr> pages, unique_lock<mutex> &lock) {
+
+  while (!pages.empty()) {
+
+    // repin the pages nobody is working on, and remember the ones that somebody is
+    std::vector<PDBPagePtr> busy;
+    std::vector<PDBPagePtr> toLoad;
+    for (auto &page : pages) {
+
+      // we check the status right before we start, since looking for memory might have unlocked the buffer manager
+      if (page->status == PDB_PAGE_LOADING || page->status == PDB_PAGE_UNLOADING) {
+        busy.emplace_back(page);
+        continue;
+      }
+
+      startRepin(page, lock, toLoad);
     }
 
-  } else {
+    // read all the pages that were not in RAM, we have to do this before we wait since the pages are marked as loading
+    loadPages(toLoad, lock);
 
-    // unlock the buffer manager
-    lock.unlock();
+    // log the repins
+    for (auto &page : toLoad) {
+      logRepin(page->whichSet, page->whichPage());
+    }
+
+    // if nobody else was working on a page we are done
+    if (busy.empty()) {
+      return;
+    }
+
+    // wait till at least one of the busy pages is done and try them again
+    waitForPages(lock, [&] {
+      return std::any_of(busy.begin(), busy.end(), [](const PDBPagePtr &page) {
+        return !(page->status == PDB_PAGE_LOADING || page->status == PDB_PAGE_UNLOADING);
+      });
+    });
+    pages = std::move(busy);
+  }
+}
+
+void PDBBufferManagerImpl::loadPages(std::vector<PDBPagePtr> &pages, unique_lock<mutex> &lock) {
 
-    // read the page from disk
-    ssize_t read_bytes;
-    read_bytes = pread(fds[me->getSet()], me->getBytes(), MIN_PAGE_SIZE << myInfo.numBytes, myInfo.startPos);
-    if (read_bytes == -1) {
-      std::cerr << "repin error when reading the page from disk with errno: " << strerror(errno) << std::endl;
+  // if there is nothing to read we are done
+  if (pages.empty()) {
+    return;
+  }
+
+  // make the reads
+  std::vector<PDBBufferManagerIORequest> reads;
+  reads.reserve(pages.size());
+  for (auto &page : pages) {
+    addRead(page, reads);
+  }
+
+  // count them
+  numPageReads.fetch_add(reads.size(), std::memory_order_relaxed);
+  for (auto &r : reads) {
+    numBytesRead.fetch_add(r.numBytes, std::memory_order_relaxed);
+  }
+
+  // unlock the buffer manager while we read the pages
+  lock.unlock();
+
+  // read them all
+  ioEngine->execute(reads);
+  for (auto &r : reads) {
+    if (!r.isComplete()) {
+      std::cerr << "Error when reading the page from disk with " << r.getError() << std::endl;
       exit(1);
     }
   }
 
-  // unlock the mutex
+  // make sure we got what we wrote and decompress the ones that are compressed
+  verifyReads(pages, reads);
+  decompressReads(reads);
+
+  // lock it again
   lock.lock();
 
-  // set the page to loaded
-  me->status = PDB_PAGE_LOADED;
+  // set the pages to loaded
+  for (auto &page : pages) {
+    page->status = PDB_PAGE_LOADED;
+  }
+}
+
+void PDBBufferManagerImpl::repinAll(std::vector<PDBPageHandle> &pages) {
 
-  // log the repin
-  logRepin(me->whichSet, me->whichPage());
+  // count the requests
+  numPageRequests.fetch_add(pages.size(), std::memory_order_relaxed);
+
+  // tell the subscribers about the memory pressure the previous requests left us with
+  signalMemoryPressure();
+
+  // grab the pages
+  std::vector<PDBPagePtr> toRepin;
+  toRepin.reserve(pages.size());
+  for (auto &page : pages) {
+    toRepin.emplace_back(page->page);
+  }
+
+  // lock the buffer manager and repin them
+  unique_lock<mutex> lock(m);
+  repinPages(std::move(toRepin), lock);
 
   // notify all waiting conditional variables
   lock.unlock();
   pagesCV.notify_all();
 }
 
+void PDBBufferManagerImpl::unpinAll(std::vector<PDBPageHandle> &pages) {
+
+  // unpin the pages, this only locks their shards
+  for (auto &page : pages) {
+    unpin(page->page);
+  }
+}
+
 PDBPageHandle PDBBufferManagerImpl::getPage() {
   return getPage(sharedMemory.pageSize);
 }
 
 PDBPageHandle PDBBufferManagerImpl::getPage(size_t maxBytes) {
+  return getAnonymousPage(maxBytes, -1);
+}
+
+PDBPageHandle PDBBufferManagerImpl::getJobPage(uint64_t jobID, size_t minBytes) {
+  return getAnonymousPage(minBytes, (int64_t) jobID);
+}
+
+PDBPageHandle PDBBufferManagerImpl::getAnonymousPage(size_t maxBytes, int64_t job, int64_t numaNode) {
 
   if (!initialized) {
     cerr << "Can't call getMaxPageSize () without initializing the storage manager\n";
@@ -957,14 +1892,72 @@ PDBPageHandle PDBBufferManagerImpl::getPage(size_t maxBytes) {
     std::cerr << maxBytes << " is larger than the system page size of " << sharedMemory.pageSize << "\n";
   }
 
+  // tell the subscribers about the memory pressure the previous requests left us with
+  signalMemoryPressure();
+
+  // lock the buffer manager
+  unique_lock<mutex> lock(m);
+
+  // make the page
+  auto returnVal = makeAnonymousPage(getLogPageSize(maxBytes), lock, job, numaNode);
+
+  // log the get page
+  logGetPage(maxBytes, returnVal->whichPage());
+
+  // return
+  return make_shared<PDBPageHandleBase>(returnVal);
+}
+
+std::vector<PDBPageHandle> PDBBufferManagerImpl::getAnonymousPages(size_t numPages, size_t minBytes) {
+  return getAnonymousPages(numPages, minBytes, -1);
+}
+
+std::vector<PDBPageHandle> PDBBufferManagerImpl::getJobPages(uint64_t jobID, size_t numPages, size_t minBytes) {
+  return getAnonymousPages(numPages, minBytes, (int64_t) jobID);
+}
+
+std::vector<PDBPageHandle> PDBBufferManagerImpl::getAnonymousPages(size_t numPages, size_t minBytes, int64_t job, int64_t numaNode) {
+
+  if (!initialized) {
+    cerr << "Can't call getMaxPageSize () without initializing the storage manager\n";
+    exit(1);
+  }
+
+  if (minBytes > sharedMemory.pageSize) {
+    std::cerr << minBytes << " is larger than the system page size of " << sharedMemory.pageSize << "\n";
+  }
+
+  // tell the subscribers about the memory pressure the previous requests left us with
+  signalMemoryPressure();
+
   // lock the buffer manager
   unique_lock<mutex> lock(m);
 
-  // figure out the size of the page that we need
-  size_t bytesRequired = getLogPageSize(maxBytes);
+  // figure out the size of the pages that we need
+  size_t bytesRequired = getLogPageSize(minBytes);
+
+  // make the pages
+  std::vector<PDBPageHandle> pages;
+  pages.reserve(numPages);
+  for (size_t i = 0; i < numPages; ++i) {
+
+    // make the page
+    auto page = makeAnonymousPage(bytesRequired, lock, job, numaNode);
+
+    // log the get page
+    logGetPage(minBytes, page->whichPage());
+
+    // store the handle
+    pages.emplace_back(make_shared<PDBPageHandleBase>(page));
+  }
+
+  return pages;
+}
+
+PDBPagePtr PDBBufferManagerImpl::makeAnonymousPage(size_t bytesRequired, unique_lock<mutex> &lock, int64_t job, int64_t numaNode) {
 
   // grab space from an empty page
-  void *space = getEmptyMemory(bytesRequired, lock);
+  void *space = getEmptyMemory(bytesRequired, lock, job, numaNode);
 
   // figure out a free page number
   if (freeAnonPageNumbers.empty()) {
@@ -1001,16 +1994,17 @@ PDBPageHandle PDBBufferManagerImpl::getPage(size_t maxBytes) {
   returnVal->getLocation().numBytes = bytesRequired;
   returnVal->getLocation().startPos = -1;
   returnVal->status = PDB_PAGE_LOADED;
+  returnVal->job = job;
   registerMiniPage(returnVal);
 
-  // log the get page
-  logGetPage(maxBytes, returnVal->whichPage());
-
-  // return
-  return make_shared<PDBPageHandleBase>(returnVal);
+  return returnVal;
 }
 
 PDBPageHandle PDBBufferManagerImpl::getPage(PDBSetPtr whichSet, uint64_t i) {
+  return getPage(std::move(whichSet), i, -1);
+}
+
+PDBPageHandle PDBBufferManagerImpl::getPage(PDBSetPtr whichSet, uint64_t i, int64_t numaNode) {
 
   if (!initialized) {
     cerr << "Can't call getMaxPageSize () without initializing the storage manager\n";
@@ -1023,18 +2017,106 @@ PDBPageHandle PDBBufferManagerImpl::getPage(PDBSetPtr whichSet, uint64_t i) {
     exit(1);
   }
 
+  // count the request
+  numPageRequests.fetch_add(1, std::memory_order_relaxed);
+
   // check if we have the file for this set...
   checkIfOpen(whichSet);
 
+  // tell the subscribers about the memory pressure the previous requests left us with
+  signalMemoryPressure();
+
+  // figure out the shard of the page table the page belongs to
+  pair<PDBSetPtr, size_t> whichPage = make_pair(whichSet, i);
+  auto &shard = getPageShard(whichSet, i);
+
+  // if the page is already pinned and loaded we only need the shard to get a handle to it
+  {
+    // lock the shard
+    std::unique_lock<std::mutex> shardLock(shard.m);
+
+    // check if the page is pinned and loaded
+    auto it = shard.allPages.find(whichPage);
+    if (it != shard.allPages.end() && it->second->isPinned() && it->second->status == PDB_PAGE_LOADED) {
+
+      // make a handle while the shard is locked so the page can not be unpinned in the mean time
+      auto ret = make_shared<PDBPageHandleBase>(it->second);
+      shardLock.unlock();
+
+#ifdef DEBUG_BUFFER_MANAGER
+      // if the log reads the state of the whole buffer manager we need to lock it
+      std::unique_lock<std::mutex> lock(m, std::defer_lock);
+      if (logsBufferManagerState()) {
+        lock.lock();
+      }
+#endif
+
+      // log the get page
+      logGetPage(whichSet, i);
+
+      // return the page
+      return ret;
+    }
+
+    // if the page was never created we can put it on one of the full pages we keep ready for the new pages
+    PDBPageInfo location;
+    void *space = nullptr;
+    if (it == shard.allPages.end() && !getPageDirectory(whichSet)->getPageLocation(i, location) &&
+        (space = takeReservedPage(getLocalArena(numaNode))) != nullptr) {
+
+      // create the page, it is pinned, dirty and loaded right away
+      auto page = make_shared<PDBPage>(*this);
+      page->setMe(page);
+      page->setPinned();
+      page->setDirty();
+      page->setSet(whichSet);
+      page->setPageNum(i);
+      page->setAnonymous(false);
+      page->getLocation().startPos = i;
+      page->getLocation().numBytes = logOfPageSize;
+      page->setBytes(space);
+      page->status = PDB_PAGE_LOADED;
+
+      // the full page is not in the eviction policy, so we only have to put the page on it and pin it
+      getSlab(space).addPage(page);
+      getNumPinned(space) = 1;
+      numPinnedFullPages++;
+      updateMemoryPressure();
+
+      // store it in allPages and make a handle while the shard is locked
+      shard.allPages[whichPage] = page;
+      auto pageHandle = make_shared<PDBPageHandleBase>(page);
+      shardLock.unlock();
+
+#ifdef DEBUG_BUFFER_MANAGER
+      // if the log reads the state of the whole buffer manager we need to lock it
+      std::unique_lock<std::mutex> lock(m, std::defer_lock);
+      if (logsBufferManagerState()) {
+        lock.lock();
+      }
+#endif
+
+      // log the get page
+      logGetPage(whichSet, i);
+
+      // return the page
+      return pageHandle;
+    }
+  }
+
   // lock the buffer manager
   std::unique_lock<std::mutex> lock(m);
 
+  // lock the shard of the page
+  std::unique_lock<std::mutex> shardLock(shard.m);
+
   // next, see if the page is already in existence
-  pair<PDBSetPtr, size_t> whichPage = make_pair(whichSet, i);
-  if (allPages.find(whichPage) == allPages.end()) {
+  auto pageIt = shard.allPages.find(whichPage);
+  if (pageIt == shard.allPages.end()) {
 
     // it is not there, so see if we have previously created it
-    if (pageLocations.find(whichPage) == pageLocations.end()) {
+    PDBPageInfo location;
+    if (!getPageDirectory(whichSet)->getPageLocation(i, location)) {
 
       // we have not previously created it
       PDBPageInfo myInfo;
@@ -1053,14 +2135,17 @@ PDBPageHandle PDBBufferManagerImpl::getPage(PDBSetPtr whichSet, uint64_t i) {
       page->setAnonymous(false);
       page->getLocation() = myInfo;
 
+      // mark that we are loading the page
+      page->status = PDB_PAGE_LOADING;
+
       // store it in allPages
-      allPages[whichPage] = page;
+      shard.allPages[whichPage] = page;
 
-      // mark that we are loading the page
-      page->status = PDB_PAGE_LOADING;
+      // we are done with the shard, we must not hold it while looking for memory since that might unlock the buffer manager
+      shardLock.unlock();
 
       // set the physical address of the page
-      page->setBytes(getEmptyMemory(myInfo.numBytes, lock));
+      page->setBytes(getEmptyMemory(myInfo.numBytes, lock, -1, numaNode));
 
       // and now that we have the physical we can simply register the page (add it to the constituent pages and pin the parent)
       registerMiniPage(page);
@@ -1071,6 +2156,9 @@ PDBPageHandle PDBBufferManagerImpl::getPage(PDBSetPtr whichSet, uint64_t i) {
       // mark the page as loaded
       page->status = PDB_PAGE_LOADED;
 
+      // keep some full pages ready so the next new pages don't need the buffer manager
+      refillReservedPages();
+
       // log the get page
       logGetPage(whichSet, i);
 
@@ -1084,7 +2172,7 @@ PDBPageHandle PDBBufferManagerImpl::getPage(PDBSetPtr whichSet, uint64_t i) {
     } else {
 
       // we have previously created it, so load it up
-      PDBPageInfo &myInfo = pageLocations[whichPage];
+      PDBPageInfo myInfo = location;
 
       // create the page and store it in the allPages, we have to do this before we unlock the buffer manager,
       // and lock the page. This is to avoid the the scenario where some other thread requests this page but we still haven't
@@ -1098,17 +2186,20 @@ PDBPageHandle PDBBufferManagerImpl::getPage(PDBSetPtr whichSet, uint64_t i) {
       page->setAnonymous(false);
       page->getLocation() = myInfo;
 
-      // store it in allPages
-      allPages[whichPage] = page;
-
       // mark that we are loading the page
       page->status = PDB_PAGE_LOADING;
 
+      // store it in allPages
+      shard.allPages[whichPage] = page;
+
+      // we are done with the shard, we must not hold it while looking for memory since that might unlock the buffer manager
+      shardLock.unlock();
+
       // make a return value
       auto pagerHandle = make_shared<PDBPageHandleBase>(page);
 
       // grab space from an empty page
-      void *space = getEmptyMemory(myInfo.numBytes, lock);
+      void *space = getEmptyMemory(myInfo.numBytes, lock, -1, numaNode);
 
       // set the physical address of the page
       page->setBytes(space);
@@ -1116,24 +2207,9 @@ PDBPageHandle PDBBufferManagerImpl::getPage(PDBSetPtr whichSet, uint64_t i) {
       // and now that we have the physical we can simply register the page (add it to the constituent pages and pin the parent)
       registerMiniPage(page);
 
-      // unlock since we are working on loading the file
-      lock.unlock();
-
-      // read the data from disk
-      auto fd = getFileDescriptor(whichSet);
-
-      ssize_t read_bytes;
-      read_bytes = pread(fd, space, MIN_PAGE_SIZE << myInfo.numBytes, myInfo.startPos);
-      if (read_bytes == -1) {
-        std::cerr << "getPage Error when read data from disk with errno: " << strerror(errno) << std::endl;
-        exit(1);
-      }
-
-      // finished working on the thing lock it
-      lock.lock();
-
-      // mark the page as loaded
-      page->status = PDB_PAGE_LOADED;
+      // read the data from disk, the buffer manager is unlocked while we read and the page is marked as loaded
+      std::vector<PDBPagePtr> toLoad = { page };
+      loadPages(toLoad, lock);
 
       // log the get page
       logGetPage(whichSet, i);
@@ -1148,14 +2224,17 @@ PDBPageHandle PDBBufferManagerImpl::getPage(PDBSetPtr whichSet, uint64_t i) {
   }
 
   // grab a page
-  auto page = allPages[whichPage];
+  auto page = pageIt->second;
 
   // make a handle to the page we have to do that before we lock the conditional variable so the page does not get
   // removed from the allPages if it was unloading and there are no handles to it...
   auto ret = make_shared<PDBPageHandleBase>(page);
 
+  // we are done with the shard
+  shardLock.unlock();
+
   // wait while the page is loading
-  pagesCV.wait(lock, [&] { return !(page->status == PDB_PAGE_LOADING || page->status == PDB_PAGE_UNLOADING); });
+  waitForPages(lock, [&] { return !(page->status == PDB_PAGE_LOADING || page->status == PDB_PAGE_UNLOADING); });
 
   // log the get page
   logGetPage(whichSet, i);
@@ -1166,36 +2245,559 @@ PDBPageHandle PDBBufferManagerImpl::getPage(PDBSetPtr whichSet, uint64_t i) {
   return ret;
 }
 
-void *PDBBufferManagerImpl::getEmptyMemory(int64_t pageSize, unique_lock<mutex> &lock) {
+std::vector<PDBPageHandle> PDBBufferManagerImpl::getPages(PDBSetPtr whichSet, const std::vector<uint64_t> &pageNums) {
+  return getPages(std::move(whichSet), pageNums, -1);
+}
 
-  // get space for it... first see if the space is available
-  if (emptyMiniPages[pageSize].empty()) {
-    createAdditionalMiniPages(pageSize, lock);
+std::vector<PDBPageHandle> PDBBufferManagerImpl::getPages(PDBSetPtr whichSet, const std::vector<uint64_t> &pageNums, int64_t numaNode) {
+
+  if (!initialized) {
+    cerr << "Can't call getMaxPageSize () without initializing the storage manager\n";
+    exit(1);
   }
 
-  // grab an empty page
-  void *space = emptyMiniPages[pageSize].back();
-  emptyMiniPages[pageSize].pop_back();
+  // make sure we don't have a null table
+  if (whichSet == nullptr) {
+    cerr << "Can't allocate a page with a null table!!\n";
+    exit(1);
+  }
 
-  // determine the parent of this guy
-  void *whichPage = (char *) sharedMemory.memory
-      + ((((char *) space - (char *) sharedMemory.memory) / sharedMemory.pageSize) * sharedMemory.pageSize);
+  // count the requests
+  numPageRequests.fetch_add(pageNums.size(), std::memory_order_relaxed);
+
+  // check if we have the file for this set...
+  checkIfOpen(whichSet);
+
+  // tell the subscribers about the memory pressure the previous requests left us with
+  signalMemoryPressure();
+
+  // the handles we return, the pages that already existed and the pages we have to read from disk
+  std::vector<PDBPageHandle> pages;
+  std::vector<PDBPagePtr> existing;
+  std::vector<PDBPagePtr> toLoad;
+  pages.reserve(pageNums.size());
+
+  // lock the buffer manager
+  std::unique_lock<std::mutex> lock(m);
+
+  for (auto i : pageNums) {
+
+    // lock the shard of the page
+    pair<PDBSetPtr, size_t> whichPage = make_pair(whichSet, i);
+    auto &shard = getPageShard(whichSet, i);
+    std::unique_lock<std::mutex> shardLock(shard.m);
+
+    // if the page already exists we repin it once we have created all the other pages
+    auto pageIt = shard.allPages.find(whichPage);
+    if (pageIt != shard.allPages.end()) {
+      pages.emplace_back(make_shared<PDBPageHandleBase>(pageIt->second));
+      existing.emplace_back(pageIt->second);
+      continue;
+    }
+
+    // see if we have previously created it
+    PDBPageInfo location;
+    bool onDisk = getPageDirectory(whichSet)->getPageLocation(i, location);
+    if (!onDisk) {
+      location.startPos = i;
+      location.numBytes = logOfPageSize;
+    }
+
+    // create the page and store it in the allPages before we unlock anything, so that nobody else creates it
+    auto page = make_shared<PDBPage>(*this);
+    page->setMe(page);
+    page->setPinned();
+    page->setSet(whichSet);
+    page->setPageNum(i);
+    page->setAnonymous(false);
+    page->getLocation() = location;
+    page->status = PDB_PAGE_LOADING;
+    shard.allPages[whichPage] = page;
+    pages.emplace_back(make_shared<PDBPageHandleBase>(page));
+
+    // a new page is dirty, the one we read is not
+    if (onDisk) {
+      page->setClean();
+    } else {
+      page->setDirty();
+    }
+
+    // we must not hold the shard while looking for memory since that might unlock the buffer manager
+    shardLock.unlock();
+
+    // set the physical address of the page and register it
+    page->setBytes(getEmptyMemory(location.numBytes, lock, -1, numaNode));
+    registerMiniPage(page);
+
+    // if we wrote it before we have to read it, otherwise it is ready
+    if (onDisk) {
+      toLoad.emplace_back(page);
+    } else {
+      page->status = PDB_PAGE_LOADED;
+    }
+  }
+
+  // read all the pages at once
+  loadPages(toLoad, lock);
+
+  // repin the pages that already existed
+  repinPages(std::move(existing), lock);
+
+  // log the get pages
+  for (auto i : pageNums) {
+    logGetPage(whichSet, i);
+  }
+
+  // notify all waiting conditional variables
+  lock.unlock();
+  pagesCV.notify_all();
+
+  return pages;
+}
+
+void PDBBufferManagerImpl::addWrite(const PDBPagePtr &page, std::vector<PDBBufferManagerIORequest> &writes, std::vector<PDBPagePtr> &written) {
+
+  // anonymous pages go to a temporary file, if the page was already written it keeps its location
+  if (page->isAnonymous()) {
+    placeAnonymousPage(page);
+  }
+
+  // the compressed bytes are not aligned so they always go through the page cache
+  PDBPageInfo myInfo = page->getLocation();
+  auto compression = getCompression(page);
+  void *bytes = compression == PDB_PAGE_COMPRESSION_NONE ? page->getBytes() : nullptr;
+
+  // set pages go to the file of the set, anonymous pages to the temporary file
+  int fd = page->isAnonymous() ? getTempFileDescriptor(myInfo.device, bytes, MIN_PAGE_SIZE << myInfo.numBytes, myInfo.startPos)
+                               : getFileDescriptor(page->getSet(), myInfo.device, bytes, MIN_PAGE_SIZE << myInfo.numBytes, myInfo.startPos);
+  writes.emplace_back(fd, page->getBytes(), MIN_PAGE_SIZE << myInfo.numBytes, myInfo.startPos, true);
+  writes.back().device = myInfo.device;
+  written.emplace_back(page);
+
+  // mark it so it is compressed right before it is written
+  if (compression != PDB_PAGE_COMPRESSION_NONE) {
+    auto &write = writes.back();
+    write.compression = compression;
+    write.page = page->getBytes();
+    write.pageSize = MIN_PAGE_SIZE << myInfo.numBytes;
+  }
+}
+
+void PDBBufferManagerImpl::addRead(const PDBPagePtr &page, std::vector<PDBBufferManagerIORequest> &reads) {
+
+  // if the page is compressed we only read the compressed bytes, they are not aligned so they go through the page cache
+  PDBPageInfo myInfo = page->getLocation();
+  bool isCompressed = myInfo.compression != PDB_PAGE_COMPRESSION_NONE;
+  void *bytes = isCompressed ? nullptr : page->getBytes();
+
+  // set pages come from the file of the set, anonymous pages from the temporary file
+  int fd = page->isAnonymous() ? getTempFileDescriptor(myInfo.device, bytes, MIN_PAGE_SIZE << myInfo.numBytes, myInfo.startPos)
+                               : getFileDescriptor(page->getSet(), myInfo.device, bytes, MIN_PAGE_SIZE << myInfo.numBytes, myInfo.startPos);
+  reads.emplace_back(fd, page->getBytes(), MIN_PAGE_SIZE << myInfo.numBytes, myInfo.startPos, false);
+  reads.back().device = myInfo.device;
+
+  // the compressed bytes go into the buffer, they are decompressed into the page once they are read
+  if (isCompressed) {
+    auto &read = reads.back();
+    read.compression = myInfo.compression;
+    read.page = page->getBytes();
+    read.pageSize = MIN_PAGE_SIZE << myInfo.numBytes;
+    read.buffer.resize(myInfo.compressedBytes);
+    read.bytes = read.buffer.data();
+    read.numBytes = read.buffer.size();
+  }
+
+  // the checksum of the bytes we are going to read
+  reads.back().checksum = myInfo.checksum;
+}
+
+void PDBBufferManagerImpl::compressWrites(std::vector<PDBBufferManagerIORequest> &writes) {
+
+  for (auto &write : writes) {
+
+    // skip the pages that are not compressed
+    if (write.compression == PDB_PAGE_COMPRESSION_NONE) {
+      continue;
+    }
+
+    // compress the page into the buffer
+    write.buffer.resize(PDBBufferManagerCompression::getMaxCompressedSize(write.compression, write.pageSize));
+    auto compressedSize = PDBBufferManagerCompression::compress(write.compression,
+                                                                (char *) write.page,
+                                                                write.pageSize,
+                                                                write.buffer.data(),
+                                                                write.buffer.size());
+
+    // if it did not get smaller we write the page as it is
+    if (compressedSize == 0 || compressedSize >= write.pageSize) {
+      write.compression = PDB_PAGE_COMPRESSION_NONE;
+      write.buffer.clear();
+      continue;
+    }
+
+    // otherwise we write the compressed bytes
+    write.bytes = write.buffer.data();
+    write.numBytes = compressedSize;
+  }
+}
+
+void PDBBufferManagerImpl::decompressReads(std::vector<PDBBufferManagerIORequest> &reads) {
+
+  for (auto &read : reads) {
+
+    // skip the pages that are not compressed
+    if (read.compression == PDB_PAGE_COMPRESSION_NONE) {
+      continue;
+    }
+
+    // decompress the buffer into the page
+    if (!read.isComplete() ||
+        !PDBBufferManagerCompression::decompress(read.compression, read.buffer.data(), read.numBytes, (char *) read.page, read.pageSize)) {
+      std::cerr << "Error when decompressing the page read from disk, the page is corrupted" << std::endl;
+      exit(1);
+    }
+  }
+}
+
+void PDBBufferManagerImpl::checksumWrites(std::vector<PDBBufferManagerIORequest> &writes) {
+
+  // the checksum is of the bytes that actually go to disk, so a compressed page is checked before it is decompressed
+  for (auto &write : writes) {
+    write.checksum = PDBBufferManagerChecksum::crc32c(write.bytes, write.numBytes);
+  }
+}
+
+void PDBBufferManagerImpl::verifyReads(const std::vector<PDBPagePtr> &pages, std::vector<PDBBufferManagerIORequest> &reads) {
+
+  // if we are not verifying we are done
+  if (!verifyChecksums) {
+    return;
+  }
+
+  for (size_t i = 0; i < reads.size(); ++i) {
+
+    // check if we got what we wrote
+    auto &read = reads[i];
+    if (PDBBufferManagerChecksum::crc32c(read.bytes, read.numBytes) == read.checksum) {
+      continue;
+    }
+    numChecksumFailures++;
+
+    // the bad bytes might have come from the transfer and not the disk, so we try once more
+    std::vector<PDBBufferManagerIORequest> retry;
+    retry.emplace_back(std::move(read));
+    ioEngine->execute(retry);
+    read = std::move(retry.back());
+    if (read.isComplete() && PDBBufferManagerChecksum::crc32c(read.bytes, read.numBytes) == read.checksum) {
+      std::cerr << "The checksum of page " << pages[i]->whichPage() << " did not match, reading it again fixed it" << std::endl;
+      continue;
+    }
+
+    // the page is corrupted
+    std::cerr << "The checksum of page " << pages[i]->whichPage()
+              << (pages[i]->isAnonymous() ? std::string(" of the temporary file") : " of the set " + pages[i]->getSet()->getSetName())
+              << " does not match what was written, the page is corrupted" << std::endl;
+    exit(1);
+  }
+}
+
+void PDBBufferManagerImpl::recordWrites(const std::vector<PDBPagePtr> &written, const std::vector<PDBBufferManagerIORequest> &writes) {
+
+  // count them
+  numPageWrites.fetch_add(writes.size(), std::memory_order_relaxed);
+  for (auto &w : writes) {
+    numBytesWritten.fetch_add(w.numBytes, std::memory_order_relaxed);
+  }
+
+  for (size_t i = 0; i < written.size(); ++i) {
+
+    // remember whether the page was compressed and to how many bytes
+    auto &location = written[i]->getLocation();
+    location.compression = writes[i].compression;
+    location.compressedBytes = writes[i].compression == PDB_PAGE_COMPRESSION_NONE ? 0 : writes[i].numBytes;
+    location.checksum = writes[i].checksum;
+
+    // the set pages are looked up in the page directory when they are read again
+    if (!written[i]->isAnonymous()) {
+      getPageDirectory(written[i]->getSet())->setPageLocation(written[i]->whichPage(), location);
+    }
+  }
+}
+
+PDBPageCompression PDBBufferManagerImpl::getCompression(const PDBPagePtr &page) {
+
+  // anonymous pages use the codec of the temporary file
+  if (page->isAnonymous()) {
+    return tempFileCompression;
+  }
 
-  // remove the page we just grabbed from the pool of the unused pages for the parent page...
-  auto &parentPage = unusedMiniPages[whichPage].first;
-  auto it = std::find(parentPage.begin(), parentPage.end(), space);
-  parentPage.erase(it);
+  // set pages the codec of their set
+  auto it = setCompressions.find(page->getSet());
+  return it == setCompressions.end() ? PDB_PAGE_COMPRESSION_NONE : it->second;
+}
+
+void PDBBufferManagerImpl::setCompression(const PDBSetPtr &whichSet, PDBPageCompression compression) {
+
+  // lock the buffer manager
+  std::unique_lock<std::mutex> lock(m);
+
+  // if we were not built with the codec we use snappy
+  if (compression != PDB_PAGE_COMPRESSION_NONE) {
+    compression = PDBBufferManagerCompression::getSupported(compression);
+  }
+
+  setCompressions[whichSet] = compression;
+}
+
+void PDBBufferManagerImpl::setVerifyChecksums(bool enable) {
+
+  // lock the buffer manager
+  std::unique_lock<std::mutex> lock(m);
+
+  // set the flag
+  verifyChecksums = enable;
+}
+
+uint64_t PDBBufferManagerImpl::getNumChecksumFailures() {
+  return numChecksumFailures;
+}
+
+PDBBufferManagerStats PDBBufferManagerImpl::getStats() {
+
+  // the counters
+  PDBBufferManagerStats stats;
+  stats.pageSize = sharedMemory.pageSize;
+  stats.numPages = sharedMemory.numPages;
+  stats.numPageRequests = numPageRequests;
+  stats.numPageReads = numPageReads;
+  stats.numPageWrites = numPageWrites;
+  stats.numBytesRead = numBytesRead;
+  stats.numBytesWritten = numBytesWritten;
+  stats.numEvictions = numEvictions;
+  stats.pagesWaitNanos = pagesWaitNanos;
+  stats.spaceWaitNanos = spaceWaitNanos;
+
+  // if we were never initialized there is no buffer pool to look at
+  if (!initialized) {
+    return stats;
+  }
+
+  // lock the buffer manager so the buffer pool does not change while we look at it
+  unique_lock<mutex> lock(m);
+
+  // the free full pages, the reserved ones are free as well
+  stats.numFreeFullPages = getNumReservedPages();
+  for (auto &arena : arenas) {
+    stats.numFreeFullPages += arena.emptyFullPages.size();
+  }
+
+  // the used ones, pinned or evictable
+  for (size_t i = 0; i < sharedMemory.numPages; ++i) {
+    if (numPinned[i] > 0) {
+      stats.numPinnedFullPages++;
+    } else if (numPinned[i] == 0) {
+      stats.numEvictableFullPages++;
+    }
+  }
+
+  // how the split full pages are used
+  stats.sizeClasses.resize(logOfPageSize + 1);
+  for (size_t i = 0; i < stats.sizeClasses.size(); ++i) {
+    stats.sizeClasses[i].miniPageSize = MIN_PAGE_SIZE << i;
+  }
+  for (auto &slab : slabs) {
+
+    // skip the full pages that are not split
+    if (slab.getNumMiniPages() == 0) {
+      continue;
+    }
+
+    auto &sizeClass = stats.sizeClasses[slab.getSizeClass()];
+    sizeClass.numFullPages++;
+    sizeClass.numMiniPages += slab.getNumMiniPages();
+    for (size_t i = 0; i < slab.getNumMiniPages(); ++i) {
+      sizeClass.numUsedMiniPages += slab.isFree(i) ? 0 : 1;
+    }
+  }
+
+  return stats;
+}
+
+void PDBBufferManagerImpl::waitForPages(unique_lock<mutex> &lock, const std::function<bool()> &isDone) {
+
+  // if we don't have to wait we don't time it
+  if (isDone()) {
+    return;
+  }
+
+  auto begin = std::chrono::steady_clock::now();
+  pagesCV.wait(lock, isDone);
+  auto waited = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin);
+  pagesWaitNanos.fetch_add(waited.count(), std::memory_order_relaxed);
+}
+
+void PDBBufferManagerImpl::waitForSpace(unique_lock<mutex> &lock, const std::function<bool()> &isDone) {
+
+  // if we don't have to wait we don't time it
+  if (isDone()) {
+    return;
+  }
+
+  auto begin = std::chrono::steady_clock::now();
+  spaceCV.wait(lock, isDone);
+  auto waited = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin);
+  spaceWaitNanos.fetch_add(waited.count(), std::memory_order_relaxed);
+}
+
+void PDBBufferManagerImpl::setStorageDirectories(const std::vector<std::string> &dirs) {
+  storageDirs = dirs;
+}
+
+void PDBBufferManagerImpl::setTempFileCompression(PDBPageCompression compression) {
+
+  // lock the buffer manager
+  std::unique_lock<std::mutex> lock(m);
+
+  // if we were not built with the codec we use snappy
+  if (compression != PDB_PAGE_COMPRESSION_NONE) {
+    compression = PDBBufferManagerCompression::getSupported(compression);
+  }
+
+  tempFileCompression = compression;
+}
+
+PDBPageCompression PDBBufferManagerImpl::getTempFileCompression(const pdb::NodeConfigPtr &config) {
+
+  // figure out the codec from its name
+  PDBPageCompression compression;
+  if (!PDBBufferManagerCompression::fromString(config->tempFileCompression, compression)) {
+    throw std::runtime_error("Unknown codec for the temporary file : " + config->tempFileCompression);
+  }
+
+  return compression;
+}
+
+void *PDBBufferManagerImpl::getEmptyMemory(int64_t pageSize, unique_lock<mutex> &lock, int64_t job, int64_t numaNode) {
+
+  // a job that is over its hard budget recycles its own memory, so it does not take the memory of the other jobs
+  if (job != -1 && jobBudgets.isOverHardLimit(job)) {
+    void *page = findJobVictim(job, false);
+    if (page != nullptr) {
+      jobBudgets.recycled(job);
+      evictFullPage(page, lock);
+    }
+  }
+
+  // we prefer the memory of the NUMA node the page is for
+  size_t whichArena = getLocalArena(numaNode);
+
+  // get space for it... first see if the space is available
+  if (arenas[whichArena].freeSlabs[pageSize] == nullptr) {
+    whichArena = createAdditionalMiniPages(pageSize, whichArena, lock);
+  }
+
+  // grab an empty page from the first slab that has one
+  auto &freeSlabs = arenas[whichArena].freeSlabs[pageSize];
+  auto *slab = freeSlabs;
+  void *space = slab->allocate();
+
+  // if that was the last free mini page of the slab it is no longer in the list
+  if (!slab->hasFree()) {
+    slab->unlink(freeSlabs);
+  }
 
   return space;
 }
 
-int PDBBufferManagerImpl::getFileDescriptor(const PDBSetPtr &whichSet) {
+std::string PDBBufferManagerImpl::getSetFile(const PDBSetPtr &whichSet, size_t device) {
+  return storageDirs[device] + "/" + whichSet->getSetName() + "." + whichSet->getDBName();
+}
+
+int PDBBufferManagerImpl::getFileDescriptor(const PDBSetPtr &whichSet, size_t device, void *bytes, size_t numBytes, size_t offset) {
 
   // lock the file descriptors structure to grab a descriptor
   unique_lock<mutex> blockLck(fdLck);
 
-  auto fd = fds[whichSet];
-  return fd;
+  // use the direct one if we can
+  if (canUseDirectIO(bytes, numBytes, offset)) {
+    auto it = directFds.find(whichSet);
+    if (it != directFds.end() && it->second[device] != -1) {
+      return it->second[device];
+    }
+  }
+
+  return fds[whichSet][device];
+}
+
+int PDBBufferManagerImpl::getTempFileDescriptor(size_t device, void *bytes, size_t numBytes, size_t offset) {
+
+  // use the direct one if we can
+  if (tempFileDirectFDs[device] != -1 && canUseDirectIO(bytes, numBytes, offset)) {
+    return tempFileDirectFDs[device];
+  }
+
+  return tempFileFDs[device];
+}
+
+bool PDBBufferManagerImpl::canUseDirectIO(void *bytes, size_t numBytes, size_t offset) {
+
+  // the memory, the size and the offset all need to be aligned, the requests that don't use the memory of the page,
+  // like the compressed ones, always go through the page cache
+  return useDirectIO &&
+         bytes != nullptr &&
+         ((uintptr_t) bytes) % PDB_DIRECT_IO_ALIGNMENT == 0 &&
+         numBytes % PDB_DIRECT_IO_ALIGNMENT == 0 &&
+         offset % PDB_DIRECT_IO_ALIGNMENT == 0;
+}
+
+size_t PDBBufferManagerImpl::getFilePosition(size_t endOfFile, size_t numBytes) {
+
+  // if the page can not be aligned we just put it at the end
+  if (!useDirectIO || numBytes % PDB_DIRECT_IO_ALIGNMENT != 0) {
+    return endOfFile;
+  }
+
+  // round up the position
+  return ((endOfFile + PDB_DIRECT_IO_ALIGNMENT - 1) / PDB_DIRECT_IO_ALIGNMENT) * PDB_DIRECT_IO_ALIGNMENT;
+}
+
+void PDBBufferManagerImpl::placeSetPage(const PDBPagePtr &page) {
+
+  // the consecutive pages of a set go to different directories so a scan reads from all the drives
+  PDBPageInfo location = page->getLocation();
+  location.device = (int64_t) (page->whichPage() % storageDirs.size());
+
+  // pages that can be read and written with direct I/O get an aligned position
+  size_t numBytes = MIN_PAGE_SIZE << location.numBytes;
+  size_t alignment = useDirectIO && numBytes % PDB_DIRECT_IO_ALIGNMENT == 0 ? PDB_DIRECT_IO_ALIGNMENT : 1;
+
+  // the directory only gives the page a location if it does not have one yet
+  if (getPageDirectory(page->getSet())->placePage(page->whichPage(), location, alignment)) {
+    page->getLocation() = location;
+  }
+}
+
+void PDBBufferManagerImpl::placeAnonymousPage(const PDBPagePtr &page) {
+
+  // if the page was already written it keeps its location
+  auto &myInfo = page->getLocation();
+  if (myInfo.startPos != -1) {
+    return;
+  }
+
+  // the pages go to the directories round robin
+  myInfo.device = (int64_t) nextTempDevice;
+  nextTempDevice = (nextTempDevice + 1) % storageDirs.size();
+
+  // reuse a free location of the directory if there is one, otherwise put the page at the end of the temporary file
+  auto &available = availablePositions[myInfo.device][myInfo.numBytes];
+  if (available.empty()) {
+    myInfo.startPos = getFilePosition(lastTempPos[myInfo.device], MIN_PAGE_SIZE << myInfo.numBytes);
+    lastTempPos[myInfo.device] = myInfo.startPos + (MIN_PAGE_SIZE << myInfo.numBytes);
+  } else {
+    myInfo.startPos = available.back();
+    available.pop_back();
+  }
 }
 
 void PDBBufferManagerImpl::checkIfOpen(PDBSetPtr &whichSet) {
@@ -1205,21 +2807,55 @@ void PDBBufferManagerImpl::checkIfOpen(PDBSetPtr &whichSet) {
   // open the file, if it is not open
   if (fds.find(whichSet) == fds.end()) {
 
-    // open the file
-    string fileLoc = storageLoc + "/" + whichSet->getSetName() + "." + whichSet->getDBName();
-    int fd = open(fileLoc.c_str(), O_CREAT | O_RDWR, 0666);
-    if (fd != -1) {
-      fds[whichSet] = fd;
-    } else {
-      std::cerr << "Fail to open the file at " << fileLoc << std::endl;
-      exit(1);
+    // open the file in every storage directory
+    auto &setFds = fds[whichSet];
+    for (size_t i = 0; i < storageDirs.size(); ++i) {
+      string fileLoc = getSetFile(whichSet, i);
+      int fd = open(fileLoc.c_str(), O_CREAT | O_RDWR, 0666);
+      if (fd != -1) {
+        setFds.emplace_back(fd);
+      } else {
+        std::cerr << "Fail to open the file at " << fileLoc << std::endl;
+        exit(1);
+      }
+
+      // if we are using direct I/O open it again with O_DIRECT, some file systems don't support it so we might not get it
+      if (useDirectIO) {
+        directFds[whichSet].emplace_back(open(fileLoc.c_str(), O_RDWR | O_DIRECT));
+      }
     }
-    // init the end of the file if we just created a new file
-    if (endOfFiles.find(whichSet) == endOfFiles.end()) {
-      endOfFiles[whichSet] = 0;
+    // open the page directory of the set if we don't have it
+    if (pageDirectories.find(whichSet) == pageDirectories.end()) {
+      pageDirectories[whichSet] = std::make_shared<PDBBufferManagerPageDirectory>(getPageDirectoryFile(whichSet), !reusePageDirectories);
     }
   }
 }
+
+PDBBufferManagerPageDirectoryPtr PDBBufferManagerImpl::getPageDirectory(const PDBSetPtr &whichSet) {
+
+  unique_lock<mutex> blockLck(fdLck);
+
+  // open the directory if we don't have it
+  auto it = pageDirectories.find(whichSet);
+  if (it == pageDirectories.end()) {
+    it = pageDirectories.emplace(whichSet, std::make_shared<PDBBufferManagerPageDirectory>(getPageDirectoryFile(whichSet), !reusePageDirectories)).first;
+  }
+
+  return it->second;
+}
+
+std::string PDBBufferManagerImpl::getPageDirectoryFile(const PDBSetPtr &whichSet) {
+
+  // the directory is stored next to the file of the set
+  return storageLoc + "/" + whichSet->getSetName() + "." + whichSet->getDBName() + ".dir";
+}
+PDBBufferManagerPageShard &PDBBufferManagerImpl::getPageShard(const PDBSetPtr &whichSet, size_t pageNum) {
+
+  // consecutive pages of a set go to different shards so that parallel scans don't collide
+  size_t hash = std::hash<std::string>()(whichSet->getDBName()) ^ (std::hash<std::string>()(whichSet->getSetName()) + pageNum);
+  return pageShards[hash % PDB_BUFFER_MANAGER_NUM_SHARDS];
+}
+
 size_t PDBBufferManagerImpl::getLogPageSize(size_t numBytes) {
 
   size_t bytesRequired = 0;
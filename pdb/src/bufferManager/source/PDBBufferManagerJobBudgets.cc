@@ -0,0 +1,151 @@
+#include <algorithm>
+#include "PDBBufferManagerJobBudgets.h"
+
+namespace pdb {
+
+void PDBBufferManagerJobBudgets::setDefaultBudget(size_t softLimit, size_t hardLimit) {
+
+  defaultSoftLimit = softLimit;
+  defaultHardLimit = hardLimit;
+
+  // the jobs that don't have their own budgets get the new ones
+  for (auto &it : jobs) {
+    if (!it.second.hasOwnBudget) {
+      bool wasOver = it.second.stats.numBytes > it.second.stats.softLimit;
+      it.second.stats.softLimit = softLimit;
+      it.second.stats.hardLimit = hardLimit;
+      updateOverSoftLimit(it.second, wasOver);
+    }
+  }
+}
+
+void PDBBufferManagerJobBudgets::setBudget(int64_t job, size_t softLimit, size_t hardLimit) {
+
+  // set the budgets
+  auto &j = getJob(job);
+  bool wasOver = j.stats.numBytes > j.stats.softLimit;
+  j.stats.softLimit = softLimit;
+  j.stats.hardLimit = hardLimit;
+  j.hasOwnBudget = true;
+
+  updateOverSoftLimit(j, wasOver);
+}
+
+void PDBBufferManagerJobBudgets::remove(int64_t job) {
+
+  // find the job
+  auto it = jobs.find(job);
+  if (it == jobs.end()) {
+    return;
+  }
+
+  // it is not over budget anymore
+  if (it->second.stats.numBytes > it->second.stats.softLimit) {
+    numOverSoftLimit--;
+  }
+  jobs.erase(it);
+}
+
+void PDBBufferManagerJobBudgets::charge(int64_t job, size_t numBytes) {
+
+  // add the bytes
+  auto &j = getJob(job);
+  bool wasOver = j.stats.numBytes > j.stats.softLimit;
+  j.stats.numBytes += numBytes;
+  j.stats.peakBytes = std::max(j.stats.peakBytes, j.stats.numBytes);
+
+  updateOverSoftLimit(j, wasOver);
+}
+
+void PDBBufferManagerJobBudgets::release(int64_t job, size_t numBytes) {
+
+  // find the job
+  auto it = jobs.find(job);
+  if (it == jobs.end()) {
+    return;
+  }
+
+  // remove the bytes
+  auto &j = it->second;
+  bool wasOver = j.stats.numBytes > j.stats.softLimit;
+  j.stats.numBytes -= std::min(j.stats.numBytes, numBytes);
+  updateOverSoftLimit(j, wasOver);
+
+  // if the job does not use any memory and has the default budgets there is no need to keep it
+  if (j.stats.numBytes == 0 && !j.hasOwnBudget) {
+    jobs.erase(it);
+  }
+}
+
+void PDBBufferManagerJobBudgets::evicted(int64_t job, bool overBudget) {
+
+  // find the job
+  auto it = jobs.find(job);
+  if (it == jobs.end()) {
+    return;
+  }
+
+  // count the eviction
+  it->second.stats.numEvicted++;
+  it->second.stats.numEvictedOverBudget += overBudget ? 1 : 0;
+}
+
+void PDBBufferManagerJobBudgets::recycled(int64_t job) {
+  getJob(job).stats.numRecycled++;
+}
+
+bool PDBBufferManagerJobBudgets::isOverSoftLimit(int64_t job) {
+
+  auto it = jobs.find(job);
+  return it != jobs.end() && it->second.stats.numBytes > it->second.stats.softLimit;
+}
+
+bool PDBBufferManagerJobBudgets::isOverHardLimit(int64_t job) {
+
+  auto it = jobs.find(job);
+  return it != jobs.end() && it->second.stats.numBytes > it->second.stats.hardLimit;
+}
+
+bool PDBBufferManagerJobBudgets::anyOverSoftLimit() {
+  return numOverSoftLimit != 0;
+}
+
+PDBBufferManagerJobStats PDBBufferManagerJobBudgets::getStats(int64_t job) {
+
+  // if we know the job return its stats
+  auto it = jobs.find(job);
+  if (it != jobs.end()) {
+    return it->second.stats;
+  }
+
+  // otherwise it has nothing
+  PDBBufferManagerJobStats stats;
+  stats.softLimit = defaultSoftLimit;
+  stats.hardLimit = defaultHardLimit;
+  return stats;
+}
+
+PDBBufferManagerJobBudgets::Job &PDBBufferManagerJobBudgets::getJob(int64_t job) {
+
+  // if we don't know the job give it the default budgets
+  auto it = jobs.find(job);
+  if (it == jobs.end()) {
+    it = jobs.emplace(job, Job()).first;
+    it->second.stats.softLimit = defaultSoftLimit;
+    it->second.stats.hardLimit = defaultHardLimit;
+  }
+
+  return it->second;
+}
+
+void PDBBufferManagerJobBudgets::updateOverSoftLimit(const Job &job, bool wasOver) {
+
+  bool isOver = job.stats.numBytes > job.stats.softLimit;
+  if (isOver && !wasOver) {
+    numOverSoftLimit++;
+  } else if (!isOver && wasOver) {
+    numOverSoftLimit--;
+  }
+}
+
+}
@@ -0,0 +1,68 @@
+#include "PDBBufferManagerLRUPolicy.h"
+
+namespace pdb {
+
+void PDBBufferManagerLRUPolicy::unpinned(void *page) {
+
+  // add the physical page to the LRU
+  lastUsed.insert(make_pair(page, lastTimeTick));
+  timeTicks[page] = lastTimeTick;
+
+  // increment the time tick
+  lastTimeTick++;
+}
+
+void PDBBufferManagerLRUPolicy::pinned(void *page) {
+  remove(page);
+}
+
+void PDBBufferManagerLRUPolicy::reloaded(void *page) {}
+
+void PDBBufferManagerLRUPolicy::freed(void *page) {
+  remove(page);
+}
+
+void *PDBBufferManagerLRUPolicy::evict() {
+
+  // if there are no pages we are done here
+  if (lastUsed.empty()) {
+    return nullptr;
+  }
+
+  // find the LRU and remove it
+  auto page = lastUsed.begin()->first;
+  lastUsed.erase(lastUsed.begin());
+  timeTicks.erase(page);
+
+  return page;
+}
+
+std::vector<void *> PDBBufferManagerLRUPolicy::getNextVictims(size_t numPages) {
+
+  // the pages are evicted from the least recently used one on
+  std::vector<void *> victims;
+  for (auto it = lastUsed.begin(); it != lastUsed.end() && victims.size() < numPages; ++it) {
+    victims.push_back(it->first);
+  }
+
+  return victims;
+}
+
+size_t PDBBufferManagerLRUPolicy::numEvictable() {
+  return lastUsed.size();
+}
+
+void PDBBufferManagerLRUPolicy::remove(void *page) {
+
+  // check if the page is in the LRU
+  auto it = timeTicks.find(page);
+  if (it == timeTicks.end()) {
+    return;
+  }
+
+  // remove it
+  lastUsed.erase(make_pair(page, it->second));
+  timeTicks.erase(it);
+}
+
+}
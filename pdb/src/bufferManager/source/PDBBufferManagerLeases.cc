@@ -0,0 +1,163 @@
+#include <sys/mman.h>
+#include <iostream>
+#include <new>
+#include "PDBBufferManagerLeases.h"
+
+namespace pdb {
+
+// the two processes update the same words so they have to be plain 32 bit integers
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "The state of a lease must be a 32 bit integer");
+
+PDBBufferManagerLeases::PDBBufferManagerLeases() {
+
+  // map the memory, it is shared so the process we fork sees the same leases
+  mappedSize = sizeof(Lease) * PDB_BUFFER_MANAGER_LEASES + sizeof(std::atomic<uint32_t>);
+  void *memory = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (memory == MAP_FAILED) {
+    std::cerr << "Fatal Error: Could not map the memory of the buffer manager leases.\n";
+    exit(1);
+  }
+
+  // construct the leases in it, they are all free
+  leases = new(memory) Lease[PDB_BUFFER_MANAGER_LEASES];
+  numUnpinned = new((char *) memory + sizeof(Lease) * PDB_BUFFER_MANAGER_LEASES) std::atomic<uint32_t>(0);
+  freeSlots.reserve(PDB_BUFFER_MANAGER_LEASES);
+  for (uint32_t i = 0; i < PDB_BUFFER_MANAGER_LEASES; ++i) {
+    leases[i].state = LEASE_FREE;
+    leases[i].dirty = 0;
+    leases[i].hint = PDB_PAGE_HINT_NORMAL;
+    leases[i].offset = 0;
+    freeSlots.emplace_back(PDB_BUFFER_MANAGER_LEASES - i - 1);
+  }
+}
+
+PDBBufferManagerLeases::~PDBBufferManagerLeases() {
+  munmap(leases, mappedSize);
+}
+
+int64_t PDBBufferManagerLeases::grant(uint64_t offset) {
+
+  // grab a free slot
+  uint32_t slot;
+  {
+    std::unique_lock<std::mutex> lck(m);
+
+    // if there is none the page simply goes without a lease
+    if (freeSlots.empty()) {
+      return -1;
+    }
+
+    slot = freeSlots.back();
+    freeSlots.pop_back();
+  }
+
+  // fill it in, the backend only looks at the offset after it pinned the lease so setting the state publishes it
+  auto &lease = leases[slot];
+  lease.offset = offset;
+  lease.dirty = 0;
+  lease.hint = PDB_PAGE_HINT_NORMAL;
+  auto generation = lease.state.load() >> 2u;
+  lease.state.store((generation << 2u) | LEASE_PINNED, std::memory_order_release);
+
+  return (int64_t) (((uint64_t) generation << 32u) | slot);
+}
+
+bool PDBBufferManagerLeases::revoke(int64_t lease, bool &isDirty) {
+  PDBPageAccessHint hint;
+  return revoke(lease, isDirty, hint);
+}
+
+bool PDBBufferManagerLeases::revoke(int64_t lease, bool &isDirty, PDBPageAccessHint &hint) {
+
+  // we can only take the frame back if the backend is not using it
+  auto &l = leases[(uint32_t) lease];
+  auto generation = (uint32_t) ((uint64_t) lease >> 32u);
+  uint32_t expected = (generation << 2u) | LEASE_UNPINNED;
+  if (!l.state.compare_exchange_strong(expected, ((generation + 1) << 2u) | LEASE_FREE)) {
+    return false;
+  }
+  numUnpinned->fetch_sub(1);
+
+  // the backend can not touch it anymore, grab the dirty bit and the hint and free the slot
+  isDirty = l.dirty != 0;
+  hint = (PDBPageAccessHint) l.hint.load();
+  {
+    std::unique_lock<std::mutex> lck(m);
+    freeSlots.emplace_back((uint32_t) lease);
+  }
+
+  return true;
+}
+
+void PDBBufferManagerLeases::release(int64_t lease) {
+
+  // bump the generation so the backend can not use it anymore
+  auto &l = leases[(uint32_t) lease];
+  auto generation = (uint32_t) ((uint64_t) lease >> 32u);
+  auto state = l.state.exchange(((generation + 1) << 2u) | LEASE_FREE);
+  if (state == ((generation << 2u) | LEASE_UNPINNED)) {
+    numUnpinned->fetch_sub(1);
+  }
+
+  // free the slot
+  std::unique_lock<std::mutex> lck(m);
+  freeSlots.emplace_back((uint32_t) lease);
+}
+
+bool PDBBufferManagerLeases::pin(int64_t lease, uint64_t &offset) {
+
+  // try to pin it
+  if (!transition(lease, LEASE_UNPINNED, LEASE_PINNED)) {
+    return false;
+  }
+  numUnpinned->fetch_sub(1);
+
+  // the frontend does not change the offset while the lease is ours
+  offset = leases[(uint32_t) lease].offset;
+  return true;
+}
+
+bool PDBBufferManagerLeases::unpin(int64_t lease, bool isDirty, PDBPageAccessHint hint) {
+
+  // the lease has to be pinned by us, nobody else can pin it so it is safe to check before we touch it
+  auto &l = leases[(uint32_t) lease];
+  auto generation = (uint32_t) ((uint64_t) lease >> 32u);
+  if (l.state.load() != ((generation << 2u) | LEASE_PINNED)) {
+    return false;
+  }
+
+  // remember whether we wrote to it and how it is going to be used, the frontend reads this once it revoked the lease
+  if (isDirty) {
+    l.dirty = 1;
+  }
+  l.hint = hint;
+
+  // count it before the frontend can see it unpinned, so the count is never below the number of unpinned leases
+  numUnpinned->fetch_add(1);
+  if (!transition(lease, LEASE_PINNED, LEASE_UNPINNED)) {
+    numUnpinned->fetch_sub(1);
+    return false;
+  }
+
+  return true;
+}
+
+bool PDBBufferManagerLeases::isUnpinned(int64_t lease) {
+  auto generation = (uint32_t) ((uint64_t) lease >> 32u);
+  return leases[(uint32_t) lease].state.load() == ((generation << 2u) | LEASE_UNPINNED);
+}
+
+uint32_t PDBBufferManagerLeases::getNumUnpinned() {
+  return numUnpinned->load();
+}
+
+bool PDBBufferManagerLeases::transition(int64_t lease, LeaseState from, LeaseState to) {
+
+  // only move it if it is still in the generation we were granted
+  auto &l = leases[(uint32_t) lease];
+  auto generation = (uint32_t) ((uint64_t) lease >> 32u);
+  uint32_t expected = (generation << 2u) | from;
+  return l.state.compare_exchange_strong(expected, (generation << 2u) | to);
+}
+
+}
@@ -0,0 +1,66 @@
+#include "PDBBufferManagerMemoryPressure.h"
+
+namespace pdb {
+
+PDBMemoryPressure PDBBufferManagerMemoryPressure::getLevel(size_t numPinned, size_t numPages) {
+
+  // if there is no buffer pool there is no pressure
+  if (numPages == 0) {
+    return PDB_MEMORY_PRESSURE_NONE;
+  }
+
+  // figure out the level from the percentage of the pool we can not evict
+  auto percent = (numPinned * 100) / numPages;
+  if (percent >= PDB_MEMORY_PRESSURE_CRITICAL_PERCENT) {
+    return PDB_MEMORY_PRESSURE_CRITICAL;
+  }
+  if (percent >= PDB_MEMORY_PRESSURE_HIGH_PERCENT) {
+    return PDB_MEMORY_PRESSURE_HIGH;
+  }
+  if (percent >= PDB_MEMORY_PRESSURE_MODERATE_PERCENT) {
+    return PDB_MEMORY_PRESSURE_MODERATE;
+  }
+  return PDB_MEMORY_PRESSURE_NONE;
+}
+
+uint64_t PDBBufferManagerMemoryPressure::subscribe(const PDBMemoryPressureCallback &callback) {
+
+  // add the subscriber
+  std::unique_lock<std::recursive_mutex> lck(m);
+  subscribers[nextID] = callback;
+
+  return nextID++;
+}
+
+void PDBBufferManagerMemoryPressure::unsubscribe(uint64_t id) {
+
+  // remove the subscriber
+  std::unique_lock<std::recursive_mutex> lck(m);
+  subscribers.erase(id);
+}
+
+PDBMemoryPressure PDBBufferManagerMemoryPressure::getLevel() const {
+  return (PDBMemoryPressure) level.load();
+}
+
+void PDBBufferManagerMemoryPressure::signal(PDBMemoryPressure newLevel) {
+
+  // if the level did not change we are done, this is the common case so it has to be cheap
+  if (level.load(std::memory_order_relaxed) == newLevel) {
+    return;
+  }
+
+  // lock the subscribers, and check again since somebody might have signaled the level in the meantime
+  std::unique_lock<std::recursive_mutex> lck(m);
+  if (level.exchange(newLevel) == newLevel) {
+    return;
+  }
+
+  // tell everybody, we copy them since a subscriber might unsubscribe in its callback
+  auto toCall = subscribers;
+  for (auto &subscriber : toCall) {
+    subscriber.second(newLevel);
+  }
+}
+
+}
@@ -0,0 +1,201 @@
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "PDBBufferManagerPageDirectory.h"
+
+namespace pdb {
+
+PDBBufferManagerPageDirectory::PDBBufferManagerPageDirectory(const std::string &fileName, bool truncate) : fileName(fileName) {
+
+  // open the file, if we truncate it it is a new directory
+  fd = open(fileName.c_str(), O_CREAT | O_RDWR | (truncate ? O_TRUNC : 0), 0666);
+  if (fd == -1) {
+    std::cerr << "Fail to open the page directory at " << fileName << std::endl;
+    exit(1);
+  }
+
+  // figure out how big it is
+  struct stat fileStat{};
+  if (fstat(fd, &fileStat) == -1) {
+    std::cerr << "Fail to stat the page directory at " << fileName << " with errno: " << strerror(errno) << std::endl;
+    exit(1);
+  }
+
+  // if it is a new directory make room for the initial entries
+  bool isNew = fileStat.st_size == 0;
+  if (isNew && ftruncate(fd, sizeof(Header) + INITIAL_NUM_ENTRIES * sizeof(Entry)) == -1) {
+    std::cerr << "Fail to create the page directory at " << fileName << " with errno: " << strerror(errno) << std::endl;
+    exit(1);
+  }
+
+  // map it
+  map();
+
+  // init the header of a new directory
+  if (isNew) {
+    header->magic = MAGIC;
+    header->numEntries = INITIAL_NUM_ENTRIES;
+    memset(header->endOfFile, 0, sizeof(header->endOfFile));
+  }
+
+  // make sure this is actually a page directory
+  if (mappedSize < sizeof(Header) || header->magic != MAGIC ||
+      mappedSize < sizeof(Header) + header->numEntries * sizeof(Entry)) {
+    std::cerr << "The file at " << fileName << " is not a valid page directory" << std::endl;
+    exit(1);
+  }
+}
+
+PDBBufferManagerPageDirectory::~PDBBufferManagerPageDirectory() {
+
+  // write it out and unmap it
+  sync();
+  munmap(header, mappedSize);
+  close(fd);
+}
+
+bool PDBBufferManagerPageDirectory::getPageLocation(size_t pageNum, PDBPageInfo &location) {
+
+  // lock the directory
+  std::unique_lock<std::mutex> lck(m);
+
+  // if the page is past the end of the directory it has no location
+  if (pageNum >= header->numEntries) {
+    return false;
+  }
+
+  // check if it has a location
+  Entry *entry = getEntry(pageNum);
+  if (entry->used == 0) {
+    return false;
+  }
+
+  // return the location
+  location.startPos = entry->startPos;
+  location.numBytes = entry->numBytes;
+  location.compressedBytes = entry->compressedBytes;
+  location.compression = (PDBPageCompression) entry->compression;
+  location.checksum = entry->checksum;
+  location.device = entry->device;
+  return true;
+}
+
+void PDBBufferManagerPageDirectory::setPageLocation(size_t pageNum, const PDBPageInfo &location) {
+
+  // lock the directory
+  std::unique_lock<std::mutex> lck(m);
+
+  // make sure we have an entry for the page
+  if (pageNum >= header->numEntries) {
+    grow(pageNum);
+  }
+
+  // store the location
+  Entry *entry = getEntry(pageNum);
+  entry->startPos = location.startPos;
+  entry->numBytes = location.numBytes;
+  entry->compressedBytes = (uint32_t) location.compressedBytes;
+  entry->compression = location.compression;
+  entry->checksum = location.checksum;
+  entry->device = (uint32_t) location.device;
+  entry->used = 1;
+}
+
+bool PDBBufferManagerPageDirectory::placePage(size_t pageNum, PDBPageInfo &location, size_t alignment) {
+
+  // lock the directory, nobody can take the same position in the mean time
+  std::unique_lock<std::mutex> lck(m);
+
+  // if the page already has a location we are done
+  if (pageNum < header->numEntries && getEntry(pageNum)->used != 0) {
+    return false;
+  }
+
+  // put it at the end of the file of its storage directory
+  size_t endOfFile = header->endOfFile[location.device];
+  location.startPos = (int64_t) (((endOfFile + alignment - 1) / alignment) * alignment);
+  header->endOfFile[location.device] = location.startPos + (MIN_PAGE_SIZE << location.numBytes);
+
+  // store the location
+  if (pageNum >= header->numEntries) {
+    grow(pageNum);
+  }
+  Entry *entry = getEntry(pageNum);
+  entry->startPos = location.startPos;
+  entry->numBytes = location.numBytes;
+  entry->compressedBytes = (uint32_t) location.compressedBytes;
+  entry->compression = location.compression;
+  entry->checksum = location.checksum;
+  entry->device = (uint32_t) location.device;
+  entry->used = 1;
+
+  return true;
+}
+
+size_t PDBBufferManagerPageDirectory::getEndOfFile(size_t device) {
+
+  // lock the directory
+  std::unique_lock<std::mutex> lck(m);
+  return header->endOfFile[device];
+}
+
+void PDBBufferManagerPageDirectory::setEndOfFile(size_t device, size_t endOfFile) {
+
+  // lock the directory
+  std::unique_lock<std::mutex> lck(m);
+  header->endOfFile[device] = endOfFile;
+}
+
+void PDBBufferManagerPageDirectory::sync() {
+
+  // lock the directory
+  std::unique_lock<std::mutex> lck(m);
+  msync(header, mappedSize, MS_SYNC);
+}
+
+void PDBBufferManagerPageDirectory::map() {
+
+  // figure out the size of the file
+  struct stat fileStat{};
+  fstat(fd, &fileStat);
+  mappedSize = fileStat.st_size;
+
+  // map the whole file
+  void *mapped = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (mapped == MAP_FAILED) {
+    std::cerr << "Fail to map the page directory at " << fileName << " with errno: " << strerror(errno) << std::endl;
+    exit(1);
+  }
+
+  header = (Header *) mapped;
+}
+
+void PDBBufferManagerPageDirectory::grow(size_t pageNum) {
+
+  // double the number of entries until the page fits
+  size_t numEntries = header->numEntries;
+  while (numEntries <= pageNum) {
+    numEntries *= 2;
+  }
+
+  // unmap the directory and grow the file, the new entries are zero so they don't have a location
+  munmap(header, mappedSize);
+  if (ftruncate(fd, sizeof(Header) + numEntries * sizeof(Entry)) == -1) {
+    std::cerr << "Fail to grow the page directory at " << fileName << " with errno: " << strerror(errno) << std::endl;
+    exit(1);
+  }
+
+  // map it again and store the new number of entries
+  map();
+  header->numEntries = numEntries;
+}
+
+PDBBufferManagerPageDirectory::Entry *PDBBufferManagerPageDirectory::getEntry(size_t pageNum) {
+  return ((Entry *) (header + 1)) + pageNum;
+}
+
+}
@@ -0,0 +1,266 @@
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include <unistd.h>
+#include <climits>
+#include <limits>
+#include <iostream>
+#include <new>
+#include "PDBBufferManagerRing.h"
+
+namespace pdb {
+
+// the queues find the cell of a position by masking it
+static_assert((PDB_BUFFER_MANAGER_RING_SLOTS & (PDB_BUFFER_MANAGER_RING_SLOTS - 1)) == 0, "The number of slots of the ring must be a power of two");
+
+// the threads of the two processes sleep on the same words so they have to be plain 32 bit integers
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "The futex words must be 32 bit integers");
+
+PDBBufferManagerRing::PDBBufferManagerRing() {
+
+  // map the memory, it is shared so the process we fork sees the same ring
+  mappedSize = sizeof(Ring);
+  void *memory = mmap(nullptr, mappedSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (memory == MAP_FAILED) {
+    std::cerr << "Fatal Error: Could not map the memory of the buffer manager ring.\n";
+    exit(1);
+  }
+
+  // construct the ring in it
+  ring = new(memory) Ring();
+  ring->freeSequence = 0;
+  ring->requestSequence = 0;
+  ring->numWaitingForSlot = 0;
+  ring->numWaitingForRequest = 0;
+  ring->closed = 0;
+  ring->memoryPressure = PDB_MEMORY_PRESSURE_NONE;
+  ring->numAvailablePages = std::numeric_limits<uint64_t>::max();
+
+  // set up the queues, every cell is ready to be written in the first lap
+  for (auto *queue : {&ring->freeSlots, &ring->requests}) {
+    queue->pushPosition = 0;
+    queue->popPosition = 0;
+    for (uint64_t i = 0; i < PDB_BUFFER_MANAGER_RING_SLOTS; ++i) {
+      queue->cells[i].sequence = i;
+    }
+  }
+
+  // all the slots are free
+  for (uint32_t i = 0; i < PDB_BUFFER_MANAGER_RING_SLOTS; ++i) {
+    ring->slots[i].state = SLOT_FREE;
+    push(ring->freeSlots, i);
+  }
+}
+
+PDBBufferManagerRing::~PDBBufferManagerRing() {
+  munmap(ring, mappedSize);
+}
+
+int64_t PDBBufferManagerRing::waitForRequest() {
+
+  uint32_t slot;
+  while (true) {
+
+    // if the ring is closed we are done
+    if (ring->closed) {
+      return -1;
+    }
+
+    // try to grab a request
+    if (pop(ring->requests, slot)) {
+      return slot;
+    }
+
+    // say that we are about to sleep, and check again so we don't miss a request pushed in the meantime
+    ring->numWaitingForRequest++;
+    auto sequence = ring->requestSequence.load();
+    bool found = pop(ring->requests, slot);
+    if (!found && !ring->closed) {
+      futexWait(ring->requestSequence, sequence);
+    }
+    ring->numWaitingForRequest--;
+
+    if (found) {
+      return slot;
+    }
+  }
+}
+
+int16_t PDBBufferManagerRing::getRequestType(int64_t slot) {
+  return ring->slots[slot].requestType;
+}
+
+PDBBufferManagerRingResponderPtr PDBBufferManagerRing::getResponder(int64_t slot) {
+  return std::make_shared<PDBBufferManagerRingResponder>(ring->slots[slot].response, ring->slots[slot].responseType);
+}
+
+void PDBBufferManagerRing::respond(int64_t slot) {
+
+  // hand over the response, if the backend went to sleep wake it up
+  if (ring->slots[slot].state.exchange(SLOT_RESPONSE) == SLOT_WAITING) {
+    futexWake(ring->slots[slot].state, 1);
+  }
+}
+
+void PDBBufferManagerRing::close() {
+
+  // mark it as closed and wake up everybody waiting for a request
+  ring->closed = 1;
+  ring->requestSequence++;
+  futexWake(ring->requestSequence, INT_MAX);
+}
+
+void PDBBufferManagerRing::setMemoryPressure(PDBMemoryPressure level) {
+  ring->memoryPressure.store(level, std::memory_order_relaxed);
+}
+
+PDBMemoryPressure PDBBufferManagerRing::getMemoryPressure() {
+  return (PDBMemoryPressure) ring->memoryPressure.load(std::memory_order_relaxed);
+}
+
+void PDBBufferManagerRing::setNumAvailablePages(uint64_t numPages) {
+  ring->numAvailablePages.store(numPages, std::memory_order_relaxed);
+}
+
+uint64_t PDBBufferManagerRing::getNumAvailablePages() {
+  return ring->numAvailablePages.load(std::memory_order_relaxed);
+}
+
+uint32_t PDBBufferManagerRing::takeSlot() {
+
+  uint32_t slot;
+  while (true) {
+
+    // try to grab a free slot
+    if (pop(ring->freeSlots, slot)) {
+      break;
+    }
+
+    // say that we are about to sleep, and check again so we don't miss a slot freed in the meantime
+    ring->numWaitingForSlot++;
+    auto sequence = ring->freeSequence.load();
+    bool found = pop(ring->freeSlots, slot);
+    if (!found) {
+      futexWait(ring->freeSequence, sequence);
+    }
+    ring->numWaitingForSlot--;
+
+    if (found) {
+      break;
+    }
+  }
+
+  return slot;
+}
+
+void PDBBufferManagerRing::pushRequest(uint32_t slot) {
+
+  // mark the slot and publish it
+  ring->slots[slot].state = SLOT_REQUEST;
+  push(ring->requests, slot);
+
+  // wake up a thread of the frontend if one is sleeping
+  ring->requestSequence++;
+  if (ring->numWaitingForRequest != 0) {
+    futexWake(ring->requestSequence, 1);
+  }
+}
+
+void PDBBufferManagerRing::waitForResponse(uint32_t slot) {
+
+  auto &state = ring->slots[slot].state;
+
+  // the frontend usually responds quickly so spin for a bit first
+  for (uint32_t i = 0; i < PDB_BUFFER_MANAGER_RING_SPINS; ++i) {
+    if (state.load(std::memory_order_acquire) == SLOT_RESPONSE) {
+      return;
+    }
+  }
+
+  // tell the frontend that we are going to sleep, if it responded in the meantime we are done
+  uint32_t expected = SLOT_REQUEST;
+  if (!state.compare_exchange_strong(expected, SLOT_WAITING)) {
+    return;
+  }
+
+  // sleep until it responds
+  while (state.load() != SLOT_RESPONSE) {
+    futexWait(state, SLOT_WAITING);
+  }
+}
+
+void PDBBufferManagerRing::releaseSlot(uint32_t slot) {
+
+  // give it back
+  ring->slots[slot].state = SLOT_FREE;
+  push(ring->freeSlots, slot);
+
+  // wake up a thread waiting for a slot if one is sleeping
+  ring->freeSequence++;
+  if (ring->numWaitingForSlot != 0) {
+    futexWake(ring->freeSequence, 1);
+  }
+}
+
+void PDBBufferManagerRing::push(Queue &queue, uint32_t slot) {
+
+  auto position = queue.pushPosition.load(std::memory_order_relaxed);
+  while (true) {
+
+    // if the cell was read in the previous lap we can try to take the position
+    auto &cell = queue.cells[position & (PDB_BUFFER_MANAGER_RING_SLOTS - 1)];
+    auto sequence = cell.sequence.load(std::memory_order_acquire);
+    if (sequence == position) {
+      if (queue.pushPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+
+        // write the cell and mark it as written in this lap
+        cell.slot = slot;
+        cell.sequence.store(position + 1, std::memory_order_release);
+        return;
+      }
+    } else {
+
+      // somebody else took the position, try the next one
+      position = queue.pushPosition.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+bool PDBBufferManagerRing::pop(Queue &queue, uint32_t &slot) {
+
+  auto position = queue.popPosition.load(std::memory_order_relaxed);
+  while (true) {
+
+    // if the cell was written in this lap we can try to take the position
+    auto &cell = queue.cells[position & (PDB_BUFFER_MANAGER_RING_SLOTS - 1)];
+    auto sequence = cell.sequence.load(std::memory_order_acquire);
+    auto difference = (int64_t) (sequence - (position + 1));
+    if (difference == 0) {
+      if (queue.popPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+
+        // read the cell and mark it as ready to be written in the next lap
+        slot = cell.slot;
+        cell.sequence.store(position + PDB_BUFFER_MANAGER_RING_SLOTS, std::memory_order_release);
+        return true;
+      }
+    } else if (difference < 0) {
+
+      // the queue is empty
+      return false;
+    } else {
+
+      // somebody else took the position, try the next one
+      position = queue.popPosition.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+void PDBBufferManagerRing::futexWait(std::atomic<uint32_t> &word, uint32_t expected) {
+  syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAIT, expected, nullptr, nullptr, 0);
+}
+
+void PDBBufferManagerRing::futexWake(std::atomic<uint32_t> &word, int numThreads) {
+  syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word), FUTEX_WAKE, numThreads, nullptr, nullptr, 0);
+}
+
+}
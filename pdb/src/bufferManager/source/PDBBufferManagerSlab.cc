@@ -0,0 +1,189 @@
+#include "PDBBufferManagerSlab.h"
+
+namespace pdb {
+
+// the free list stores a pointer in each free mini page so the smallest mini page must fit one
+static_assert(MIN_PAGE_SIZE >= sizeof(void *), "The mini pages must be able to hold a pointer");
+
+void PDBBufferManagerSlab::split(void *fullPageIn, int64_t sizeClassIn, size_t fullPageSize) {
+
+  // figure out the mini pages
+  fullPage = (char *) fullPageIn;
+  sizeClass = sizeClassIn;
+  miniPageSize = MIN_PAGE_SIZE << sizeClass;
+  numMiniPages = fullPageSize / miniPageSize;
+
+  // all of them are free and none was handed out yet
+  numCarved = 0;
+  numFree = numMiniPages;
+  freeList = nullptr;
+
+  // mark them in the bitmap
+  freeBitmap.assign((numMiniPages + 63) / 64, ~0ul);
+  if (numMiniPages % 64 != 0) {
+    freeBitmap.back() = (1ul << (numMiniPages % 64)) - 1;
+  }
+}
+
+void PDBBufferManagerSlab::reset() {
+
+  // forget the mini pages
+  numMiniPages = 0;
+  numCarved = 0;
+  numFree = 0;
+  freeList = nullptr;
+  freeBitmap.clear();
+
+  // and the pages
+  pages.clear();
+}
+
+void *PDBBufferManagerSlab::allocate() {
+
+  // if the first mini page of the free list is not free somebody wrote to it after it was given back
+  if (freeList != nullptr && !isFreeMiniPage(freeList)) {
+    rebuildFreeList();
+  }
+
+  // take the first mini page that was given back, if there is none take the next one that was never handed out
+  char *miniPage;
+  if (freeList != nullptr) {
+    miniPage = (char *) freeList;
+    freeList = *((void **) miniPage);
+  } else {
+    miniPage = fullPage + numCarved * miniPageSize;
+    numCarved++;
+  }
+
+  // mark it as used
+  size_t i = (miniPage - fullPage) / miniPageSize;
+  freeBitmap[i / 64] &= ~(1ul << (i % 64));
+  numFree--;
+
+  return miniPage;
+}
+
+void PDBBufferManagerSlab::free(void *miniPage) {
+
+  // if it is already free there is nothing to do
+  size_t i = ((char *) miniPage - fullPage) / miniPageSize;
+  if (isFree(i)) {
+    return;
+  }
+
+  // mark it as free
+  freeBitmap[i / 64] |= 1ul << (i % 64);
+  numFree++;
+
+  // and put it at the front of the free list
+  *((void **) miniPage) = freeList;
+  freeList = miniPage;
+}
+
+bool PDBBufferManagerSlab::hasFree() {
+  return numFree != 0;
+}
+
+bool PDBBufferManagerSlab::isUnused() {
+  return numFree == numMiniPages;
+}
+
+int64_t PDBBufferManagerSlab::getSizeClass() {
+  return sizeClass;
+}
+
+size_t PDBBufferManagerSlab::getNumMiniPages() {
+  return numMiniPages;
+}
+
+void *PDBBufferManagerSlab::getMiniPage(size_t i) {
+  return fullPage + i * miniPageSize;
+}
+
+bool PDBBufferManagerSlab::isFree(size_t i) {
+  return (freeBitmap[i / 64] & (1ul << (i % 64))) != 0;
+}
+
+void PDBBufferManagerSlab::addPage(const PDBPagePtr &page) {
+  page->slabPosition = pages.size();
+  pages.push_back(page);
+}
+
+void PDBBufferManagerSlab::removePage(const PDBPagePtr &page) {
+
+  // move the last page into the position of the one we are removing
+  size_t position = page->slabPosition;
+  pages[position] = pages.back();
+  pages[position]->slabPosition = position;
+  pages.pop_back();
+}
+
+std::vector<PDBPagePtr> &PDBBufferManagerSlab::getPages() {
+  return pages;
+}
+
+void PDBBufferManagerSlab::link(PDBBufferManagerSlab *&head) {
+
+  // put it at the front
+  prev = nullptr;
+  next = head;
+  if (head != nullptr) {
+    head->prev = this;
+  }
+  head = this;
+  isLinked = true;
+}
+
+void PDBBufferManagerSlab::unlink(PDBBufferManagerSlab *&head) {
+
+  // if it is not linked we are done
+  if (!isLinked) {
+    return;
+  }
+
+  // take it out
+  if (prev != nullptr) {
+    prev->next = next;
+  } else {
+    head = next;
+  }
+  if (next != nullptr) {
+    next->prev = prev;
+  }
+  prev = nullptr;
+  next = nullptr;
+  isLinked = false;
+}
+
+void PDBBufferManagerSlab::setFlushing(bool flushingIn) {
+  flushing = flushingIn;
+}
+
+bool PDBBufferManagerSlab::isFlushing() {
+  return flushing;
+}
+
+bool PDBBufferManagerSlab::isFreeMiniPage(void *miniPage) {
+
+  // it has to be one of the mini pages that were handed out
+  char *address = (char *) miniPage;
+  if (address < fullPage || address >= fullPage + numCarved * miniPageSize || (address - fullPage) % miniPageSize != 0) {
+    return false;
+  }
+
+  return isFree((address - fullPage) / miniPageSize);
+}
+
+void PDBBufferManagerSlab::rebuildFreeList() {
+
+  // chain all the free mini pages that were handed out
+  freeList = nullptr;
+  for (size_t i = numCarved; i > 0; --i) {
+    if (isFree(i - 1)) {
+      *((void **) getMiniPage(i - 1)) = freeList;
+      freeList = getMiniPage(i - 1);
+    }
+  }
+}
+
+}
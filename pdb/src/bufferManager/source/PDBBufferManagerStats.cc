@@ -0,0 +1,64 @@
+#include <iomanip>
+#include <sstream>
+#include "PDBBufferManagerStats.h"
+
+namespace pdb {
+
+double PDBBufferManagerStats::getHitRatio() const {
+
+  // if nothing was requested nothing was missed
+  if (numPageRequests == 0) {
+    return 1.0;
+  }
+
+  // a page that was read can only be requested once, but the counters are not read at the same time
+  return numPageReads >= numPageRequests ? 0.0 : 1.0 - (double) numPageReads / (double) numPageRequests;
+}
+
+std::string PDBBufferManagerStats::toString() const {
+
+  std::stringstream ss;
+  ss << std::fixed << std::setprecision(4);
+
+  // the pool
+  ss << "buffer pool           : " << numPages << " pages of " << pageSize << " bytes\n";
+  ss << "full pages            : " << numFreeFullPages << " free, " << numPinnedFullPages << " pinned, "
+     << numEvictableFullPages << " evictable\n";
+
+  // the traffic
+  ss << "page requests         : " << numPageRequests << " (hit ratio " << getHitRatio() << ")\n";
+  ss << "pages read            : " << numPageReads << " (" << numBytesRead << " bytes)\n";
+  ss << "pages written         : " << numPageWrites << " (" << numBytesWritten << " bytes)\n";
+  ss << "evictions             : " << numEvictions << "\n";
+  ss << "waited for pages      : " << (double) pagesWaitNanos / 1e9 << " s\n";
+  ss << "waited for space      : " << (double) spaceWaitNanos / 1e9 << " s\n";
+
+  // the mini pages, how much of the split full pages is unused
+  for (auto &sizeClass : sizeClasses) {
+
+    // skip the sizes nobody uses
+    if (sizeClass.numFullPages == 0) {
+      continue;
+    }
+
+    auto unused = sizeClass.numMiniPages - sizeClass.numUsedMiniPages;
+    ss << "mini pages of " << std::setw(8) << sizeClass.miniPageSize << ": " << sizeClass.numUsedMiniPages << " of "
+       << sizeClass.numMiniPages << " used on " << sizeClass.numFullPages << " full pages ("
+       << unused * sizeClass.miniPageSize << " bytes unused)\n";
+  }
+
+  // the backend
+  ss << "backend               : " << numBackEndPages << " pages, " << numLeasesGranted << " leases granted, "
+     << numLeasesRevoked << " revoked\n";
+
+  // the pages sent over the wire
+  auto wireBytesSaved = numWireBytesIn > numWireBytesOut ? numWireBytesIn - numWireBytesOut : 0;
+  ss << "wire compression      : " << numWireCompressed << " pages compressed, " << numWireBypassed
+     << " sent as they are, " << wireBytesSaved << " of " << numWireBytesIn << " bytes saved\n";
+  ss << "wire compression time : " << (double) wireCompressNanos / 1e9 << " s compressing, "
+     << (double) wireDecompressNanos / 1e9 << " s decompressing\n";
+
+  return ss.str();
+}
+
+}
@@ -0,0 +1,125 @@
+#include "PDBBufferManagerStripedIOEngine.h"
+
+namespace pdb {
+
+PDBBufferManagerStripedIOEngine::PDBBufferManagerStripedIOEngine(std::vector<PDBBufferManagerIOEnginePtr> engines) {
+
+  // create the devices
+  for (auto &engine : engines) {
+    devices.emplace_back(new PDBDevice());
+    devices.back()->engine = engine;
+  }
+
+  // start a thread for every device, any of them might have to do a part of a batch that the calling thread doesn't
+  for (auto &device : devices) {
+    auto *d = device.get();
+    device->thread = std::thread([this, d]() { run(*d); });
+  }
+}
+
+PDBBufferManagerStripedIOEngine::~PDBBufferManagerStripedIOEngine() {
+
+  // tell the threads to finish
+  {
+    std::unique_lock<std::mutex> lck(m);
+    shutdown = true;
+  }
+  for (auto &device : devices) {
+    device->queueCV.notify_all();
+  }
+
+  // wait for them
+  for (auto &device : devices) {
+    device->thread.join();
+  }
+}
+
+void PDBBufferManagerStripedIOEngine::execute(std::vector<PDBBufferManagerIORequest> &requests) {
+
+  // nothing to do
+  if (requests.empty()) {
+    return;
+  }
+
+  // if the whole batch goes to one device there is nothing to split
+  size_t first = requests.front().device % devices.size();
+  bool sameDevice = true;
+  for (auto &r : requests) {
+    sameDevice = sameDevice && r.device % devices.size() == first;
+  }
+  if (sameDevice) {
+    devices[first]->engine->execute(requests);
+    return;
+  }
+
+  // split the batch by device, remember where each request came from
+  std::vector<std::vector<PDBBufferManagerIORequest>> parts(devices.size());
+  std::vector<std::vector<size_t>> positions(devices.size());
+  for (size_t i = 0; i < requests.size(); ++i) {
+    auto device = requests[i].device % devices.size();
+    parts[device].emplace_back(std::move(requests[i]));
+    positions[device].emplace_back(i);
+  }
+
+  // hand all the parts but the first one to the threads of their devices
+  size_t numPending = 0;
+  {
+    std::unique_lock<std::mutex> lck(m);
+    for (size_t d = 0; d < devices.size(); ++d) {
+      if (d != first && !parts[d].empty()) {
+        devices[d]->queue.push_back(PDBDeviceBatch{&parts[d], &numPending});
+        devices[d]->queueCV.notify_one();
+        numPending++;
+      }
+    }
+  }
+
+  // do the first part ourselves
+  devices[first]->engine->execute(parts[first]);
+
+  // wait for the rest
+  {
+    std::unique_lock<std::mutex> lck(m);
+    doneCV.wait(lck, [&] { return numPending == 0; });
+  }
+
+  // put the requests back where they were
+  for (size_t d = 0; d < devices.size(); ++d) {
+    for (size_t i = 0; i < parts[d].size(); ++i) {
+      requests[positions[d][i]] = std::move(parts[d][i]);
+    }
+  }
+}
+
+size_t PDBBufferManagerStripedIOEngine::getNumDevices() {
+  return devices.size();
+}
+
+void PDBBufferManagerStripedIOEngine::run(PDBDevice &device) {
+
+  std::unique_lock<std::mutex> lck(m);
+  while (true) {
+
+    // wait for a part of a batch
+    device.queueCV.wait(lck, [&] { return shutdown || !device.queue.empty(); });
+    if (shutdown) {
+      return;
+    }
+
+    // take it
+    auto batch = device.queue.front();
+    device.queue.pop_front();
+
+    // do it without holding the lock
+    lck.unlock();
+    device.engine->execute(*batch.requests);
+    lck.lock();
+
+    // if this was the last part of the batch wake up the caller
+    if (--(*batch.numPending) == 0) {
+      doneCV.notify_all();
+    }
+  }
+}
+
+}
@@ -0,0 +1,13 @@
+#include "PDBBufferManagerSyncIOEngine.h"
+
+namespace pdb {
+
+void PDBBufferManagerSyncIOEngine::execute(std::vector<PDBBufferManagerIORequest> &requests) {
+
+  // do the requests one by one
+  for (auto &r : requests) {
+    transfer(r);
+  }
+}
+
+}
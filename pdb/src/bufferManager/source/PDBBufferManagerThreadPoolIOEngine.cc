@@ -0,0 +1,77 @@
+#include "PDBBufferManagerThreadPoolIOEngine.h"
+
+namespace pdb {
+
+PDBBufferManagerThreadPoolIOEngine::PDBBufferManagerThreadPoolIOEngine(size_t numThreads) {
+
+  // we need at least one thread
+  numThreads = numThreads == 0 ? 1 : numThreads;
+
+  // start the threads
+  for (size_t i = 0; i < numThreads; ++i) {
+    threads.emplace_back([this]() { run(); });
+  }
+}
+
+PDBBufferManagerThreadPoolIOEngine::~PDBBufferManagerThreadPoolIOEngine() {
+
+  // tell the threads to finish
+  {
+    std::unique_lock<std::mutex> lck(m);
+    shutdown = true;
+  }
+  queueCV.notify_all();
+
+  // wait for them
+  for (auto &t : threads) {
+    t.join();
+  }
+}
+
+void PDBBufferManagerThreadPoolIOEngine::execute(std::vector<PDBBufferManagerIORequest> &requests) {
+
+  // nothing to do
+  if (requests.empty()) {
+    return;
+  }
+
+  // queue all the requests of the batch
+  std::unique_lock<std::mutex> lck(m);
+  size_t numPending = requests.size();
+  for (auto &r : requests) {
+    queue.push_back(PDBQueuedRequest{&r, &numPending});
+  }
+  queueCV.notify_all();
+
+  // wait for the batch to finish
+  doneCV.wait(lck, [&] { return numPending == 0; });
+}
+
+void PDBBufferManagerThreadPoolIOEngine::run() {
+
+  std::unique_lock<std::mutex> lck(m);
+  while (true) {
+
+    // wait for a request
+    queueCV.wait(lck, [&] { return shutdown || !queue.empty(); });
+    if (shutdown) {
+      return;
+    }
+
+    // take the request
+    auto queued = queue.front();
+    queue.pop_front();
+
+    // do it without holding the lock
+    lck.unlock();
+    transfer(*queued.request);
+    lck.lock();
+
+    // if this was the last request of the batch wake up the caller
+    if (--(*queued.numPending) == 0) {
+      doneCV.notify_all();
+    }
+  }
+}
+
+}
@@ -20,7 +20,7 @@
 
 namespace pdb {
 
-PDBPage :: PDBPage (PDBBufferManagerInterface &parent) : parent (parent), status(PDB_PAGE_NOT_LOADED), dirty(false) {}
+PDBPage :: PDBPage (PDBBufferManagerInterface &parent) : parent (parent), status(PDB_PAGE_NOT_LOADED), pinned(false), dirty(false), hint(PDB_PAGE_HINT_NORMAL) {}
 
 void PDBPage :: incRefCount () {
 
@@ -98,6 +98,14 @@ void PDBPage :: repin () {
 	parent.repin (spMe);
 }
 
+void PDBPage :: setAccessHint (PDBPageAccessHint toMe) {
+	hint = toMe;
+}
+
+PDBPageAccessHint PDBPage :: getAccessHint () {
+	return hint;
+}
+
 void PDBPage :: setSet (PDBSetPtr inPtr) {
 	whichSet = std::move(inPtr);
 }
@@ -110,7 +118,7 @@ PDBPageInfo &PDBPage :: getLocation () {
 	return location;
 }
 
-PDBPageStatus &PDBPage::getStatus() {
+std::atomic<PDBPageStatus> &PDBPage::getStatus() {
   return status;
 }
 
@@ -0,0 +1,28 @@
+#include "PDBPageHandle.h"
+#include "PDBBufferManagerInterface.h"
+
+namespace pdb {
+
+void PDBPageHandleBase::repinAll(std::vector<PDBPageHandle> &pages) {
+
+  // if there are no pages we are done
+  if (pages.empty()) {
+    return;
+  }
+
+  // let the buffer manager of the pages do it
+  pages.front()->page->parent.repinAll(pages);
+}
+
+void PDBPageHandleBase::unpinAll(std::vector<PDBPageHandle> &pages) {
+
+  // if there are no pages we are done
+  if (pages.empty()) {
+    return;
+  }
+
+  // let the buffer manager of the pages do it
+  pages.front()->page->parent.unpinAll(pages);
+}
+
+}
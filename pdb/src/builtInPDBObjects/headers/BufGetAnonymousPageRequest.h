@@ -35,12 +35,14 @@ public:
 
   BufGetAnonymousPageRequest() = default;
 
-  explicit BufGetAnonymousPageRequest(size_t size) : size(size) {};
+  explicit BufGetAnonymousPageRequest(size_t size, int64_t jobID = -1, int64_t numaNode = -1) : size(size), jobID(jobID), numaNode(numaNode) {};
 
   explicit BufGetAnonymousPageRequest(const pdb::Handle<BufGetAnonymousPageRequest> & copyMe) : BufManagerRequestBase(*copyMe) {
 
     // copy stuff
     size = copyMe->size;
+    jobID = copyMe->jobID;
+    numaNode = copyMe->numaNode;
   }
 
   ~BufGetAnonymousPageRequest() = default;
@@ -51,6 +53,16 @@ public:
    * The page number
    */
   size_t size = 0;
+
+  /**
+   * The job the page is charged to, -1 if it is not charged to any
+   */
+  int64_t jobID = -1;
+
+  /**
+   * The NUMA node the thread that asked for the page runs on, the frontend takes the memory of the page from it
+   */
+  int64_t numaNode = -1;
 };
 }
 
@@ -0,0 +1,57 @@
+#ifndef PDB_BUFGETANONYMOUSPAGESREQUEST_H
+#define PDB_BUFGETANONYMOUSPAGESREQUEST_H
+
+// PRELOAD %BufGetAnonymousPagesRequest%
+
+#include "Object.h"
+#include "Handle.h"
+#include "BufManagerRequestBase.h"
+
+namespace pdb {
+
+// request to get a batch of anonymous pages of the same size
+class BufGetAnonymousPagesRequest : public BufManagerRequestBase {
+
+ public:
+
+  BufGetAnonymousPagesRequest() = default;
+
+  BufGetAnonymousPagesRequest(size_t numPages, size_t size, int64_t jobID = -1, int64_t numaNode = -1)
+      : numPages(numPages), size(size), jobID(jobID), numaNode(numaNode) {}
+
+  explicit BufGetAnonymousPagesRequest(const pdb::Handle<BufGetAnonymousPagesRequest> &copyMe) : BufManagerRequestBase(*copyMe) {
+
+    // copy stuff
+    numPages = copyMe->numPages;
+    size = copyMe->size;
+    jobID = copyMe->jobID;
+    numaNode = copyMe->numaNode;
+  }
+
+  ~BufGetAnonymousPagesRequest() = default;
+
+  ENABLE_DEEP_COPY;
+
+  /**
+   * The number of pages
+   */
+  size_t numPages = 0;
+
+  /**
+   * The size of each of the pages
+   */
+  size_t size = 0;
+
+  /**
+   * The job the pages are charged to, -1 if they are not charged to any
+   */
+  int64_t jobID = -1;
+
+  /**
+   * The NUMA node the thread that asked for the pages runs on, the frontend takes the memory of the pages from it
+   */
+  int64_t numaNode = -1;
+};
+}
+
+#endif //PDB_BUFGETANONYMOUSPAGESREQUEST_H
@@ -38,7 +38,7 @@ public:
 
   ~BufGetPageRequest() = default;
 
-  BufGetPageRequest(const pdb::PDBSetPtr &whichSet, uint64_t pageNumber) : pageNumber(pageNumber) {
+  BufGetPageRequest(const pdb::PDBSetPtr &whichSet, uint64_t pageNumber, int64_t numaNode = -1) : pageNumber(pageNumber), numaNode(numaNode) {
 
 
     if(whichSet != nullptr){
@@ -61,6 +61,7 @@ public:
     dbName = copyMe->dbName;
     pageNumber = copyMe->pageNumber;
     isAnon = copyMe->isAnon;
+    numaNode = copyMe->numaNode;
   }
 
 
@@ -85,6 +86,11 @@ public:
    * Is this an anonymous page
    */
   bool isAnon = false;
+
+  /**
+   * The NUMA node the thread that asked for the page runs on, the frontend takes the memory of the page from it
+   */
+  int64_t numaNode = -1;
 };
 }
 
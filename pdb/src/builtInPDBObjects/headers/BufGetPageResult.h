@@ -44,7 +44,8 @@ public:
                    const uint64_t &startPos,
                    const int64_t &numBytes,
                    const std::string &setName,
-                   const std::string &dbName)
+                   const std::string &dbName,
+                   const int64_t &lease = -1)
       : offset(offset),
         pageNum(pageNum),
         isAnonymous(isAnonymous),
@@ -52,7 +53,8 @@ public:
         startPos(startPos),
         numBytes(numBytes),
         setName(setName),
-        dbName(dbName) {}
+        dbName(dbName),
+        lease(lease) {}
 
   ~BufGetPageResult() = default;
 
@@ -84,6 +86,9 @@ public:
 
   // the database the set belongs to
   pdb::String dbName;
+
+  // the lease the backend gets on the frame of the page, -1 if there is none
+  int64_t lease = -1;
 };
 }
 
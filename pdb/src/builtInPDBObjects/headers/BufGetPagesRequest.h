@@ -0,0 +1,67 @@
+#ifndef PDB_BUFGETPAGESREQUEST_H
+#define PDB_BUFGETPAGESREQUEST_H
+
+// PRELOAD %BufGetPagesRequest%
+
+#include <vector>
+#include "PDBString.h"
+#include "PDBSet.h"
+#include "PDBVector.h"
+#include "BufManagerRequestBase.h"
+
+namespace pdb {
+
+// request to get a batch of pages of the same set
+class BufGetPagesRequest : public BufManagerRequestBase {
+
+ public:
+
+  BufGetPagesRequest(const PDBSetPtr &set, const std::vector<uint64_t> &pageNumbers, int64_t numaNode = -1)
+      : pageNumbers(pageNumbers.size(), 0), numaNode(numaNode) {
+
+    // the pages of a batch all belong to the same set
+    databaseName = pdb::makeObject<pdb::String>(set->getDBName());
+    setName = pdb::makeObject<pdb::String>(set->getSetName());
+
+    // copy the page numbers
+    for(auto pageNumber : pageNumbers) { this->pageNumbers.push_back(pageNumber); }
+  }
+
+  BufGetPagesRequest() = default;
+
+  explicit BufGetPagesRequest(const pdb::Handle<BufGetPagesRequest>& copyMe) : BufManagerRequestBase(*copyMe) {
+
+    // copy stuff
+    databaseName = copyMe->databaseName;
+    setName = copyMe->setName;
+    pageNumbers = copyMe->pageNumbers;
+    numaNode = copyMe->numaNode;
+  }
+
+  ~BufGetPagesRequest() = default;
+
+  ENABLE_DEEP_COPY;
+
+  /**
+   * The database name
+   */
+  pdb::Handle<pdb::String> databaseName;
+
+  /**
+   * The set name
+   */
+  pdb::Handle<pdb::String> setName;
+
+  /**
+   * The page numbers
+   */
+  pdb::Vector<uint64_t> pageNumbers;
+
+  /**
+   * The NUMA node the thread that asked for the pages runs on, the frontend takes the memory of the pages from it
+   */
+  int64_t numaNode = -1;
+};
+}
+
+#endif //PDB_BUFGETPAGESREQUEST_H
@@ -0,0 +1,60 @@
+#ifndef PDB_BUFGETPAGESRESULT_H
+#define PDB_BUFGETPAGESRESULT_H
+
+// PRELOAD %BufGetPagesResult%
+
+#include <vector>
+#include "PDBVector.h"
+
+namespace pdb {
+
+// the response to a request to get a batch of pages, everything we send for a single page with BufGetPageResult except
+// the set, since all the pages of a batch belong to the same set
+class BufGetPagesResult : public Object {
+
+ public:
+
+  BufGetPagesResult() = default;
+
+  explicit BufGetPagesResult(size_t numPages) : offsets(numPages, 0),
+                                                pageNums(numPages, 0),
+                                                startPositions(numPages, 0),
+                                                numBytes(numPages, 0),
+                                                leases(numPages, 0) {}
+
+  ~BufGetPagesResult() = default;
+
+  ENABLE_DEEP_COPY;
+
+  /**
+   * Adds a page to the response
+   */
+  void addPage(uint64_t offset, uint64_t pageNum, int64_t startPos, int64_t logNumBytes, int64_t lease) {
+    offsets.push_back(offset);
+    pageNums.push_back(pageNum);
+    startPositions.push_back(startPos);
+    numBytes.push_back((int8_t) logNumBytes);
+    leases.push_back(lease);
+  }
+
+  // the offsets of the pages in the shared memory, in the same order as they were requested
+  pdb::Vector<uint64_t> offsets;
+
+  // the page numbers
+  pdb::Vector<uint64_t> pageNums;
+
+  // the start positions in the file
+  pdb::Vector<int64_t> startPositions;
+
+  // the sizes of the pages, as the log of the number of bytes like in the location of a page
+  pdb::Vector<int8_t> numBytes;
+
+  // the leases the backend gets on the frames of the pages, -1 if a page has none
+  pdb::Vector<int64_t> leases;
+
+  // did we succeed
+  bool success = false;
+};
+}
+
+#endif //PDB_BUFGETPAGESRESULT_H
@@ -0,0 +1,23 @@
+#ifndef PDB_BUFGETSTATSREQUEST_H
+#define PDB_BUFGETSTATSREQUEST_H
+
+// PRELOAD %BufGetStatsRequest%
+
+#include "Object.h"
+
+namespace pdb {
+
+// request to get the counters of the buffer manager of a node
+class BufGetStatsRequest : public Object {
+
+ public:
+
+  BufGetStatsRequest() = default;
+
+  ~BufGetStatsRequest() = default;
+
+  ENABLE_DEEP_COPY;
+};
+}
+
+#endif //PDB_BUFGETSTATSREQUEST_H
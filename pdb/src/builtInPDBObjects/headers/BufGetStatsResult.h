@@ -0,0 +1,160 @@
+#ifndef PDB_BUFGETSTATSRESULT_H
+#define PDB_BUFGETSTATSRESULT_H
+
+// PRELOAD %BufGetStatsResult%
+
+#include "Object.h"
+#include "PDBVector.h"
+#include "PDBBufferManagerStats.h"
+
+namespace pdb {
+
+// the counters of the buffer manager of a node
+class BufGetStatsResult : public Object {
+
+ public:
+
+  explicit BufGetStatsResult(const PDBBufferManagerStats &stats) : pageSize(stats.pageSize),
+                                                                   numPages(stats.numPages),
+                                                                   numPageRequests(stats.numPageRequests),
+                                                                   numPageReads(stats.numPageReads),
+                                                                   numPageWrites(stats.numPageWrites),
+                                                                   numBytesRead(stats.numBytesRead),
+                                                                   numBytesWritten(stats.numBytesWritten),
+                                                                   numEvictions(stats.numEvictions),
+                                                                   pagesWaitNanos(stats.pagesWaitNanos),
+                                                                   spaceWaitNanos(stats.spaceWaitNanos),
+                                                                   numFreeFullPages(stats.numFreeFullPages),
+                                                                   numPinnedFullPages(stats.numPinnedFullPages),
+                                                                   numEvictableFullPages(stats.numEvictableFullPages),
+                                                                   miniPageSizes(stats.sizeClasses.size(), 0),
+                                                                   numSplitFullPages(stats.sizeClasses.size(), 0),
+                                                                   numMiniPages(stats.sizeClasses.size(), 0),
+                                                                   numUsedMiniPages(stats.sizeClasses.size(), 0),
+                                                                   numLeasesGranted(stats.numLeasesGranted),
+                                                                   numLeasesRevoked(stats.numLeasesRevoked),
+                                                                   numBackEndPages(stats.numBackEndPages),
+                                                                   numWireCompressed(stats.numWireCompressed),
+                                                                   numWireBypassed(stats.numWireBypassed),
+                                                                   numWireBytesIn(stats.numWireBytesIn),
+                                                                   numWireBytesOut(stats.numWireBytesOut),
+                                                                   wireCompressNanos(stats.wireCompressNanos),
+                                                                   wireDecompressNanos(stats.wireDecompressNanos) {
+
+    // copy the size classes
+    for (auto &sizeClass : stats.sizeClasses) {
+      miniPageSizes.push_back(sizeClass.miniPageSize);
+      numSplitFullPages.push_back(sizeClass.numFullPages);
+      numMiniPages.push_back(sizeClass.numMiniPages);
+      numUsedMiniPages.push_back(sizeClass.numUsedMiniPages);
+    }
+  }
+
+  BufGetStatsResult() = default;
+
+  ~BufGetStatsResult() = default;
+
+  ENABLE_DEEP_COPY;
+
+  /**
+   * Returns the counters we got
+   */
+  PDBBufferManagerStats getStats() {
+
+    PDBBufferManagerStats stats;
+    stats.pageSize = pageSize;
+    stats.numPages = numPages;
+    stats.numPageRequests = numPageRequests;
+    stats.numPageReads = numPageReads;
+    stats.numPageWrites = numPageWrites;
+    stats.numBytesRead = numBytesRead;
+    stats.numBytesWritten = numBytesWritten;
+    stats.numEvictions = numEvictions;
+    stats.pagesWaitNanos = pagesWaitNanos;
+    stats.spaceWaitNanos = spaceWaitNanos;
+    stats.numFreeFullPages = numFreeFullPages;
+    stats.numPinnedFullPages = numPinnedFullPages;
+    stats.numEvictableFullPages = numEvictableFullPages;
+    stats.numLeasesGranted = numLeasesGranted;
+    stats.numLeasesRevoked = numLeasesRevoked;
+    stats.numBackEndPages = numBackEndPages;
+    stats.numWireCompressed = numWireCompressed;
+    stats.numWireBypassed = numWireBypassed;
+    stats.numWireBytesIn = numWireBytesIn;
+    stats.numWireBytesOut = numWireBytesOut;
+    stats.wireCompressNanos = wireCompressNanos;
+    stats.wireDecompressNanos = wireDecompressNanos;
+
+    // the size classes
+    stats.sizeClasses.resize(miniPageSizes.size());
+    for (size_t i = 0; i < miniPageSizes.size(); ++i) {
+      stats.sizeClasses[i].miniPageSize = miniPageSizes[i];
+      stats.sizeClasses[i].numFullPages = numSplitFullPages[i];
+      stats.sizeClasses[i].numMiniPages = numMiniPages[i];
+      stats.sizeClasses[i].numUsedMiniPages = numUsedMiniPages[i];
+    }
+
+    return stats;
+  }
+
+  /**
+   * The size of a full page and the number of full pages in the buffer pool
+   */
+  uint64_t pageSize = 0;
+  uint64_t numPages = 0;
+
+  /**
+   * The pages that were requested, read and written and the bytes that were read and written
+   */
+  uint64_t numPageRequests = 0;
+  uint64_t numPageReads = 0;
+  uint64_t numPageWrites = 0;
+  uint64_t numBytesRead = 0;
+  uint64_t numBytesWritten = 0;
+
+  /**
+   * The number of full pages that were evicted
+   */
+  uint64_t numEvictions = 0;
+
+  /**
+   * The time spent waiting for the pages and the space in nanoseconds
+   */
+  uint64_t pagesWaitNanos = 0;
+  uint64_t spaceWaitNanos = 0;
+
+  /**
+   * The full pages that are free, pinned and evictable
+   */
+  uint64_t numFreeFullPages = 0;
+  uint64_t numPinnedFullPages = 0;
+  uint64_t numEvictableFullPages = 0;
+
+  /**
+   * The size classes, the value with the same index belongs to the same size class
+   */
+  pdb::Vector<uint64_t> miniPageSizes;
+  pdb::Vector<uint64_t> numSplitFullPages;
+  pdb::Vector<uint64_t> numMiniPages;
+  pdb::Vector<uint64_t> numUsedMiniPages;
+
+  /**
+   * The leases of the frontend and the pages the backend has
+   */
+  uint64_t numLeasesGranted = 0;
+  uint64_t numLeasesRevoked = 0;
+  uint64_t numBackEndPages = 0;
+
+  /**
+   * The pages compressed and sent as they are over the wire, the bytes before and after and the time it took
+   */
+  uint64_t numWireCompressed = 0;
+  uint64_t numWireBypassed = 0;
+  uint64_t numWireBytesIn = 0;
+  uint64_t numWireBytesOut = 0;
+  uint64_t wireCompressNanos = 0;
+  uint64_t wireDecompressNanos = 0;
+};
+}
+
+#endif //PDB_BUFGETSTATSRESULT_H
@@ -17,7 +17,7 @@ class BufPinPageResult : public Object {
 
 public:
 
-  BufPinPageResult(const size_t &offset, const bool success) : offset(offset), success(success) {}
+  BufPinPageResult(const size_t &offset, const bool success, const int64_t &lease = -1) : offset(offset), success(success), lease(lease) {}
 
   BufPinPageResult() = default;
 
@@ -30,6 +30,9 @@ public:
 
   // did we succeed
   bool success = false;
+
+  // the lease the backend gets on the frame of the page, -1 if there is none
+  int64_t lease = -1;
 };
 }
 
@@ -0,0 +1,69 @@
+#ifndef PDB_BUFPINPAGESREQUEST_H
+#define PDB_BUFPINPAGESREQUEST_H
+
+// PRELOAD %BufPinPagesRequest%
+
+#include <vector>
+#include "PDBString.h"
+#include "PDBSet.h"
+#include "PDBVector.h"
+#include "BufManagerRequestBase.h"
+
+namespace pdb {
+
+// request to pin a batch of pages of the same set
+class BufPinPagesRequest : public BufManagerRequestBase {
+
+ public:
+
+  BufPinPagesRequest(const PDBSetPtr &set, const std::vector<uint64_t> &pageNumbers)
+      : isAnonymous(set == nullptr), pageNumbers(pageNumbers.size(), 0) {
+
+    // is this an anonymous page if it is
+    if(!isAnonymous) {
+      databaseName = pdb::makeObject<pdb::String>(set->getDBName());
+      setName = pdb::makeObject<pdb::String>(set->getSetName());
+    }
+
+    // copy the page numbers
+    for(auto pageNumber : pageNumbers) { this->pageNumbers.push_back(pageNumber); }
+  }
+
+  BufPinPagesRequest() = default;
+
+  explicit BufPinPagesRequest(const pdb::Handle<BufPinPagesRequest>& copyMe) : BufManagerRequestBase(*copyMe) {
+
+    // copy stuff
+    isAnonymous = copyMe->isAnonymous;
+    databaseName = copyMe->databaseName;
+    setName = copyMe->setName;
+    pageNumbers = copyMe->pageNumbers;
+  }
+
+  ~BufPinPagesRequest() = default;
+
+  ENABLE_DEEP_COPY;
+
+  /**
+   * are the pages anonymous
+   */
+  bool isAnonymous = false;
+
+  /**
+   * The database name
+   */
+  pdb::Handle<pdb::String> databaseName;
+
+  /**
+   * The set name
+   */
+  pdb::Handle<pdb::String> setName;
+
+  /**
+   * The page numbers
+   */
+  pdb::Vector<uint64_t> pageNumbers;
+};
+}
+
+#endif //PDB_BUFPINPAGESREQUEST_H
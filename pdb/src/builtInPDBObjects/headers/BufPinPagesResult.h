@@ -0,0 +1,42 @@
+#ifndef PDB_BUFPINPAGESRESULT_H
+#define PDB_BUFPINPAGESRESULT_H
+
+// PRELOAD %BufPinPagesResult%
+
+#include <vector>
+#include "PDBVector.h"
+
+namespace pdb {
+
+// the response to a request to pin a batch of pages
+class BufPinPagesResult : public Object {
+
+ public:
+
+  BufPinPagesResult(const std::vector<uint64_t> &offsets,
+                    const std::vector<int64_t> &leases,
+                    const bool success) : offsets(offsets.size(), 0), leases(leases.size(), 0), success(success) {
+
+    // copy the offsets and the leases
+    for(auto offset : offsets) { this->offsets.push_back(offset); }
+    for(auto lease : leases) { this->leases.push_back(lease); }
+  }
+
+  BufPinPagesResult() = default;
+
+  ~BufPinPagesResult() = default;
+
+  ENABLE_DEEP_COPY;
+
+  // the offsets of the pages in the shared memory, in the same order as they were requested
+  pdb::Vector<uint64_t> offsets;
+
+  // the leases the backend gets on the frames of the pages, -1 if a page has none
+  pdb::Vector<int64_t> leases;
+
+  // did we succeed
+  bool success = false;
+};
+}
+
+#endif //PDB_BUFPINPAGESRESULT_H
@@ -9,6 +9,7 @@
 
 #include "PDBString.h"
 #include "PDBSet.h"
+#include "PDBPageAccessHint.h"
 #include "BufManagerRequestBase.h"
 
 namespace pdb {
@@ -18,8 +19,8 @@ class BufUnpinPageRequest : public BufManagerRequestBase {
 
 public:
 
-  BufUnpinPageRequest(const PDBSetPtr &set, const size_t &pageNumber, bool isDirty)
-      : isAnonymous(set == nullptr), pageNumber(pageNumber), isDirty(isDirty) {
+  BufUnpinPageRequest(const PDBSetPtr &set, const size_t &pageNumber, bool isDirty, PDBPageAccessHint accessHint = PDB_PAGE_HINT_NORMAL)
+      : isAnonymous(set == nullptr), isDirty(isDirty), accessHint(accessHint), pageNumber(pageNumber) {
 
     // is this an anonymous page if it is
     if(!isAnonymous) {
@@ -35,6 +36,7 @@ public:
     // copy stuff
     isAnonymous = copyMe->isAnonymous;
     isDirty = copyMe->isDirty;
+    accessHint = copyMe->accessHint;
     databaseName = copyMe->databaseName;
     setName = copyMe->setName;
     pageNumber = copyMe->pageNumber;
@@ -54,6 +56,11 @@ public:
    */
   bool isDirty = false;
 
+  /**
+   * how the page is going to be used, the frontend evicts it accordingly
+   */
+  PDBPageAccessHint accessHint = PDB_PAGE_HINT_NORMAL;
+
   /**
    * The database name
    */
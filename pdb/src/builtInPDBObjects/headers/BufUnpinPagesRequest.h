@@ -0,0 +1,85 @@
+#ifndef PDB_BUFUNPINPAGESREQUEST_H
+#define PDB_BUFUNPINPAGESREQUEST_H
+
+// PRELOAD %BufUnpinPagesRequest%
+
+#include <vector>
+#include "PDBString.h"
+#include "PDBSet.h"
+#include "PDBPageAccessHint.h"
+#include "PDBVector.h"
+#include "BufManagerRequestBase.h"
+
+namespace pdb {
+
+// request to unpin a batch of pages of the same set
+class BufUnpinPagesRequest : public BufManagerRequestBase {
+
+public:
+
+  BufUnpinPagesRequest(const PDBSetPtr &set, const std::vector<uint64_t> &pageNumbers, const std::vector<bool> &isDirty,
+                       const std::vector<PDBPageAccessHint> &accessHints)
+      : isAnonymous(set == nullptr), pageNumbers(pageNumbers.size(), 0), isDirty(isDirty.size(), 0), accessHints(accessHints.size(), 0) {
+
+    // is this an anonymous page if it is
+    if(!isAnonymous) {
+      databaseName = pdb::makeObject<pdb::String>(set->getDBName());
+      setName = pdb::makeObject<pdb::String>(set->getSetName());
+    }
+
+    // copy the page numbers, the dirty bits and the hints
+    for(auto pageNumber : pageNumbers) { this->pageNumbers.push_back(pageNumber); }
+    for(auto dirty : isDirty) { this->isDirty.push_back(dirty); }
+    for(auto hint : accessHints) { this->accessHints.push_back(hint); }
+  }
+
+  BufUnpinPagesRequest() = default;
+
+  explicit BufUnpinPagesRequest(const pdb::Handle<BufUnpinPagesRequest>& copyMe) : BufManagerRequestBase(*copyMe) {
+
+    // copy stuff
+    isAnonymous = copyMe->isAnonymous;
+    databaseName = copyMe->databaseName;
+    setName = copyMe->setName;
+    pageNumbers = copyMe->pageNumbers;
+    isDirty = copyMe->isDirty;
+    accessHints = copyMe->accessHints;
+  }
+
+  ~BufUnpinPagesRequest() = default;
+
+  ENABLE_DEEP_COPY;
+
+  /**
+   * are the pages anonymous
+   */
+  bool isAnonymous = false;
+
+  /**
+   * The database name
+   */
+  pdb::Handle<pdb::String> databaseName;
+
+  /**
+   * The set name
+   */
+  pdb::Handle<pdb::String> setName;
+
+  /**
+   * The page numbers
+   */
+  pdb::Vector<uint64_t> pageNumbers;
+
+  /**
+   * is the page with the same index dirty
+   */
+  pdb::Vector<bool> isDirty;
+
+  /**
+   * the access hint of the page with the same index
+   */
+  pdb::Vector<uint32_t> accessHints;
+};
+}
+
+#endif //PDB_BUFUNPINPAGESREQUEST_H
@@ -47,12 +47,14 @@ class CatGetSetResult : public Object {
                            const std::string &internalType,
                            const std::string &type,
                            size_t setSize,
-                           const PDBCatalogSetContainerType &containerType) : databaseName(database),
-                                                                              setName(set),
-                                                                              internalType(internalType),
-                                                                              type(type),
-                                                                              containerType(containerType),
-                                                                              setSize(setSize) {}
+                           const PDBCatalogSetContainerType &containerType,
+                           PDBPageCompression compression = PDB_PAGE_COMPRESSION_NONE) : databaseName(database),
+                                                                                         setName(set),
+                                                                                         internalType(internalType),
+                                                                                         type(type),
+                                                                                         setSize(setSize),
+                                                                                         containerType(containerType),
+                                                                                         compression(compression) {}
 
   ENABLE_DEEP_COPY
 
@@ -86,6 +88,11 @@ class CatGetSetResult : public Object {
    * The type of the container that are stored on the pages of this set
    */
   PDBCatalogSetContainerType containerType;
+
+  /**
+   * The codec the pages of this set are compressed with on disk
+   */
+  PDBPageCompression compression = PDB_PAGE_COMPRESSION_NONE;
 };
 }
 
@@ -0,0 +1,81 @@
+/*****************************************************************************
+ *                                                                           *
+ *  Copyright 2018 Rice University                                           *
+ *                                                                           *
+ *  Licensed under the Apache License, Version 2.0 (the "License");          *
+ *  you may not use this file except in compliance with the License.         *
+ *  You may obtain a copy of the License at                                  *
+ *                                                                           *
+ *      http://www.apache.org/licenses/LICENSE-2.0                           *
+ *                                                                           *
+ *  Unless required by applicable law or agreed to in writing, software      *
+ *  distributed under the License is distributed on an "AS IS" BASIS,        *
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. *
+ *  See the License for the specific language governing permissions and      *
+ *  limitations under the License.                                           *
+ *                                                                           *
+ *****************************************************************************/
+
+#pragma once
+
+#include "Object.h"
+#include "Handle.h"
+#include "PDBString.h"
+#include "PDBBufferManagerCompression.h"
+
+// PRELOAD %CatSetUpdateCompressionRequest%
+
+namespace pdb {
+
+/**
+ * Encapsulates a request to update the codec the pages of a set are compressed with on disk
+ */
+class CatSetUpdateCompressionRequest : public Object {
+
+ public:
+
+  CatSetUpdateCompressionRequest() = default;
+  ~CatSetUpdateCompressionRequest() = default;
+
+  /**
+   * Creates a request to update the codec of the set
+   * @param database - the name of database
+   * @param set - the name of the set
+   * @param compression - the codec
+   */
+  explicit CatSetUpdateCompressionRequest(const std::string &database,
+                                          const std::string &set,
+                                          PDBPageCompression compression) : databaseName(database),
+                                                                            setName(set),
+                                                                            compression(compression) {}
+
+  /**
+   * Copy the request this is needed by the broadcast
+   * @param pdbItemToCopy - the request to copy
+   */
+  explicit CatSetUpdateCompressionRequest(const Handle<CatSetUpdateCompressionRequest>& pdbItemToCopy) {
+
+    // copy the thing
+    databaseName = pdbItemToCopy->databaseName;
+    setName = pdbItemToCopy->setName;
+    compression = pdbItemToCopy->compression;
+  }
+
+  ENABLE_DEEP_COPY
+
+  /**
+   * The name of the database
+   */
+  String databaseName;
+
+  /**
+   * The name of the set
+   */
+  String setName;
+
+  /**
+   * The codec
+   */
+  PDBPageCompression compression = PDB_PAGE_COMPRESSION_NONE;
+};
+}
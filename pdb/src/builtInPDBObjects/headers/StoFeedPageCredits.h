@@ -0,0 +1,30 @@
+#ifndef PDB_STOFEEDPAGECREDITS_H
+#define PDB_STOFEEDPAGECREDITS_H
+
+// PRELOAD %StoFeedPageCredits%
+
+#include "Object.h"
+
+namespace pdb {
+
+// the node that is fed the pages of a page set lets the sender send this many more pages
+class StoFeedPageCredits : public Object {
+
+ public:
+
+  StoFeedPageCredits() = default;
+
+  ~StoFeedPageCredits() = default;
+
+  explicit StoFeedPageCredits(uint64_t credits) : credits(credits) {}
+
+  ENABLE_DEEP_COPY
+
+  /**
+   * The number of pages the sender can send on top of the ones it was already allowed to send
+   */
+  uint64_t credits = 0;
+};
+}
+
+#endif //PDB_STOFEEDPAGECREDITS_H
@@ -122,6 +122,16 @@ class PDBCatalog {
    */
   bool updateSetContainer(const std::string &dbName, const std::string &setName, PDBCatalogSetContainerType type, std::string &error);
 
+  /**
+   * Update the codec the pages of the set are compressed with, @see PDBPageCompression for valid values
+   * @param dbName - the name of the database the set belongs to
+   * @param setName - the name of the set
+   * @param compression - the codec
+   * @param error - error string if any
+   * @return true if we succeed false otherwise
+   */
+  bool updateSetCompression(const std::string &dbName, const std::string &setName, PDBPageCompression compression, std::string &error);
+
   /**
    * Check if the database with the provided name exists
    * @param name - the name of the database
@@ -235,6 +245,12 @@ class PDBCatalog {
    */
   std::vector<PDBCatalogSet> getSetsInDatabase(const std::string &dbName);
 
+  /**
+   * Returns all the sets in the catalog
+   * @return - the sets
+   */
+  std::vector<PDBCatalogSet> getSets();
+
   /**
    * Returns all the nodes
    * @return - all the nodes inside the catalog
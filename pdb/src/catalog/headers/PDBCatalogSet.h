@@ -10,6 +10,7 @@
 #include "PDBCatalogDatabase.h"
 #include "PDBCatalogType.h"
 #include "PDBCatalogNode.h"
+#include "PDBBufferManagerCompression.h"
 
 namespace pdb {
 
@@ -55,8 +56,8 @@ public:
                 setIdentifier(database + ":" + name),
                 name(name),
                 database(database),
-                type(std::make_shared<std::string>(type)),
                 setSize(setSize),
+                type(std::make_shared<std::string>(type)),
                 containerType(containerType) {}
 
   /**
@@ -89,6 +90,11 @@ public:
    */
    int containerType = PDB_CATALOG_SET_NO_CONTAINER;
 
+  /**
+   * The codec the pages of this set are compressed with on disk, @see PDBPageCompression
+   */
+  int compression = PDB_PAGE_COMPRESSION_NONE;
+
   /**
    * Return the schema of the database object
    * @return the schema
@@ -102,6 +108,7 @@ public:
                                            sqlite_orm::make_column("setSize", &PDBCatalogSet::setSize),
                                            sqlite_orm::make_column("setType", &PDBCatalogSet::type),
                                            sqlite_orm::make_column("setContainerType", &PDBCatalogSet::containerType),
+                                           sqlite_orm::make_column("setCompression", &PDBCatalogSet::compression),
                                            sqlite_orm::foreign_key(&PDBCatalogSet::database).references(&PDBCatalogDatabase::name),
                                            sqlite_orm::foreign_key(&PDBCatalogSet::type).references(&PDBCatalogType::name),
                                            sqlite_orm::primary_key(&PDBCatalogSet::setIdentifier));
@@ -26,6 +26,8 @@
 #include "CatalogServer.h"
 #include <CatGetWorkersRequest.h>
 #include <CatSetUpdateContainerTypeRequest.h>
+#include <CatSetUpdateCompressionRequest.h>
+#include <PDBBufferManagerInterface.h>
 
 #include "BuiltInObjectTypeIDs.h"
 #include "CatSyncWorkerRequest.h"
@@ -104,6 +106,14 @@ void CatalogServer::init() {
   // initialize the types
   initBuiltInTypes();
 
+  // the buffer manager compresses the pages of the sets that have a codec
+  for (auto &set : pdbCatalog->getSets()) {
+    if (set.compression != PDB_PAGE_COMPRESSION_NONE) {
+      getFunctionality<PDBBufferManagerInterface>().setCompression(std::make_shared<PDBSet>(set.database, set.name),
+                                                                   (PDBPageCompression) set.compression);
+    }
+  }
+
   PDB_COUT << "Catalog Server successfully initialized!\n";
 }
 
@@ -625,6 +635,61 @@ void CatalogServer::registerHandlers(PDBServer &forMe) {
             return make_pair(res, errMsg);
           }));
 
+  forMe.registerHandler(
+      CatSetUpdateCompressionRequest_TYPEID,
+      make_shared<HeapRequestHandler<CatSetUpdateCompressionRequest>>(
+          [&](Handle<CatSetUpdateCompressionRequest> request, PDBCommunicatorPtr sendUsingMe) {
+
+            // lock the catalog server
+            std::lock_guard<std::mutex> guard(serverMutex);
+
+            // update the codec
+            std::string errMsg;
+            bool res = pdbCatalog->updateSetCompression(request->databaseName, request->setName, request->compression, errMsg);
+
+            // the pages of the set on this node are compressed with it from now on
+            if (res) {
+              getFunctionality<PDBBufferManagerInterface>().setCompression(std::make_shared<PDBSet>(request->databaseName, request->setName),
+                                                                           request->compression);
+            }
+
+            // after we updated the codec of the set in the local catalog, if this is the
+            // manager catalog iterate over all nodes in the cluster and broadcast the
+            // request to the distributed copies of the catalog
+            if (getConfiguration()->isManager) {
+
+              // get the results of each broadcast
+              map<string, pair<bool, string>> updateResults;
+
+              // broadcast the update
+              broadcastRequest(request, 1024, updateResults, errMsg);
+
+              for (auto &item : updateResults) {
+
+                // if we failed res would be set to false
+                res = item.second.first && res;
+
+                // log what is happening
+                PDB_COUT << "Node IP: " << item.first + (item.second.first ? " updated correctly!" : " couldn't be updated due to error: ") << item.second.second << "\n";
+              }
+
+            } else {
+
+              // log what happened
+              PDB_COUT << "This is not Manager Catalog Node, thus metadata was only registered locally!\n";
+            }
+
+            // create an allocation block to hold the response
+            const UseTemporaryAllocationBlock tempBlock{1024};
+
+            // create the response
+            Handle<SimpleRequestResult> response = makeObject<SimpleRequestResult>(res, errMsg);
+
+            // sends result to requester
+            res = sendUsingMe->sendObject(response, errMsg) && res;
+            return make_pair(res, errMsg);
+          }));
+
   // handles a request to retrieve the name of a Type, if it's not registered returns -1
   forMe.registerHandler(
       CatSetObjectTypeRequest_TYPEID,
@@ -1009,7 +1074,8 @@ void CatalogServer::registerHandlers(PDBServer &forMe) {
             if(res) {
 
               // create the response object
-              response = makeObject<CatGetSetResult>(set->database, set->name, *set->type, *set->type, set->setSize, (PDBCatalogSetContainerType) set->containerType);
+              response = makeObject<CatGetSetResult>(set->database, set->name, *set->type, *set->type, set->setSize,
+                                                     (PDBCatalogSetContainerType) set->containerType, (PDBPageCompression) set->compression);
 
             } else {
 
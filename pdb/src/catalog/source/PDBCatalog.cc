@@ -257,6 +257,42 @@ bool pdb::PDBCatalog::updateSetContainer(const std::string &dbName, const std::s
   }
 }
 
+bool pdb::PDBCatalog::updateSetCompression(const std::string &dbName, const std::string &setName, PDBPageCompression compression, std::string &error) {
+
+  try {
+
+    // grab the set we want to update
+    auto set = getSet(dbName, setName);
+
+    // if the set does not exist we can not update it
+    if(set == nullptr) {
+
+      // set the error
+      error = "The set with the name (" + dbName + "," + setName + ") does not exist\n";
+
+      // we failed return false
+      return false;
+    }
+
+    // ok the set exists set the codec
+    set->compression = compression;
+
+    // insert the the set
+    storage.replace(*set);
+
+    // return true
+    return true;
+
+  } catch(std::system_error &e) {
+
+    // set the error we failed
+    error = "The set with the name (" + dbName + "," + setName + ") count not be updated! The SQL error is : "  + std::string(e.what());
+
+    // we failed
+    return false;
+  }
+}
+
 bool pdb::PDBCatalog::databaseExists(const std::string &name) {
 
   // try to find the database
@@ -414,7 +450,7 @@ int32_t pdb::PDBCatalog::numRegisteredTypes() {
 std::vector<pdb::PDBCatalogSet> pdb::PDBCatalog::getSetsInDatabase(const std::string &dbName) {
 
   // select all the sets
-  auto rows = storage.select(columns(&PDBCatalogSet::name, &PDBCatalogSet::database, &PDBCatalogSet::type, &PDBCatalogSet::setSize, &PDBCatalogSet::containerType),
+  auto rows = storage.select(columns(&PDBCatalogSet::name, &PDBCatalogSet::database, &PDBCatalogSet::type, &PDBCatalogSet::setSize, &PDBCatalogSet::containerType, &PDBCatalogSet::compression),
                              where(c(&PDBCatalogSet::database) == dbName));
 
   // create a return value
@@ -426,11 +462,16 @@ std::vector<pdb::PDBCatalogSet> pdb::PDBCatalog::getSetsInDatabase(const std::st
   // create the objects
   for(auto &r : rows) {
     ret.emplace_back(pdb::PDBCatalogSet(std::get<1>(r), std::get<0>(r), *std::get<2>(r), std::get<3>(r), (PDBCatalogSetContainerType) std::get<4>(r)));
+    ret.back().compression = std::get<5>(r);
   }
 
   return std::move(ret);
 }
 
+std::vector<pdb::PDBCatalogSet> pdb::PDBCatalog::getSets() {
+  return std::move(storage.get_all<PDBCatalogSet>());
+}
+
 std::vector<pdb::PDBCatalogNode> pdb::PDBCatalog::getNodes() {
   return std::move(storage.get_all<PDBCatalogNode>());
 }
@@ -148,6 +148,19 @@ public:
                               PDBCatalogSetContainerType containerType,
                               std::string &errMsg);
 
+  /**
+   * Update the codec the pages of a set are compressed with on disk
+   * @param databaseName - the database the set belongs to
+   * @param setName - the name of the set
+   * @param compression - the codec
+   * @param errMsg - the error message if any
+   * @return - true if we succeed
+   */
+  bool updateSetCompression(const std::string &databaseName,
+                            const std::string &setName,
+                            PDBPageCompression compression,
+                            std::string &errMsg);
+
   /* Sends a request to the Catalog Server to delete a database; returns true on
    * success, false on
    * fail
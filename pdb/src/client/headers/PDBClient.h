@@ -89,6 +89,24 @@ class PDBClient : public ServerFunctionality {
   template<class DataType>
   bool createSet(const std::string &databaseName, const std::string &setName);
 
+  /**
+   * Sets the codec the pages of the set are compressed with when they are written to disk, the pages that are
+   * already on disk are compressed once they are written again
+   * @param databaseName - the name of the database
+   * @param setName - the name of the set
+   * @param codec - "none", "snappy", "lz4" or "zstd", if a node was not built with lz4 or zstd it uses snappy
+   * @return - true if we succeed
+   */
+  bool setCompression(const std::string &databaseName, const std::string &setName, const std::string &codec);
+
+  /**
+   * Sets the codec the data this client sends is compressed with, the nodes use their own codec for the pages they send
+   * @param codec - "none", "snappy", "lz4" or "zstd", if the client was not built with lz4 or zstd it uses snappy
+   * @param minSavings - the fraction of the data we have to save to keep compressing, zero always compresses
+   * @return - true if we succeed
+   */
+  bool setWireCompression(const std::string &codec, double minSavings = 0.1);
+
   /**
    * Sends a request to the Catalog Server to register a user-defined type defined in a shared library.
    * @param fileContainingSharedLib - the file that contains the library
@@ -147,6 +165,13 @@ class PDBClient : public ServerFunctionality {
    */
   void listUserDefinedTypes();
 
+  /**
+   * Prints the counters of the buffer manager of the manager and of every worker, they tell how well the buffer pool
+   * and the page size of a node fit the workload
+   * @return - true if we got the counters of every node false otherwise
+   */
+  bool listBufferManagerStats();
+
   /**
    * Send the data to be stored in a set
    * @param setAndDatabase - the database name and set name
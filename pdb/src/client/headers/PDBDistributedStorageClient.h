@@ -25,6 +25,7 @@
 #include "Handle.h"
 #include "PDBVector.h"
 #include "PDBCatalogClient.h"
+#include "PDBWireCompression.h"
 
 namespace pdb {
 
@@ -79,6 +80,15 @@ public:
    */
   bool removeSet(const string &dbName, const string &setName, std::string &errMsg);
 
+  /**
+   * Sets the codec the data we send is compressed with
+   * @param codec - "none", "snappy", "lz4" or "zstd"
+   * @param minSavings - the fraction of the data we have to save to keep compressing, zero always compresses
+   * @param errMsg - the error message
+   * @return true if we succeed false otherwise
+   */
+  bool setWireCompression(const std::string &codec, double minSavings, std::string &errMsg);
+
   /**
    * Returns an vector iterator that can fetch records from the storage
    * @param set - the set want to grab the iterator for
@@ -111,6 +121,11 @@ private:
    * The logger of the client
    */
   PDBLoggerPtr logger;
+
+  /**
+   * The compression of the data we send
+   */
+  PDBWireCompressionPtr wireCompression = std::make_shared<PDBWireCompression>(PDB_PAGE_COMPRESSION_SNAPPY, 0.1);
 };
 
 }
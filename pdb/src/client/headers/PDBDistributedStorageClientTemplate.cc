@@ -47,7 +47,7 @@ bool PDBDistributedStorageClient::sendData(const std::string &db, const std::str
 
         return true;
       },
-      dataToSend, db, set, getTypeName<DataType>());
+      *wireCompression, dataToSend, db, set, getTypeName<DataType>());
 }
 
 template<class DataType>
@@ -29,6 +29,7 @@
 #include <PDBCatalogClient.h>
 #include <CatSetUpdateSizeRequest.h>
 #include <CatSetUpdateContainerTypeRequest.h>
+#include <CatSetUpdateCompressionRequest.h>
 
 #include "CatCreateDatabaseRequest.h"
 #include "CatCreateSetRequest.h"
@@ -409,7 +410,9 @@ pdb::PDBCatalogSetPtr PDBCatalogClient::getSet(const std::string &dbName, const
 
                 // do we have the thing
                 if(result != nullptr && result->databaseName == dbName && result->setName == setName) {
-                  return std::make_shared<pdb::PDBCatalogSet>(result->databaseName, result->setName, result->type, result->setSize, result->containerType);
+                  auto set = std::make_shared<pdb::PDBCatalogSet>(result->databaseName, result->setName, result->type, result->setSize, result->containerType);
+                  set->compression = result->compression;
+                  return set;
                 }
 
                 // return a null pointer otherwise
@@ -464,6 +467,28 @@ bool PDBCatalogClient::updateSetContainerType(const string &databaseName,
       databaseName, setName, containerType);
 }
 
+bool PDBCatalogClient::updateSetCompression(const string &databaseName,
+                                            const string &setName,
+                                            PDBPageCompression compression,
+                                            string &errMsg) {
+  // make a request and return the value
+  return RequestFactory::heapRequest<CatSetUpdateCompressionRequest, SimpleRequestResult, bool>(
+      myLogger, port, address, false, 1024,
+      [&](Handle<SimpleRequestResult> result) {
+        if (result != nullptr) {
+          if (!result->getRes().first) {
+            errMsg = "Error updating set: " + result->getRes().second;
+            myLogger->error("Error updating set: " + result->getRes().second);
+            return false;
+          }
+          return true;
+        }
+        errMsg = "Error getting set: got nothing back from catalog";
+        return false;
+      },
+      databaseName, setName, compression);
+}
+
 pdb::PDBCatalogDatabasePtr PDBCatalogClient::getDatabase(const std::string &dbName, std::string &errMsg) {
 
   // make a request and return the value
@@ -20,8 +20,11 @@
 #define PDBCLIENT_CC
 
 #include <ShutDown.h>
+#include <BufGetStatsRequest.h>
+#include <BufGetStatsResult.h>
 #include <PDBClient.h>
 #include <QueryGraphAnalyzer.h>
+#include <PDBBufferManagerCompression.h>
 
 #include "PDBClient.h"
 
@@ -134,6 +137,26 @@ bool PDBClient::registerType(const std::string &fileContainingSharedLib) {
   return result;
 }
 
+bool PDBClient::setCompression(const std::string &databaseName, const std::string &setName, const std::string &codec) {
+
+  // figure out the codec
+  PDBPageCompression compression;
+  if (!PDBBufferManagerCompression::fromString(codec, compression)) {
+    errorMsg = "Unknown codec: " + codec;
+    return false;
+  }
+
+  bool result = catalogClient->updateSetCompression(databaseName, setName, compression, returnedMsg);
+  if (!result) {
+    errorMsg = "Not able to set the codec of the set: " + returnedMsg;
+  }
+  return result;
+}
+
+bool PDBClient::setWireCompression(const std::string &codec, double minSavings) {
+  return distributedStorage->setWireCompression(codec, minSavings, errorMsg);
+}
+
 bool PDBClient::clearSet(const string &dbName, const string &setName) {
   return distributedStorage->clearSet(dbName, setName, errorMsg);
 }
@@ -182,6 +205,37 @@ void PDBClient::listUserDefinedTypes() {
   cout << catalogClient->listUserDefinedTypes(returnedMsg);
 }
 
+bool PDBClient::listBufferManagerStats() {
+
+  // the manager and the workers
+  std::vector<std::pair<std::string, int>> nodes = { std::make_pair(address, port) };
+  for (const auto &w : catalogClient->getActiveWorkerNodes()) {
+    nodes.emplace_back(w->address, w->port);
+  }
+
+  // grab the counters of every node and print them
+  bool success = true;
+  for (const auto &node : nodes) {
+    success = RequestFactory::heapRequest<BufGetStatsRequest, BufGetStatsResult, bool>(logger, node.second, node.first, false, 1024,
+      [&](Handle<BufGetStatsResult> result) {
+
+        // do we have a result
+        if (result == nullptr) {
+
+          errorMsg = "Error getting the buffer manager stats: got nothing back from " + node.first + ":" + std::to_string(node.second);
+          logger->error(errorMsg);
+          return false;
+        }
+
+        // print them
+        cout << "Buffer manager of " << node.first << ":" << node.second << "\n" << result->getStats().toString() << "\n";
+        return true;
+      }) && success;
+  }
+
+  return success;
+}
+
 
 
 }
@@ -43,4 +43,17 @@ bool PDBDistributedStorageClient::removeSet(const string &dbName, const string &
       dbName, setName);
 }
 
+bool PDBDistributedStorageClient::setWireCompression(const std::string &codec, double minSavings, std::string &errMsg) {
+
+  // figure out the codec
+  PDBPageCompression compression;
+  if (!PDBBufferManagerCompression::fromString(codec, compression)) {
+    errMsg = "Unknown codec: " + codec;
+    return false;
+  }
+
+  wireCompression = std::make_shared<PDBWireCompression>(compression, minSavings);
+  return true;
+}
+
 }
@@ -20,7 +20,7 @@
 #define SIMPLE_REQUEST_H
 
 #include "PDBLogger.h"
-#include <snappy.h>
+#include <PDBWireCompression.h>
 #include <PDBCommunicator.h>
 #include <functional>
 
@@ -103,6 +103,7 @@ public:
    * @param onErr - the value to return if there is an error sending/receiving data
    * @param bytesForRequest - the number of bytes to give to the allocator used to build the request
    * @param processResponse - the std::function used to process the response to the request
+   * @param compression - the compression we make the frame of the data with
    * @param dataToSend - the vector of data we want to send
    * @param args - the arguments to give to the constructor of the request
    * @return whatever is returned from processResponse or onErr in case of failure
@@ -110,7 +111,7 @@ public:
   template <class RequestType, class DataType, class ResponseType, class ReturnType, class... RequestTypeParams>
   static ReturnType dataHeapRequest(pdb::PDBLoggerPtr myLogger, int port, const std::string &address,
                                     ReturnType onErr, size_t bytesForRequest, std::function<ReturnType(pdb::Handle<ResponseType>)> processResponse,
-                                    pdb::Handle<Vector<pdb::Handle<DataType>>> dataToSend, RequestTypeParams&&... args);
+                                    PDBWireCompression &compression, pdb::Handle<Vector<pdb::Handle<DataType>>> dataToSend, RequestTypeParams&&... args);
 
 
   /**
@@ -25,6 +25,7 @@
 #include "InterfaceFunctions.h"
 #include "UseTemporaryAllocationBlock.h"
 #include "PDBCommunicator.h"
+#include "PDBConnectionPool.h"
 
 using std::function;
 using std::string;
@@ -45,6 +46,14 @@ ReturnType RequestFactory::heapRequest(PDBLoggerPtr myLogger,
                                        RequestTypeParams &&... args) {
 
 
+    // check if it is invalid
+    if (bytesForRequest <= BLOCK_HEADER_SIZE) {
+
+        // ok this is an unrecoverable error
+        myLogger->error("Too small buffer size for processing simple request");
+        return onErr;
+    }
+
     // try multiple times if we fail to connect
     int numRetries = 0;
     while (numRetries <= MAX_RETRIES) {
@@ -53,9 +62,10 @@ ReturnType RequestFactory::heapRequest(PDBLoggerPtr myLogger,
         string errMsg;
         bool success;
 
-        // connect to the server
-        PDBCommunicator temp;
-        if (!temp.connectToInternetServer(myLogger, port, address, errMsg)) {
+        // borrow a connection to the server
+        bool reused;
+        PDBCommunicatorPtr temp = PDBConnectionPool::getDefault().borrow(myLogger, port, address, reused, errMsg);
+        if (temp == nullptr) {
 
             // log the error
             myLogger->error(errMsg);
@@ -69,14 +79,6 @@ ReturnType RequestFactory::heapRequest(PDBLoggerPtr myLogger,
         // log that we are connected
         myLogger->info(std::string("Successfully connected to remote server with port=") + std::to_string(port) + std::string(" and address=") + address);
 
-        // check if it is invalid
-        if (bytesForRequest <= BLOCK_HEADER_SIZE) {
-
-            // ok this is an unrecoverable error
-            myLogger->error("Too small buffer size for processing simple request");
-            return onErr;
-        }
-
         // make a block to send the request
         const UseTemporaryAllocationBlock tempBlock{bytesForRequest};
 
@@ -84,7 +86,13 @@ ReturnType RequestFactory::heapRequest(PDBLoggerPtr myLogger,
         Handle<RequestType> request = makeObject<RequestType>(args...);
 
         // send the object
-        if (!temp.sendObject(request, errMsg)) {
+        if (!temp->sendObject(request, errMsg)) {
+
+            // if we reused the connection the server closed it before it got the request, so we try the next one
+            if (reused) {
+                myLogger->info("The connection to the server was closed, trying another one.");
+                continue;
+            }
 
             // yeah something happened
             myLogger->error(errMsg);
@@ -99,11 +107,17 @@ ReturnType RequestFactory::heapRequest(PDBLoggerPtr myLogger,
 
         // get the response and process it
         ReturnType finalResult;
-        size_t objectSize = temp.getSizeOfNextObject();
+        size_t objectSize = temp->getSizeOfNextObject();
 
         // check if we did get a response
         if (objectSize == 0) {
 
+            // if we reused the connection the server might have closed it right before the request got there
+            if (reused) {
+                myLogger->info("The connection to the server was closed, trying another one.");
+                continue;
+            }
+
             // ok we did not that sucks log what happened
             myLogger->error("We did not get a response.\n");
 
@@ -124,7 +138,7 @@ ReturnType RequestFactory::heapRequest(PDBLoggerPtr myLogger,
         }
 
         {
-            Handle<ResponseType> result =  temp.getNextObject<ResponseType> (memory.get(), success, errMsg);
+            Handle<ResponseType> result =  temp->getNextObject<ResponseType> (memory.get(), success, errMsg);
             if (!success) {
 
                 // log the error
@@ -135,6 +149,9 @@ ReturnType RequestFactory::heapRequest(PDBLoggerPtr myLogger,
                 return onErr;
             }
 
+            // we have the whole response, so the connection can be used by the next request
+            PDBConnectionPool::getDefault().giveBack(port, address, temp);
+
             finalResult = processResponse(result);
         }
         return finalResult;
@@ -227,19 +244,27 @@ ReturnType RequestFactory::doubleHeapRequest(PDBLoggerPtr logger,
 template<class RequestType, class DataType, class ResponseType, class ReturnType, class... RequestTypeParams>
 ReturnType RequestFactory::dataHeapRequest(PDBLoggerPtr logger, int port, const std::string &address,
                                            ReturnType onErr, size_t bytesForRequest, function<ReturnType(Handle<ResponseType>)> processResponse,
-                                           Handle<Vector<Handle<DataType>>> dataToSend, RequestTypeParams&&... args) {
+                                           PDBWireCompression &compression, Handle<Vector<Handle<DataType>>> dataToSend,
+                                           RequestTypeParams&&... args) {
 
     // get the record
     auto* myRecord = (Record<Vector<Handle<Object>>>*) getRecord(dataToSend);
 
-    auto maxCompressedSize = snappy::MaxCompressedLength(myRecord->numBytes());
+    auto maxCompressedSize = compression.getMaxFrameSize(myRecord->numBytes());
 
     // allocate the bytes for the compressed record
     std::unique_ptr<char[]> compressedBytes(new char[maxCompressedSize]);
 
     // compress the record
-    size_t compressedSize;
-    snappy::RawCompress((char*) myRecord, myRecord->numBytes(), compressedBytes.get(), &compressedSize);
+    size_t compressedSize = compression.compress((char*) myRecord, myRecord->numBytes(), compressedBytes.get(), maxCompressedSize);
+    if (compressedSize == 0) {
+
+        // log the error
+        logger->error("dataHeapRequest: could not compress the data");
+
+        // we are done here
+        return onErr;
+    }
 
     // log what we are doing
     logger->info("size before compression is "  + std::to_string(myRecord->numBytes()) + " and size after compression is " + std::to_string(compressedSize));
@@ -276,21 +301,12 @@ ReturnType RequestFactory::dataHeapRequest(PDBLoggerPtr logger, int port, const
 
         const UseTemporaryAllocationBlock tempBlock{bytesForRequest};
         Handle<RequestType> request = makeObject<RequestType>(args...);
-        if (!temp.sendObject(request, errMsg)) {
+        // send the request and the bytes together
+        if (!temp.sendObjectAndBytes(request, compressedBytes.get(), compressedSize, errMsg)) {
 
             // log the error
             logger->error(errMsg);
-            logger->error("simpleSendDataRequest: not able to send request to server.\n");
-
-            // we are done here
-            return onErr;
-        }
-
-        // now, send the bytes
-        if (!temp.sendBytes(compressedBytes.get(), compressedSize, errMsg)) {
-
-            logger->error(errMsg);
-            logger->error("simpleSendDataRequest: not able to send data to server.\n");
+            logger->error("simpleSendDataRequest: not able to send request and data to server.\n");
 
             // we are done here
             return onErr;
@@ -376,21 +392,12 @@ ReturnType RequestFactory::bytesHeapRequest(PDBLoggerPtr logger, int port, std::
 
         const UseTemporaryAllocationBlock tempBlock{bytesForRequest};
         Handle<RequestType> request = makeObject<RequestType>(args...);
-        if (!temp.sendObject(request, errMsg)) {
+        // send the request and the bytes together
+        if (!temp.sendObjectAndBytes(request, bytes, numBytes, errMsg)) {
 
             // log the error
             logger->error(errMsg);
-            logger->error("simpleSendDataRequest: not able to send request to server.\n");
-
-            // we are done here
-            return onErr;
-        }
-
-        // now, send the bytes
-        if (!temp.sendBytes(bytes, numBytes, errMsg)) {
-
-            logger->error(errMsg);
-            logger->error("simpleSendDataRequest: not able to send data to server.\n");
+            logger->error("simpleSendDataRequest: not able to send request and data to server.\n");
 
             // we are done here
             return onErr;
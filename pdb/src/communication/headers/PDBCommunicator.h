@@ -32,6 +32,12 @@
 #include "PDBLogger.h"
 #include <stdlib.h>
 #include <cstring>
+#include <sys/uio.h>
+
+// the smallest write we send with MSG_ZEROCOPY, below this pinning the pages costs more than the copy
+#ifndef PDB_ZERO_COPY_MIN_BYTES
+#define PDB_ZERO_COPY_MIN_BYTES (64 * 1024)
+#endif
 
 // This class the encoding/decoding of IPC sockets messages in PDB
 namespace pdb {
@@ -87,6 +93,11 @@ public:
     // sends a bunch of binary data over a channel
     bool sendBytes(void* data, size_t size, std::string& errMsg);
 
+    // sends an object followed by a bunch of binary data, the same as sendObject followed by sendBytes
+    // but everything goes out with one system call straight from the memory of the object and the data
+    template <class ObjType>
+    bool sendObjectAndBytes(Handle<ObjType>& sendMe, void* data, size_t size, std::string& errMsg);
+
     // receives a bunch of binary data over a channel
     bool receiveBytes(void* data, std::string& errMsg);
 
@@ -110,9 +121,25 @@ public:
 
     bool reconnect(std::string& errMsg);
 
+    // returns true if the connection can be used for the next request, that is the socket is open, we read all the
+    // messages we were sent and the other side did not close its end or send us something we did not ask for
+    bool isIdle();
+
+    // asks the kernel to send the writes of at least PDB_ZERO_COPY_MIN_BYTES straight from our memory
+    // instead of copying them (MSG_ZEROCOPY); a write still only returns once the kernel is done with
+    // the memory; returns false if the kernel or the socket does not support it
+    bool enableZeroCopy();
+
+    // returns the number of writes that were sent with MSG_ZEROCOPY
+    uint64_t getNumZeroCopyWrites();
+
 private:
-    // write from start to end to the output socket
-    bool doTheWrite(char* start, char* end);
+    // write all the buffers to the output socket with as few system calls as possible, the iovecs are
+    // modified to keep track of what was written
+    bool doTheWritev(struct iovec* iov, int iovcnt);
+
+    // wait until the kernel is done with the memory of all the zero copy writes
+    bool waitForZeroCopy();
 
     // read the message data from socket
     bool doTheRead(char* dataIn);
@@ -151,6 +178,14 @@ private:
     std::string fileName;
 
     bool isInternet;
+
+    // do we send the large writes with MSG_ZEROCOPY
+    bool useZeroCopy = false;
+
+    // the number of zero copy writes we sent and the number the kernel told us it is done with
+    uint32_t numZeroCopySent = 0;
+    uint32_t numZeroCopyDone = 0;
+    uint64_t numZeroCopyWrites = 0;
 };
 }
 
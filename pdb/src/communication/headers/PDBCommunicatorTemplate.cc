@@ -52,14 +52,7 @@ bool PDBCommunicator::sendObject(Handle<ObjType>& sendMe, std::string& errMsg) {
         exit(1);
     }
 
-    // write out the record type
-    if (!doTheWrite(((char*)&recType), ((char*)&recType) + sizeof(int16_t))) {
-        logToMe->error(errMsg);
-        logToMe->error(strerror(errno));
-        return false;
-    }
-
-    // next, write the object
+    // next, grab the object
     auto* record = getRecord(sendMe);
 
     // check if the record is on a different allocation block
@@ -68,8 +61,9 @@ bool PDBCommunicator::sendObject(Handle<ObjType>& sendMe, std::string& errMsg) {
         exit(1);
     }
 
-    // write it out
-    if (!doTheWrite((char*)record, ((char*)record) + record->numBytes())) {
+    // write out the record type and the object together
+    struct iovec iov[2] = {{&recType, sizeof(int16_t)}, {record, record->numBytes()}};
+    if (!doTheWritev(iov, 2)) {
 
         // set the error
         errMsg = "PDBCommunicator: not able to send the object size";
@@ -98,13 +92,6 @@ bool PDBCommunicator::sendObject(Handle<ObjType>& sendMe, std::string& errMsg, s
         exit(1);
     }
 
-    // write out the record type
-    if (!doTheWrite(((char*)&recType), ((char*)&recType) + sizeof(int16_t))) {
-        logToMe->error(errMsg);
-        logToMe->error(strerror(errno));
-        return false;
-    }
-
     // since we assume that sendMe is not in this thread's allocator block, we do a deep copy
     std::unique_ptr<char[]> mem(new char[blockSize]);
     auto* record = getRecord(sendMe, mem.get(), blockSize);
@@ -117,8 +104,9 @@ bool PDBCommunicator::sendObject(Handle<ObjType>& sendMe, std::string& errMsg, s
         exit(1);
     }
 
-    // do the write
-    if (!doTheWrite((char*)record, ((char*)record) + record->numBytes())) {
+    // write out the record type and the object together
+    struct iovec iov[2] = {{&recType, sizeof(int16_t)}, {record, record->numBytes()}};
+    if (!doTheWritev(iov, 2)) {
 
         // set the error
         errMsg = "PDBCommunicator: not able to send the object size";
@@ -159,30 +147,55 @@ inline bool PDBCommunicator::receiveBytes(void* data, std::string& errMsg) {
 
 inline bool PDBCommunicator::sendBytes(void* data, size_t sizeOfBytes, std::string& errMsg) {
 
+    // the type, the size and the actual bytes go out together
     int16_t recType = NoMsg_TYPEID;
-    if (!doTheWrite(((char*)&recType), ((char*)&recType) + sizeof(int16_t))) {
-        errMsg = "PDBCommunicator: not able to send the object type";
+    struct iovec iov[3] = {{&recType, sizeof(int16_t)}, {&sizeOfBytes, sizeof(size_t)}, {data, sizeOfBytes}};
+    if (!doTheWritev(iov, 3)) {
+        errMsg = "PDBCommunicator: not able to send the bytes";
         logToMe->error(errMsg);
         logToMe->error(strerror(errno));
         return false;
     }
 
-    // now write the size
-    if (!doTheWrite(((char*)&sizeOfBytes), ((char*)&sizeOfBytes) + sizeof(size_t))) {
-        errMsg = "PDBCommunicator: not able to send the object size";
-        logToMe->error(errMsg);
-        logToMe->error(strerror(errno));
-        return false;
+    return true;
+}
+
+template <class ObjType>
+bool PDBCommunicator::sendObjectAndBytes(Handle<ObjType>& sendMe, void* data, size_t sizeOfBytes, std::string& errMsg) {
+
+    // grab the type of the object
+    int16_t recType = getTypeID<ObjType>();
+    if (recType < 0) {
+        logToMe->error("Fatal Error: BAD!  Trying to send a handle to a non-Object type.\n");
+        exit(1);
     }
 
-    // now we put the actual bytes
-    if (!doTheWrite(((char*)data), ((char*)data) + sizeOfBytes)) {
-        errMsg = "PDBCommunicator: not able to send the bytes";
+    // grab the object
+    auto* record = getRecord(sendMe);
+    if (record == nullptr) {
+        logToMe->error("Fatal Error: BAD!  Trying to get a record for an object not created by this thread's allocator.\n");
+        exit(1);
+    }
+
+    // this is exactly what sendObject and sendBytes write, just with one system call
+    int16_t bytesType = NoMsg_TYPEID;
+    struct iovec iov[5] = {{&recType, sizeof(int16_t)},
+                           {record, record->numBytes()},
+                           {&bytesType, sizeof(int16_t)},
+                           {&sizeOfBytes, sizeof(size_t)},
+                           {data, sizeOfBytes}};
+    if (!doTheWritev(iov, 5)) {
+        errMsg = "PDBCommunicator: not able to send the object and the bytes";
         logToMe->error(errMsg);
         logToMe->error(strerror(errno));
         return false;
     }
 
+    // log the stuff
+    logToMe->info(std::string("Sent object with typeName=") + getTypeName<ObjType>() +
+                  std::string(", recType=") + std::to_string(recType) +
+                  std::string(" and ") + std::to_string(sizeOfBytes) +
+                  std::string(" bytes over socketFD=") + std::to_string(socketFD));
     return true;
 }
 
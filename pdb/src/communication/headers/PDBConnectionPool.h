@@ -0,0 +1,157 @@
+/*****************************************************************************
+ *                                                                           *
+ *  Copyright 2018 Rice University                                           *
+ *                                                                           *
+ *  Licensed under the Apache License, Version 2.0 (the "License");          *
+ *  you may not use this file except in compliance with the License.         *
+ *  You may obtain a copy of the License at                                  *
+ *                                                                           *
+ *      http://www.apache.org/licenses/LICENSE-2.0                           *
+ *                                                                           *
+ *  Unless required by applicable law or agreed to in writing, software      *
+ *  distributed under the License is distributed on an "AS IS" BASIS,        *
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. *
+ *  See the License for the specific language governing permissions and      *
+ *  limitations under the License.                                           *
+ *                                                                           *
+ *****************************************************************************/
+
+#ifndef PDB_CONNECTION_POOL_H
+#define PDB_CONNECTION_POOL_H
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "PDBCommunicator.h"
+#include "PDBLogger.h"
+
+// the number of idle connections we keep to each server, every one of them holds a worker of the server
+#ifndef PDB_CONNECTION_POOL_MAX_IDLE
+#define PDB_CONNECTION_POOL_MAX_IDLE 4
+#endif
+
+// how long in milliseconds we keep a connection nobody is using before we close it
+#ifndef PDB_CONNECTION_POOL_KEEP_ALIVE_MS
+#define PDB_CONNECTION_POOL_KEEP_ALIVE_MS 30000
+#endif
+
+namespace pdb {
+
+class PDBConnectionPool;
+typedef std::shared_ptr<PDBConnectionPool> PDBConnectionPoolPtr;
+
+/**
+ * Keeps the connections to the servers we talked to open so that the next request does not have to connect again.
+ * The server keeps handling the requests that come over a connection until the connection is closed, so a
+ * connection can be reused as long as the last request was answered completely.
+ *
+ * A connection is borrowed for a request and given back once the response was read. Before we hand out an idle
+ * connection we check that the server did not close it and that it did not send us anything we did not ask for,
+ * if it did we close it and try the next one. The connections nobody used for a while are closed, since each of them
+ * keeps a worker of the server busy.
+ */
+class PDBConnectionPool {
+
+ public:
+
+  /**
+   * Makes the pool
+   * @param maxIdle - the number of idle connections we keep to each server, zero disables the pool
+   * @param keepAlive - how long we keep an idle connection
+   */
+  explicit PDBConnectionPool(size_t maxIdle = PDB_CONNECTION_POOL_MAX_IDLE,
+                             std::chrono::milliseconds keepAlive = std::chrono::milliseconds(PDB_CONNECTION_POOL_KEEP_ALIVE_MS));
+
+  /**
+   * Returns the pool the requests of this process share
+   */
+  static PDBConnectionPool &getDefault();
+
+  /**
+   * Borrows a connection to the server, if there is no idle one we connect to the server
+   * @param logger - the logger of the connection if we have to make one
+   * @param port - the port of the server
+   * @param address - the address of the server
+   * @param reused - set to true if the connection was used before, if it fails it might have been closed by the server
+   * @param errMsg - the error if we could not connect
+   * @return - the connection or null if we could not connect
+   */
+  PDBCommunicatorPtr borrow(const PDBLoggerPtr &logger, int port, const std::string &address, bool &reused, std::string &errMsg);
+
+  /**
+   * Gives back a connection once the response to the last request was read, if we already have enough idle
+   * connections to the server it is closed
+   * @param port - the port of the server
+   * @param address - the address of the server
+   * @param communicator - the connection
+   */
+  void giveBack(int port, const std::string &address, const PDBCommunicatorPtr &communicator);
+
+  /**
+   * Sets the number of idle connections we keep to each server, zero disables the pool
+   */
+  void setMaxIdle(size_t maxIdle);
+
+  /**
+   * Sets how long we keep an idle connection
+   */
+  void setKeepAlive(std::chrono::milliseconds keepAlive);
+
+  /**
+   * Closes all the idle connections
+   */
+  void clear();
+
+  /**
+   * Returns the number of times we had to connect to a server and the number of times we reused a connection
+   */
+  uint64_t getNumConnects();
+  uint64_t getNumReuses();
+
+ private:
+
+  /**
+   * Closes the idle connections that were not used for longer than the keep alive
+   */
+  void closeExpired(std::chrono::steady_clock::time_point now);
+
+  /**
+   * A connection nobody uses and since when
+   */
+  struct IdleConnection {
+    PDBCommunicatorPtr communicator;
+    std::chrono::steady_clock::time_point since;
+  };
+
+  /**
+   * The idle connections to each server by address and port, the one used last is at the back
+   */
+  std::map<std::pair<std::string, int>, std::vector<IdleConnection>> idle;
+
+  /**
+   * The number of idle connections we keep to each server
+   */
+  size_t maxIdle;
+
+  /**
+   * How long we keep an idle connection
+   */
+  std::chrono::milliseconds keepAlive;
+
+  /**
+   * The number of times we had to connect to a server and the number of times we reused a connection
+   */
+  uint64_t numConnects = 0;
+  uint64_t numReuses = 0;
+
+  /**
+   * Protects the pool
+   */
+  std::mutex m;
+};
+
+}
+
+#endif //PDB_CONNECTION_POOL_H
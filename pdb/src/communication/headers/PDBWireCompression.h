@@ -0,0 +1,182 @@
+/*****************************************************************************
+ *                                                                           *
+ *  Copyright 2018 Rice University                                           *
+ *                                                                           *
+ *  Licensed under the Apache License, Version 2.0 (the "License");          *
+ *  you may not use this file except in compliance with the License.         *
+ *  You may obtain a copy of the License at                                  *
+ *                                                                           *
+ *      http://www.apache.org/licenses/LICENSE-2.0                           *
+ *                                                                           *
+ *  Unless required by applicable law or agreed to in writing, software      *
+ *  distributed under the License is distributed on an "AS IS" BASIS,        *
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. *
+ *  See the License for the specific language governing permissions and      *
+ *  limitations under the License.                                           *
+ *                                                                           *
+ *****************************************************************************/
+
+#ifndef PDB_WIRE_COMPRESSION_H
+#define PDB_WIRE_COMPRESSION_H
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include "PDBBufferManagerCompression.h"
+
+// once a page saves less than the minimum we send this many pages as they are before we try to compress one again
+#ifndef PDB_WIRE_COMPRESSION_SKIP_PAGES
+#define PDB_WIRE_COMPRESSION_SKIP_PAGES 16
+#endif
+
+namespace pdb {
+
+class PDBWireCompression;
+typedef std::shared_ptr<PDBWireCompression> PDBWireCompressionPtr;
+
+/**
+ * The bytes we saved by compressing the pages we sent and the time we spent on it, they are counted for the whole
+ * process
+ */
+struct PDBWireCompressionStats {
+
+  // the pages we compressed and the ones we sent as they are
+  uint64_t numCompressed = 0;
+  uint64_t numBypassed = 0;
+
+  // the bytes of the pages before and after compression, the ones sent as they are count for both
+  uint64_t numBytesIn = 0;
+  uint64_t numBytesOut = 0;
+
+  // the time we spent compressing and decompressing in nanoseconds
+  uint64_t compressNanos = 0;
+  uint64_t decompressNanos = 0;
+
+  /**
+   * Returns the number of bytes we did not have to send
+   */
+  uint64_t getBytesSaved() const {
+    return numBytesIn > numBytesOut ? numBytesIn - numBytesOut : 0;
+  }
+};
+
+/**
+ * Compresses the pages we send over the wire. Every page is sent as a frame, a small header with the codec and the
+ * uncompressed size followed by the bytes, so the receiver never has to know how the sender was configured and the
+ * nodes that only forward a page don't have to touch it.
+ *
+ * If the minimum savings are not zero the compression is adaptive. A page that does not shrink by at least that
+ * fraction, like float data or bytes that are already compressed, makes us send the next few pages as they are, then
+ * we sample the next one again. A page that would grow is always sent as it is. An object can be shared by the threads
+ * that send the pages of the same set or over the same connection.
+ */
+class PDBWireCompression {
+
+ public:
+
+  /**
+   * Makes the compression
+   * @param codec - the codec we compress with, if we were not built with it we use snappy
+   * @param minSavings - the fraction of a page we have to save to keep compressing, zero always compresses
+   */
+  explicit PDBWireCompression(PDBPageCompression codec, double minSavings = 0);
+
+  /**
+   * Makes the compression with the codec of the name, "none", "snappy", "lz4" or "zstd"
+   * @param codec - the name of the codec
+   * @param minSavings - the fraction of a page we have to save to keep compressing, zero always compresses
+   * @return - the compression, throws a runtime_error if there is no codec with the name
+   */
+  static PDBWireCompressionPtr make(const std::string &codec, double minSavings);
+
+  /**
+   * Returns the largest number of bytes the frame of a page can take
+   * @param numBytes - the size of the page
+   */
+  size_t getMaxFrameSize(size_t numBytes) const;
+
+  /**
+   * Makes a frame out of the page
+   * @param in - the page
+   * @param inSize - the size of the page
+   * @param out - where the frame goes, it has room for at least getMaxFrameSize bytes
+   * @param outSize - the size of out
+   * @return - the size of the frame or 0 if it does not fit
+   */
+  size_t compress(const char *in, size_t inSize, char *out, size_t outSize);
+
+  /**
+   * Reads the size of the page in the frame
+   * @param in - the frame
+   * @param inSize - the size of the frame
+   * @param numBytes - the size of the page is stored here
+   * @return - false if this is not a frame
+   */
+  static bool getUncompressedSize(const char *in, size_t inSize, size_t &numBytes);
+
+  /**
+   * Gets the page out of the frame
+   * @param in - the frame
+   * @param inSize - the size of the frame
+   * @param out - where the page goes
+   * @param outSize - the size of out
+   * @return - true if it worked and the page fits into out
+   */
+  static bool decompress(const char *in, size_t inSize, char *out, size_t outSize);
+
+  /**
+   * Returns the codec we compress with
+   */
+  PDBPageCompression getCodec() const;
+
+  /**
+   * Returns the counters of the process
+   */
+  static PDBWireCompressionStats getStats();
+
+ private:
+
+  /**
+   * The header of a frame
+   */
+  struct Header {
+
+    // the codec the page was compressed with
+    uint32_t codec;
+
+    // unused, it keeps the size aligned
+    uint32_t reserved;
+
+    // the size of the page
+    uint64_t numBytes;
+  };
+
+  /**
+   * Returns true if we send the next page as it is because the last sampled one did not compress well
+   */
+  bool skipPage();
+
+  /**
+   * Makes a frame with the page as it is
+   */
+  static size_t copy(const char *in, size_t inSize, char *out, size_t outSize);
+
+  /**
+   * The codec we compress with
+   */
+  PDBPageCompression codec;
+
+  /**
+   * The fraction of a page we have to save to keep compressing
+   */
+  double minSavings;
+
+  /**
+   * The number of pages we still send as they are before we sample again
+   */
+  std::atomic<uint32_t> numToSkip{0};
+};
+
+}
+
+#endif //PDB_WIRE_COMPRESSION_H
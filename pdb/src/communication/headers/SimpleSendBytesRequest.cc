@@ -65,20 +65,10 @@ ReturnType simpleSendBytesRequest(PDBLoggerPtr myLogger,
         }
         const UseTemporaryAllocationBlock tempBlock{bytesForRequest};
         Handle<RequestType> request = makeObject<RequestType>(args...);
-        if (!temp.sendObject(request, errMsg)) {
+        // send the request and the bytes together
+        if (!temp.sendObjectAndBytes(request, bytes, numBytes, errMsg)) {
             myLogger->error(errMsg);
-            myLogger->error("simpleSendDataRequest: not able to send request to server.\n");
-            if (retries < MAX_RETRIES) {
-                retries++;
-                continue;
-            } else {
-                return onErr;
-            }
-        }
-        // now, send the bytes
-        if (!temp.sendBytes(bytes, numBytes, errMsg)) {
-            myLogger->error(errMsg);
-            myLogger->error("simpleSendDataRequest: not able to send data to server.\n");
+            myLogger->error("simpleSendDataRequest: not able to send request and data to server.\n");
             if (retries < MAX_RETRIES) {
                 retries++;
                 continue;
@@ -26,6 +26,11 @@
 #include <iostream>
 #include <netdb.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#ifdef __linux__
+#include <linux/errqueue.h>
+#endif
 #include "Object.h"
 #include "PDBVector.h"
 #include "CloseConnection.h"
@@ -77,6 +82,12 @@ bool PDBCommunicator::pointToInternet(PDBLoggerPtr logToMeIn, int socketFDIn, st
         return false;
     }
     socketClosed = false;
+
+    // the clients keep their connections open for more requests, a response is written in a few small pieces and we
+    // don't want them to wait for the ack of the previous one
+    int on = 1;
+    setsockopt(socketFD, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+
     logToMe->info("PDBCommunicator: got request from Internet");
     return true;
 }
@@ -156,6 +167,8 @@ bool PDBCommunicator::connectToInternetServer(PDBLoggerPtr logToMeIn,
     this->portNumber = portNumber;
     this->serverAddress = serverAddress;
     socketClosed = false;
+    useZeroCopy = false;
+    numZeroCopySent = numZeroCopyDone = 0;
     logToMe->trace("PDBCommunicator: Successfully connected to the remote host");
     logToMe->trace("PDBCommunicator: Socket FD is " + std::to_string(socketFD));
 
@@ -207,6 +220,8 @@ bool PDBCommunicator::connectToLocalServer(PDBLoggerPtr logToMeIn,
     fileName = fName;
     // std :: cout << "Connected!!\n";
     socketClosed = false;
+    useZeroCopy = false;
+    numZeroCopySent = numZeroCopyDone = 0;
     return true;
 }
 
@@ -299,18 +314,19 @@ size_t PDBCommunicator::getSizeOfNextObject() {
         return msgSize;
     }
 
-    // make sure we got enough bytes... if we did not, then error out
+    // the type and the size always come together, so we read them with one call into the two fields
     // JIANOTE: we may not receive all the bytes at once, so we need a loop
-    int receivedBytes = 0;
-    int receivedTotal = 0;
-    int bytesToReceive = (int)(sizeof(int16_t));
-    int retries = 0;
-    while (receivedTotal < (int)(sizeof(int16_t))) {
-        if ((receivedBytes = read(socketFD,
-                                  (char*)((char*)(&nextTypeID) + receivedTotal * sizeof(char)),
-                                  bytesToReceive)) < 0) {
+    struct iovec iov[2] = {{&nextTypeID, sizeof(int16_t)}, {&msgSize, sizeof(size_t)}};
+    struct iovec* cur = iov;
+    int iovcnt = 2;
+    while (iovcnt > 0) {
+        ssize_t receivedBytes = readv(socketFD, cur, iovcnt);
+        if (receivedBytes < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
             std::string errMsg =
-                std::string("PDBCommunicator: could not read next message type") + strerror(errno);
+                std::string("PDBCommunicator: could not read next message type and size") + strerror(errno);
             logToMe->error(errMsg);
             PDB_COUT << errMsg << std::endl;
             nextTypeID = NoMsg_TYPEID;
@@ -321,133 +337,178 @@ size_t PDBCommunicator::getSizeOfNextObject() {
             return 0;
         } else if (receivedBytes == 0) {
             logToMe->info(
-                "PDBCommunicator: the other side closed the socket when we try to read the type");
-            nextTypeID = NoMsg_TYPEID;
+                "PDBCommunicator: the other side closed the socket when we try to get next type and size");
             PDB_COUT
-                << "PDBCommunicator: the other side closed the socket when we try to get next type"
+                << "PDBCommunicator: the other side closed the socket when we try to get next type and size"
                 << std::endl;
-
-            // if (retries < MAX_RETRIES) {
-            if (retries < 0) {
-                retries++;
-                logToMe->info("PDBCommunicator: Retry to see whether network can recover");
-                PDB_COUT << "PDBCommunicator: Retry to see whether network can recover"
-                         << std::endl;
-                continue;
-            } else {
-                close(socketFD);
-                socketFD = -1;
-                socketClosed = true;
-                msgSize = 0;
-                return 0;
-            }
-
-        } else {
-            logToMe->info(std::string("PDBCommunicator: receivedBytes for reading type is ") +
-                          std::to_string(receivedBytes));
-            receivedTotal = receivedTotal + receivedBytes;
-            bytesToReceive = sizeof(int16_t) - receivedTotal;
-        }
-    }
-    // now we get enough bytes
-    logToMe->trace("PDBCommunicator: typeID of next object is " + std::to_string(nextTypeID));
-    logToMe->trace("PDBCommunicator: getting the size of the next object:");
-
-    // make sure we got enough bytes... if we did not, then error out
-    receivedBytes = 0;
-    receivedTotal = 0;
-    bytesToReceive = (int)(sizeof(size_t));
-    retries = 0;
-    while (receivedTotal < (int)(sizeof(size_t))) {
-        if ((receivedBytes = read(socketFD,
-                                  (char*)((char*)(&msgSize) + receivedTotal * sizeof(char)),
-                                  bytesToReceive)) < 0) {
-            std::string errMsg = "PDBCommunicator: could not read next message size:" +
-                std::to_string(receivedTotal) + strerror(errno);
-            logToMe->error(errMsg);
-            PDB_COUT << errMsg << std::endl;
+            nextTypeID = NoMsg_TYPEID;
             close(socketFD);
             socketFD = -1;
-
             socketClosed = true;
             msgSize = 0;
             return 0;
-        } else if (receivedBytes == 0) {
-            logToMe->info(
-                "PDBCommunicator: the other side closed the socket when we try to get next size");
-            nextTypeID = NoMsg_TYPEID;
-            PDB_COUT
-                << "PDBCommunicator: the other side closed the socket when we try to get next size"
-                << std::endl;
-            // if (retries < MAX_RETRIES) {
-            if (retries < 0) {
-                retries++;
-                PDB_COUT << "PDBCommunicator: Retry to see whether network can recover"
-                         << std::endl;
-                logToMe->info("PDBCommunicator: Retry to see whether network can recover");
-                continue;
-            } else {
-                close(socketFD);
-                socketFD = -1;
-                socketClosed = true;
-                msgSize = 0;
-                return 0;
-            }
+        }
 
-        } else {
-            logToMe->info(std::string("PDBCommunicator: receivedBytes for reading size is ") +
-                          std::to_string(receivedBytes));
-            receivedTotal = receivedTotal + receivedBytes;
-            bytesToReceive = sizeof(size_t) - receivedTotal;
+        // skip what we got
+        logToMe->info(std::string("PDBCommunicator: receivedBytes for reading type and size is ") +
+                      std::to_string(receivedBytes));
+        while (iovcnt > 0 && (size_t) receivedBytes >= cur->iov_len) {
+            receivedBytes -= cur->iov_len;
+            cur++;
+            iovcnt--;
+        }
+        if (iovcnt > 0) {
+            cur->iov_base = (char*) cur->iov_base + receivedBytes;
+            cur->iov_len -= receivedBytes;
         }
     }
+    logToMe->trace("PDBCommunicator: typeID of next object is " + std::to_string(nextTypeID));
+
     // OK, we did get enough bytes
     logToMe->trace("PDBCommunicator: size of next object is " + std::to_string(msgSize));
     readCurMsgSize = true;
     return msgSize;
 }
 
-bool PDBCommunicator::doTheWrite(char* start, char* end) {
+bool PDBCommunicator::doTheWritev(struct iovec* iov, int iovcnt) {
+
+    // figure out how much we are writing, only the large writes are worth sending with zero copy
+    size_t total = 0;
+    for (int i = 0; i < iovcnt; ++i) {
+        total += iov[i].iov_len;
+    }
+    int flags = 0;
+#ifdef MSG_ZEROCOPY
+    if (useZeroCopy && total >= PDB_ZERO_COPY_MIN_BYTES) {
+        flags = MSG_ZEROCOPY;
+    }
+#endif
 
-    int retries = 0;
     // and do the write
-    while (end != start) {
+    while (iovcnt > 0) {
 
         // write some bytes
-        ssize_t numBytes = write(socketFD, start, end - start);
+        struct msghdr msg{};
+        msg.msg_iov = iov;
+        msg.msg_iovlen = (size_t) iovcnt;
+        ssize_t numBytes = sendmsg(socketFD, &msg, flags);
+
         // make sure they went through
         if (numBytes < 0) {
+
+            // interrupted, or the kernel could not pin any more of our memory, then it has to copy
+            if (errno == EINTR) {
+                continue;
+            }
+            if (flags != 0 && errno == ENOBUFS) {
+                flags = 0;
+                continue;
+            }
+
             logToMe->error("PDBCommunicator: error in socket write");
-            logToMe->trace("PDBCommunicator: tried to write " + std::to_string(end - start) +
-                           " bytes.\n");
+            logToMe->trace("PDBCommunicator: tried to write " + std::to_string(total) + " bytes.\n");
             logToMe->trace("PDBCommunicator: Socket FD is " + std::to_string(socketFD));
             logToMe->error(strerror(errno));
-            // if (retries < MAX_RETRIES) {
-            if (retries < 0) {
-                retries++;
-                PDB_COUT << "PDBCommunicator: Retry to see whether network can recover"
-                         << std::endl;
-                logToMe->info("PDBCommunicator: Retry to see whether network can recover");
+            close(socketFD);
+            socketFD = -1;
+            socketClosed = true;
+            return false;
+        }
+
+        // the kernel numbers the zero copy writes and tells us once it is done with them
+        if (flags != 0 && numBytes > 0) {
+            numZeroCopySent++;
+            numZeroCopyWrites++;
+        }
+
+        // skip the buffers that were written completely and move into the one that was written partially
+        total -= numBytes;
+        logToMe->trace("PDBCommunicator: wrote " + std::to_string(numBytes) + " and are " +
+                       std::to_string(total) + " to go!");
+        while (iovcnt > 0 && (size_t) numBytes >= iov->iov_len) {
+            numBytes -= iov->iov_len;
+            iov++;
+            iovcnt--;
+        }
+        if (iovcnt > 0) {
+            iov->iov_base = (char*) iov->iov_base + numBytes;
+            iov->iov_len -= numBytes;
+        }
+    }
+
+    // the caller might reuse the memory as soon as we return
+    return flags == 0 || waitForZeroCopy();
+}
+
+bool PDBCommunicator::waitForZeroCopy() {
+
+#if defined(MSG_ZEROCOPY) && defined(SO_EE_ORIGIN_ZEROCOPY)
+    while (numZeroCopyDone != numZeroCopySent) {
+
+        // the notifications come over the error queue of the socket
+        struct pollfd pfd{};
+        pfd.fd = socketFD;
+        pfd.events = 0;
+        if (poll(&pfd, 1, -1) < 0 && errno != EINTR) {
+            logToMe->error("PDBCommunicator: could not wait for the zero copy writes " + std::string(strerror(errno)));
+            return false;
+        }
+
+        char control[128];
+        struct msghdr msg{};
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+        if (recvmsg(socketFD, &msg, MSG_ERRQUEUE) < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
                 continue;
-            } else {
-                // std :: cout << "############################################" << std :: endl;
-                // std :: cout << "WARNING: CONNECTION CLOSED DUE TO WRITE ERROR AFTER RETRY" << std
-                // :: endl;
-                // std :: cout << "############################################" << std :: endl;
-                close(socketFD);
-                socketFD = -1;
-                socketClosed = true;
-                return false;
             }
-        } else {
-            logToMe->trace("PDBCommunicator: wrote " + std::to_string(numBytes) + " and are " +
-                           std::to_string(end - start - numBytes) + " to go!");
-            start += numBytes;
+            logToMe->error("PDBCommunicator: could not read the zero copy notification " + std::string(strerror(errno)));
+            close(socketFD);
+            socketFD = -1;
+            socketClosed = true;
+            return false;
+        }
+
+        for (struct cmsghdr* cm = CMSG_FIRSTHDR(&msg); cm != nullptr; cm = CMSG_NXTHDR(&msg, cm)) {
+
+            // we only care about the zero copy notifications
+            auto* err = (struct sock_extended_err*) CMSG_DATA(cm);
+            if (!((cm->cmsg_level == SOL_IP && cm->cmsg_type == IP_RECVERR) ||
+                  (cm->cmsg_level == SOL_IPV6 && cm->cmsg_type == IPV6_RECVERR)) ||
+                err->ee_origin != SO_EE_ORIGIN_ZEROCOPY || err->ee_errno != 0) {
+                continue;
+            }
+
+            // the writes from ee_info to ee_data are done
+            numZeroCopyDone = err->ee_data + 1;
+
+            // if the kernel had to copy anyway, for example over the loopback, zero copy only costs us
+            if (err->ee_code & SO_EE_CODE_ZEROCOPY_COPIED) {
+                logToMe->info("PDBCommunicator: the kernel copied the zero copy write, not using zero copy anymore");
+                useZeroCopy = false;
+            }
         }
     }
+#endif
     return true;
 }
 
+bool PDBCommunicator::enableZeroCopy() {
+
+#if defined(MSG_ZEROCOPY) && defined(SO_ZEROCOPY)
+    int on = 1;
+    if (socketFD >= 0 && setsockopt(socketFD, SOL_SOCKET, SO_ZEROCOPY, &on, sizeof(on)) == 0) {
+        useZeroCopy = true;
+        return true;
+    }
+#endif
+    return false;
+}
+
+uint64_t PDBCommunicator::getNumZeroCopyWrites() {
+    return numZeroCopyWrites;
+}
+
 bool PDBCommunicator::doTheRead(char* dataIn) {
 
     if (!readCurMsgSize) {
@@ -530,7 +591,7 @@ bool PDBCommunicator::skipTheRead() {
     size_t cur = 0;
 
     int retries = 0;
-    while (cur < (long) msgSize) {
+    while (cur < msgSize) {
 
         ssize_t numBytes = read(socketFD, memory.get(), std::min<size_t>(msgSize - cur, 1024 * 1024));
         this->logToMe->trace("PDBCommunicator: received bytes: " + std::to_string(numBytes));
@@ -588,6 +649,20 @@ bool PDBCommunicator::isSocketClosed() {
     return socketClosed;
 }
 
+bool PDBCommunicator::isIdle() {
+
+    // a closed socket or a message we started reading can not be used for the next request
+    if (socketClosed || socketFD < 0 || readCurMsgSize) {
+        return false;
+    }
+
+    // peek without blocking, if the other side closed the socket we get 0 bytes and if it sent us something we get
+    // the data, in both cases the connection can not be used
+    char c;
+    ssize_t res = recv(socketFD, &c, 1, MSG_PEEK | MSG_DONTWAIT);
+    return res < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+}
+
 bool PDBCommunicator::reconnect(std::string& errMsg) {
 
     if (needToSendDisconnectMsg == true) {
@@ -0,0 +1,154 @@
+/*****************************************************************************
+ *                                                                           *
+ *  Copyright 2018 Rice University                                           *
+ *                                                                           *
+ *  Licensed under the Apache License, Version 2.0 (the "License");          *
+ *  you may not use this file except in compliance with the License.         *
+ *  You may obtain a copy of the License at                                  *
+ *                                                                           *
+ *      http://www.apache.org/licenses/LICENSE-2.0                           *
+ *                                                                           *
+ *  Unless required by applicable law or agreed to in writing, software      *
+ *  distributed under the License is distributed on an "AS IS" BASIS,        *
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. *
+ *  See the License for the specific language governing permissions and      *
+ *  limitations under the License.                                           *
+ *                                                                           *
+ *****************************************************************************/
+
+#include <algorithm>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include "PDBConnectionPool.h"
+
+namespace pdb {
+
+PDBConnectionPool::PDBConnectionPool(size_t maxIdle, std::chrono::milliseconds keepAlive) : maxIdle(maxIdle),
+                                                                                           keepAlive(keepAlive) {}
+
+PDBConnectionPool &PDBConnectionPool::getDefault() {
+  static PDBConnectionPool pool;
+  return pool;
+}
+
+PDBCommunicatorPtr PDBConnectionPool::borrow(const PDBLoggerPtr &logger,
+                                             int port,
+                                             const std::string &address,
+                                             bool &reused,
+                                             std::string &errMsg) {
+
+  {
+    // lock the pool
+    std::unique_lock<std::mutex> lck(m);
+
+    // close the connections nobody used for a while
+    closeExpired(std::chrono::steady_clock::now());
+
+    // take the idle connection we used last, the ones the server closed in the meantime are dropped
+    auto it = idle.find(std::make_pair(address, port));
+    while (it != idle.end() && !it->second.empty()) {
+
+      auto communicator = std::move(it->second.back().communicator);
+      it->second.pop_back();
+
+      if (communicator->isIdle()) {
+        numReuses++;
+        reused = true;
+        return communicator;
+      }
+    }
+
+    numConnects++;
+  }
+
+  // there is none so we connect, this can take a while so we don't hold the lock
+  reused = false;
+  auto communicator = std::make_shared<PDBCommunicator>();
+  if (!communicator->connectToInternetServer(logger, port, address, errMsg)) {
+    return nullptr;
+  }
+
+  // the connection is kept open, so let the kernel find out if the server is gone, and since a request is written in
+  // a few small pieces we don't want them to wait for each other
+  int on = 1;
+  setsockopt(communicator->getSocketFD(), SOL_SOCKET, SO_KEEPALIVE, &on, sizeof(on));
+  setsockopt(communicator->getSocketFD(), IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+
+  return communicator;
+}
+
+void PDBConnectionPool::giveBack(int port, const std::string &address, const PDBCommunicatorPtr &communicator) {
+
+  // lock the pool
+  std::unique_lock<std::mutex> lck(m);
+
+  // if we have enough connections to the server or the connection is broken it is closed once the last copy is gone
+  auto &connections = idle[std::make_pair(address, port)];
+  if (connections.size() >= maxIdle || communicator->isSocketClosed()) {
+    return;
+  }
+
+  // keep it
+  connections.push_back(IdleConnection{communicator, std::chrono::steady_clock::now()});
+}
+
+void PDBConnectionPool::setMaxIdle(size_t maxIdleIn) {
+
+  // lock the pool
+  std::unique_lock<std::mutex> lck(m);
+
+  // set the limit and close the connections above it
+  maxIdle = maxIdleIn;
+  for (auto &connections : idle) {
+    if (connections.second.size() > maxIdle) {
+      connections.second.erase(connections.second.begin(), connections.second.end() - maxIdle);
+    }
+  }
+}
+
+void PDBConnectionPool::setKeepAlive(std::chrono::milliseconds keepAliveIn) {
+
+  // lock the pool
+  std::unique_lock<std::mutex> lck(m);
+
+  // set it
+  keepAlive = keepAliveIn;
+}
+
+void PDBConnectionPool::clear() {
+
+  // lock the pool
+  std::unique_lock<std::mutex> lck(m);
+
+  // close them all
+  idle.clear();
+}
+
+uint64_t PDBConnectionPool::getNumConnects() {
+  std::unique_lock<std::mutex> lck(m);
+  return numConnects;
+}
+
+uint64_t PDBConnectionPool::getNumReuses() {
+  std::unique_lock<std::mutex> lck(m);
+  return numReuses;
+}
+
+void PDBConnectionPool::closeExpired(std::chrono::steady_clock::time_point now) {
+
+  for (auto it = idle.begin(); it != idle.end();) {
+
+    // the oldest connections are at the front
+    auto &connections = it->second;
+    auto firstAlive = std::find_if(connections.begin(), connections.end(), [&](const IdleConnection &connection) {
+      return now - connection.since < keepAlive;
+    });
+    connections.erase(connections.begin(), firstAlive);
+
+    // forget the servers we have no connections to
+    it = connections.empty() ? idle.erase(it) : std::next(it);
+  }
+}
+
+}
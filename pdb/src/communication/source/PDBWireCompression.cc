@@ -0,0 +1,190 @@
+/*****************************************************************************
+ *                                                                           *
+ *  Copyright 2018 Rice University                                           *
+ *                                                                           *
+ *  Licensed under the Apache License, Version 2.0 (the "License");          *
+ *  you may not use this file except in compliance with the License.         *
+ *  You may obtain a copy of the License at                                  *
+ *                                                                           *
+ *      http://www.apache.org/licenses/LICENSE-2.0                           *
+ *                                                                           *
+ *  Unless required by applicable law or agreed to in writing, software      *
+ *  distributed under the License is distributed on an "AS IS" BASIS,        *
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. *
+ *  See the License for the specific language governing permissions and      *
+ *  limitations under the License.                                           *
+ *                                                                           *
+ *****************************************************************************/
+
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include "PDBWireCompression.h"
+
+namespace pdb {
+
+namespace {
+
+// the counters of the process
+std::atomic<uint64_t> numCompressed{0};
+std::atomic<uint64_t> numBypassed{0};
+std::atomic<uint64_t> numBytesIn{0};
+std::atomic<uint64_t> numBytesOut{0};
+std::atomic<uint64_t> compressNanos{0};
+std::atomic<uint64_t> decompressNanos{0};
+
+uint64_t nanosSince(std::chrono::steady_clock::time_point begin) {
+  return (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count();
+}
+
+}
+
+PDBWireCompression::PDBWireCompression(PDBPageCompression codec, double minSavings)
+    : codec(PDBBufferManagerCompression::getSupported(codec)), minSavings(minSavings) {}
+
+PDBWireCompressionPtr PDBWireCompression::make(const std::string &codec, double minSavings) {
+
+  PDBPageCompression compression;
+  if (!PDBBufferManagerCompression::fromString(codec, compression)) {
+    throw std::runtime_error("Unknown codec for the pages sent over the wire : " + codec);
+  }
+
+  return std::make_shared<PDBWireCompression>(compression, minSavings);
+}
+
+size_t PDBWireCompression::getMaxFrameSize(size_t numBytes) const {
+  return sizeof(Header) + std::max(numBytes, PDBBufferManagerCompression::getMaxCompressedSize(codec, numBytes));
+}
+
+size_t PDBWireCompression::compress(const char *in, size_t inSize, char *out, size_t outSize) {
+
+  // if we don't compress or we are skipping the pages that don't compress well send the page as it is
+  if (codec == PDB_PAGE_COMPRESSION_NONE || skipPage()) {
+    numBypassed.fetch_add(1, std::memory_order_relaxed);
+    return copy(in, inSize, out, outSize);
+  }
+
+  // check if the page could fit
+  if (outSize < sizeof(Header)) {
+    return 0;
+  }
+
+  // compress it
+  auto begin = std::chrono::steady_clock::now();
+  auto compressedSize = PDBBufferManagerCompression::compress(codec, in, inSize, out + sizeof(Header), outSize - sizeof(Header));
+  compressNanos.fetch_add(nanosSince(begin), std::memory_order_relaxed);
+
+  // if it did not save enough skip the next pages
+  if (compressedSize == 0 || (double) compressedSize > (1.0 - minSavings) * (double) inSize) {
+    if (minSavings > 0) {
+      numToSkip = PDB_WIRE_COMPRESSION_SKIP_PAGES;
+    }
+
+    // if it would grow we send it as it is
+    if (compressedSize == 0 || compressedSize >= inSize) {
+      numBypassed.fetch_add(1, std::memory_order_relaxed);
+      return copy(in, inSize, out, outSize);
+    }
+  }
+
+  // write the header
+  auto header = (Header *) out;
+  header->codec = codec;
+  header->reserved = 0;
+  header->numBytes = inSize;
+
+  numCompressed.fetch_add(1, std::memory_order_relaxed);
+  numBytesIn.fetch_add(inSize, std::memory_order_relaxed);
+  numBytesOut.fetch_add(compressedSize, std::memory_order_relaxed);
+
+  return sizeof(Header) + compressedSize;
+}
+
+bool PDBWireCompression::getUncompressedSize(const char *in, size_t inSize, size_t &numBytes) {
+
+  // check if it is a frame
+  if (inSize < sizeof(Header)) {
+    return false;
+  }
+
+  numBytes = ((Header *) in)->numBytes;
+  return true;
+}
+
+bool PDBWireCompression::decompress(const char *in, size_t inSize, char *out, size_t outSize) {
+
+  // check if it is a frame and if the page fits
+  size_t numBytes;
+  if (!getUncompressedSize(in, inSize, numBytes) || numBytes > outSize) {
+    return false;
+  }
+
+  // the pages that were sent as they are are just copied
+  auto codec = (PDBPageCompression) ((Header *) in)->codec;
+  if (codec == PDB_PAGE_COMPRESSION_NONE) {
+    if (inSize - sizeof(Header) != numBytes) {
+      return false;
+    }
+    memcpy(out, in + sizeof(Header), numBytes);
+    return true;
+  }
+
+  // decompress the rest
+  auto begin = std::chrono::steady_clock::now();
+  bool success = PDBBufferManagerCompression::decompress(codec, in + sizeof(Header), inSize - sizeof(Header), out, outSize);
+  decompressNanos.fetch_add(nanosSince(begin), std::memory_order_relaxed);
+
+  return success;
+}
+
+PDBPageCompression PDBWireCompression::getCodec() const {
+  return codec;
+}
+
+PDBWireCompressionStats PDBWireCompression::getStats() {
+
+  PDBWireCompressionStats stats;
+  stats.numCompressed = numCompressed;
+  stats.numBypassed = numBypassed;
+  stats.numBytesIn = numBytesIn;
+  stats.numBytesOut = numBytesOut;
+  stats.compressNanos = compressNanos;
+  stats.decompressNanos = decompressNanos;
+
+  return stats;
+}
+
+bool PDBWireCompression::skipPage() {
+
+  // take one of the pages we skip if there are any left
+  auto skipped = numToSkip.load();
+  while (skipped > 0) {
+    if (numToSkip.compare_exchange_weak(skipped, skipped - 1)) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+size_t PDBWireCompression::copy(const char *in, size_t inSize, char *out, size_t outSize) {
+
+  // check if the page fits
+  if (outSize < sizeof(Header) + inSize) {
+    return 0;
+  }
+
+  // write the header and the page
+  auto header = (Header *) out;
+  header->codec = PDB_PAGE_COMPRESSION_NONE;
+  header->reserved = 0;
+  header->numBytes = inSize;
+  memcpy(out + sizeof(Header), in, inSize);
+
+  numBytesIn.fetch_add(inSize, std::memory_order_relaxed);
+  numBytesOut.fetch_add(inSize, std::memory_order_relaxed);
+
+  return sizeof(Header) + inSize;
+}
+
+}
@@ -7,6 +7,7 @@
 
 #include <string>
 #include <memory>
+#include <vector>
 
 namespace pdb {
 
@@ -53,13 +54,112 @@ struct NodeConfig {
    */
   size_t pageSize = 0;
 
+  /**
+   * The eviction policy of the buffer manager, either "lru" or the scan resistant "2q"
+   */
+  std::string evictionPolicy = "lru";
+
+  /**
+   * The engine the buffer manager uses for disk I/O, either "sync", "threads" or "io_uring"
+   */
+  std::string ioEngine = "sync";
+
+  /**
+   * The number of threads of the "threads" I/O engine, also used if io_uring is not available
+   */
+  uint32_t ioThreads = 4;
+
+  /**
+   * The directories the buffer manager stripes the files of the sets and the temporary file over, usually one on each
+   * drive. If there are none everything goes to the data directory in the root directory
+   */
+  std::vector<std::string> storageDirectories;
+
+  /**
+   * Whether the buffer manager reads and writes the pages with O_DIRECT so they are not cached by the kernel
+   */
+  bool directIO = false;
+
+  /**
+   * The codec the anonymous pages are compressed with when they are spilled to disk, "none", "snappy", "lz4" or "zstd"
+   */
+  std::string tempFileCompression = "none";
+
+  /**
+   * The codec the pages this node sends over the wire are compressed with, "none", "snappy", "lz4" or "zstd"
+   */
+  std::string wireCompression = "snappy";
+
+  /**
+   * The fraction of a page the compression has to save, if a page of a set saves less the next pages of the set are
+   * sent as they are for a while, zero always compresses
+   */
+  double wireCompressionMinSavings = 0.1;
+
+  /**
+   * Whether the buffer manager checks the checksums of the pages it reads from disk
+   */
+  bool verifyChecksums = true;
+
+  /**
+   * Whether we back the buffer pool of the buffer manager with huge pages
+   */
+  bool hugePages = false;
+
+  /**
+   * Whether we spread the worker threads over the NUMA nodes and pin them there
+   */
+  bool pinWorkers = false;
+
+  /**
+   * The buffer manager starts writing unpinned dirty pages in the background when the fraction of the buffer pool it
+   * can reuse without writing drops below this, zero disables the background writes
+   */
+  double flushLowWatermark = 0.1;
+
+  /**
+   * The background writes stop once this fraction of the buffer pool can be reused without writing
+   */
+  double flushHighWatermark = 0.2;
+
+  /**
+   * The fraction of the buffer pool a job can use before its pages are evicted before the pages of the other jobs
+   */
+  double jobSoftBudget = 0.5;
+
+  /**
+   * The fraction of the buffer pool a job can use before it has to recycle its own pages to get more memory
+   */
+  double jobHardBudget = 1.0;
+
   /**
    * Number of threads the execution engine is going to use
    */
   int32_t numThreads = 0;
 
   /**
-   * The maximum number of connections the server has
+   * The number of pages per thread we read ahead when scanning a set, the pages stay pinned until they are used, 0 disables it
+   */
+  uint32_t readAheadPages = 0;
+
+  /**
+   * The number of threads that wait for the requests on the open connections of the server
+   */
+  uint32_t networkThreads = 2;
+
+  /**
+   * The number of pages a node lets another node send it before it has to wait for the node to grant it more, the node
+   * never grants more than it has free pages in its buffer pool
+   */
+  uint32_t pageFeedWindow = 8;
+
+  /**
+   * The number of threads that send the pages for the same node over the same connection
+   */
+  uint32_t pageFeedSenders = 2;
+
+  /**
+   * The number of workers of the server, every request that is being handled takes one, the open connections don't
    */
   int32_t maxConnections = 0;
 
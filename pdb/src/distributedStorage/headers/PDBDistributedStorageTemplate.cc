@@ -13,6 +13,7 @@
 #include <DisClearSet.h>
 #include <DisRemoveSet.h>
 #include <GenericWork.h>
+#include <PDBWireCompression.h>
 
 template<class Communicator, class Requests>
 std::pair<pdb::PDBPageHandle, size_t> pdb::PDBDistributedStorage::requestPage(const PDBCatalogNodePtr &node,
@@ -179,12 +180,9 @@ std::pair<bool, std::string> pdb::PDBDistributedStorage::handleGetNextPage(const
       // create an allocation block to hold the response
       pdb::Handle<pdb::StoGetNextPageResult> response = pdb::makeObject<pdb::StoGetNextPageResult>(currPage, (*it)->nodeID, pageInfo.second, true);
 
-      // sends result to requester
+      // sends result to requester together with the bytes
       string error;
-      sendUsingMe->sendObject(response, error);
-
-      // now, send the bytes
-      if (!sendUsingMe->sendBytes(pageInfo.first->getBytes(), pageInfo.second, error)) {
+      if (!sendUsingMe->sendObjectAndBytes(response, pageInfo.first->getBytes(), pageInfo.second, error)) {
 
         this->logger->error(error);
         this->logger->error("sending page bytes: not able to send data to client.\n");
@@ -342,7 +340,7 @@ std::pair<bool, std::string> pdb::PDBDistributedStorage::handleAddData(const pdb
 
   // check the uncompressed size
   size_t uncompressedSize = 0;
-  snappy::GetUncompressedLength((char *) page->getBytes(), numBytes, &uncompressedSize);
+  PDBWireCompression::getUncompressedSize((char *) page->getBytes(), numBytes, uncompressedSize);
 
   // check the uncompressed size
   if (bufferManager->getMaxPageSize() < uncompressedSize) {
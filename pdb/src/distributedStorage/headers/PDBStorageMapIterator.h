@@ -217,13 +217,14 @@ class PDBStorageMapIterator<T, typename std::enable_if<hasGetKey<T>::value and h
 
     // get the uncompressed size
     size_t uncompressedSize = 0;
-    snappy::GetUncompressedLength(compressedBuffer.get(), compressedBufferSize, &uncompressedSize);
+    PDBWireCompression::getUncompressedSize(compressedBuffer.get(), compressedBufferSize, uncompressedSize);
 
     // allocate some memory if we need it
     if (bufferSize < uncompressedSize) {
 
       // allocate the memory
       buffer = std::unique_ptr<char[]>(new char[uncompressedSize]);
+      bufferSize = uncompressedSize;
 
       // check if we failed to allocate
       if (buffer == nullptr) {
@@ -232,7 +233,9 @@ class PDBStorageMapIterator<T, typename std::enable_if<hasGetKey<T>::value and h
     }
 
     // uncompress and copy to buffer
-    snappy::RawUncompress((char *) compressedBuffer.get(), compressedBufferSize, (char *) buffer.get());
+    if (!PDBWireCompression::decompress(compressedBuffer.get(), compressedBufferSize, buffer.get(), bufferSize)) {
+      throw std::runtime_error("Could not decompress the page");
+    }
 
     // grab the current map
     currMap = ((Record<Map<Key, Value>> *) (buffer.get()))->getRootObject();
@@ -5,7 +5,7 @@
 #include <HeapRequest.h>
 #include <StoGetNextPageRequest.h>
 #include <StoGetNextPageResult.h>
-#include <snappy.h>
+#include <PDBWireCompression.h>
 
 namespace pdb {
 
@@ -163,13 +163,14 @@ bool PDBStorageVectorIterator<T>::getNextPage(bool isFirst) {
 
   // get the uncompressed size
   size_t uncompressedSize = 0;
-  snappy::GetUncompressedLength(compressedBuffer.get(), compressedBufferSize, &uncompressedSize);
+  PDBWireCompression::getUncompressedSize(compressedBuffer.get(), compressedBufferSize, uncompressedSize);
 
   // allocate some memory if we need it
   if (bufferSize < uncompressedSize) {
 
     // allocate the memory
     buffer = std::unique_ptr<char[]>(new char[uncompressedSize]);
+    bufferSize = uncompressedSize;
 
     // check if we failed to allocate
     if (buffer == nullptr) {
@@ -178,7 +179,9 @@ bool PDBStorageVectorIterator<T>::getNextPage(bool isFirst) {
   }
 
   // uncompress and copy to buffer
-  snappy::RawUncompress((char *) compressedBuffer.get(), compressedBufferSize, (char *) buffer.get());
+  if (!PDBWireCompression::decompress(compressedBuffer.get(), compressedBufferSize, buffer.get(), bufferSize)) {
+    throw std::runtime_error("Could not decompress the page");
+  }
 
   // we succeeded
   return true;
@@ -17,7 +17,7 @@
  *****************************************************************************/
 
 #include "PDBDistributedStorage.h"
-#include <snappy.h>
+#include <PDBWireCompression.h>
 #include <HeapRequestHandler.h>
 #include <DisAddData.h>
 #include <DisClearSet.h>
@@ -6,6 +6,7 @@
 #include <HeapRequestHandler.h>
 #include <ExRunJob.h>
 #include <PDBStorageManagerBackend.h>
+#include <PDBBufferManagerInterface.h>
 #include <SharedEmployee.h>
 #include <boost/filesystem/path.hpp>
 #include "ExecutionServerFrontend.h"
@@ -144,7 +145,18 @@ void pdb::ExecutionServerFrontend::registerHandlers(pdb::PDBServer &forMe) {
                 return false;
               });
 
-            /// 8. Send the response back the computation
+            /// 8. Report how much memory the job used
+
+            auto stats = getFunctionality<PDBBufferManagerInterface>().getJobStats(request->computationID);
+            logger->info("Computation " + std::to_string(request->computationID) + " job " + std::to_string(request->jobID) +
+                         " uses " + std::to_string(stats.numBytes) + " bytes of the buffer pool, at most " +
+                         std::to_string(stats.peakBytes) + " bytes, " + std::to_string(stats.numEvicted) + " of its pages were evicted, " +
+                         std::to_string(stats.numEvictedOverBudget) + " of them since it was over its soft budget of " +
+                         std::to_string(stats.softLimit) + " bytes, and it recycled its own memory " +
+                         std::to_string(stats.numRecycled) + " times since it was over its hard budget of " +
+                         std::to_string(stats.hardLimit) + " bytes.");
+
+            /// 9. Send the response back the computation
 
             // create the response
             response = pdb::makeObject<pdb::SimpleRequestResult>(success, error);
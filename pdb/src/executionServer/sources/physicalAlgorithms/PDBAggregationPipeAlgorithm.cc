@@ -43,6 +43,9 @@ bool pdb::PDBAggregationPipeAlgorithm::setup(std::shared_ptr<pdb::PDBStorageMana
     return false;
   }
 
+  // the pages wait here until they are sent to the other nodes, they can go to disk before anything else we need
+  intermediatePageSet->setAccessHint(PDB_PAGE_HINT_TEMP_SPILL);
+
   /// 2. Init the preaggregation queues
 
   pageQueues = std::make_shared<std::vector<PDBPageQueuePtr>>();
@@ -141,6 +144,9 @@ bool pdb::PDBAggregationPipeAlgorithm::setup(std::shared_ptr<pdb::PDBStorageMana
     return false;
   }
 
+  // the hash maps of the aggregation are updated over and over so we keep them in memory as long as we can
+  sinkPageSet->setAccessHint(PDB_PAGE_HINT_HOT_REUSE);
+
   /// 6. Create the page set that contains the preaggregated pages for this node
 
   // get the receive page set
@@ -153,6 +159,9 @@ bool pdb::PDBAggregationPipeAlgorithm::setup(std::shared_ptr<pdb::PDBStorageMana
     return false;
   }
 
+  // the preaggregated pages are read once by the aggregation
+  recvPageSet->setAccessHint(PDB_PAGE_HINT_SEQUENTIAL_ONCE);
+
   /// 7. Create the self receiver to forward pages that are created on this node and the network senders to forward pages for the other nodes
 
   senders = std::make_shared<std::vector<PDBPageNetworkSenderPtr>>();
@@ -174,7 +183,8 @@ bool pdb::PDBAggregationPipeAlgorithm::setup(std::shared_ptr<pdb::PDBStorageMana
                                                            storage->getConfiguration()->maxRetries,
                                                            logger,
                                                            std::make_pair(hashedToRecv->pageSetIdentifier.first, hashedToRecv->pageSetIdentifier.second),
-                                                           pageQueues->at(i));
+                                                           pageQueues->at(i),
+                                                           storage->getConfiguration()->pageFeedSenders);
 
       // setup the sender, if we fail return false
       if(!sender->setup()) {
@@ -297,7 +307,8 @@ bool pdb::PDBAggregationPipeAlgorithm::run(std::shared_ptr<pdb::PDBStorageManage
 
   // create the buzzer
   atomic_int sendersDone;
-  sendersDone = senders->size();
+  sendersDone = 0;
+  auto numSenderThreads = std::max<uint32_t>(storage->getConfiguration()->pageFeedSenders, 1);
   PDBBuzzerPtr sendersBuzzer = make_shared<PDBBuzzer>([&](PDBAlarm myAlarm, atomic_int &cnt) {
 
     // did we fail?
@@ -309,27 +320,29 @@ bool pdb::PDBAggregationPipeAlgorithm::run(std::shared_ptr<pdb::PDBStorageManage
     cnt++;
   });
 
-  // go through each sender and run them
+  // go through each sender and run it on as many threads as we want to use for it
   for(auto &sender : *senders) {
+    for(uint32_t j = 0; j < numSenderThreads; ++j) {
 
-    // make the work
-    PDBWorkPtr myWork = std::make_shared<pdb::GenericWork>([&sendersDone, sender, this](const PDBBuzzerPtr& callerBuzzer) {
+      // make the work
+      PDBWorkPtr myWork = std::make_shared<pdb::GenericWork>([&sendersDone, sender, this](const PDBBuzzerPtr& callerBuzzer) {
 
-      // run the sender
-      if(sender->run()) {
+        // run the sender
+        if(sender->run()) {
 
-        // signal that the run was successful
-        callerBuzzer->buzz(PDBAlarm::WorkAllDone, sendersDone);
-      }
-      else {
+          // signal that the run was successful
+          callerBuzzer->buzz(PDBAlarm::WorkAllDone, sendersDone);
+        }
+        else {
 
-        // signal that the run was unsuccessful
-        callerBuzzer->buzz(PDBAlarm::GenericError, sendersDone);
-      }
-    });
+          // signal that the run was unsuccessful
+          callerBuzzer->buzz(PDBAlarm::GenericError, sendersDone);
+        }
+      });
 
-    // run the work
-    storage->getWorker()->execute(myWork, sendersBuzzer);
+      // run the work
+      storage->getWorker()->execute(myWork, sendersBuzzer);
+    }
   }
 
   /// 4. Run the preaggregation, this step comes before the aggregation step
@@ -395,7 +408,7 @@ bool pdb::PDBAggregationPipeAlgorithm::run(std::shared_ptr<pdb::PDBStorageManage
   }
 
   // wait while we are running the senders
-  while(sendersDone < senders->size()) {
+  while(sendersDone < senders->size() * numSenderThreads) {
     sendersBuzzer->wait();
   }
 
@@ -48,6 +48,9 @@ bool pdb::PDBBroadcastForJoinAlgorithm::setup(std::shared_ptr<pdb::PDBStorageMan
     return false;
   }
 
+  // the pages wait here until they are sent to the other nodes, they can go to disk before anything else we need
+  intermediatePageSet->setAccessHint(PDB_PAGE_HINT_TEMP_SPILL);
+
   /// 1. Init the prebroadcastjoin queues
 
   pageQueues = std::make_shared<std::vector<PDBPageQueuePtr>>();
@@ -143,6 +146,9 @@ bool pdb::PDBBroadcastForJoinAlgorithm::setup(std::shared_ptr<pdb::PDBStorageMan
   // set it to concurrent since each thread needs to use the same pages
   sinkPageSet->setAccessOrder(PDBAnonymousPageSetAccessPattern::CONCURRENT);
 
+  // this is the hash table every thread probes for every tuple, so we keep it in memory as long as we can
+  sinkPageSet->setAccessHint(PDB_PAGE_HINT_HOT_REUSE);
+
   /// 4. Create the page set that contains the prebroadcastjoin pages for this node
 
   // get the receive page set
@@ -156,6 +162,9 @@ bool pdb::PDBBroadcastForJoinAlgorithm::setup(std::shared_ptr<pdb::PDBStorageMan
     return false;
   }
 
+  // the broadcasted pages are read once while we build the hash table
+  recvPageSet->setAccessHint(PDB_PAGE_HINT_SEQUENTIAL_ONCE);
+
   /// 5. Create the self receiver to forward pages that are created on this node and the network senders to forward pages for the other nodes
 
   senders = std::make_shared<std::vector<PDBPageNetworkSenderPtr>>();
@@ -177,7 +186,8 @@ bool pdb::PDBBroadcastForJoinAlgorithm::setup(std::shared_ptr<pdb::PDBStorageMan
                                                            logger,
                                                            std::make_pair(hashedToRecv->pageSetIdentifier.first,
                                                                           hashedToRecv->pageSetIdentifier.second),
-                                                           pageQueues->at(i));
+                                                           pageQueues->at(i),
+                                                           storage->getConfiguration()->pageFeedSenders);
 
       // setup the sender, if we fail return false
       if (!sender->setup()) {
@@ -303,7 +313,8 @@ bool pdb::PDBBroadcastForJoinAlgorithm::run(std::shared_ptr<pdb::PDBStorageManag
 
   // create the buzzer
   atomic_int sendersDone;
-  sendersDone = senders->size();
+  sendersDone = 0;
+  auto numSenderThreads = std::max<uint32_t>(storage->getConfiguration()->pageFeedSenders, 1);
   PDBBuzzerPtr sendersBuzzer = make_shared<PDBBuzzer>([&](PDBAlarm myAlarm, atomic_int &cnt) {
 
     // did we fail?
@@ -315,26 +326,28 @@ bool pdb::PDBBroadcastForJoinAlgorithm::run(std::shared_ptr<pdb::PDBStorageManag
     cnt++;
   });
 
-  // go through each sender and run them
+  // go through each sender and run it on as many threads as we want to use for it
   for (auto &sender : *senders) {
+    for(uint32_t j = 0; j < numSenderThreads; ++j) {
 
-    // make the work
-    PDBWorkPtr myWork = std::make_shared<pdb::GenericWork>([&sendersDone, sender, this](const PDBBuzzerPtr& callerBuzzer) {
+      // make the work
+      PDBWorkPtr myWork = std::make_shared<pdb::GenericWork>([&sendersDone, sender, this](const PDBBuzzerPtr& callerBuzzer) {
 
-      // run the sender
-      if (sender->run()) {
+        // run the sender
+        if (sender->run()) {
 
-        // signal that the run was successful
-        callerBuzzer->buzz(PDBAlarm::WorkAllDone, sendersDone);
-      } else {
+          // signal that the run was successful
+          callerBuzzer->buzz(PDBAlarm::WorkAllDone, sendersDone);
+        } else {
 
-        // signal that the run was unsuccessful
-        callerBuzzer->buzz(PDBAlarm::GenericError, sendersDone);
-      }
-    });
+          // signal that the run was unsuccessful
+          callerBuzzer->buzz(PDBAlarm::GenericError, sendersDone);
+        }
+      });
 
-    // run the work
-    storage->getWorker()->execute(myWork, sendersBuzzer);
+      // run the work
+      storage->getWorker()->execute(myWork, sendersBuzzer);
+    }
   }
 
   /// 4. Run the prebroadcastjoin, this step comes before the broadcastjoin (merge) step
@@ -400,7 +413,7 @@ bool pdb::PDBBroadcastForJoinAlgorithm::run(std::shared_ptr<pdb::PDBStorageManag
   }
 
   // wait while we are running the senders
-  while (sendersDone < senders->size()) {
+  while (sendersDone < senders->size() * numSenderThreads) {
     sendersBuzzer->wait();
   }
 
@@ -66,6 +66,9 @@ PDBAbstractPageSetPtr PDBPhysicalAlgorithm::getSourcePageSet(std::shared_ptr<pdb
     // we are reading from an existing page set get it
     sourcePageSet = storage->getPageSet(this->sources[idx].pageSet->pageSetIdentifier);
     sourcePageSet->resetPageSet();
+
+    // the pipeline reads each page once
+    sourcePageSet->setAccessHint(PDB_PAGE_HINT_SEQUENTIAL_ONCE);
   }
 
   // return the page set
@@ -102,6 +105,9 @@ std::shared_ptr<JoinArguments> PDBPhysicalAlgorithm::getJoinArguments(std::share
       return nullptr;
     }
 
+    // these are the hash tables we probe for every tuple, so we keep them in memory as long as we can
+    additionalSource->setAccessHint(PDB_PAGE_HINT_HOT_REUSE);
+
     // insert the join argument
     joinArguments->hashTables[sourceIdentifier.pageSetIdentifier.second] = std::make_shared<JoinArg>(additionalSource);
   }
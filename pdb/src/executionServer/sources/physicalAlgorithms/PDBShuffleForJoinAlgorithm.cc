@@ -47,6 +47,9 @@ bool pdb::PDBShuffleForJoinAlgorithm::setup(std::shared_ptr<pdb::PDBStorageManag
     return false;
   }
 
+  // the pages wait here until they are sent to the other nodes, they can go to disk before anything else we need
+  intermediatePageSet->setAccessHint(PDB_PAGE_HINT_TEMP_SPILL);
+
   /// 1. Init the shuffle queues
 
   pageQueues = std::make_shared<std::vector<PDBPageQueuePtr>>();
@@ -67,6 +70,9 @@ bool pdb::PDBShuffleForJoinAlgorithm::setup(std::shared_ptr<pdb::PDBStorageManag
     return false;
   }
 
+  // the shuffled pages are kept until the join reads them, they can go to disk in the meantime
+  recvPageSet->setAccessHint(PDB_PAGE_HINT_TEMP_SPILL);
+
   /// 3. Create the self receiver to forward pages that are created on this node and the network senders to forward pages for the other nodes
 
   auto myMgr = storage->getFunctionalityPtr<PDBBufferManagerInterface>();
@@ -90,7 +96,8 @@ bool pdb::PDBShuffleForJoinAlgorithm::setup(std::shared_ptr<pdb::PDBStorageManag
                                                            storage->getConfiguration()->maxRetries,
                                                            logger,
                                                            std::make_pair(sink->pageSetIdentifier.first, sink->pageSetIdentifier.second),
-                                                           pageQueues->at(i));
+                                                           pageQueues->at(i),
+                                                           storage->getConfiguration()->pageFeedSenders);
 
       // setup the sender, if we fail return false
       if(!sender->setup()) {
@@ -237,6 +244,7 @@ bool pdb::PDBShuffleForJoinAlgorithm::run(std::shared_ptr<pdb::PDBStorageManager
   // create the buzzer
   atomic_int sendersDone;
   sendersDone = 0;
+  auto numSenderThreads = std::max<uint32_t>(storage->getConfiguration()->pageFeedSenders, 1);
   PDBBuzzerPtr sendersBuzzer = make_shared<PDBBuzzer>([&](PDBAlarm myAlarm, atomic_int &cnt) {
 
     // did we fail?
@@ -248,27 +256,29 @@ bool pdb::PDBShuffleForJoinAlgorithm::run(std::shared_ptr<pdb::PDBStorageManager
     cnt++;
   });
 
-  // go through each sender and run them
+  // go through each sender and run it on as many threads as we want to use for it
   for(auto &sender : *senders) {
+    for(uint32_t j = 0; j < numSenderThreads; ++j) {
 
-    // make the work
-    PDBWorkPtr myWork = std::make_shared<pdb::GenericWork>([&sendersDone, sender, this](PDBBuzzerPtr callerBuzzer) {
+      // make the work
+      PDBWorkPtr myWork = std::make_shared<pdb::GenericWork>([&sendersDone, sender, this](PDBBuzzerPtr callerBuzzer) {
 
-      // run the sender
-      if(sender->run()) {
+        // run the sender
+        if(sender->run()) {
 
-        // signal that the run was successful
-        callerBuzzer->buzz(PDBAlarm::WorkAllDone, sendersDone);
-      }
-      else {
+          // signal that the run was successful
+          callerBuzzer->buzz(PDBAlarm::WorkAllDone, sendersDone);
+        }
+        else {
 
-        // signal that the run was unsuccessful
-        callerBuzzer->buzz(PDBAlarm::GenericError, sendersDone);
-      }
-    });
+          // signal that the run was unsuccessful
+          callerBuzzer->buzz(PDBAlarm::GenericError, sendersDone);
+        }
+      });
 
-    // run the work
-    storage->getWorker()->execute(myWork, sendersBuzzer);
+      // run the work
+      storage->getWorker()->execute(myWork, sendersBuzzer);
+    }
   }
 
   /// 3. Run the join pipelines
@@ -332,7 +342,7 @@ bool pdb::PDBShuffleForJoinAlgorithm::run(std::shared_ptr<pdb::PDBStorageManager
   }
 
   // wait while we are running the senders
-  while(sendersDone < senders->size()) {
+  while(sendersDone < senders->size() * numSenderThreads) {
     sendersBuzzer->wait();
   }
 
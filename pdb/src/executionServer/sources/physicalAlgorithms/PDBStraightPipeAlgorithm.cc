@@ -39,6 +39,9 @@ bool pdb::PDBStraightPipeAlgorithm::setup(std::shared_ptr<pdb::PDBStorageManager
     return false;
   }
 
+  // the output is written once and read back when it is materialized or used by the next stage
+  sinkPageSet->setAccessHint(PDB_PAGE_HINT_TEMP_SPILL);
+
   /// 1. Initialize the sources
 
   // we put them here
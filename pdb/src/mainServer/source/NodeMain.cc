@@ -27,6 +27,7 @@
 #include <PDBDistributedStorage.h>
 #include "CatalogServer.h"
 #include <PDBBufferManagerFrontEnd.h>
+#include <PDBBufferManagerCompression.h>
 #include <PDBStorageManagerFrontend.h>
 #include <PDBComputationServerFrontend.h>
 #include <ExecutionServerFrontend.h>
@@ -104,7 +105,26 @@ int main(int argc, char *argv[]) {
   desc.add_options()("managerPort,o", po::value<int32_t>(&config->managerPort)->default_value(8108), "Port of the manager");
   desc.add_options()("sharedMemSize,s", po::value<size_t>(&config->sharedMemSize)->default_value(2048), "The size of the shared memory (MB)");
   desc.add_options()("pageSize,e", po::value<size_t>(&config->pageSize)->default_value(1024 * 1024 * 128), "The size of a page (bytes)");
+  desc.add_options()("evictionPolicy", po::value<std::string>(&config->evictionPolicy)->default_value("lru"), "The eviction policy of the buffer manager (lru or 2q)");
+  desc.add_options()("ioEngine", po::value<std::string>(&config->ioEngine)->default_value("sync"), "The I/O engine of the buffer manager (sync, threads or io_uring)");
+  desc.add_options()("ioThreads", po::value<uint32_t>(&config->ioThreads)->default_value(4), "The number of threads the threads I/O engine uses");
+  desc.add_options()("storageDirectories", po::value<std::vector<std::string>>(&config->storageDirectories)->multitoken(), "The directories the set files and the temporary file are striped over, one per drive (defaults to the data directory)");
+  desc.add_options()("directIO", po::bool_switch(&config->directIO), "Whether the buffer manager bypasses the page cache of the kernel with O_DIRECT");
+  desc.add_options()("tempFileCompression", po::value<std::string>(&config->tempFileCompression)->default_value("none"), "The codec the spilled anonymous pages are compressed with: none, snappy, lz4 or zstd");
+  desc.add_options()("wireCompression", po::value<std::string>(&config->wireCompression)->default_value("snappy"), "The codec the pages sent over the wire are compressed with: none, snappy, lz4 or zstd");
+  desc.add_options()("wireCompressionMinSavings", po::value<double>(&config->wireCompressionMinSavings)->default_value(0.1), "The fraction of a page the wire compression has to save to keep compressing the pages of its set (0 always compresses)");
+  desc.add_options()("verifyChecksums", po::value<bool>(&config->verifyChecksums)->default_value(true), "Whether the buffer manager checks the CRC32C checksums of the pages it reads from disk");
+  desc.add_options()("hugePages", po::bool_switch(&config->hugePages), "Whether the buffer pool is backed by huge pages, falls back to transparent huge pages if none are reserved");
+  desc.add_options()("pinWorkers", po::bool_switch(&config->pinWorkers), "Whether the worker threads are spread over the NUMA nodes and pinned to them");
+  desc.add_options()("flushLowWatermark", po::value<double>(&config->flushLowWatermark)->default_value(0.1), "The fraction of the buffer pool reusable without writing below which dirty pages are written in the background (0 to disable)");
+  desc.add_options()("flushHighWatermark", po::value<double>(&config->flushHighWatermark)->default_value(0.2), "The fraction of the buffer pool reusable without writing at which the background writes stop");
+  desc.add_options()("jobSoftBudget", po::value<double>(&config->jobSoftBudget)->default_value(0.5), "The fraction of the buffer pool a job can use before its pages are evicted first");
+  desc.add_options()("jobHardBudget", po::value<double>(&config->jobHardBudget)->default_value(1.0), "The fraction of the buffer pool a job can use before it has to recycle its own pages");
   desc.add_options()("numThreads,t", po::value<int32_t>(&config->numThreads)->default_value(2), "The number of threads we want to use");
+  desc.add_options()("networkThreads", po::value<uint32_t>(&config->networkThreads)->default_value(2), "The number of threads that wait for the requests on the open connections");
+  desc.add_options()("pageFeedWindow", po::value<uint32_t>(&config->pageFeedWindow)->default_value(8), "The number of pages another node can send before this node grants it more");
+  desc.add_options()("pageFeedSenders", po::value<uint32_t>(&config->pageFeedSenders)->default_value(2), "The number of threads that send the pages for the same node");
+  desc.add_options()("readAheadPages", po::value<uint32_t>(&config->readAheadPages)->default_value(0), "The number of pages per thread we read ahead when scanning a set (0 to disable)");
   desc.add_options()("rootDirectory,r", po::value<std::string>(&config->rootDirectory)->default_value("./pdbRoot"), "The root directory we want to use.");
   desc.add_options()("maxRetries", po::value<uint32_t>(&config->maxRetries)->default_value(5), "The maximum number of retries before we give up.");
 
@@ -119,6 +139,17 @@ int main(int argc, char *argv[]) {
     return 0;
   }
 
+  // check the codec of the wire here, otherwise we only find out it is wrong when the first page is sent
+  pdb::PDBPageCompression wireCompression;
+  if (!pdb::PDBBufferManagerCompression::fromString(config->wireCompression, wireCompression)) {
+    std::cerr << "Unknown codec for the wire compression: " << config->wireCompression << '\n';
+    return 1;
+  }
+  if (config->wireCompressionMinSavings < 0 || config->wireCompressionMinSavings >= 1) {
+    std::cerr << "The wireCompressionMinSavings have to be at least 0 and less than 1\n";
+    return 1;
+  }
+
   // create the root directory
   fs::path rootPath(config->rootDirectory);
   if(!fs::exists(rootPath) && !fs::create_directories(rootPath)) {
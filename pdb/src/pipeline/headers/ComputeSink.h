@@ -22,6 +22,7 @@
 #include <PDBPageHandle.h>
 #include "Object.h"
 #include "TupleSet.h"
+#include "PDBBufferManagerMemoryPressure.h"
 
 namespace pdb {
 
@@ -44,6 +45,10 @@ public:
 	// this writes out the whole page to this sink
   	virtual void writeOutPage(pdb::PDBPageHandle &page, Handle<Object> &writeToMe) = 0;
 
+	// this tells the pipeline whether to hand over the current output container once the memory pressure goes up to
+	// the given level, so it can be processed and its page unpinned instead of growing until we run out of memory
+	virtual bool flushOnMemoryPressure (PDBMemoryPressure level) { return false; }
+
 	virtual ~ComputeSink () = default;
 
 };
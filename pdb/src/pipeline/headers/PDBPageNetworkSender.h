@@ -6,6 +6,8 @@
 #define PDB_PAGESENDER_H
 
 #include <memory>
+#include <mutex>
+#include <condition_variable>
 #include <PageProcessor.h>
 #include <PDBCommunicator.h>
 
@@ -16,12 +18,18 @@ using PDBPageNetworkSenderPtr = std::shared_ptr<PDBPageNetworkSender>;
 
 /**
  * This class sends pages over the wire. It gets pages from the provided queue and sends them over the wire.
+ *
+ * The receiving node grants us credits, one for each page we can send, as it makes room for them in its buffer pool. So
+ * that we don't wait for a round trip after every page it lets us have a window of pages in flight. Multiple threads can
+ * call run at the same time, they share the connection and the credits, whoever runs out of credits first reads the next
+ * grant while the others wait for it.
  */
 class PDBPageNetworkSender {
 public:
 
   PDBPageNetworkSender(string address, int32_t port, uint64_t numberOfProcessingThreads, uint64_t numberOfNodes,
-                       uint64_t maxRetries, PDBLoggerPtr logger, std::pair<uint64_t, std::string> pageSetID, pdb::PDBPageQueuePtr queue);
+                       uint64_t maxRetries, PDBLoggerPtr logger, std::pair<uint64_t, std::string> pageSetID, pdb::PDBPageQueuePtr queue,
+                       uint64_t numSenderThreads = 1);
 
   /**
    * Connects to the node with the parameters provided in the constructor and gets the ACK that the other side has set everything up.
@@ -30,13 +38,35 @@ public:
   bool setup();
 
   /**
-   * Starts grabbing pages from the queue and sending them over the wire until we get a null ptr from the queue
+   * Starts grabbing pages from the queue and sending them over the wire until we get a null ptr from the queue. It has
+   * to be called by as many threads as we were told in the constructor, the last one to finish tells the other node that
+   * we are done and waits until it got everything.
    * @return true if everything works just fine false otherwise
    */
   bool run();
 
 private:
 
+  /**
+   * Takes a credit to send a page, if there are none left it waits for the other node to grant more
+   * @return - true if we got the credit, false if we failed to get one
+   */
+  bool takeCredit();
+
+  /**
+   * Reads the next credits the other node granted us
+   * @param error - the error if any
+   * @return - the number of credits, zero if we failed
+   */
+  uint64_t readCredits(std::string &error);
+
+  /**
+   * Tells the other node that there are no more pages and waits until it confirms it got all of them
+   * @param error - the error if any
+   * @return - true if it did, false otherwise
+   */
+  bool finish(std::string &error);
+
   /**
    * The error if any
    */
@@ -86,6 +116,30 @@ private:
    * The communicator to the node
    */
   PDBCommunicatorPtr comm;
+
+  /**
+   * The number of threads that call run and how many of them are done
+   */
+  uint64_t numSenderThreads;
+  uint64_t numFinished = 0;
+
+  /**
+   * The number of pages we can still send, whether a thread is reading the next grant and whether somebody failed
+   */
+  uint64_t credits = 0;
+  bool isReadingCredits = false;
+  bool failed = false;
+
+  /**
+   * Protects the credits, the threads wait on the condition variable for the next grant
+   */
+  std::mutex creditsMutex;
+  std::condition_variable creditsCV;
+
+  /**
+   * Only one thread can write to the connection at a time
+   */
+  std::mutex sendMutex;
 };
 
 }
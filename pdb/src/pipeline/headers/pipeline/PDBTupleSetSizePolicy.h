@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <PDBBufferManagerMemoryPressure.h>
 
 namespace pdb {
 
@@ -29,6 +30,13 @@ public:
    */
   void writeToPageSucceeded(uint64_t additionalPages, uint64_t initialFree, uint64_t finalFree);
 
+  /**
+   * This is supposed to be called with the memory pressure of the buffer manager before we process a chunk.
+   * Every time it goes up we halve the chunk size, and we don't grow it while there is any pressure.
+   * @param level - the current level of the memory pressure
+   */
+  void memoryPressure(PDBMemoryPressure level);
+
   /**
    * This will tell us if the input was processed or not. It will be used by the source to know if it should use the
    * the same input again
@@ -112,6 +120,9 @@ protected:
   // finish without using additional pages since we need to redo expensive steps otherwise.
   bool tryToMakePipelineSucceed = true;
 
+  // the last memory pressure we were told about
+  PDBMemoryPressure pressure = PDB_MEMORY_PRESSURE_NONE;
+
   // the size of the page
   uint64_t pageSize;
 };
@@ -66,6 +66,12 @@ class JoinSink : public ComputeSink {
     return returnVal;
   }
 
+  bool flushOnMemoryPressure(PDBMemoryPressure level) override {
+
+    // the join maps are sent off as soon as the page is processed, so we can start with new ones
+    return level >= PDB_MEMORY_PRESSURE_HIGH;
+  }
+
   void writeOut(TupleSetPtr input, Handle<Object> &writeToMe) override {
 
     // get the map we are adding to
@@ -57,6 +57,12 @@ class PreaggregationSink : public ComputeSink {
     return returnVal;
   }
 
+  bool flushOnMemoryPressure(PDBMemoryPressure level) override {
+
+    // the maps are sent off as soon as the page is processed, so we can start with new ones
+    return level >= PDB_MEMORY_PRESSURE_HIGH;
+  }
+
   void writeOut(TupleSetPtr input, Handle<Object> &writeToMe) override {
 
     // cast the thing to the map of maps
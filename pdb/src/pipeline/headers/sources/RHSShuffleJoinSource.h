@@ -85,14 +85,18 @@ class RHSShuffleJoinSource : public RHSShuffleJoinSourceBase {
     // add the hash column
     output->addColumn(keyAtt, &hashColumn, false);
 
+    // grab all the pages and pin them at once
+    std::vector<PDBPageHandle> allPages;
     PDBPageHandle page;
     while ((page = pageSet->getNextPage(workerID)) != nullptr) {
+      allPages.emplace_back(page);
+    }
+    PDBPageHandleBase::repinAll(allPages);
 
-      // pin the page
-      page->repin();
+    for (auto &pinned : allPages) {
 
       // we grab the vector of hash maps
-      Handle<Vector<Handle<JoinMap<RHS>>>> returnVal = ((Record<Vector<Handle<JoinMap<RHS>>>> *) (page->getBytes()))->getRootObject();
+      Handle<Vector<Handle<JoinMap<RHS>>>> returnVal = ((Record<Vector<Handle<JoinMap<RHS>>>> *) (pinned->getBytes()))->getRootObject();
 
       // next we grab the join map we need
       maps.push_back((*returnVal)[workerID]);
@@ -105,14 +109,14 @@ class RHSShuffleJoinSource : public RHSShuffleJoinSourceBase {
         pageIterators.push(it);
 
         // push the page
-        pages.push_back(page);
+        pages.push_back(pinned);
       }
     }
   }
 
   ~RHSShuffleJoinSource() override {
     // unpin the pages
-    for_each (pages.begin(), pages.end(), [&](PDBPageHandle &page) { page->unpin(); });
+    PDBPageHandleBase::unpinAll(pages);
 
     // delete the columns
     delete[] columns;
@@ -12,13 +12,16 @@
 #include <UseTemporaryAllocationBlock.h>
 #include <SimpleRequestResult.h>
 #include <StoFeedPageRequest.h>
+#include <StoFeedPageCredits.h>
 
 #include "PDBPageNetworkSender.h"
 
 pdb::PDBPageNetworkSender::PDBPageNetworkSender(string address, int32_t port, uint64_t numberOfProcessingThreads, uint64_t numberOfNodes,
-                                                uint64_t maxRetries, PDBLoggerPtr logger, std::pair<uint64_t, std::string> pageSetID, pdb::PDBPageQueuePtr queue)
+                                                uint64_t maxRetries, PDBLoggerPtr logger, std::pair<uint64_t, std::string> pageSetID, pdb::PDBPageQueuePtr queue,
+                                                uint64_t numSenderThreads)
     : address(std::move(address)), port(port), queue(std::move(queue)), numberOfProcessingThreads(numberOfProcessingThreads),
-      numberOfNodes(numberOfNodes), logger(std::move(logger)), pageSetID(std::move(pageSetID)), maxRetries(maxRetries) {}
+      numberOfNodes(numberOfNodes), logger(std::move(logger)), pageSetID(std::move(pageSetID)), maxRetries(maxRetries),
+      numSenderThreads(std::max<uint64_t>(numSenderThreads, 1)) {}
 
 bool pdb::PDBPageNetworkSender::setup() {
 
@@ -41,6 +44,9 @@ bool pdb::PDBPageNetworkSender::setup() {
     return false;
   }
 
+  // the pages are large, so let the kernel send them straight from the buffer pool if it can
+  comm->enableZeroCopy();
+
   {
     // create an allocation block to hold the response
     const UseTemporaryAllocationBlock tempBlock{1024};
@@ -63,58 +69,173 @@ bool pdb::PDBPageNetworkSender::setup() {
   // want this to be destroyed
   bool success;
   Handle<pdb::SimpleRequestResult> result = comm->getNextObject<pdb::SimpleRequestResult> (success, errMsg);
-  if (success && result != nullptr) {
-
-    // we are done here
-    return result->getRes().first;
+  if (!success || result == nullptr || !result->getRes().first) {
+    return false;
   }
 
-  return false;
+  // the other node grants us the first credits right away
+  credits = readCredits(errMsg);
+  return credits != 0;
 }
 
 bool pdb::PDBPageNetworkSender::run() {
 
-  // create an allocation block to hold the response
+  // create an allocation block to hold the request, every thread makes its own
   const UseTemporaryAllocationBlock tempBlock{1024};
 
   // make the request
   Handle<pdb::StoFeedPageRequest> request = makeObject<pdb::StoFeedPageRequest>();
 
   // send the pages
+  std::string error;
+  bool success = true;
   PDBPageHandle page;
-  do {
+  while (success) {
 
     // get a page
     queue->wait_dequeue(page);
 
-    // if we got a page from the queue
-    if(page != nullptr) {
+    // the null ptr means that there are no more pages, we leave it in the queue for the other threads
+    if(page == nullptr) {
+      queue->enqueue(nullptr);
+      break;
+    }
 
-      // signal that we have another page
-      request->hasNextPage = true;
-      request->pageSize = page->getSize();
+    // wait until the other node lets us send it
+    success = takeCredit();
+    if(!success) {
+      break;
+    }
+
+    // signal that we have another page
+    request->hasNextPage = true;
+    request->pageSize = page->getSize();
 
-      // send the object
-      if (!comm->sendObject(request, errMsg)) {
-        return false;
-      }
+    // repin the page
+    page->repin();
 
-      // repin the page
-      page->repin();
+    // ret the record
+    auto curRec = (Record<Object> *) page->getBytes();
 
-      // ret the record
-      auto curRec = (Record<Object> *) page->getBytes();
+    // get how large it was
+    auto numBytes = curRec->numBytes();
 
-      // get how large it was
-      auto numBytes = curRec->numBytes();
+    // send the object and the page together
+    std::unique_lock<std::mutex> lock(sendMutex);
+    success = comm->sendObjectAndBytes(request, page->getBytes(), numBytes, error);
+  }
 
-      // send the page
-      comm->sendBytes(page->getBytes(), numBytes, errMsg);
+  // check if we are the last thread to finish
+  {
+    std::unique_lock<std::mutex> lock(creditsMutex);
+
+    // if we failed the threads waiting for credits should stop
+    if(!success) {
+      logger->error(error);
+      failed = true;
+      creditsCV.notify_all();
     }
 
-  } while (page != nullptr);
+    // if we are not the last we are done
+    if(++numFinished < numSenderThreads || failed) {
+      return !failed;
+    }
+  }
 
   // signal that we are done
-  request->hasNextPage = false;
-  return comm->sendObject(request, errMsg);
+  success = finish(error);
+  if(!success) {
+    logger->error(error);
+  }
+
+  return success;
+}
+
+bool pdb::PDBPageNetworkSender::takeCredit() {
+
+  std::unique_lock<std::mutex> lock(creditsMutex);
+  while(credits == 0) {
+
+    // if somebody failed we are done
+    if(failed) {
+      return false;
+    }
+
+    // if somebody else is reading the next grant wait for it
+    if(isReadingCredits) {
+      creditsCV.wait(lock);
+      continue;
+    }
+
+    // read the next grant, the other threads can still send while we wait for it
+    isReadingCredits = true;
+    lock.unlock();
+    std::string error;
+    auto granted = readCredits(error);
+    lock.lock();
+    isReadingCredits = false;
+
+    // zero credits means that we failed to get them
+    if(granted == 0) {
+      logger->error(error);
+      failed = true;
+    }
+
+    // let the others know
+    credits += granted;
+    creditsCV.notify_all();
+  }
+
+  // take the credit
+  credits--;
+  return true;
+}
+
+uint64_t pdb::PDBPageNetworkSender::readCredits(std::string &error) {
+
+  // make sure we got the credits
+  if(comm->getObjectTypeID() != StoFeedPageCredits_TYPEID) {
+    error = "Expected the credits to send the pages to " + address + ":" + std::to_string(port);
+    return 0;
+  }
+
+  // read them into our own memory, the threads don't share an allocation block
+  bool success;
+  std::unique_ptr<char[]> memory(new char[comm->getSizeOfNextObject()]);
+  auto grant = comm->getNextObject<pdb::StoFeedPageCredits>(memory.get(), success, error);
+
+  return success ? grant->credits : 0;
+}
+
+bool pdb::PDBPageNetworkSender::finish(std::string &error) {
+
+  {
+    // create an allocation block to hold the request
+    const UseTemporaryAllocationBlock tempBlock{1024};
+
+    // signal that we are done
+    Handle<pdb::StoFeedPageRequest> request = makeObject<pdb::StoFeedPageRequest>(0, false);
+    if(!comm->sendObject(request, error)) {
+      return false;
+    }
+  }
+
+  // skip the credits the other node granted us in the meantime, if we closed the connection with them unread the other
+  // node could lose the end of the stream
+  while(comm->getObjectTypeID() == StoFeedPageCredits_TYPEID) {
+    if(readCredits(error) == 0) {
+      return false;
+    }
+  }
+
+  // wait for the other node to confirm that it got all the pages
+  if(comm->getObjectTypeID() != SimpleRequestResult_TYPEID) {
+    error = "Expected the confirmation that " + address + ":" + std::to_string(port) + " got all the pages";
+    return false;
+  }
+  bool success;
+  std::unique_ptr<char[]> memory(new char[comm->getSizeOfNextObject()]);
+  auto result = comm->getNextObject<pdb::SimpleRequestResult>(memory.get(), success, error);
+
+  return success && result->getRes().first;
 }
@@ -53,7 +53,7 @@ void PDBTupleSetSizePolicy::writeToPageSucceeded(uint64_t additionalPages, uint6
 
   // if the pipeline succeeded and write succeeded without any additional pages then we
   // can possibly increase the chunk size
-  if(allowIncrements && pipeline.succeeded && pipeline.numAdditionalPages == 0 && additionalPages == 0) {
+  if(allowIncrements && pressure == PDB_MEMORY_PRESSURE_NONE && pipeline.succeeded && pipeline.numAdditionalPages == 0 && additionalPages == 0) {
 
     // so the rule is if we only used less than 20% of the page in total
     // increase chunk size 3 times because we expect the usage to go up to 60%
@@ -107,6 +107,17 @@ void PDBTupleSetSizePolicy::writeToPageSucceeded(uint64_t additionalPages, uint6
   lastIncremented = false;
 }
 
+void PDBTupleSetSizePolicy::memoryPressure(PDBMemoryPressure level) {
+
+  // halve the chunk size for every level the pressure went up, smaller chunks need less intermediate memory
+  for(auto i = pressure; i < level && chunkSize != 1; i = (PDBMemoryPressure) (i + 1)) {
+    chunkSize /= 2;
+  }
+
+  // remember the level, the increments are blocked until it goes back to none
+  pressure = level;
+}
+
 bool PDBTupleSetSizePolicy::inputWasProcessed() const {
 
   // if the pipeline succeeded we are fine, since not writing to the
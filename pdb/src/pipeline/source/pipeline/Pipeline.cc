@@ -138,6 +138,12 @@ void pdb::Pipeline::run() {
   uint64_t finalFree = 0;
   uint64_t additionalPagesUsed = 0;
 
+  // the memory pressure we last flushed the output container at, we only flush again if it goes higher
+  PDBMemoryPressure flushedAt = PDB_MEMORY_PRESSURE_NONE;
+
+  // tell the policy how much memory is left before we grab the first chunk
+  tupleSetSizePolicy.memoryPressure(outputPageSet->getMemoryPressure());
+
   // while there is still data
   while ((curChunk = dataSource->getNextTupleSet(tupleSetSizePolicy)) != nullptr) {
 
@@ -246,6 +252,20 @@ REAPPLY:
 // we jump here to do some cleanup and repeat with a smaller chunk size
 CLEAN_ITERATION:
 
+    // if the memory pressure went up and the sink wants it, hand over the output container so it is processed and
+    // its page unpinned
+    auto pressure = outputPageSet->getMemoryPressure();
+    if (pressure > flushedAt && ram->outputSink != nullptr && dataSink->flushOnMemoryPressure(pressure)) {
+      addPageToIteration(ram, iteration);
+      ram = std::make_shared<MemoryHolder>(outputPageSet->getNewPage());
+      flushedAt = pressure;
+    } else if (pressure < flushedAt) {
+      flushedAt = pressure;
+    }
+
+    // the next chunk is sized for the memory we have left
+    tupleSetSizePolicy.memoryPressure(pressure);
+
     // lastly, write back all of the output pages
     iteration++;
     cleanPages(iteration);
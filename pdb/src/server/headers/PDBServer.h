@@ -38,6 +38,7 @@ typedef std::shared_ptr<PDBServer> PDBServerPtr;
 #include "PDBLogger.h"
 #include "PDBWork.h"
 #include "PDBCommunicator.h"
+#include "PDBServerReactor.h"
 #include "NodeConfig.h"
 #include <string>
 #include <map>
@@ -45,10 +46,10 @@ typedef std::shared_ptr<PDBServer> PDBServerPtr;
 
 // This class encapsulates a multi-threaded sever in PDB.  The way it works is that one simply
 // registers
-// an event handler (encapsulated inside of a PDBWorkPtr); whenever there is a new connection that
-// comes
-// over the given port (or file in the case of a local socket) a PWBWorker is asked to handle the
-// connection using the appropriate port using a cloned version of the specified PDBWork object.
+// an event handler (encapsulated inside of a PDBWorkPtr); whenever a request comes over one of the
+// connections on the given port (or file in the case of a local socket) a PWBWorker is asked to handle the
+// request using a cloned version of the specified PDBWork object.  In between the requests the open
+// connections are watched by the PDBServerReactor, so they don't keep a worker busy.
 //
 
 namespace pdb {
@@ -112,11 +113,14 @@ public:
 
   // asks us to handle one request that is coming over the given PDBCommunicator; return true if
   // this
-  // is not the last request over this PDBCommunicator object; buzzMeWhenDone is sent to the
-  // worker that
-  // is spawned to handle the request
+  // is not the last request over this PDBCommunicator object; buzzMeWhenDone is given to the
+  // handler, which runs on the worker that calls this
   bool handleOneRequest(PDBBuzzerPtr buzzMeWhenDone, PDBCommunicatorPtr myCommunicator);
 
+  // called once a request that came over the given PDBCommunicator was handled; if keepConnection is
+  // true we wait for the next request on it, otherwise it is closed
+  void doneWithRequest(const PDBCommunicatorPtr &myCommunicator, bool keepConnection);
+
   void stop();  // added by Jia
 
   /**
@@ -157,6 +161,9 @@ private:
   // handles a request using the given PDBCommunicator to obtain the data
   void handleRequest(const PDBCommunicatorPtr &myCommunicator);
 
+  // waits for the requests on the open connections
+  PDBServerReactorPtr reactor;
+
   // true if we started accepting requests
   std::atomic_bool startedAcceptingRequests;
 
@@ -0,0 +1,158 @@
+/*****************************************************************************
+ *                                                                           *
+ *  Copyright 2018 Rice University                                           *
+ *                                                                           *
+ *  Licensed under the Apache License, Version 2.0 (the "License");          *
+ *  you may not use this file except in compliance with the License.         *
+ *  You may obtain a copy of the License at                                  *
+ *                                                                           *
+ *      http://www.apache.org/licenses/LICENSE-2.0                           *
+ *                                                                           *
+ *  Unless required by applicable law or agreed to in writing, software      *
+ *  distributed under the License is distributed on an "AS IS" BASIS,        *
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. *
+ *  See the License for the specific language governing permissions and      *
+ *  limitations under the License.                                           *
+ *                                                                           *
+ *****************************************************************************/
+
+#ifndef PDB_SERVER_REACTOR_H
+#define PDB_SERVER_REACTOR_H
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "PDBCommunicator.h"
+#include "PDBLogger.h"
+
+namespace pdb {
+
+class PDBServerReactor;
+typedef std::shared_ptr<PDBServerReactor> PDBServerReactorPtr;
+
+/**
+ * Waits for the requests on all the open connections of a server with a few threads, so that a connection nobody
+ * is sending anything over does not keep a worker busy. Each thread has its own epoll instance, the connections are
+ * spread over them round robin.
+ *
+ * A connection is watched until something arrives over it, then it is handed to the request handler and not
+ * watched anymore until the handler gives it back with rearm or closes it with remove. That way only one thread
+ * at a time reads from a connection. If the other side closed the connection without sending anything we close it
+ * right away, no handler is needed for that.
+ */
+class PDBServerReactor {
+
+ public:
+
+  /**
+   * Starts the threads
+   * @param numThreads - the number of threads that wait for the requests
+   * @param onRequest - called by one of the threads once a request arrives over a connection, it should hand the
+   *                    connection to a worker and must not block for long since the other connections of the thread
+   *                    wait in the meantime
+   * @param logger - the logger
+   */
+  PDBServerReactor(size_t numThreads, std::function<void(const PDBCommunicatorPtr &)> onRequest, PDBLoggerPtr logger);
+
+  /**
+   * Stops the threads and closes all the connections
+   */
+  ~PDBServerReactor();
+
+  /**
+   * Starts watching a connection we just accepted
+   * @param communicator - the connection
+   */
+  void add(const PDBCommunicatorPtr &communicator);
+
+  /**
+   * Watches the connection again once the request that came over it was handled
+   * @param communicator - the connection
+   */
+  void rearm(const PDBCommunicatorPtr &communicator);
+
+  /**
+   * Stops watching the connection and closes it
+   * @param communicator - the connection
+   */
+  void remove(const PDBCommunicatorPtr &communicator);
+
+  /**
+   * Returns the number of connections we have, whether we are watching them or a request is being handled
+   */
+  size_t getNumConnections();
+
+ private:
+
+  /**
+   * A thread and the epoll instance it waits on
+   */
+  struct Poller {
+
+    // the epoll instance
+    int epollFD = -1;
+
+    // written to wake up the thread when we stop
+    int wakeFD = -1;
+
+    // the thread
+    std::thread thread;
+  };
+
+  /**
+   * A connection and the poller it belongs to
+   */
+  struct Connection {
+    PDBCommunicatorPtr communicator;
+    Poller *poller;
+  };
+
+  /**
+   * Waits for the requests on the connections of the poller and hands them to the handler
+   * @param poller - the poller
+   */
+  void run(Poller &poller);
+
+  /**
+   * Returns the connection of the communicator, null if we don't have it
+   */
+  Connection *find(PDBCommunicator *communicator);
+
+  /**
+   * The pollers, one per thread
+   */
+  std::vector<std::unique_ptr<Poller>> pollers;
+
+  /**
+   * The poller the next connection goes to
+   */
+  std::atomic<size_t> nextPoller{0};
+
+  /**
+   * The connections we have by their communicator
+   */
+  std::unordered_map<PDBCommunicator *, Connection> connections;
+
+  /**
+   * Protects the connections
+   */
+  std::mutex m;
+
+  /**
+   * Called once a request arrives over a connection
+   */
+  std::function<void(const PDBCommunicatorPtr &)> onRequest;
+
+  /**
+   * The logger
+   */
+  PDBLoggerPtr logger;
+};
+
+}
+
+#endif //PDB_SERVER_REACTOR_H
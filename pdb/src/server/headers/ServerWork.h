@@ -36,7 +36,7 @@ namespace pdb {
 class ServerWork;
 typedef shared_ptr<ServerWork> ServerWorkPtr;
 
-// does all of the work associated with one connection to the server
+// does all of the work associated with one request that came over a connection to the server
 
 class ServerWork : public PDBCommWork {
 public:
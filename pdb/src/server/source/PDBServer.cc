@@ -57,7 +57,12 @@ PDBServer::PDBServer(NodeType type, const NodeConfigPtr &config, const PDBLogger
   sigaction(SIGPIPE, &sa, nullptr);
 
   // init the worker threads of this server
-  workers = make_shared<PDBWorkerQueue>(logger, config->maxConnections);
+  workers = make_shared<PDBWorkerQueue>(logger, config->maxConnections, config->pinWorkers);
+
+  // init the threads that wait for the requests, once one arrives a worker handles it
+  reactor = make_shared<PDBServerReactor>(config->networkThreads, [this](const PDBCommunicatorPtr &myCommunicator) {
+    handleRequest(myCommunicator);
+  }, logger);
 }
 
 void PDBServer::registerHandler(int16_t requestID, const PDBCommWorkPtr &handledBy) {
@@ -141,7 +146,7 @@ void PDBServer::listen() {
       PDB_COUT << "||||||||||||||||||||||||||||||||||" << std::endl;
       PDB_COUT << "accepted the connection with sockFD=" << myCommunicator->getSocketFD()
                << std::endl;
-      handleRequest(myCommunicator);
+      reactor->add(myCommunicator);
     }
 
   } else if (nodeType == NodeType::BACKEND) {
@@ -206,7 +211,7 @@ void PDBServer::listen() {
       PDB_COUT << "||||||||||||||||||||||||||||||||||" << std::endl;
       PDB_COUT << "accepted the connection with sockFD=" << myCommunicator->getSocketFD()
                << std::endl;
-      handleRequest(myCommunicator);
+      reactor->add(myCommunicator);
     }
   }
   // let the main thread know we are done
@@ -235,6 +240,16 @@ void PDBServer::handleRequest(const PDBCommunicatorPtr &myCommunicator) {
   tempWorker->execute(tempWork, tempWork->getLinkedBuzzer());
 }
 
+void PDBServer::doneWithRequest(const PDBCommunicatorPtr &myCommunicator, bool keepConnection) {
+
+  // wait for the next request or close the connection
+  if (keepConnection) {
+    reactor->rearm(myCommunicator);
+  } else {
+    reactor->remove(myCommunicator);
+  }
+}
+
 // returns true while we need to keep going... false when this connection is done
 bool PDBServer::handleOneRequest(PDBBuzzerPtr callerBuzzer, PDBCommunicatorPtr myCommunicator) {
 
@@ -306,20 +321,15 @@ bool PDBServer::handleOneRequest(PDBBuzzerPtr callerBuzzer, PDBCommunicatorPtr m
     // in this case, got a handler
   } else {
 
-    // End code replacement for testing
-
-    // Chris' old code: (Observed problem: sometimes, buzzer never get buzzed.)
-    // get a worker to run the handler (this blocks if no workers available)
-    PDBWorkerPtr tempWorker = workers->getWorker();
-    logger->trace("PDBServer: got a worker, start to do something...");
+    // run the handler right here, we are already on a worker so there is no need to take another one
+    // and wait for it
     logger->trace("PDBServer: requestID " + std::to_string(requestID));
 
     PDBCommWorkPtr tempWork = handlers[requestID]->clone();
 
     logger->trace("PDBServer: setting guts");
     tempWork->setGuts(myCommunicator, this);
-    tempWorker->execute(tempWork, callerBuzzer);
-    callerBuzzer->wait();
+    tempWork->execute(workers.get(), callerBuzzer);
     logger->trace("PDBServer: handler has completed its work");
     return true;
   }
@@ -0,0 +1,201 @@
+/*****************************************************************************
+ *                                                                           *
+ *  Copyright 2018 Rice University                                           *
+ *                                                                           *
+ *  Licensed under the Apache License, Version 2.0 (the "License");          *
+ *  you may not use this file except in compliance with the License.         *
+ *  You may obtain a copy of the License at                                  *
+ *                                                                           *
+ *      http://www.apache.org/licenses/LICENSE-2.0                           *
+ *                                                                           *
+ *  Unless required by applicable law or agreed to in writing, software      *
+ *  distributed under the License is distributed on an "AS IS" BASIS,        *
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. *
+ *  See the License for the specific language governing permissions and      *
+ *  limitations under the License.                                           *
+ *                                                                           *
+ *****************************************************************************/
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include "PDBServerReactor.h"
+
+namespace pdb {
+
+PDBServerReactor::PDBServerReactor(size_t numThreads,
+                                   std::function<void(const PDBCommunicatorPtr &)> onRequest,
+                                   PDBLoggerPtr logger) : onRequest(std::move(onRequest)), logger(std::move(logger)) {
+
+  // we need at least one thread
+  numThreads = std::max<size_t>(numThreads, 1);
+
+  for (size_t i = 0; i < numThreads; ++i) {
+
+    // make the epoll instance and the file descriptor that wakes up the thread, the latter is the only one without
+    // a connection
+    std::unique_ptr<Poller> poller(new Poller());
+    poller->epollFD = epoll_create1(EPOLL_CLOEXEC);
+    poller->wakeFD = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (poller->epollFD < 0 || poller->wakeFD < 0) {
+      std::cerr << "Could not create the epoll instance of the server : " << strerror(errno) << "\n";
+      exit(1);
+    }
+
+    struct epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.ptr = nullptr;
+    epoll_ctl(poller->epollFD, EPOLL_CTL_ADD, poller->wakeFD, &event);
+
+    // start the thread
+    auto *p = poller.get();
+    poller->thread = std::thread([this, p]() { run(*p); });
+    pollers.emplace_back(std::move(poller));
+  }
+}
+
+PDBServerReactor::~PDBServerReactor() {
+
+  // wake up the threads and wait for them to finish
+  for (auto &poller : pollers) {
+    uint64_t one = 1;
+    if (write(poller->wakeFD, &one, sizeof(one)) != sizeof(one)) {
+      logger->error("PDBServerReactor: could not wake up a thread " + std::string(strerror(errno)));
+    }
+    poller->thread.join();
+  }
+
+  // close the connections and the epoll instances
+  connections.clear();
+  for (auto &poller : pollers) {
+    close(poller->epollFD);
+    close(poller->wakeFD);
+  }
+}
+
+void PDBServerReactor::add(const PDBCommunicatorPtr &communicator) {
+
+  // lock the connections
+  std::unique_lock<std::mutex> lck(m);
+
+  // remember the connection before we watch it, a request might already be there
+  auto *poller = pollers[nextPoller++ % pollers.size()].get();
+  connections[communicator.get()] = Connection{communicator, poller};
+
+  // watch it until the first request arrives
+  struct epoll_event event{};
+  event.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+  event.data.ptr = communicator.get();
+  if (epoll_ctl(poller->epollFD, EPOLL_CTL_ADD, communicator->getSocketFD(), &event) != 0) {
+    logger->error("PDBServerReactor: could not watch the connection " + std::string(strerror(errno)));
+    connections.erase(communicator.get());
+  }
+}
+
+void PDBServerReactor::rearm(const PDBCommunicatorPtr &communicator) {
+
+  // lock the connections
+  std::unique_lock<std::mutex> lck(m);
+
+  // find the connection
+  auto connection = find(communicator.get());
+  if (connection == nullptr) {
+    return;
+  }
+
+  // watch it until the next request arrives, if the handler closed the socket we are done with it
+  struct epoll_event event{};
+  event.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+  event.data.ptr = communicator.get();
+  if (communicator->getSocketFD() < 0 ||
+      epoll_ctl(connection->poller->epollFD, EPOLL_CTL_MOD, communicator->getSocketFD(), &event) != 0) {
+    connections.erase(communicator.get());
+  }
+}
+
+void PDBServerReactor::remove(const PDBCommunicatorPtr &communicator) {
+
+  // lock the connections
+  std::unique_lock<std::mutex> lck(m);
+
+  // find the connection
+  auto connection = find(communicator.get());
+  if (connection == nullptr) {
+    return;
+  }
+
+  // stop watching the socket if it is still open, if it was closed the kernel already forgot about it and the
+  // descriptor might belong to a new connection by now
+  if (communicator->getSocketFD() >= 0) {
+    epoll_ctl(connection->poller->epollFD, EPOLL_CTL_DEL, communicator->getSocketFD(), nullptr);
+  }
+
+  // forget it, the socket is closed once the last copy of the communicator is gone
+  connections.erase(communicator.get());
+}
+
+size_t PDBServerReactor::getNumConnections() {
+  std::unique_lock<std::mutex> lck(m);
+  return connections.size();
+}
+
+void PDBServerReactor::run(Poller &poller) {
+
+  std::vector<struct epoll_event> events(64);
+  while (true) {
+
+    // wait for something to happen
+    int numEvents = epoll_wait(poller.epollFD, events.data(), (int) events.size(), -1);
+    if (numEvents < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      logger->error("PDBServerReactor: could not wait for the connections " + std::string(strerror(errno)));
+      return;
+    }
+
+    for (int i = 0; i < numEvents; ++i) {
+
+      // were we woken up to stop
+      if (events[i].data.ptr == nullptr) {
+        return;
+      }
+
+      // grab the connection
+      PDBCommunicatorPtr communicator;
+      {
+        std::unique_lock<std::mutex> lck(m);
+        auto connection = find((PDBCommunicator *) events[i].data.ptr);
+        if (connection == nullptr) {
+          continue;
+        }
+        communicator = connection->communicator;
+      }
+
+      // figure out if the other side sent a request or just closed the connection, a request that was sent right
+      // before the connection was closed still has to be handled
+      char c;
+      ssize_t res = recv(communicator->getSocketFD(), &c, 1, MSG_PEEK | MSG_DONTWAIT);
+      if (res > 0) {
+        onRequest(communicator);
+      } else if (res < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+        rearm(communicator);
+      } else {
+        logger->trace("PDBServerReactor: the other side closed the connection");
+        remove(communicator);
+      }
+    }
+  }
+}
+
+PDBServerReactor::Connection *PDBServerReactor::find(PDBCommunicator *communicator) {
+  auto it = connections.find(communicator);
+  return it == connections.end() ? nullptr : &it->second;
+}
+
+}
@@ -43,13 +43,11 @@ PDBBuzzerPtr ServerWork::getLinkedBuzzer() {
 
 void ServerWork::execute(PDBBuzzerPtr callerBuzzer) {
 
-    // while there is still something to do on this connection
+    // handle the request that arrived, the connection then goes back to the server to wait for the next one
     getLogger()->trace("ServerWork: about to handle a request");
     PDBBuzzerPtr myBuzzer{getLinkedBuzzer()};
-    while (!wasEnError && server->handleOneRequest(myBuzzer, getCommunicator())) {
-        getLogger()->trace("ServerWork: just handled another request");
-        myBuzzer = getLinkedBuzzer();
-    }
+    bool keepConnection = !wasEnError && server->handleOneRequest(myBuzzer, getCommunicator());
+    server->doneWithRequest(getCommunicator(), keepConnection);
 
     getLogger()->trace("ServerWork: done with this server work");
     callerBuzzer->buzz(PDBAlarm::WorkAllDone);
@@ -15,6 +15,8 @@ using PDBAbstractPageSetPtr = std::shared_ptr<PDBAbstractPageSet>;
 class PDBAbstractPageSet {
 public:
 
+  virtual ~PDBAbstractPageSet() = default;
+
   /**
    * Gets the next page in the page set
    * @param workerID - in the case that the next page is going to depend on the worker we need to specify an id for it
@@ -38,6 +40,42 @@ public:
    * Resets the page set so it can be reused
    */
   virtual void resetPageSet() = 0;
+
+  /**
+   * Sets how the pages of this page set are going to be used, the pages the page set hands out or creates from now on
+   * get this access hint so the buffer manager knows which ones to evict first
+   * @param hint - the hint
+   */
+  void setAccessHint(PDBPageAccessHint hint) {
+    accessHint = hint;
+  }
+
+  /**
+   * Returns the access hint of the pages of this page set
+   * @return - the hint
+   */
+  PDBPageAccessHint getAccessHint() {
+    return accessHint;
+  }
+
+ protected:
+
+  /**
+   * Stamps the access hint of the page set on the page
+   * @param page - the page, can be null
+   * @return - the same page
+   */
+  PDBPageHandle applyAccessHint(const PDBPageHandle &page) {
+    if (page != nullptr) {
+      page->setAccessHint(accessHint);
+    }
+    return page;
+  }
+
+  /**
+   * the access hint of the pages of this page set
+   */
+  std::atomic<PDBPageAccessHint> accessHint{PDB_PAGE_HINT_NORMAL};
 };
 
 }
@@ -33,6 +33,13 @@ public:
 
   explicit PDBAnonymousPageSet(const PDBBufferManagerInterfacePtr &bufferManager);
 
+  /**
+   * Makes a page set whose pages are charged to the job, so the buffer manager can keep it within its budget
+   * @param bufferManager - the buffer manager to get the pages from
+   * @param jobID - the id of the job, this is the id of the computation the page set belongs to
+   */
+  PDBAnonymousPageSet(const PDBBufferManagerInterfacePtr &bufferManager, uint64_t jobID);
+
   /**
    * Returns the next page for are particular worker. This method is supposed to be used after all the pages have been
    * added that need to be added
@@ -59,6 +66,12 @@ public:
    */
   size_t getMaxPageSize();
 
+  /**
+   * Returns the memory pressure of the buffer manager we get the pages from
+   * @return the level
+   */
+  PDBMemoryPressure getMemoryPressure();
+
   /**
    * Remove the page from this page. The page has to be in this page set, otherwise the behavior is not defined
    * @param pageHandle - the page handle we want to remove
@@ -98,6 +111,11 @@ public:
    */
   PDBBufferManagerInterfacePtr bufferManager;
 
+  /**
+   * the job the pages are charged to, -1 if they are not charged to any
+   */
+  int64_t jobID = -1;
+
   /**
    * Tells us what is the next page we are supposed to give a worker
    */
@@ -8,6 +8,9 @@
 #include "PDBAbstractPageSet.h"
 #include <PDBBufferManagerInterface.h>
 #include <vector>
+#include <map>
+#include <thread>
+#include <condition_variable>
 
 namespace pdb {
 
@@ -30,6 +33,25 @@ public:
    */
   PDBSetPageSet(const std::string &db, const std::string &set, vector<uint64_t> &pages, PDBBufferManagerInterfacePtr bufferManager);
 
+  /**
+   * Initializes the page set so that it reads the pages ahead of the workers. Once the first page is requested
+   * a number of background threads will start grabbing the pages that come next so that they are already in memory
+   * by the time a worker asks for them. The pages that are read ahead stay pinned until a worker takes them.
+   * @param db - the name of the database the set belongs to
+   * @param set - the set name
+   * @param pages - the page numbers that are valid for the set
+   * @param bufferManager - the buffer manager
+   * @param readAhead - the maximum number of pages we grab ahead of the workers, 0 disables the read ahead
+   * @param numIOThreads - the number of background threads that grab the pages
+   */
+  PDBSetPageSet(const std::string &db, const std::string &set, vector<uint64_t> &pages, PDBBufferManagerInterfacePtr bufferManager,
+                uint64_t readAhead, uint64_t numIOThreads);
+
+  /**
+   * Stops the read ahead threads if there are any
+   */
+  ~PDBSetPageSet() override;
+
   /**
    * Grabs the next page for this set.
    * @param workerID - the worker id does nothing in this case
@@ -56,6 +78,25 @@ public:
 
  private:
 
+  /**
+   * The state of a page when we read ahead
+   */
+  enum PDBReadAheadState : uint8_t {
+    READ_AHEAD_NOT_REQUESTED,
+    READ_AHEAD_LOADING,
+    READ_AHEAD_LOADED
+  };
+
+  /**
+   * The loop the read ahead threads run, they grab the next page that is not requested and within the read ahead window
+   */
+  void readAheadLoop();
+
+  /**
+   * Starts the read ahead threads if they are not already running
+   */
+  void startReadAhead();
+
   // current page, it is thread safe to update it
   std::atomic<std::uint64_t > curPage;
 
@@ -67,6 +108,36 @@ public:
 
   // the buffer manager to get the pages
   PDBBufferManagerInterfacePtr bufferManager;
+
+  // the maximum number of pages we grab ahead of the workers, 0 if we do not read ahead
+  uint64_t readAhead = 0;
+
+  // the number of threads that read ahead
+  uint64_t numIOThreads = 0;
+
+  // the threads that read ahead
+  std::vector<std::thread> ioThreads;
+
+  // the read ahead state of each page in the pages vector
+  std::vector<PDBReadAheadState> readAheadStates;
+
+  // the pages that were read ahead and are waiting for a worker to take them, the key is the index in the pages vector
+  std::map<uint64_t, PDBPageHandle> readAheadPages;
+
+  // the index of the first page in the pages vector that might not be requested yet
+  uint64_t nextReadAhead = 0;
+
+  // the number of pages that are currently being grabbed by the read ahead threads
+  uint64_t numLoading = 0;
+
+  // set to true when the read ahead threads need to finish
+  bool stopReadAhead = false;
+
+  // locks the read ahead structures
+  std::mutex m;
+
+  // the read ahead threads wait here for the window to move, the workers wait here for the pages to load
+  std::condition_variable cv;
 };
 
 }
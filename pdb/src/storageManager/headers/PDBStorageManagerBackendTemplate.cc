@@ -8,6 +8,7 @@
 #include <PDBBufferManagerBackEnd.h>
 #include <StoFeedPageRequest.h>
 #include <PDBBufferManagerDebugBackEnd.h>
+#include <PDBWireCompression.h>
 
 template <class Communicator>
 std::pair<bool, std::string> pdb::PDBStorageManagerBackend::handleStoreOnPage(const pdb::Handle<pdb::StoStoreOnPageRequest> &request,
@@ -21,30 +22,37 @@ std::pair<bool, std::string> pdb::PDBStorageManagerBackend::handleStoreOnPage(co
   // grab the forwarded page
   auto inPage = bufferManager->expectPage(sendUsingMe);
 
-  // check the uncompressed size
-  size_t uncompressedSize = 0;
-  snappy::GetUncompressedLength((char*) inPage->getBytes(), request->compressedSize, &uncompressedSize);
-
   // grab the page
   auto outPage = bufferManager->getPage(make_shared<pdb::PDBSet>(request->databaseName, request->setName), request->page);
 
-  // uncompress and copy to page
-  snappy::RawUncompress((char*) inPage->getBytes(), request->compressedSize, (char*) outPage->getBytes());
+  // check the uncompressed size, uncompress and copy to page
+  string error;
+  size_t uncompressedSize = 0;
+  bool success = PDBWireCompression::getUncompressedSize((char*) inPage->getBytes(), request->compressedSize, uncompressedSize) &&
+                 PDBWireCompression::decompress((char*) inPage->getBytes(), request->compressedSize, (char*) outPage->getBytes(), outPage->getSize());
+
+  if(success) {
 
-  // freeze the page
-  outPage->freezeSize(uncompressedSize);
+    // freeze the page
+    outPage->freezeSize(uncompressedSize);
+  }
+  else {
+
+    // the frame was bad, clear the page so nothing of it ends up in the set, the frontend returns it to the free list
+    error = "Could not decompress the page";
+    memset(outPage->getBytes(), 0, outPage->getSize());
+  }
 
   /// 2. Send the response that we are done
 
   // create an allocation block to hold the response
-  string error;
-  pdb::Handle<pdb::SimpleRequestResult> simpleResponse = pdb::makeObject<pdb::SimpleRequestResult>(true, error);
+  pdb::Handle<pdb::SimpleRequestResult> simpleResponse = pdb::makeObject<pdb::SimpleRequestResult>(success, error);
 
   // sends result to requester
   sendUsingMe->sendObject(simpleResponse, error);
 
   // finish
-  return make_pair(true, error);
+  return make_pair(success, error);
 }
 
 template<class Communicator>
@@ -22,6 +22,7 @@
 #include <StoRemovePageSetRequest.h>
 #include <StoStartFeedingPageSetRequest.h>
 #include <StoClearSetRequest.h>
+#include <PDBWireCompression.h>
 
 namespace pdb {
 
@@ -258,6 +259,14 @@ public:
    */
   std::shared_ptr<PDBStorageSetStats> getSetStats(const PDBSetPtr &set);
 
+  /**
+   * Returns the compression of the pages of the set we send over the wire. Every set has its own, so a set that does not
+   * compress well does not stop us from compressing the others
+   * @param set - the set
+   * @return - the compression
+   */
+  PDBWireCompressionPtr getWireCompression(const PDBSetPtr &set);
+
   /**
    * The logger
    */
@@ -282,6 +291,12 @@ public:
    * Lock last pages
    */
   std::mutex pageMutex;
+
+  /**
+   * The compression of the pages of each set we send over the wire and the mutex that protects them
+   */
+  map<PDBSetPtr, PDBWireCompressionPtr, PDBSetCompare> wireCompressions;
+  std::mutex wireCompressionMutex;
 };
 
 }
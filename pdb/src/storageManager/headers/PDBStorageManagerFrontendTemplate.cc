@@ -24,6 +24,7 @@
 #include <StoRemovePageSetRequest.h>
 #include <StoMaterializePageResult.h>
 #include <StoFeedPageRequest.h>
+#include <StoFeedPageCredits.h>
 
 template <class T>
 std::pair<bool, std::string> pdb::PDBStorageManagerFrontend::handleGetPageRequest(const pdb::Handle<pdb::StoGetPageRequest> &request,
@@ -67,13 +68,29 @@ std::pair<bool, std::string> pdb::PDBStorageManagerFrontend::handleGetPageReques
   // grab the vector
   auto* pageRecord = (pdb::Record<pdb::Vector<pdb::Handle<pdb::Object>>> *) (page->getBytes());
 
+  // grab the compression of the set
+  auto compression = getWireCompression(set);
+
   // grab an anonymous page to store the compressed stuff //TODO this kind of sucks since the max compressed size can be larger than the actual size
-  auto maxCompressedSize = std::min<size_t>(snappy::MaxCompressedLength(pageRecord->numBytes()), 128 * 1024 * 1024);
+  auto maxCompressedSize = std::min<size_t>(compression->getMaxFrameSize(pageRecord->numBytes()), 128 * 1024 * 1024);
   auto compressedPage = getFunctionalityPtr<PDBBufferManagerInterface>()->getPage(maxCompressedSize);
 
-  // compress the record
-  size_t compressedSize;
-  snappy::RawCompress((char*) pageRecord, pageRecord->numBytes(), (char*)compressedPage->getBytes(), &compressedSize);
+  // compress the record, if it does not compress well it is sent as it is
+  size_t compressedSize = compression->compress((char*) pageRecord, pageRecord->numBytes(), (char*) compressedPage->getBytes(), maxCompressedSize);
+
+  // if it does not fit we can not send it
+  if(compressedSize == 0) {
+
+    // make an allocation block
+    const pdb::UseTemporaryAllocationBlock tempBlock{1024};
+
+    // send back a NACK
+    pdb::Handle<pdb::StoGetPageResult> response = pdb::makeObject<pdb::StoGetPageResult>(0, 0, false);
+    string error = "The compressed page does not fit in a page";
+    sendUsingMe->sendObject(response, error);
+
+    return make_pair(false, error);
+  }
 
   /// 4. Send the compressed page
 
@@ -83,12 +100,9 @@ std::pair<bool, std::string> pdb::PDBStorageManagerFrontend::handleGetPageReques
   // create an allocation block to hold the response
   pdb::Handle<pdb::StoGetPageResult> response = pdb::makeObject<pdb::StoGetPageResult>(compressedSize, pageNum, true);
 
-  // sends result to requester
+  // sends result to requester together with the bytes
   string error;
-  sendUsingMe->sendObject(response, error);
-
-  // now, send the bytes
-  if (!sendUsingMe->sendBytes(compressedPage->getBytes(), compressedSize, error)) {
+  if (!sendUsingMe->sendObjectAndBytes(response, compressedPage->getBytes(), compressedSize, error)) {
 
     this->logger->error(error);
     this->logger->error("sending page bytes: not able to send data to client.\n");
@@ -137,7 +151,7 @@ std::pair<bool, std::string> pdb::PDBStorageManagerFrontend::handleDispatchedDat
   // figure out the size so we can increment it
   // check the uncompressed size
   size_t uncompressedSize = 0;
-  snappy::GetUncompressedLength((char*) page->getBytes(), numBytes, &uncompressedSize);
+  PDBWireCompression::getUncompressedSize((char*) page->getBytes(), numBytes, uncompressedSize);
 
   /// 2. Figure out the page we want to put this thing onto
 
@@ -592,6 +606,12 @@ std::pair<bool, std::string> pdb::PDBStorageManagerFrontend::handleClearSetReque
   // remove the skipped pages
   freeSkippedPages.erase(set);
 
+  // forget how well the set compressed
+  {
+    std::unique_lock<std::mutex> compressionLck{wireCompressionMutex};
+    wireCompressions.erase(set);
+  }
+
   // get the buffer manger
   auto bufferManager = std::dynamic_pointer_cast<pdb::PDBBufferManagerFrontEnd>(getFunctionalityPtr<pdb::PDBBufferManagerInterface>());
 
@@ -672,6 +692,39 @@ std::pair<bool, std::string> pdb::PDBStorageManagerFrontend::handleStartFeedingP
   // get the buffer manager
   auto bufferManager = std::dynamic_pointer_cast<pdb::PDBBufferManagerFrontEnd>(getFunctionalityPtr<pdb::PDBBufferManagerInterface>());
 
+  // the other node can only send the pages we granted it credits for, we grant them as the pages go to the backend,
+  // a batch at a time so that we don't answer every page
+  uint64_t window = std::max<uint64_t>(getConfiguration()->pageFeedWindow, 1);
+  uint64_t batch = std::max<uint64_t>(window / 2, 1);
+  uint64_t outstanding = 0;
+
+  // grants the credits so that the other node can have up to a window of pages in flight, but never more than we have
+  // free pages in the buffer pool, unless it has none left, then it gets one so that we don't stall forever
+  auto grantCredits = [&]() {
+
+    // figure out how many we can grant
+    uint64_t credits = std::min<uint64_t>(window - outstanding, bufferManager->getNumReusablePages());
+    if(outstanding == 0) {
+      credits = std::max<uint64_t>(credits, 1);
+    }
+
+    // if there is nothing to grant we are done
+    if(credits == 0) {
+      return true;
+    }
+
+    // send the credits
+    const UseTemporaryAllocationBlock creditsBlock{1024};
+    pdb::Handle<pdb::StoFeedPageCredits> grant = pdb::makeObject<pdb::StoFeedPageCredits>(credits);
+    outstanding += credits;
+    return sendUsingMe->sendObject(grant, error);
+  };
+
+  // grant the first credits
+  if(success) {
+    success = grantCredits();
+  }
+
   // if everything went well start receiving the pages
   while(success) {
 
@@ -698,10 +751,20 @@ std::pair<bool, std::string> pdb::PDBStorageManagerFrontend::handleStartFeedingP
       break;
     }
 
-    // do we have a page, if we don't finish
+    // do we have a page, if we don't tell the other node that we got everything and finish
     if(!hasPage->hasNextPage){
+      pdb::Handle<pdb::SimpleRequestResult> doneResponse = pdb::makeObject<pdb::SimpleRequestResult>(true, error);
+      success = sendUsingMe->sendObject(doneResponse, error);
+      break;
+    }
+
+    // the other node used up a credit, a page without one means it does not follow the protocol
+    if(outstanding == 0) {
+      error = "Got a page without a credit.";
+      success = false;
       break;
     }
+    outstanding--;
 
     /// 4.3 Get the page from the other node
 
@@ -720,6 +783,12 @@ std::pair<bool, std::string> pdb::PDBStorageManagerFrontend::handleStartFeedingP
 
     // forward the page to the backend
     success = bufferManager->forwardPage(page, communicatorToBackend, error);
+
+    /// 4.5 Grant more credits if a batch of them was used up
+
+    if(success && (window - outstanding >= batch || outstanding == 0)) {
+      success = grantCredits();
+    }
   }
 
   // return
@@ -6,6 +6,9 @@
 
 pdb::PDBAnonymousPageSet::PDBAnonymousPageSet(const pdb::PDBBufferManagerInterfacePtr &bufferManager) : bufferManager(bufferManager) {}
 
+pdb::PDBAnonymousPageSet::PDBAnonymousPageSet(const pdb::PDBBufferManagerInterfacePtr &bufferManager, uint64_t jobID) : bufferManager(bufferManager),
+                                                                                                                     jobID((int64_t) jobID) {}
+
 pdb::PDBPageHandle pdb::PDBAnonymousPageSet::getNextPage(size_t workerID) {
 
   // lock so we can mess with the data structure
@@ -41,13 +44,13 @@ pdb::PDBPageHandle pdb::PDBAnonymousPageSet::getNextPage(size_t workerID) {
   curPage++;
 
   // return the page
-  return pageHandle;
+  return applyAccessHint(pageHandle);
 }
 
 pdb::PDBPageHandle pdb::PDBAnonymousPageSet::getNewPage() {
 
-  // grab an anonymous page
-  auto page = bufferManager->getPage();
+  // grab an anonymous page, if we have a job it is charged to it
+  auto page = jobID == -1 ? bufferManager->getPage() : bufferManager->getJobPage((uint64_t) jobID, bufferManager->getMaxPageSize());
 
   // lock the pages struct
   {
@@ -57,7 +60,7 @@ pdb::PDBPageHandle pdb::PDBAnonymousPageSet::getNewPage() {
     pages[page->whichPage()] = page;
   }
 
-  return page;
+  return applyAccessHint(page);
 }
 
 void pdb::PDBAnonymousPageSet::removePage(pdb::PDBPageHandle pageHandle) {
@@ -102,3 +105,7 @@ void pdb::PDBAnonymousPageSet::setAccessOrder(PDBAnonymousPageSetAccessPattern p
 size_t pdb::PDBAnonymousPageSet::getMaxPageSize() {
   return bufferManager->getMaxPageSize();
 }
+
+pdb::PDBMemoryPressure pdb::PDBAnonymousPageSet::getMemoryPressure() {
+  return bufferManager->getMemoryPressure();
+}
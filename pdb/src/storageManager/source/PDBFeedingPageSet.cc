@@ -76,7 +76,7 @@ pdb::PDBPageHandle pdb::PDBFeedingPageSet::getNextPage(size_t workerID) {
 
   // repin and return the page
   it->second.page->repin();
-  return it->second.page;
+  return applyAccessHint(it->second.page);
 }
 
 void pdb::PDBFeedingPageSet::feedPage(const PDBPageHandle &page) {
@@ -88,8 +88,8 @@ void pdb::PDBFeedingPageSet::feedPage(const PDBPageHandle &page) {
     throw runtime_error("Trying to feed pages, when all feeders have done feeding.");
   }
 
-  // insert the page
-  pages.insert(std::make_pair(nextPage++, PDBFeedingPageInfo(page, 0, 0)));
+  // insert the page, it is evicted according to the hint of this page set until somebody reads it
+  pages.insert(std::make_pair(nextPage++, PDBFeedingPageInfo(applyAccessHint(page), 0, 0)));
 
   // unlock and notify that we inserted a page
   lck.unlock();
@@ -1,4 +1,5 @@
 #include <utility>
+#include <algorithm>
 
 //
 // Created by dimitrije on 3/5/19.
@@ -14,6 +15,39 @@ pdb::PDBSetPageSet::PDBSetPageSet(const std::string &db,
                                   pdb::PDBBufferManagerInterfacePtr bufferManager) : curPage(0), pages(pages), bufferManager(std::move(bufferManager)) {
   // make the pdb set
   this->set = make_shared<PDBSet>(db, set);
+
+  // the pages of a set are scanned, once a worker is done with a page nobody needs it
+  accessHint = PDB_PAGE_HINT_SEQUENTIAL_ONCE;
+}
+
+pdb::PDBSetPageSet::PDBSetPageSet(const std::string &db,
+                                  const std::string &set,
+                                  vector<uint64_t> &pages,
+                                  pdb::PDBBufferManagerInterfacePtr bufferManager,
+                                  uint64_t readAhead,
+                                  uint64_t numIOThreads) : PDBSetPageSet(db, set, pages, std::move(bufferManager)) {
+
+  // we need at least one thread to read ahead
+  this->readAhead = numIOThreads == 0 ? 0 : readAhead;
+  this->numIOThreads = numIOThreads;
+
+  // nothing is requested at the beginning
+  readAheadStates.resize(this->pages.size(), READ_AHEAD_NOT_REQUESTED);
+}
+
+pdb::PDBSetPageSet::~PDBSetPageSet() {
+
+  // tell the read ahead threads to finish
+  {
+    unique_lock<std::mutex> lck(m);
+    stopReadAhead = true;
+  }
+  cv.notify_all();
+
+  // wait for them to finish
+  for(auto &t : ioThreads) {
+    t.join();
+  }
 }
 
 pdb::PDBPageHandle pdb::PDBSetPageSet::getNextPage(size_t workerID) {
@@ -26,8 +60,102 @@ pdb::PDBPageHandle pdb::PDBSetPageSet::getNextPage(size_t workerID) {
     return nullptr;
   }
 
-  // return the page
-  return bufferManager->getPage(set, pages[pageNum]);
+  // if we are not reading ahead just return the page
+  if(readAhead == 0) {
+    return applyAccessHint(bufferManager->getPage(set, pages[pageNum]));
+  }
+
+  // lock the read ahead structures
+  unique_lock<std::mutex> lck(m);
+
+  // make sure we are reading ahead
+  startReadAhead();
+
+  // the window moved so the read ahead threads might have something to do
+  cv.notify_all();
+
+  // if nobody requested the page we grab it ourselves
+  if(readAheadStates[pageNum] == READ_AHEAD_NOT_REQUESTED) {
+
+    // mark it as loading so the read ahead threads skip it
+    readAheadStates[pageNum] = READ_AHEAD_LOADING;
+    lck.unlock();
+
+    // grab the page
+    return applyAccessHint(bufferManager->getPage(set, pages[pageNum]));
+  }
+
+  // wait for the read ahead thread to load the page
+  cv.wait(lck, [&] { return readAheadStates[pageNum] == READ_AHEAD_LOADED; });
+
+  // take the page
+  auto it = readAheadPages.find(pageNum);
+  auto page = it->second;
+  readAheadPages.erase(it);
+
+  return applyAccessHint(page);
+}
+
+void pdb::PDBSetPageSet::startReadAhead() {
+
+  // if we have the threads we are done
+  if(!ioThreads.empty()) {
+    return;
+  }
+
+  // start the threads
+  for(uint64_t i = 0; i < numIOThreads; ++i) {
+    ioThreads.emplace_back([&]() { readAheadLoop(); });
+  }
+}
+
+void pdb::PDBSetPageSet::readAheadLoop() {
+
+  // lock the read ahead structures
+  unique_lock<std::mutex> lck(m);
+
+  while(true) {
+
+    // wait until we are told to stop or there is a page within the window
+    cv.wait(lck, [&] {
+
+      // are we done
+      if(stopReadAhead) {
+        return true;
+      }
+
+      // skip the pages that are already requested
+      while(nextReadAhead < pages.size() && readAheadStates[nextReadAhead] != READ_AHEAD_NOT_REQUESTED) {
+        nextReadAhead++;
+      }
+
+      // is the page within the window
+      return nextReadAhead < pages.size() && nextReadAhead < curPage + readAhead;
+    });
+
+    // are we done
+    if(stopReadAhead) {
+      return;
+    }
+
+    // mark the page as loading
+    uint64_t pageNum = nextReadAhead++;
+    readAheadStates[pageNum] = READ_AHEAD_LOADING;
+    numLoading++;
+
+    // grab the page without holding the lock so that the other threads can grab pages too
+    lck.unlock();
+    auto page = applyAccessHint(bufferManager->getPage(set, pages[pageNum]));
+    lck.lock();
+
+    // store the page
+    readAheadPages[pageNum] = page;
+    readAheadStates[pageNum] = READ_AHEAD_LOADED;
+    numLoading--;
+
+    // notify the workers waiting for the page
+    cv.notify_all();
+  }
 }
 
 pdb::PDBPageHandle pdb::PDBSetPageSet::getNewPage() {
@@ -42,6 +170,15 @@ size_t pdb::PDBSetPageSet::getNumPages() {
 
 void pdb::PDBSetPageSet::resetPageSet() {
 
+  // wait for the pages that are currently being read ahead
+  unique_lock<std::mutex> lck(m);
+  cv.wait(lck, [&] { return numLoading == 0; });
+
+  // release the pages that nobody took and start reading ahead from the beginning
+  readAheadPages.clear();
+  std::fill(readAheadStates.begin(), readAheadStates.end(), READ_AHEAD_NOT_REQUESTED);
+  nextReadAhead = 0;
+
   // reset the page counter
   curPage = 0;
 }
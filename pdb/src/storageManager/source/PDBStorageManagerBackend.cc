@@ -4,6 +4,7 @@
 
 #include <SharedEmployee.h>
 #include <memory>
+#include <algorithm>
 #include "HeapRequestHandler.h"
 #include "StoStoreOnPageRequest.h"
 #include "StoGetSetPagesRequest.h"
@@ -91,7 +92,8 @@ pdb::PDBSetPageSetPtr pdb::PDBStorageManagerBackend::createPageSetFromPDBSet(con
 
 
   // store the page set
-  return std::make_shared<pdb::PDBSetPageSet>(db, set, pageInfo.second, getFunctionalityPtr<PDBBufferManagerInterface>());
+  return std::make_shared<pdb::PDBSetPageSet>(db, set, pageInfo.second, getFunctionalityPtr<PDBBufferManagerInterface>(),
+                                              (uint64_t) conf->readAheadPages * conf->numThreads, (uint64_t) conf->numThreads);
 }
 
 pdb::PDBAnonymousPageSetPtr pdb::PDBStorageManagerBackend::createAnonymousPageSet(const std::pair<uint64_t, std::string> &pageSetID) {
@@ -108,8 +110,8 @@ pdb::PDBAnonymousPageSetPtr pdb::PDBStorageManagerBackend::createAnonymousPageSe
 
   /// 2. We don't have it so create it
 
-  // store the page set
-  auto pageSet = std::make_shared<pdb::PDBAnonymousPageSet>(getFunctionalityPtr<PDBBufferManagerInterface>());
+  // store the page set, its pages are charged to the computation it belongs to
+  auto pageSet = std::make_shared<pdb::PDBAnonymousPageSet>(getFunctionalityPtr<PDBBufferManagerInterface>(), pageSetID.first);
   pageSets[pageSetID] = pageSet;
 
   // return it
@@ -259,16 +261,26 @@ bool pdb::PDBStorageManagerBackend::materializePageSet(const pdb::PDBAbstractPag
   pdb::PDBBufferManagerBackEndPtr bufferManager = std::dynamic_pointer_cast<PDBBufferManagerBackEndImpl>(getFunctionalityPtr<pdb::PDBBufferManagerInterface>());
   auto setIdentifier = std::make_shared<PDBSet>(set.first, set.second);
 
-  // go through each page and materialize
-  PDBPageHandle page;
+  // go through the pages and materialize them, we pin them in batches
   auto numPages = pageSet->getNumPages();
+  std::vector<PDBPageHandle> batch;
+  size_t inBatch = 0;
   for (int i = 0; i < numPages; ++i) {
 
-    // grab the next page
-    page = pageSet->getNextPage(0);
+    // grab the next batch of pages and pin them all at once, the batch takes no more pages than the frontend can pin
+    // and leaves one for the set page we copy into
+    if (batch.empty()) {
+      size_t numAvailable = bufferManager->getNumAvailablePages();
+      size_t batchSize = std::min<size_t>(PDB_BUFFER_MANAGER_MAX_BATCH, numAvailable > 1 ? numAvailable - 1 : 1);
+      for (int j = i; j < numPages && batch.size() < batchSize; ++j) {
+        batch.emplace_back(pageSet->getNextPage(0));
+      }
+      bufferManager->repinAll(batch);
+      inBatch = 0;
+    }
 
-    // repin the page
-    page->repin();
+    // the page we materialize now
+    auto &page = batch[inBatch++];
 
     // grab a page
     auto setPage = bufferManager->expectPage(comm);
@@ -289,8 +301,11 @@ bool pdb::PDBStorageManagerBackend::materializePageSet(const pdb::PDBAbstractPag
     // copy the memory to the set page
     memcpy(setPage->getBytes(), page->getBytes(), pageSize);
 
-    // unpin the page
-    page->unpin();
+    // if this was the last page of the batch unpin the whole batch
+    if (inBatch == batch.size()) {
+      bufferManager->unpinAll(batch);
+      batch.clear();
+    }
 
     // make an allocation block to send the response
     const pdb::UseTemporaryAllocationBlock blk{1024};
@@ -325,3 +325,23 @@ std::shared_ptr<pdb::PDBStorageSetStats> pdb::PDBStorageManagerFrontend::getSetS
   // return null
   return nullptr;
 }
+
+pdb::PDBWireCompressionPtr pdb::PDBStorageManagerFrontend::getWireCompression(const PDBSetPtr &set) {
+
+  // lock the compressions
+  unique_lock<std::mutex> lck(wireCompressionMutex);
+
+  // if we already have one return it
+  auto it = wireCompressions.find(set);
+  if(it != wireCompressions.end()) {
+    return it->second;
+  }
+
+  // make one with the codec of the node, it was checked when the node started so we just fall back to snappy
+  PDBPageCompression codec = PDB_PAGE_COMPRESSION_SNAPPY;
+  PDBBufferManagerCompression::fromString(getConfiguration()->wireCompression, codec);
+  auto compression = std::make_shared<PDBWireCompression>(codec, getConfiguration()->wireCompressionMinSavings);
+  wireCompressions[set] = compression;
+
+  return compression;
+}
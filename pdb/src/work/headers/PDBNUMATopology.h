@@ -0,0 +1,88 @@
+#ifndef PDB_PDBNUMATOPOLOGY_H
+#define PDB_PDBNUMATOPOLOGY_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <pthread.h>
+
+namespace pdb {
+
+class PDBNUMATopology;
+typedef std::shared_ptr<PDBNUMATopology> PDBNUMATopologyPtr;
+
+/**
+ * The NUMA nodes of the machine and the CPUs that belong to them. The topology is read from /sys/devices/system/node,
+ * if it is not there, for example on a machine without NUMA support, we assume that there is one node with all the CPUs.
+ * The nodes are numbered from zero to getNumNodes() - 1, the id the kernel uses for a node is given by getNodeID.
+ */
+class PDBNUMATopology {
+
+ public:
+
+  /**
+   * Detects the topology of this machine
+   */
+  PDBNUMATopology();
+
+  /**
+   * Creates a topology with the given nodes, this is used to test the NUMA awareness on a single node machine
+   * @param nodeIDs - the ids the kernel uses for the nodes
+   * @param cpuToNode - for each CPU the node it belongs to
+   */
+  PDBNUMATopology(std::vector<int> nodeIDs, std::vector<size_t> cpuToNode);
+
+  /**
+   * Returns the number of nodes
+   */
+  size_t getNumNodes() const;
+
+  /**
+   * Returns the id the kernel uses for the node
+   */
+  int getNodeID(size_t node) const;
+
+  /**
+   * Returns the node the calling thread is currently running on
+   */
+  size_t getCurrentNode() const;
+
+  /**
+   * Returns all the CPUs of the node
+   */
+  std::vector<int> getCPUs(size_t node) const;
+
+  /**
+   * Asks the kernel to place the memory on the node, the memory must not be touched yet and must be aligned to the
+   * page size of the system. This is only a preference if the node runs out of memory the kernel uses the other nodes.
+   * @return - true if it succeeded
+   */
+  bool bindMemory(void *memory, size_t numBytes, size_t node) const;
+
+  /**
+   * Makes the thread run only on the CPUs of the node
+   * @return - true if it succeeded
+   */
+  bool pinThread(pthread_t thread, size_t node) const;
+
+ private:
+
+  /**
+   * Parses a list of CPUs or nodes in the format the kernel uses, for example 0-3,8,10-11
+   */
+  static std::vector<int> parseList(const std::string &list);
+
+  /**
+   * the ids the kernel uses for the nodes
+   */
+  std::vector<int> nodeIDs;
+
+  /**
+   * for each CPU the node it belongs to
+   */
+  std::vector<size_t> cpuToNode;
+};
+
+}
+
+#endif //PDB_PDBNUMATOPOLOGY_H
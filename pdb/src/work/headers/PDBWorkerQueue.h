@@ -29,6 +29,7 @@
 #include <memory>
 
 #include "PDBLogger.h"
+#include "PDBNUMATopology.h"
 #include "PDBWorker.h"
 #include <pthread.h>
 #include <set>
@@ -51,8 +52,10 @@ public:
     static const size_t defaultAllocatorBlockSize = (1024 * 64);
 
     // create a worker queue that has the specified number of workers... output is written
-    // to the specified logger
-    PDBWorkerQueue(PDBLoggerPtr myLogger, int numWorkers);
+    // to the specified logger.  If pinToNUMANodes is true the workers are spread over the NUMA
+    // nodes of the machine and each one is only allowed to run on the CPUs of its node, so that
+    // the pages it gets from the buffer manager are always in the memory of its node
+    PDBWorkerQueue(PDBLoggerPtr myLogger, int numWorkers, bool pinToNUMANodes = false);
 
     // destroy the queue... if there are any outstanding workers, this will not complete
     // until they have all finished their work and been destroyed
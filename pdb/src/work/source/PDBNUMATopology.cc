@@ -0,0 +1,146 @@
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+#include "PDBNUMATopology.h"
+
+// the memory policy that prefers a node, this is in numaif.h but we don't want to depend on libnuma
+#ifndef MPOL_PREFERRED
+#define MPOL_PREFERRED 1
+#endif
+
+namespace pdb {
+
+PDBNUMATopology::PDBNUMATopology() {
+
+  // the nodes that have memory, a node without memory can not have an arena
+  std::ifstream nodesFile("/sys/devices/system/node/has_memory");
+  std::string nodes;
+  if (nodesFile.is_open()) {
+    std::getline(nodesFile, nodes);
+  }
+  nodeIDs = parseList(nodes);
+
+  // if there are no nodes we assume one node with all the CPUs
+  if (nodeIDs.empty()) {
+    nodeIDs.push_back(0);
+    cpuToNode.resize(std::max(std::thread::hardware_concurrency(), 1u), 0);
+    return;
+  }
+
+  // go through the nodes and assign their CPUs, the CPUs of nodes without memory stay on the first node
+  for (size_t node = 0; node < nodeIDs.size(); ++node) {
+
+    // read the CPUs of the node
+    std::ifstream cpusFile("/sys/devices/system/node/node" + std::to_string(nodeIDs[node]) + "/cpulist");
+    std::string cpus;
+    if (cpusFile.is_open()) {
+      std::getline(cpusFile, cpus);
+    }
+
+    // assign them
+    for (auto cpu : parseList(cpus)) {
+      if (cpu >= cpuToNode.size()) {
+        cpuToNode.resize(cpu + 1, 0);
+      }
+      cpuToNode[cpu] = node;
+    }
+  }
+}
+
+PDBNUMATopology::PDBNUMATopology(std::vector<int> nodeIDs, std::vector<size_t> cpuToNode) : nodeIDs(std::move(nodeIDs)),
+                                                                                            cpuToNode(std::move(cpuToNode)) {}
+
+size_t PDBNUMATopology::getNumNodes() const {
+  return nodeIDs.size();
+}
+
+int PDBNUMATopology::getNodeID(size_t node) const {
+  return nodeIDs[node];
+}
+
+size_t PDBNUMATopology::getCurrentNode() const {
+
+  // on a single node we don't need to ask
+  if (nodeIDs.size() == 1) {
+    return 0;
+  }
+
+  // figure out the CPU we are running on
+  int cpu = sched_getcpu();
+  if (cpu < 0 || cpu >= cpuToNode.size()) {
+    return 0;
+  }
+
+  return cpuToNode[cpu];
+}
+
+std::vector<int> PDBNUMATopology::getCPUs(size_t node) const {
+
+  std::vector<int> cpus;
+  for (int cpu = 0; cpu < cpuToNode.size(); ++cpu) {
+    if (cpuToNode[cpu] == node) {
+      cpus.push_back(cpu);
+    }
+  }
+
+  return cpus;
+}
+
+bool PDBNUMATopology::bindMemory(void *memory, size_t numBytes, size_t node) const {
+
+  // the mask of the nodes, it has only the node we want
+  int nodeID = nodeIDs[node];
+  std::vector<unsigned long> mask(nodeID / (8 * sizeof(unsigned long)) + 1, 0);
+  mask[nodeID / (8 * sizeof(unsigned long))] |= 1ul << (nodeID % (8 * sizeof(unsigned long)));
+
+  // the kernel ignores the last bit of the max node so we give it one more
+  unsigned long maxNode = mask.size() * 8 * sizeof(unsigned long) + 1;
+  return syscall(SYS_mbind, memory, numBytes, MPOL_PREFERRED, mask.data(), maxNode, 0) == 0;
+}
+
+bool PDBNUMATopology::pinThread(pthread_t thread, size_t node) const {
+
+  // make the set of the CPUs of the node
+  cpu_set_t cpus;
+  CPU_ZERO(&cpus);
+  for (auto cpu : getCPUs(node)) {
+    CPU_SET(cpu, &cpus);
+  }
+
+  // pin the thread
+  return pthread_setaffinity_np(thread, sizeof(cpus), &cpus) == 0;
+}
+
+std::vector<int> PDBNUMATopology::parseList(const std::string &list) {
+
+  std::vector<int> out;
+
+  // go through the ranges, they are separated by commas
+  std::stringstream stream(list);
+  std::string range;
+  while (std::getline(stream, range, ',')) {
+
+    // skip the empty ones
+    if (range.empty() || range == "\n") {
+      continue;
+    }
+
+    // a range is either a number or two numbers separated by a dash
+    auto dash = range.find('-');
+    int first = std::stoi(range.substr(0, dash));
+    int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+
+    // add them
+    for (int i = first; i <= last; ++i) {
+      out.push_back(i);
+    }
+  }
+
+  return out;
+}
+
+}
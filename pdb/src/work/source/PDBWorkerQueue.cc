@@ -31,7 +31,7 @@ namespace pdb {
 extern void* stackBase;
 extern void* stackEnd;
 
-PDBWorkerQueue::PDBWorkerQueue(PDBLoggerPtr myLoggerIn, int numWorkers) {
+PDBWorkerQueue::PDBWorkerQueue(PDBLoggerPtr myLoggerIn, int numWorkers, bool pinToNUMANodes) {
 
     // first, make sure that another worker queue does not exist
     if (stackBase != nullptr) {
@@ -74,6 +74,16 @@ PDBWorkerQueue::PDBWorkerQueue(PDBLoggerPtr myLoggerIn, int numWorkers) {
                          (i + 1) * 1024 * 1024 * 4 + ((char*)stackBase));
     }
     myLogger = myLoggerIn;
+
+    // spread the workers over the NUMA nodes if we were asked to
+    if (pinToNUMANodes) {
+        PDBNUMATopology topology;
+        for (int i = 0; i < threads.size(); i++) {
+            if (!topology.pinThread(threads[i], i % topology.getNumNodes())) {
+                std::cout << "Could not pin worker " << i << " to a NUMA node.\n";
+            }
+        }
+    }
 }
 
 PDBLoggerPtr PDBWorkerQueue::getLogger() {
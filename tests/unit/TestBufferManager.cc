@@ -1,14 +1,19 @@
 
 #include <cstring>
+#include <fcntl.h>
 #include <iostream>
 #include <time.h>
 #include <unistd.h>
+#include <sys/stat.h>
 #include <vector>
 #include <thread>
 #include <random>
 #include <gtest/gtest.h>
 
+#include "PDBBufferManagerChecksum.h"
 #include "PDBBufferManagerImpl.h"
+#include "PDBBufferManager2QPolicy.h"
+#include "PDBBufferManagerLRUPolicy.h"
 #include "PDBPageHandle.h"
 #include "PDBSet.h"
 
@@ -420,7 +425,7 @@ TEST(BufferManagerTest, Test7) {
       shuffle (pageIndices.begin(), pageIndices.end(), std::default_random_engine(seed));
 
       sync++;
-      while (sync != numThreads) {}
+      while (sync < numThreads) {}
       for(auto it : pageIndices) {
 
         // grab the page
@@ -476,7 +481,7 @@ TEST(BufferManagerTest, Test8) {
 
       // sync the threads to make sure there is more overlapping
       sync++;
-      while (sync != numThreads) {}
+      while (sync < numThreads) {}
 
       int offset = 0;
 
@@ -506,7 +511,7 @@ TEST(BufferManagerTest, Test8) {
 
       // sync the threads to make sure there is more overlapping
       sync++;
-      while (sync != 2 * numThreads) {}
+      while (sync < 2 * numThreads) {}
 
       offset = 0;
       for(auto &page : pageHandles) {
@@ -562,7 +567,7 @@ TEST(BufferManagerTest, Test9) {
 
       // sync the threads to make sure there is more overlapping
       sync++;
-      while (sync != numThreads) {}
+      while (sync < numThreads) {}
 
       int offset = 0;
 
@@ -592,7 +597,7 @@ TEST(BufferManagerTest, Test9) {
 
       // sync the threads to make sure there is more overlapping
       sync++;
-      while (sync != 2 * numThreads) {}
+      while (sync < 2 * numThreads) {}
 
       offset = 0;
       for(auto &page : pageHandles) {
@@ -651,7 +656,7 @@ TEST(BufferManagerTest, Test10) {
 
       // sync the threads to make sure there is more overlapping
       sync++;
-      while (sync != numThreads) {}
+      while (sync < numThreads) {}
 
       int offset = 0;
 
@@ -684,7 +689,7 @@ TEST(BufferManagerTest, Test10) {
 
       // sync the threads to make sure there is more overlapping
       sync++;
-      while (sync != 2 * numThreads) {}
+      while (sync < 2 * numThreads) {}
 
       offset = 0;
       for(int i = 0; i < numPages; ++i) {
@@ -749,7 +754,7 @@ TEST(BufferManagerTest, Test11) {
 
       // sync the threads to make sure there is more overlapping
       sync++;
-      while (sync != numThreads) {}
+      while (sync < numThreads) {}
 
       int offset = 0;
 
@@ -785,7 +790,7 @@ TEST(BufferManagerTest, Test11) {
 
       // sync the threads to make sure there is more overlapping
       sync++;
-      while (sync != 2 * numThreads) {}
+      while (sync < 2 * numThreads) {}
 
       offset = 0;
       for(int i = 0; i < numPages; ++i) {
@@ -882,7 +887,7 @@ TEST(BufferManagerTest, Test12) {
       shuffle (pageIndices.begin(), pageIndices.end(), std::default_random_engine(seed));
 
       sync++;
-      while (sync != numThreads) {}
+      while (sync < numThreads) {}
       for(auto it : pageIndices) {
 
         // grab the page
@@ -1014,7 +1019,7 @@ TEST(BufferManagerTest, Test14) {
 
       // sync the threads to make sure there is more overlapping
       sync++;
-      while (sync != numThreads) {}
+      while (sync < numThreads) {}
 
       int offset = 0;
 
@@ -1049,7 +1054,7 @@ TEST(BufferManagerTest, Test14) {
 
       // sync the threads to make sure there is more overlapping
       sync++;
-      while (sync != 2 * numThreads) {}
+      while (sync < 2 * numThreads) {}
 
       offset = 0;
       for(auto &page : pageHandles) {
@@ -1098,6 +1103,1306 @@ TEST(BufferManagerTest, Test14) {
   }
 }
 
+// this test checks that the 2Q policy evicts the pages of a scan before the pages that are reused
+TEST(BufferManagerTest, Test15) {
+
+  // the fake full pages
+  char pages[8];
+
+  // create the policies
+  PDBBufferManager2QPolicy twoQ(8);
+  PDBBufferManagerLRUPolicy lru;
+
+  // the first two pages are reused, they are unpinned, pinned again and then unpinned
+  for(int i = 0; i < 2; ++i) {
+    twoQ.unpinned(&pages[i]);
+    twoQ.pinned(&pages[i]);
+    twoQ.unpinned(&pages[i]);
+
+    lru.unpinned(&pages[i]);
+    lru.pinned(&pages[i]);
+    lru.unpinned(&pages[i]);
+  }
+
+  // the rest of the pages are scanned once
+  for(int i = 2; i < 8; ++i) {
+    twoQ.unpinned(&pages[i]);
+    lru.unpinned(&pages[i]);
+  }
+
+  // the LRU evicts the reused pages first
+  EXPECT_EQ(lru.evict(), &pages[0]);
+  EXPECT_EQ(lru.evict(), &pages[1]);
+
+  // the 2Q evicts the scanned pages until the probation queue is below a quarter of the pages
+  for(int i = 2; i < 7; ++i) {
+    EXPECT_EQ(twoQ.evict(), &pages[i]);
+  }
+
+  // then the reused pages in LRU order
+  EXPECT_EQ(twoQ.evict(), &pages[0]);
+  EXPECT_EQ(twoQ.evict(), &pages[1]);
+
+  // and finally the rest of the scan
+  EXPECT_EQ(twoQ.evict(), &pages[7]);
+  EXPECT_EQ(twoQ.evict(), nullptr);
+
+  // a freed page is forgotten
+  twoQ.unpinned(&pages[0]);
+  twoQ.freed(&pages[0]);
+  EXPECT_EQ(twoQ.evict(), nullptr);
+}
+
+// this test runs the anonymous page workload of the first test with the 2Q policy
+TEST(BufferManagerTest, Test16) {
+
+  // create the buffer manager
+  PDBBufferManagerImpl myMgr;
+  myMgr.initialize("tempDSFSD", 64, 16, "metadata", ".");
+  myMgr.setEvictionPolicy(PDBBufferManagerEvictionPolicy::create("2q", 16));
+
+  // grab the pages we reuse and write something to them
+  vector<PDBPageHandle> hot;
+  for (int i = 0; i < 4; i++) {
+    hot.emplace_back(myMgr.getPage());
+    memset(hot.back()->getBytes(), 'A' + i, 64);
+    hot.back()->unpin();
+  }
+
+  // scan a lot of pages and touch the hot pages in between
+  vector<PDBPageHandle> scan;
+  for (int i = 0; i < 128; i++) {
+
+    // grab a page of the scan and write to it
+    scan.emplace_back(myMgr.getPage());
+    memset(scan.back()->getBytes(), 'Z', 64);
+    scan.back()->unpin();
+
+    // reuse a hot page
+    auto &h = hot[i % hot.size()];
+    h->repin();
+    EXPECT_EQ(((char*) h->getBytes())[63], 'A' + (char) (i % hot.size()));
+    h->unpin();
+  }
+
+  // check the hot pages one more time
+  for (int i = 0; i < 4; i++) {
+    hot[i]->repin();
+    char expected[64];
+    memset(expected, 'A' + i, 64);
+    EXPECT_EQ(memcmp(expected, hot[i]->getBytes(), 64), 0);
+  }
+
+  // check the scanned pages
+  for (auto &page : scan) {
+    page->repin();
+    EXPECT_EQ(((char*) page->getBytes())[0], 'Z');
+    page->unpin();
+  }
+}
+
+// this test runs a workload that evicts a lot of set and anonymous pages with every I/O engine
+TEST(BufferManagerTest, Test17) {
+
+  for (const std::string engine : { "sync", "threads", "io_uring" }) {
+
+    // create a buffer manager with the engine
+    PDBBufferManagerImpl myMgr;
+    myMgr.initialize("tempDSFSD", 64, 16, "metadata", ".");
+    myMgr.setIOEngine(PDBBufferManagerIOEngine::create(engine, 4));
+
+    // create the sets
+    vector<PDBSetPtr> mySets;
+    vector<unsigned> myEnds;
+    vector<vector<size_t>> lens;
+    for (int i = 0; i < 6; i++) {
+      PDBSetPtr set = make_shared<PDBSet>("DB" + to_string(i), "set_" + engine);
+      mySets.push_back(set);
+      myEnds.push_back(0);
+      lens.emplace_back(vector<size_t>());
+    }
+
+    // create a bunch of set pages and anonymous pages and unpin them
+    vector<PDBPageHandle> tempPages;
+    vector<size_t> tempLens;
+    for (int i = 0; i < 1000; i++) {
+      PDBPageHandle temp = createRandomPage(myMgr, mySets, myEnds, lens);
+      temp->unpin();
+
+      if (i % 10 == 0) {
+        tempPages.emplace_back(createRandomTempPage(myMgr, tempLens));
+        tempPages.back()->unpin();
+      }
+    }
+
+    // check the set pages
+    char buffer[1024];
+    for (int i = 0; i < 6; i++) {
+      for (int j = 0; j < myEnds[i]; j++) {
+
+        // grab the page and check it
+        PDBPageHandle temp = myMgr.getPage(mySets[i], (uint64_t) j);
+        writeBytes(i, j, (int) lens[i][j], (char *) buffer);
+        EXPECT_EQ(strcmp(buffer, (char*) temp->getBytes()), 0);
+      }
+    }
+
+    // check the anonymous pages
+    for (auto &page : tempPages) {
+      page->repin();
+      EXPECT_EQ(((char*) page->getBytes())[0], 'F');
+      page->unpin();
+    }
+    tempPages.clear();
+
+    // clear the sets
+    for (auto &set : mySets) {
+      myMgr.clearSet(set);
+    }
+  }
+}
+
+// this test mixes pages that can be read and written with direct I/O with pages that are too small for it
+TEST(BufferManagerTest, Test18) {
+
+  // create a buffer manager with direct I/O
+  const size_t pageSize = 16384;
+  PDBBufferManagerImpl myMgr;
+  myMgr.initialize("tempDSFSD", pageSize, 8, "metadata", ".");
+  myMgr.setDirectIO(true);
+
+  // the sizes of the pages, the small ones need the buffered I/O
+  vector<size_t> sizes = { pageSize, 4096, 64, 8192, 256 };
+
+  // write the set pages and some anonymous pages, there is way more of them than memory
+  auto set = make_shared<PDBSet>("DB", "directSet");
+  vector<PDBPageHandle> tempPages;
+  for (uint64_t i = 0; i < 64; i++) {
+
+    // write a set page
+    PDBPageHandle page = myMgr.getPage(set, i);
+    memset(page->getBytes(), 'A' + (int) (i % 26), sizes[i % sizes.size()]);
+    page->setDirty();
+    page->freezeSize(sizes[i % sizes.size()]);
+    page->unpin();
+
+    // write an anonymous page
+    tempPages.emplace_back(myMgr.getPage(sizes[(i + 1) % sizes.size()]));
+    memset(tempPages.back()->getBytes(), 'a' + (int) (i % 26), sizes[(i + 1) % sizes.size()]);
+    tempPages.back()->unpin();
+  }
+
+  // check the set pages
+  for (uint64_t i = 0; i < 64; i++) {
+    PDBPageHandle page = myMgr.getPage(set, i);
+    vector<char> expected(sizes[i % sizes.size()], 'A' + (int) (i % 26));
+    EXPECT_EQ(memcmp(expected.data(), page->getBytes(), expected.size()), 0);
+  }
+
+  // check the anonymous pages
+  for (uint64_t i = 0; i < 64; i++) {
+    tempPages[i]->repin();
+    vector<char> expected(sizes[(i + 1) % sizes.size()], 'a' + (int) (i % 26));
+    EXPECT_EQ(memcmp(expected.data(), tempPages[i]->getBytes(), expected.size()), 0);
+    tempPages[i]->unpin();
+  }
+
+  // clear the set
+  tempPages.clear();
+  myMgr.clearSet(set);
+}
+
+TEST(BufferManagerTest, Test19) {
+
+  // create a buffer manager that asks for huge pages, the pool is not a multiple of the huge page size
+  const size_t pageSize = 64 * 1024;
+  PDBBufferManagerImpl myMgr;
+  myMgr.setHugePages(true);
+  myMgr.initialize("tempDSFSD", pageSize, 24, "metadata", ".");
+
+  // whatever we got the pool must work the same, write way more pages than fit in memory
+  auto set = make_shared<PDBSet>("DB", "hugeSet");
+  for (uint64_t i = 0; i < 64; i++) {
+    PDBPageHandle page = myMgr.getPage(set, i);
+    memset(page->getBytes(), 'A' + (int) (i % 26), pageSize);
+    page->setDirty();
+  }
+
+  // check the pages
+  for (uint64_t i = 0; i < 64; i++) {
+    PDBPageHandle page = myMgr.getPage(set, i);
+    vector<char> expected(pageSize, 'A' + (int) (i % 26));
+    EXPECT_EQ(memcmp(expected.data(), page->getBytes(), pageSize), 0);
+  }
+
+  // clear the set
+  myMgr.clearSet(set);
+}
+
+TEST(BufferManagerTest, Test20) {
+
+  // pretend we have two NUMA nodes and that every CPU belongs to the second one
+  std::vector<size_t> cpuToNode(std::max(std::thread::hardware_concurrency(), 1u) * 2, 1);
+  auto topology = std::make_shared<PDBNUMATopology>(std::vector<int>{0, 0}, cpuToNode);
+
+  // create a buffer manager with two arenas of four pages
+  const size_t pageSize = 1024 * 1024;
+  PDBBufferManagerImpl myMgr;
+  myMgr.setNUMATopology(topology);
+  myMgr.initialize("tempDSFSD", pageSize, 8, "metadata", ".");
+  EXPECT_EQ(myMgr.getNumArenas(), 2);
+
+  // the first four pages come from the local arena, the rest from the other one
+  vector<PDBPageHandle> pages;
+  for (uint64_t i = 0; i < 8; i++) {
+    pages.emplace_back(myMgr.getPage());
+    EXPECT_EQ(myMgr.getArena(pages.back()->getBytes()), i < 4 ? 1 : 0);
+    memset(pages.back()->getBytes(), 'A' + (int) i, pageSize);
+  }
+
+  // free one page in each arena, the small pages are made from the local one
+  pages[0] = nullptr;
+  pages[4] = nullptr;
+  auto small = myMgr.getPage(1024);
+  EXPECT_EQ(myMgr.getArena(small->getBytes()), 1);
+  small = nullptr;
+
+  // unpin all the pages and write a set that does not fit into memory so that the pages move between the arenas
+  for (auto &page : pages) {
+    if (page != nullptr) {
+      page->unpin();
+    }
+  }
+  auto set = make_shared<PDBSet>("DB", "numaSet");
+  for (uint64_t i = 0; i < 32; i++) {
+    PDBPageHandle page = myMgr.getPage(set, i);
+    memset(page->getBytes(), 'a' + (int) i, pageSize);
+    page->setDirty();
+  }
+
+  // check the anonymous pages
+  for (uint64_t i = 0; i < 8; i++) {
+    if (pages[i] != nullptr) {
+      pages[i]->repin();
+      vector<char> expected(pageSize, 'A' + (int) i);
+      EXPECT_EQ(memcmp(expected.data(), pages[i]->getBytes(), pageSize), 0);
+      pages[i]->unpin();
+    }
+  }
+
+  // check the set pages
+  for (uint64_t i = 0; i < 32; i++) {
+    PDBPageHandle page = myMgr.getPage(set, i);
+    vector<char> expected(pageSize, 'a' + (int) i);
+    EXPECT_EQ(memcmp(expected.data(), page->getBytes(), pageSize), 0);
+  }
+
+  // clear the set
+  pages.clear();
+  myMgr.clearSet(set);
+
+  // the frontend asks for the memory of the node the backend runs on, no matter which node it runs on itself
+  auto remoteSet = make_shared<PDBSet>("DB", "remoteNumaSet");
+  for (uint64_t i = 0; i < 4; i++) {
+    PDBPageHandle page = myMgr.getPage(remoteSet, i, (int64_t) (i % 2));
+    EXPECT_EQ(myMgr.getArena(page->getBytes()), i % 2);
+  }
+  myMgr.clearSet(remoteSet);
+}
+
+TEST(BufferManagerTest, Test21) {
+
+  // write a set with page numbers that don't fit into a new page directory
+  const size_t pageSize = 64;
+  const uint64_t numPages = 3000;
+  {
+    PDBBufferManagerImpl myMgr;
+    myMgr.initialize("tempDSFSD", pageSize, 16, "metadataDirectory", ".");
+    auto set = make_shared<PDBSet>("DB", "directorySet");
+    for (uint64_t i = 0; i < numPages; i++) {
+      PDBPageHandle page = myMgr.getPage(set, i * 3);
+      memset(page->getBytes(), 'A' + (int) (i % 26), pageSize);
+      page->setDirty();
+    }
+  }
+
+  // restart the buffer manager, the page locations come from the page directory of the set
+  PDBBufferManagerImpl myMgr;
+  myMgr.initialize("metadataDirectory");
+  auto set = make_shared<PDBSet>("DB", "directorySet");
+  for (uint64_t i = 0; i < numPages; i++) {
+    PDBPageHandle page = myMgr.getPage(set, i * 3);
+    vector<char> expected(pageSize, 'A' + (int) (i % 26));
+    EXPECT_EQ(memcmp(expected.data(), page->getBytes(), pageSize), 0);
+  }
+
+  // the pages we never wrote are new
+  PDBPageHandle page = myMgr.getPage(set, 1);
+  page->setDirty();
+  page->unpin();
+
+  // clearing the set removes the directory so a new set with the same name starts from scratch
+  page = nullptr;
+  myMgr.clearSet(set);
+  EXPECT_NE(access("./directorySet.DB.dir", F_OK), 0);
+}
+
+TEST(BufferManagerTest, Test22) {
+
+  // a buffer manager with few big pages so lots of small pages share one full page
+  const size_t pageSize = 64 * 1024;
+  PDBBufferManagerImpl myMgr;
+  myMgr.initialize("tempDSFSD", pageSize, 8, "metadata", ".");
+
+  // grab a lot of small pages of different sizes, like a shuffle sink does, and free them in random order
+  std::mt19937 gen(22);
+  std::vector<PDBPageHandle> pages;
+  std::vector<size_t> sizes;
+  for (int round = 0; round < 8; round++) {
+
+    // fill the memory with small pages
+    while (pages.size() < 1000) {
+      sizes.push_back(16u << (gen() % 5));
+      pages.emplace_back(myMgr.getPage(sizes.back()));
+      memset(pages.back()->getBytes(), (int) (pages.size() % 256), sizes.back());
+    }
+
+    // check that none of them overlap
+    for (size_t i = 0; i < pages.size(); i++) {
+      for (size_t j = 0; j < sizes[i]; j++) {
+        EXPECT_EQ(((unsigned char *) pages[i]->getBytes())[j], (unsigned char) ((i + 1) % 256));
+      }
+    }
+
+    // free half of them in random order and rewrite the rest so their positions match the values
+    std::vector<PDBPageHandle> kept;
+    std::vector<size_t> keptSizes;
+    for (size_t i = 0; i < pages.size(); i++) {
+      if (gen() % 2 == 0) {
+        kept.emplace_back(pages[i]);
+        keptSizes.emplace_back(sizes[i]);
+        memset(kept.back()->getBytes(), (int) (kept.size() % 256), keptSizes.back());
+      }
+    }
+    pages = std::move(kept);
+    sizes = std::move(keptSizes);
+  }
+
+  // free everything, the full pages must be free again so we can grab all of them
+  pages.clear();
+  std::vector<PDBPageHandle> fullPages;
+  for (int i = 0; i < 8; i++) {
+    fullPages.emplace_back(myMgr.getPage());
+  }
+}
+
+TEST(BufferManagerTest, Test23) {
+
+  // a buffer manager that writes all the unpinned dirty pages in the background
+  const size_t pageSize = 64;
+  const size_t numPages = 16;
+  PDBBufferManagerImpl myMgr;
+  myMgr.initialize("tempDSFSD", pageSize, numPages, "metadata", ".");
+  myMgr.startFlusher(1.0, 1.0);
+
+  // fill the whole pool with set pages and anonymous pages and unpin them, they are all dirty
+  auto set = make_shared<PDBSet>("DB", "flushedSet");
+  vector<PDBPageHandle> pages;
+  for (size_t i = 0; i < numPages; i++) {
+    pages.emplace_back(i % 2 == 0 ? myMgr.getPage(set, i) : myMgr.getPage());
+    memset(pages.back()->getBytes(), 'A' + (int) i, pageSize);
+    pages.back()->setDirty();
+    pages.back()->unpin();
+  }
+
+  // wait for the flusher to write all of them
+  for (int i = 0; i < 5000 && myMgr.getNumBackgroundWrites() < numPages; i++) {
+    usleep(1000);
+  }
+  EXPECT_EQ(myMgr.getNumBackgroundWrites(), numPages);
+
+  // now the pool is clean so taking new pages does not write anything
+  vector<PDBPageHandle> newPages;
+  for (size_t i = 0; i < numPages; i++) {
+    newPages.emplace_back(myMgr.getPage());
+  }
+  EXPECT_EQ(myMgr.getNumForegroundWrites(), 0);
+  newPages.clear();
+
+  // the evicted pages are read back from what the flusher wrote
+  for (size_t i = 0; i < numPages; i++) {
+    pages[i]->repin();
+    vector<char> expected(pageSize, 'A' + (int) i);
+    EXPECT_EQ(memcmp(expected.data(), pages[i]->getBytes(), pageSize), 0);
+    pages[i]->unpin();
+  }
+
+  myMgr.stopFlusher();
+}
+
+TEST(BufferManagerTest, Test24) {
+
+  // a small buffer manager so the batches have to evict pages and read them back
+  const size_t pageSize = 64;
+  const size_t numPages = 16;
+  PDBBufferManagerImpl myMgr;
+  myMgr.initialize("tempDSFSD", pageSize, numPages, "metadata", ".");
+
+  // write twice as many set pages as fit in memory, in batches of eight
+  auto set = make_shared<PDBSet>("DB", "batchedSet");
+  for (uint64_t first = 0; first < 2 * numPages; first += 8) {
+
+    std::vector<uint64_t> pageNums;
+    for (uint64_t i = first; i < first + 8; i++) {
+      pageNums.emplace_back(i);
+    }
+
+    auto pages = myMgr.getPages(set, pageNums);
+    ASSERT_EQ(pages.size(), 8);
+    for (auto &page : pages) {
+      EXPECT_TRUE(page->isPinned());
+      memset(page->getBytes(), 'A' + (int) page->whichPage(), pageSize);
+    }
+    myMgr.unpinAll(pages);
+    for (auto &page : pages) {
+      EXPECT_FALSE(page->isPinned());
+    }
+  }
+
+  // read them back in batches, asking for one of the pages twice
+  for (uint64_t first = 0; first < 2 * numPages; first += 8) {
+
+    std::vector<uint64_t> pageNums;
+    for (uint64_t i = first + 7; i + 1 > first; i--) {
+      pageNums.emplace_back(i);
+    }
+    pageNums.emplace_back(first);
+
+    auto pages = myMgr.getPages(set, pageNums);
+    ASSERT_EQ(pages.size(), 9);
+    for (size_t i = 0; i < pages.size(); i++) {
+      EXPECT_EQ(pages[i]->whichPage(), pageNums[i]);
+      vector<char> expected(pageSize, 'A' + (int) pageNums[i]);
+      EXPECT_EQ(memcmp(expected.data(), pages[i]->getBytes(), pageSize), 0);
+    }
+    myMgr.unpinAll(pages);
+  }
+
+  // get a batch of anonymous pages, fill them and unpin them
+  auto anonPages = myMgr.getAnonymousPages(8, pageSize / 2);
+  ASSERT_EQ(anonPages.size(), 8);
+  for (size_t i = 0; i < anonPages.size(); i++) {
+    EXPECT_TRUE(anonPages[i]->isPinned());
+    memset(anonPages[i]->getBytes(), 'a' + (int) i, pageSize / 2);
+  }
+  myMgr.unpinAll(anonPages);
+
+  // take all the memory so the anonymous pages are written out
+  {
+    auto fullPages = myMgr.getAnonymousPages(numPages, pageSize);
+    ASSERT_EQ(fullPages.size(), numPages);
+  }
+
+  // repin them all at once and check them, the set pages are mixed in so the batch has pages of both kinds
+  std::vector<PDBPageHandle> mixed = anonPages;
+  mixed.emplace_back(myMgr.getPage(set, 3));
+  mixed.back()->unpin();
+  myMgr.repinAll(mixed);
+  for (size_t i = 0; i < anonPages.size(); i++) {
+    EXPECT_TRUE(anonPages[i]->isPinned());
+    vector<char> expected(pageSize / 2, 'a' + (int) i);
+    EXPECT_EQ(memcmp(expected.data(), anonPages[i]->getBytes(), pageSize / 2), 0);
+  }
+  vector<char> expected(pageSize, 'A' + 3);
+  EXPECT_EQ(memcmp(expected.data(), mixed.back()->getBytes(), pageSize), 0);
+}
+
+// pin more and more of the pool and check that the subscribers are told about the memory pressure
+TEST(BufferManagerTest, Test25) {
+
+  const size_t pageSize = 64;
+  const size_t numPages = 20;
+  PDBBufferManagerImpl myMgr;
+  myMgr.initialize("tempDSFSD", pageSize, numPages, "metadata", ".");
+
+  // the levels for a pool of twenty pages
+  EXPECT_EQ(PDBBufferManagerMemoryPressure::getLevel(14, numPages), PDB_MEMORY_PRESSURE_NONE);
+  EXPECT_EQ(PDBBufferManagerMemoryPressure::getLevel(15, numPages), PDB_MEMORY_PRESSURE_MODERATE);
+  EXPECT_EQ(PDBBufferManagerMemoryPressure::getLevel(18, numPages), PDB_MEMORY_PRESSURE_HIGH);
+  EXPECT_EQ(PDBBufferManagerMemoryPressure::getLevel(20, numPages), PDB_MEMORY_PRESSURE_CRITICAL);
+
+  // remember every level we are told about
+  std::vector<PDBMemoryPressure> levels;
+  auto id = myMgr.subscribeToMemoryPressure([&](PDBMemoryPressure level) { levels.emplace_back(level); });
+
+  // the level is signaled when we ask for the next page, so after sixteen pages we know about fifteen
+  std::vector<PDBPageHandle> pinned;
+  for (size_t i = 0; i < 16; i++) {
+    pinned.emplace_back(myMgr.getPage());
+  }
+  EXPECT_EQ(myMgr.getMemoryPressure(), PDB_MEMORY_PRESSURE_MODERATE);
+
+  // after nineteen pages we know about eighteen
+  for (size_t i = 0; i < 3; i++) {
+    pinned.emplace_back(myMgr.getPage());
+  }
+  EXPECT_EQ(myMgr.getMemoryPressure(), PDB_MEMORY_PRESSURE_HIGH);
+
+  // unpinned pages can be evicted so they don't count
+  for (auto &page : pinned) {
+    page->unpin();
+  }
+  auto page = myMgr.getPage();
+  EXPECT_EQ(myMgr.getMemoryPressure(), PDB_MEMORY_PRESSURE_NONE);
+
+  // we were told about every change once
+  std::vector<PDBMemoryPressure> expected = {PDB_MEMORY_PRESSURE_MODERATE, PDB_MEMORY_PRESSURE_HIGH, PDB_MEMORY_PRESSURE_NONE};
+  EXPECT_EQ(levels, expected);
+
+  // once we unsubscribe we hear nothing
+  myMgr.unsubscribeFromMemoryPressure(id);
+  for (auto &p : pinned) {
+    p->repin();
+  }
+  EXPECT_EQ(myMgr.getMemoryPressure(), PDB_MEMORY_PRESSURE_HIGH);
+  EXPECT_EQ(levels, expected);
+}
+
+// the pages of a job that is over its soft budget are evicted first, a job over its hard budget recycles its own pages
+TEST(BufferManagerTest, Test26) {
+
+  const size_t pageSize = 64;
+  const size_t numPages = 16;
+
+  {
+    PDBBufferManagerImpl myMgr;
+    myMgr.initialize("tempDSFSD", pageSize, numPages, "metadata", ".");
+
+    // the first job can use four pages before it is over its soft budget, the second one has no budget
+    myMgr.setJobBudget(1, 4 * pageSize, numPages * pageSize);
+
+    // the second job gets its pages first so the policy would evict them first
+    std::vector<PDBPageHandle> pages;
+    for (int job = 2; job > 0; --job) {
+      for (int i = 0; i < 8; ++i) {
+        pages.emplace_back(myMgr.getJobPage(job, pageSize));
+        memset(pages.back()->getBytes(), 'A' + job, pageSize);
+        pages.back()->unpin();
+      }
+    }
+    EXPECT_EQ(myMgr.getJobStats(1).numBytes, 8 * pageSize);
+    EXPECT_EQ(myMgr.getJobStats(2).numBytes, 8 * pageSize);
+
+    // we need four pages, they are taken from the first job until it is within its budget
+    std::vector<PDBPageHandle> other;
+    for (int i = 0; i < 4; ++i) {
+      other.emplace_back(myMgr.getPage());
+    }
+    auto stats = myMgr.getJobStats(1);
+    EXPECT_EQ(stats.numBytes, 4 * pageSize);
+    EXPECT_EQ(stats.peakBytes, 8 * pageSize);
+    EXPECT_EQ(stats.numEvicted, 4);
+    EXPECT_EQ(stats.numEvictedOverBudget, 4);
+    EXPECT_EQ(myMgr.getJobStats(2).numEvicted, 0);
+
+    // after that the policy decides again
+    other.emplace_back(myMgr.getPage());
+    EXPECT_EQ(myMgr.getJobStats(2).numEvicted, 1);
+    EXPECT_EQ(myMgr.getJobStats(2).numEvictedOverBudget, 0);
+
+    // the evicted pages are still there
+    other.clear();
+    for (int i = 0; i < 16; ++i) {
+      pages[i]->repin();
+      char expected[pageSize];
+      memset(expected, i < 8 ? 'C' : 'B', pageSize);
+      EXPECT_EQ(memcmp(expected, pages[i]->getBytes(), pageSize), 0);
+    }
+  }
+
+  {
+    PDBBufferManagerImpl myMgr;
+    myMgr.initialize("tempDSFSD", pageSize, numPages, "metadata", ".");
+
+    // the job can use two pages
+    myMgr.setJobBudget(3, 2 * pageSize, 2 * pageSize);
+
+    // it takes three and unpins them
+    std::vector<PDBPageHandle> pages;
+    for (int i = 0; i < 3; ++i) {
+      pages.emplace_back(myMgr.getJobPage(3, pageSize));
+      memset(pages.back()->getBytes(), 'a' + i, pageSize);
+      pages.back()->unpin();
+    }
+
+    // there is plenty of free memory but it is over its hard budget so it has to recycle one of its pages
+    auto page = myMgr.getJobPage(3, pageSize);
+    auto stats = myMgr.getJobStats(3);
+    EXPECT_EQ(stats.numRecycled, 1);
+    EXPECT_EQ(stats.numEvicted, 1);
+    EXPECT_EQ(stats.numBytes, 3 * pageSize);
+
+    // the recycled page can be read back
+    for (int i = 0; i < 3; ++i) {
+      pages[i]->repin();
+      char expected[pageSize];
+      memset(expected, 'a' + i, pageSize);
+      EXPECT_EQ(memcmp(expected, pages[i]->getBytes(), pageSize), 0);
+    }
+  }
+}
+
+// the pages a job takes in a batch are charged to it and count against its budget like the ones it takes one at a time
+TEST(BufferManagerTest, Test27) {
+
+  const size_t pageSize = 64;
+  const size_t numPages = 16;
+
+  PDBBufferManagerImpl myMgr;
+  myMgr.initialize("tempDSFSD", pageSize, numPages, "metadata", ".");
+
+  // the job can use two pages
+  myMgr.setJobBudget(4, 2 * pageSize, 2 * pageSize);
+
+  // it takes three in one batch and unpins them
+  auto pages = myMgr.getJobPages(4, 3, pageSize);
+  ASSERT_EQ(pages.size(), 3);
+  EXPECT_EQ(myMgr.getJobStats(4).numBytes, 3 * pageSize);
+  for (size_t i = 0; i < pages.size(); ++i) {
+    memset(pages[i]->getBytes(), 'a' + (int) i, pageSize);
+    pages[i]->unpin();
+  }
+
+  // there is plenty of free memory but it is over its hard budget so the next batch recycles its pages
+  auto more = myMgr.getJobPages(4, 2, pageSize);
+  auto stats = myMgr.getJobStats(4);
+  EXPECT_EQ(stats.numRecycled, 2);
+  EXPECT_EQ(stats.numEvicted, 2);
+  EXPECT_EQ(stats.numBytes, 3 * pageSize);
+
+  // the recycled pages can be read back
+  for (size_t i = 0; i < pages.size(); ++i) {
+    pages[i]->repin();
+    char expected[pageSize];
+    memset(expected, 'a' + (int) i, pageSize);
+    EXPECT_EQ(memcmp(expected, pages[i]->getBytes(), pageSize), 0);
+  }
+}
+
+// the pages of a set with a codec and the spilled anonymous pages are compressed on disk and come back the same
+TEST(BufferManagerTest, Test28) {
+
+  const size_t pageSize = 64;
+  const size_t numPages = 4;
+  const size_t numSetPages = 16;
+
+  auto set = make_shared<PDBSet>("DB", "compressed");
+  {
+    PDBBufferManagerImpl myMgr;
+    myMgr.initialize("tempDSFSD", pageSize, numPages, "metadata", ".");
+    myMgr.setCompression(set, PDB_PAGE_COMPRESSION_SNAPPY);
+    myMgr.setTempFileCompression(PDB_PAGE_COMPRESSION_SNAPPY);
+
+    // write more set pages than fit into memory so they are evicted
+    for (uint64_t i = 0; i < numSetPages; ++i) {
+      auto page = myMgr.getPage(set, i);
+      memset(page->getBytes(), 'a' + i, pageSize);
+    }
+
+    // same with the anonymous pages
+    std::vector<PDBPageHandle> pages;
+    for (int i = 0; i < 8; ++i) {
+      pages.emplace_back(myMgr.getPage());
+      memset(pages.back()->getBytes(), 'A' + i, pageSize);
+      pages.back()->unpin();
+    }
+
+    // read them back
+    char expected[pageSize];
+    for (uint64_t i = 0; i < numSetPages; ++i) {
+      auto page = myMgr.getPage(set, i);
+      memset(expected, 'a' + i, pageSize);
+      EXPECT_EQ(memcmp(expected, page->getBytes(), pageSize), 0);
+    }
+    for (int i = 0; i < 8; ++i) {
+      pages[i]->repin();
+      memset(expected, 'A' + i, pageSize);
+      EXPECT_EQ(memcmp(expected, pages[i]->getBytes(), pageSize), 0);
+      pages[i]->unpin();
+    }
+  }
+
+  // only the compressed bytes were written so the last page does not take up its whole size
+  struct stat fileStat{};
+  ASSERT_EQ(stat("./compressed.DB", &fileStat), 0);
+  EXPECT_LT((size_t) fileStat.st_size, numSetPages * pageSize);
+
+  // the page directory knows which pages are compressed so they can be read without the codec being set
+  {
+    PDBBufferManagerImpl myMgr;
+    myMgr.initialize("metadata");
+
+    char expected[pageSize];
+    for (uint64_t i = 0; i < numSetPages; ++i) {
+      auto page = myMgr.getPage(set, i);
+      memset(expected, 'a' + i, pageSize);
+      EXPECT_EQ(memcmp(expected, page->getBytes(), pageSize), 0);
+    }
+  }
+}
+
+// the compressed pages are not aligned, so they go through the page cache even if we are using direct I/O
+TEST(BufferManagerTest, Test29) {
+
+  const size_t pageSize = 16384;
+  const size_t numPages = 4;
+  const size_t numSetPages = 16;
+
+  auto set = make_shared<PDBSet>("DB", "directCompressed");
+  PDBBufferManagerImpl myMgr;
+  myMgr.initialize("tempDSFSD", pageSize, numPages, "metadata", ".");
+  myMgr.setDirectIO(true);
+  myMgr.setCompression(set, PDB_PAGE_COMPRESSION_SNAPPY);
+  myMgr.setTempFileCompression(PDB_PAGE_COMPRESSION_SNAPPY);
+
+  // write more full set pages than fit into memory so they are evicted
+  for (uint64_t i = 0; i < numSetPages; ++i) {
+    auto page = myMgr.getPage(set, i);
+    memset(page->getBytes(), 'a' + i, pageSize);
+    page->setDirty();
+  }
+
+  // same with the full anonymous pages
+  std::vector<PDBPageHandle> pages;
+  for (int i = 0; i < 8; ++i) {
+    pages.emplace_back(myMgr.getPage());
+    memset(pages.back()->getBytes(), 'A' + i, pageSize);
+    pages.back()->unpin();
+  }
+
+  // read them back
+  vector<char> expected(pageSize);
+  for (uint64_t i = 0; i < numSetPages; ++i) {
+    auto page = myMgr.getPage(set, i);
+    memset(expected.data(), 'a' + i, pageSize);
+    EXPECT_EQ(memcmp(expected.data(), page->getBytes(), pageSize), 0);
+  }
+  for (int i = 0; i < 8; ++i) {
+    pages[i]->repin();
+    memset(expected.data(), 'A' + i, pageSize);
+    EXPECT_EQ(memcmp(expected.data(), pages[i]->getBytes(), pageSize), 0);
+    pages[i]->unpin();
+  }
+
+  // clear the set
+  pages.clear();
+  myMgr.clearSet(set);
+}
+
+TEST(BufferManagerTest, Test30) {
+
+  // the check value of CRC32C, both implementations have to agree on it and on anything else
+  EXPECT_EQ(PDBBufferManagerChecksum::crc32c("123456789", 9), 0xE3069283u);
+  EXPECT_EQ(PDBBufferManagerChecksum::crc32cSoftware("123456789", 9), 0xE3069283u);
+
+  std::vector<char> bytes(1027);
+  for (size_t i = 0; i < bytes.size(); ++i) {
+    bytes[i] = (char) (i * 31 + 7);
+  }
+  for (size_t offset = 0; offset < 8; ++offset) {
+    EXPECT_EQ(PDBBufferManagerChecksum::crc32c(bytes.data() + offset, bytes.size() - offset),
+              PDBBufferManagerChecksum::crc32cSoftware(bytes.data() + offset, bytes.size() - offset));
+  }
+
+  const size_t pageSize = 64;
+  const size_t numPages = 4;
+  const size_t numSetPages = 16;
+
+  auto set = make_shared<PDBSet>("DB", "checksummed");
+  {
+    PDBBufferManagerImpl myMgr;
+    myMgr.initialize("tempDSFSD", pageSize, numPages, "metadata", ".");
+    myMgr.setCompression(set, PDB_PAGE_COMPRESSION_SNAPPY);
+
+    // write more set pages than fit into memory so they are evicted, the odd ones don't compress
+    for (uint64_t i = 0; i < numSetPages; ++i) {
+      auto page = myMgr.getPage(set, i);
+      for (size_t j = 0; j < pageSize; ++j) {
+        ((char *) page->getBytes())[j] = (char) (i % 2 == 0 ? i : i * j + j * j);
+      }
+    }
+
+    // same with the anonymous pages
+    std::vector<PDBPageHandle> pages;
+    for (int i = 0; i < 8; ++i) {
+      pages.emplace_back(myMgr.getPage());
+      memset(pages.back()->getBytes(), 'A' + i, pageSize);
+      pages.back()->unpin();
+    }
+
+    // read them back, they all have to match their checksums
+    for (int i = 0; i < 8; ++i) {
+      pages[i]->repin();
+      EXPECT_EQ(((char *) pages[i]->getBytes())[pageSize - 1], 'A' + i);
+      pages[i]->unpin();
+    }
+    pages.clear();
+    for (uint64_t i = 0; i < numSetPages; ++i) {
+      auto page = myMgr.getPage(set, i);
+      EXPECT_EQ(((char *) page->getBytes())[pageSize - 1], (char) (i % 2 == 0 ? i : i * (pageSize - 1) + (pageSize - 1) * (pageSize - 1)));
+    }
+    EXPECT_EQ(myMgr.getNumChecksumFailures(), 0);
+  }
+
+  // the checksums are stored in the page directory so they are checked after a restart
+  {
+    PDBBufferManagerImpl myMgr;
+    myMgr.initialize("metadata");
+
+    for (uint64_t i = 0; i < numSetPages; ++i) {
+      auto page = myMgr.getPage(set, i);
+      EXPECT_EQ(((char *) page->getBytes())[0], (char) (i % 2 == 0 ? i : 0));
+    }
+    EXPECT_EQ(myMgr.getNumChecksumFailures(), 0);
+  }
+}
+
+TEST(BufferManagerTest, Test31) {
+
+  const size_t pageSize = 64;
+  const size_t numPages = 4;
+  const size_t numSetPages = 16;
+
+  auto set = make_shared<PDBSet>("DB", "striped");
+  {
+    PDBBufferManagerImpl myMgr;
+    myMgr.setStorageDirectories({"./stripe0", "./stripe1", "./stripe2"});
+    myMgr.initialize("./stripe0/tempDSFSD", pageSize, numPages, "metadata", ".");
+    myMgr.setIOEngine(PDBBufferManagerIOEngine::create("threads", 2, 3));
+
+    // write more set pages than fit into memory so they are evicted
+    for (uint64_t i = 0; i < numSetPages; ++i) {
+      auto page = myMgr.getPage(set, i);
+      memset(page->getBytes(), 'a' + i, pageSize);
+    }
+
+    // same with the anonymous pages
+    std::vector<PDBPageHandle> pages;
+    for (int i = 0; i < 8; ++i) {
+      pages.emplace_back(myMgr.getPage());
+      memset(pages.back()->getBytes(), 'A' + i, pageSize);
+      pages.back()->unpin();
+    }
+
+    // read them back
+    char expected[pageSize];
+    for (uint64_t i = 0; i < numSetPages; ++i) {
+      auto page = myMgr.getPage(set, i);
+      memset(expected, 'a' + i, pageSize);
+      EXPECT_EQ(memcmp(expected, page->getBytes(), pageSize), 0);
+    }
+    for (int i = 0; i < 8; ++i) {
+      pages[i]->repin();
+      memset(expected, 'A' + i, pageSize);
+      EXPECT_EQ(memcmp(expected, pages[i]->getBytes(), pageSize), 0);
+      pages[i]->unpin();
+    }
+  }
+
+  // the set has a file in every directory and the pages are spread over them, as are the anonymous pages
+  for (auto &dir : {"./stripe0", "./stripe1", "./stripe2"}) {
+    struct stat fileStat{};
+    ASSERT_EQ(stat((std::string(dir) + "/striped.DB").c_str(), &fileStat), 0);
+    EXPECT_GT((size_t) fileStat.st_size, 0);
+    EXPECT_LT((size_t) fileStat.st_size, numSetPages * pageSize);
+    ASSERT_EQ(stat((std::string(dir) + "/tempDSFSD").c_str(), &fileStat), 0);
+    EXPECT_GT((size_t) fileStat.st_size, 0);
+  }
+
+  // the directories are stored in the metadata so the pages are found after a restart
+  {
+    PDBBufferManagerImpl myMgr;
+    myMgr.initialize("metadata");
+
+    char expected[pageSize];
+    for (uint64_t i = 0; i < numSetPages; ++i) {
+      auto page = myMgr.getPage(set, i);
+      memset(expected, 'a' + i, pageSize);
+      EXPECT_EQ(memcmp(expected, page->getBytes(), pageSize), 0);
+    }
+  }
+}
+
+// this test checks that the access hints decide the order the full pages are evicted in and that the hot pages
+// survive a scan that is much larger than the buffer pool
+TEST(BufferManagerTest, Test32) {
+
+  // the hinted pages go around the wrapped policy
+  PDBBufferManagerHintedPolicy policy(std::make_shared<PDBBufferManagerLRUPolicy>());
+  char pages[8];
+  policy.unpinned(&pages[0], PDB_PAGE_HINT_HOT_REUSE);
+  policy.unpinned(&pages[1], PDB_PAGE_HINT_NORMAL);
+  policy.unpinned(&pages[2], PDB_PAGE_HINT_TEMP_SPILL);
+  policy.unpinned(&pages[3], PDB_PAGE_HINT_SEQUENTIAL_ONCE);
+  policy.unpinned(&pages[4], PDB_PAGE_HINT_NORMAL);
+  policy.unpinned(&pages[5], PDB_PAGE_HINT_SEQUENTIAL_ONCE);
+  policy.unpinned(&pages[6], PDB_PAGE_HINT_HOT_REUSE);
+  EXPECT_EQ(policy.numEvictable(), 7);
+
+  // a pinned page is not evictable no matter the hint
+  policy.pinned(&pages[5]);
+  EXPECT_EQ(policy.numEvictable(), 6);
+
+  // the scanned pages go first, then the spilled ones, then the pages of the wrapped policy and then the hot ones
+  std::vector<void *> order = {&pages[3], &pages[2], &pages[1], &pages[4], &pages[0], &pages[6]};
+  EXPECT_EQ(policy.getNextVictims(order.size()), order);
+  for (auto page : order) {
+    EXPECT_EQ(policy.evict(), page);
+  }
+  EXPECT_EQ(policy.evict(), nullptr);
+  EXPECT_EQ(policy.numEvictable(), 0);
+
+  // create the buffer manager
+  PDBBufferManagerImpl myMgr;
+  myMgr.initialize("tempDSFSD", 64, 16, "metadata", ".");
+
+  // grab the pages we reuse and write something to them
+  vector<PDBPageHandle> hot;
+  for (int i = 0; i < 4; i++) {
+    hot.emplace_back(myMgr.getPage());
+    hot.back()->setAccessHint(PDB_PAGE_HINT_HOT_REUSE);
+    memset(hot.back()->getBytes(), 'A' + i, 64);
+    hot.back()->unpin();
+  }
+
+  // and a few pages without a hint
+  vector<PDBPageHandle> normal;
+  for (int i = 0; i < 4; i++) {
+    normal.emplace_back(myMgr.getPage());
+    memset(normal.back()->getBytes(), 'a' + i, 64);
+    normal.back()->unpin();
+  }
+
+  // scan much more pages than fit into the buffer pool, they are evicted before anything else
+  vector<PDBPageHandle> scan;
+  for (int i = 0; i < 128; i++) {
+    scan.emplace_back(myMgr.getPage());
+    scan.back()->setAccessHint(PDB_PAGE_HINT_SEQUENTIAL_ONCE);
+    memset(scan.back()->getBytes(), 'Z', 64);
+    scan.back()->unpin();
+  }
+
+  // the hot pages and the pages without a hint are still in memory
+  for (auto &page : hot) {
+    EXPECT_NE(page->getBytes(), nullptr);
+  }
+  for (auto &page : normal) {
+    EXPECT_NE(page->getBytes(), nullptr);
+  }
+
+  // write more pages without a hint, the older ones without a hint are evicted but the hot pages stay
+  vector<PDBPageHandle> more;
+  for (int i = 0; i < 32; i++) {
+    more.emplace_back(myMgr.getPage());
+    memset(more.back()->getBytes(), 'M', 64);
+    more.back()->unpin();
+  }
+  for (auto &page : hot) {
+    EXPECT_NE(page->getBytes(), nullptr);
+  }
+
+  // everything can be read back
+  char expected[64];
+  for (int i = 0; i < 4; i++) {
+    hot[i]->repin();
+    memset(expected, 'A' + i, 64);
+    EXPECT_EQ(memcmp(expected, hot[i]->getBytes(), 64), 0);
+    hot[i]->unpin();
+    normal[i]->repin();
+    memset(expected, 'a' + i, 64);
+    EXPECT_EQ(memcmp(expected, normal[i]->getBytes(), 64), 0);
+    normal[i]->unpin();
+  }
+  for (auto &page : scan) {
+    page->repin();
+    EXPECT_EQ(((char*) page->getBytes())[0], 'Z');
+    page->unpin();
+  }
+}
+
+TEST(BufferManagerTest, Test33) {
+
+  // create the buffer manager
+  PDBBufferManagerImpl myMgr;
+  myMgr.initialize("tempDSFSD", 64, 16, "metadata", ".");
+
+  // nothing happened yet
+  auto stats = myMgr.getStats();
+  EXPECT_EQ(stats.pageSize, 64);
+  EXPECT_EQ(stats.numPages, 16);
+  EXPECT_EQ(stats.numPageRequests, 0);
+  EXPECT_EQ(stats.numFreeFullPages, 16);
+  EXPECT_EQ(stats.getHitRatio(), 1.0);
+
+  // write twice as many set pages as fit into the buffer pool
+  PDBSetPtr set = make_shared<PDBSet>("DB", "statsSet");
+  for (uint64_t i = 0; i < 32; i++) {
+    auto page = myMgr.getPage(set, i);
+    memset(page->getBytes(), 'A' + (char) (i % 26), 64);
+    page->setDirty();
+  }
+
+  // the new pages were not read, but half of them had to be evicted and written
+  stats = myMgr.getStats();
+  EXPECT_EQ(stats.numPageRequests, 32);
+  EXPECT_EQ(stats.numPageReads, 0);
+  EXPECT_GE(stats.numEvictions, 16);
+  EXPECT_GE(stats.numPageWrites, 16);
+  EXPECT_GE(stats.numBytesWritten, 16 * 64);
+
+  // read them all again, the evicted ones come from disk
+  for (uint64_t i = 0; i < 32; i++) {
+    auto page = myMgr.getPage(set, i);
+    EXPECT_EQ(((char *) page->getBytes())[0], 'A' + (char) (i % 26));
+  }
+  stats = myMgr.getStats();
+  EXPECT_EQ(stats.numPageRequests, 64);
+  EXPECT_GE(stats.numPageReads, 16);
+  EXPECT_LE(stats.numPageReads, 32);
+  EXPECT_EQ(stats.numBytesRead, stats.numPageReads * 64);
+  EXPECT_GT(stats.getHitRatio(), 0.0);
+  EXPECT_LE(stats.getHitRatio(), 0.75);
+
+  // every full page is used by an unpinned page now
+  EXPECT_EQ(stats.numFreeFullPages + stats.numPinnedFullPages + stats.numEvictableFullPages, 16);
+  EXPECT_EQ(stats.numPinnedFullPages, 0);
+
+  // pin two mini pages of 16 bytes, they share a full page split into four
+  auto page1 = myMgr.getPage(16);
+  auto page2 = myMgr.getPage(16);
+  stats = myMgr.getStats();
+  EXPECT_EQ(stats.numPinnedFullPages, 1);
+  auto sizeClass = *std::find_if(stats.sizeClasses.begin(), stats.sizeClasses.end(), [](auto &c) { return c.miniPageSize == 16; });
+  EXPECT_EQ(sizeClass.numFullPages, 1);
+  EXPECT_EQ(sizeClass.numMiniPages, 4);
+  EXPECT_EQ(sizeClass.numUsedMiniPages, 2);
+
+  // the summary has a line for them
+  EXPECT_NE(stats.toString().find("2 of 4 used on 1 full pages"), std::string::npos);
+}
+
+TEST(BufferManagerTest, Test34) {
+
+  // create the buffer manager
+  PDBBufferManagerImpl myMgr;
+  myMgr.initialize("tempDSFSD", 64, 16, "metadata", ".");
+
+  // fill the buffer pool with set pages and unpin them
+  PDBSetPtr set = make_shared<PDBSet>("DB", "pinSet");
+  std::vector<PDBPageHandle> pages;
+  for (uint64_t i = 0; i < 16; i++) {
+    pages.emplace_back(myMgr.getPage(set, i));
+    memset(pages.back()->getBytes(), 'a' + (char) i, 64);
+    pages.back()->setDirty();
+    pages.back()->unpin();
+  }
+  EXPECT_EQ(myMgr.getStats().numPinnedFullPages, 0);
+
+  // repin the first four, they are in RAM so only their full pages are pinned
+  std::vector<void *> bytes;
+  for (uint64_t i = 0; i < 4; i++) {
+    pages[i]->repin();
+    bytes.emplace_back(pages[i]->getBytes());
+  }
+  EXPECT_EQ(myMgr.getStats().numPinnedFullPages, 4);
+
+  // take the rest of the buffer pool, the pinned pages must stay where they are
+  std::vector<PDBPageHandle> anonymous;
+  for (uint64_t i = 0; i < 12; i++) {
+    anonymous.emplace_back(myMgr.getPage());
+  }
+  for (uint64_t i = 0; i < 4; i++) {
+    EXPECT_EQ(pages[i]->getBytes(), bytes[i]);
+    EXPECT_EQ(((char *) pages[i]->getBytes())[63], 'a' + (char) i);
+  }
+  EXPECT_EQ(myMgr.getStats().numPinnedFullPages, 16);
+
+  // once they are unpinned they can be evicted
+  for (uint64_t i = 0; i < 4; i++) {
+    pages[i]->unpin();
+  }
+  for (uint64_t i = 0; i < 4; i++) {
+    anonymous.emplace_back(myMgr.getPage());
+  }
+  EXPECT_GE(myMgr.getStats().numEvictions, 16);
+
+  // and read back from disk
+  anonymous.clear();
+  for (uint64_t i = 0; i < 16; i++) {
+    pages[i]->repin();
+    EXPECT_EQ(((char *) pages[i]->getBytes())[0], 'a' + (char) i);
+    pages[i]->unpin();
+  }
+}
+
+// the engines finish the transfers the kernel cuts short and report a read that hits the end of the file as incomplete
+TEST(BufferManagerTest, Test35) {
+
+  for (const std::string engine : { "sync", "threads", "io_uring" }) {
+
+    // create the engine and the file
+    auto ioEngine = PDBBufferManagerIOEngine::create(engine, 4);
+    std::string fileName = "ioEngineTest_" + engine;
+    int fd = open(fileName.c_str(), O_CREAT | O_RDWR | O_TRUNC, S_IRUSR | S_IWUSR);
+    ASSERT_NE(fd, -1);
+
+    // write a few megabytes in one request
+    std::vector<char> data(8 * 1024 * 1024);
+    for (size_t i = 0; i < data.size(); ++i) {
+      data[i] = (char) (i % 127);
+    }
+    std::vector<PDBBufferManagerIORequest> writes;
+    writes.emplace_back(fd, data.data(), data.size(), 0, true);
+    ioEngine->execute(writes);
+    EXPECT_TRUE(writes.front().isComplete());
+
+    // read it back together with a request that goes past the end of the file
+    std::vector<char> in(data.size());
+    std::vector<char> tail(4096);
+    std::vector<PDBBufferManagerIORequest> reads;
+    reads.emplace_back(fd, in.data(), in.size(), 0, false);
+    reads.emplace_back(fd, tail.data(), tail.size(), data.size() - 1024, false);
+    ioEngine->execute(reads);
+    EXPECT_TRUE(reads[0].isComplete());
+    EXPECT_EQ(memcmp(in.data(), data.data(), data.size()), 0);
+    EXPECT_FALSE(reads[1].isComplete());
+    EXPECT_EQ(reads[1].result, 1024);
+    EXPECT_EQ(memcmp(tail.data(), data.data() + data.size() - 1024, 1024), 0);
+
+    // a failed request has the errno
+    EXPECT_EQ(ioEngine->read(-1, in.data(), 16, 0), -1);
+
+    close(fd);
+    remove(fileName.c_str());
+  }
+}
+
+// a new storage does not pick up the page directories an old storage left behind in the same location
+TEST(BufferManagerTest, Test36) {
+
+  auto set = make_shared<PDBSet>("DB", "staleDirectorySet");
+  {
+    // write a small page
+    PDBBufferManagerImpl myMgr;
+    myMgr.initialize("tempDSFSD", 64, 16, "metadata", ".");
+    PDBPageHandle page = myMgr.getPage(set, 0);
+    memset(page->getBytes(), 'A', 16);
+    page->freezeSize(16);
+    page->unpin();
+  }
+
+  {
+    // start a new storage in the same location, the page was never created in it so it has the full size
+    PDBBufferManagerImpl myMgr;
+    myMgr.initialize("tempDSFSD", 64, 16, "metadata", ".");
+    PDBPageHandle page = myMgr.getPage(set, 0);
+    memset(page->getBytes(), 'B', 64);
+    page->freezeSize(64);
+    page->unpin();
+
+    // it is read back with the full size
+    page->repin();
+    EXPECT_EQ(((char *) page->getBytes())[63], 'B');
+    page = nullptr;
+    myMgr.clearSet(set);
+  }
+}
+
+TEST(BufferManagerTest, Test37) {
+
+  // an I/O engine that holds back the writes until we let them go
+  class HeldIOEngine : public PDBBufferManagerIOEngine {
+   public:
+
+    void execute(std::vector<PDBBufferManagerIORequest> &requests) override {
+      {
+        unique_lock<mutex> lck(m);
+        if (std::any_of(requests.begin(), requests.end(), [](auto &r) { return r.isWrite; })) {
+          numHeld++;
+          cv.notify_all();
+          cv.wait(lck, [&] { return released; });
+        }
+      }
+      engine->execute(requests);
+    }
+
+    PDBBufferManagerIOEnginePtr engine = PDBBufferManagerIOEngine::create("sync", 1);
+    mutex m;
+    condition_variable cv;
+    int numHeld = 0;
+    bool released = false;
+  };
+
+  // a buffer manager with a flusher whose writes we hold back
+  const size_t pageSize = 64;
+  const size_t numPages = 4;
+  PDBBufferManagerImpl myMgr;
+  myMgr.initialize("tempDSFSD", pageSize, numPages, "metadata", ".");
+  auto engine = make_shared<HeldIOEngine>();
+  myMgr.setIOEngine(engine);
+
+  // a dirty page that is unpinned
+  auto set = make_shared<PDBSet>("DB", "reflushedSet");
+  auto page = myMgr.getPage(set, 0);
+  memset(page->getBytes(), 'A', pageSize);
+  page->setDirty();
+  page->unpin();
+
+  // wait for the flusher to write it
+  myMgr.startFlusher(1.0, 1.0);
+  {
+    unique_lock<mutex> lck(engine->m);
+    EXPECT_TRUE(engine->cv.wait_for(lck, std::chrono::seconds(10), [&] { return engine->numHeld != 0; }));
+  }
+
+  // repin and modify it while it is written, the repin has to wait for the write
+  std::atomic_bool repinned(false);
+  std::thread modifier([&] {
+    page->repin();
+    repinned = true;
+    page->setDirty();
+    memset(page->getBytes(), 'B', pageSize);
+    page->unpin();
+  });
+  usleep(50000);
+  EXPECT_FALSE(repinned);
+
+  // let the write go, now the page can be repinned
+  {
+    unique_lock<mutex> lck(engine->m);
+    engine->released = true;
+    engine->cv.notify_all();
+  }
+  modifier.join();
+  EXPECT_TRUE(repinned);
+
+  // evict it
+  {
+    vector<PDBPageHandle> anonPages;
+    for (size_t i = 0; i < numPages; i++) {
+      anonPages.emplace_back(myMgr.getPage());
+    }
+  }
+  page.reset();
+
+  // the modification was written when it was evicted
+  auto reread = myMgr.getPage(set, 0);
+  vector<char> expected(pageSize, 'B');
+  EXPECT_EQ(memcmp(expected.data(), reread->getBytes(), pageSize), 0);
+
+  myMgr.stopFlusher();
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
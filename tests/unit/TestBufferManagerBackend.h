@@ -39,6 +39,24 @@ MOCK_METHOD7(getAnonPage, pdb::PDBPageHandle(pdb::PDBLoggerPtr &myLogger,
                                              const std::function<pdb::PDBPageHandle(pdb::Handle<pdb::BufGetPageResult>)> &processResponse,
                                              size_t minSize));
 
+MOCK_METHOD8(getPages, bool(pdb::PDBLoggerPtr &myLogger,
+                            int port,
+                            const std::string &address,
+                            bool onErr,
+                            size_t bytesForRequest,
+                            const std::function<bool(pdb::Handle<pdb::BufGetPagesResult>)> &processResponse,
+                            const pdb::PDBSetPtr &set,
+                            const std::vector<uint64_t> &pageNums));
+
+MOCK_METHOD8(getAnonPages, bool(pdb::PDBLoggerPtr &myLogger,
+                                int port,
+                                const std::string &address,
+                                bool onErr,
+                                size_t bytesForRequest,
+                                const std::function<bool(pdb::Handle<pdb::BufGetPagesResult>)> &processResponse,
+                                size_t numPages,
+                                size_t minSize));
+
 MOCK_METHOD9(unpinPage, bool(pdb::PDBLoggerPtr &myLogger,
                                int port,
                                const std::string &address,
@@ -88,6 +106,25 @@ MOCK_METHOD8(pinPage, bool(pdb::PDBLoggerPtr &myLogger,
                            const pdb::PDBSetPtr &setPtr,
                            size_t pageNum));
 
+MOCK_METHOD8(pinPages, bool(pdb::PDBLoggerPtr &myLogger,
+                            int port,
+                            const std::string &address,
+                            bool onErr,
+                            size_t bytesForRequest,
+                            const std::function<bool(pdb::Handle<pdb::BufPinPagesResult>)> &processResponse,
+                            const pdb::PDBSetPtr &setPtr,
+                            const std::vector<uint64_t> &pageNums));
+
+MOCK_METHOD9(unpinPages, bool(pdb::PDBLoggerPtr &myLogger,
+                              int port,
+                              const std::string &address,
+                              bool onErr,
+                              size_t bytesForRequest,
+                              const std::function<bool(pdb::Handle<pdb::SimpleRequestResult>)> &processResponse,
+                              const pdb::PDBSetPtr &setPtr,
+                              const std::vector<uint64_t> &pageNums,
+                              const std::vector<bool> &isDirty));
+
 };
 
 
@@ -103,7 +140,8 @@ public:
                                             size_t bytesForRequest,
                                             const std::function<pdb::PDBPageHandle(pdb::Handle<pdb::BufGetPageResult>)> &processResponse,
                                             const pdb::PDBSetPtr set,
-                                            uint64_t pageNum) {
+                                            uint64_t pageNum,
+                                            int64_t numaNode) {
 
     return _requestFactory->getPage(myLogger, port, address, onErr, bytesForRequest, processResponse, set, pageNum);
   }
@@ -116,11 +154,44 @@ public:
                                         pdb::PDBPageHandle onErr,
                                         size_t bytesForRequest,
                                         const std::function<pdb::PDBPageHandle(pdb::Handle<pdb::BufGetPageResult>)> &processResponse,
-                                        size_t minSize) {
+                                        size_t minSize,
+                                        int64_t jobID,
+                                        int64_t numaNode) {
 
     return _requestFactory->getAnonPage(myLogger, port, address, onErr, bytesForRequest, processResponse, minSize);
   }
 
+  // the mock get pages request
+  template <class RequestType, class ResponseType, class ReturnType>
+  static bool heapRequest(pdb::PDBLoggerPtr &myLogger,
+                          int port,
+                          const std::string &address,
+                          bool onErr,
+                          size_t bytesForRequest,
+                          const std::function<bool(pdb::Handle<pdb::BufGetPagesResult>)> &processResponse,
+                          const pdb::PDBSetPtr &set,
+                          const std::vector<uint64_t> &pageNums,
+                          int64_t numaNode) {
+
+    return _requestFactory->getPages(myLogger, port, address, onErr, bytesForRequest, processResponse, set, pageNums);
+  }
+
+  // the mock get anonymous pages request
+  template <class RequestType, class ResponseType, class ReturnType>
+  static bool heapRequest(pdb::PDBLoggerPtr &myLogger,
+                          int port,
+                          const std::string &address,
+                          bool onErr,
+                          size_t bytesForRequest,
+                          const std::function<bool(pdb::Handle<pdb::BufGetPagesResult>)> &processResponse,
+                          size_t numPages,
+                          size_t minSize,
+                          int64_t jobID,
+                          int64_t numaNode) {
+
+    return _requestFactory->getAnonPages(myLogger, port, address, onErr, bytesForRequest, processResponse, numPages, minSize);
+  }
+
   // return anonymous page
   template <class RequestType, class ResponseType, class ReturnType>
   static bool heapRequest(pdb::PDBLoggerPtr &myLogger,
@@ -160,7 +231,8 @@ public:
                           const std::function<bool(pdb::Handle<pdb::SimpleRequestResult>)> &processResponse,
                           PDBSetPtr &set,
                           size_t pageNum,
-                          bool isDirty) {
+                          bool isDirty,
+                          PDBPageAccessHint accessHint) {
 
     return _requestFactory->unpinPage(myLogger, port, address, onErr, bytesForRequest, processResponse, set, pageNum, isDirty);
   }
@@ -194,6 +266,36 @@ public:
     return _requestFactory->pinPage(myLogger, port, address, onErr, bytesForRequest, processResponse, setPtr, pageNum);
   }
 
+  // pin pages
+  template <class RequestType, class ResponseType, class ReturnType>
+  static bool heapRequest(pdb::PDBLoggerPtr &myLogger,
+                          int port,
+                          const std::string &address,
+                          bool onErr,
+                          size_t bytesForRequest,
+                          const std::function<bool(pdb::Handle<pdb::BufPinPagesResult>)> &processResponse,
+                          const pdb::PDBSetPtr &setPtr,
+                          const std::vector<uint64_t> &pageNums) {
+
+    return _requestFactory->pinPages(myLogger, port, address, onErr, bytesForRequest, processResponse, setPtr, pageNums);
+  }
+
+  // unpin pages
+  template <class RequestType, class ResponseType, class ReturnType>
+  static bool heapRequest(pdb::PDBLoggerPtr &myLogger,
+                          int port,
+                          const std::string &address,
+                          bool onErr,
+                          size_t bytesForRequest,
+                          const std::function<bool(pdb::Handle<pdb::SimpleRequestResult>)> &processResponse,
+                          const pdb::PDBSetPtr &setPtr,
+                          const std::vector<uint64_t> &pageNums,
+                          const std::vector<bool> &isDirty,
+                          const std::vector<PDBPageAccessHint> &accessHints) {
+
+    return _requestFactory->unpinPages(myLogger, port, address, onErr, bytesForRequest, processResponse, setPtr, pageNums, isDirty);
+  }
+
   static shared_ptr<MockRequestFactoryImpl> _requestFactory;
 };
 
@@ -250,7 +250,7 @@ TEST(BufferManagerBackendTest, Test3) {
 
         // sync the threads to make sure there is more overlapping
         sync++;
-        while (sync != numThreads) {}
+        while (sync < numThreads) {}
 
         int offset = 0;
 
@@ -287,7 +287,7 @@ TEST(BufferManagerBackendTest, Test3) {
 
         // sync the threads to make sure there is more overlapping
         sync++;
-        while (sync != 2 * numThreads) {}
+        while (sync < 2 * numThreads) {}
 
         offset = 0;
         for (int i = 0; i < numPages / numThreads; ++i) {
@@ -286,7 +286,7 @@ TEST(BufferManagerBackendTest, Test4) {
         shuffle (pageIndices.begin(), pageIndices.end(), std::default_random_engine(seed));
 
         sync++;
-        while (sync != numThreads) {}
+        while (sync < numThreads) {}
         for(auto it : pageIndices) {
 
           // grab the page
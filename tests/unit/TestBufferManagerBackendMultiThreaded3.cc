@@ -364,7 +364,7 @@ TEST(BufferManagerBackendTest, Test5) {
         shuffle (pageIndices.begin(), pageIndices.end(), std::default_random_engine(seed));
 
         sync++;
-        while (sync != numThreads) {}
+        while (sync < numThreads) {}
         for(auto it : pageIndices) {
 
           // grab the page
@@ -399,7 +399,7 @@ TEST(BufferManagerBackendTest, Test5) {
         }
 
         sync++;
-        while (sync != 2 * numThreads) {}
+        while (sync < 2 * numThreads) {}
 
         std::vector<pdb::PDBPageHandle> tmpPages;
         for(uint64_t i = 0; i < numPages; ++i) {
@@ -496,4 +496,170 @@ TEST(BufferManagerBackendTest, Test2) {
   myMgr.parent = nullptr;
 }
 
+// this test checks whether the pages of a set and the anonymous pages are requested with a request per batch
+TEST(BufferManagerBackendTest, Test6) {
+
+  const size_t numPages = 64;
+  const size_t numSetPages = 40;
+  const size_t numAnonPages = 20;
+  const size_t pageSize = 64;
+
+  int curPage = numSetPages;
+  std::vector<size_t> batchSizes;
+
+  // allocate memory
+  std::unique_ptr<char[]> memory(new char[numPages * pageSize]);
+
+  // make the shared memory object
+  PDBSharedMemory sharedMemory{};
+  sharedMemory.pageSize = pageSize;
+  sharedMemory.numPages = numPages;
+  sharedMemory.memory = memory.get();
+
+  pdb::PDBBufferManagerBackEnd<MockRequestFactory> myMgr(sharedMemory);
+
+  MockRequestFactory::_requestFactory = std::make_shared<MockRequestFactoryImpl>();
+
+  MockServer server;
+  ON_CALL(server, getConfiguration).WillByDefault(testing::Invoke(
+      [&]() {
+        return std::make_shared<pdb::NodeConfig>();
+      }));
+
+  EXPECT_CALL(server, getConfiguration).Times(testing::AtLeast(1));
+
+  myMgr.recordServer(server);
+
+  /// 1. Mock the get pages for the set
+
+  ON_CALL(*MockRequestFactory::_requestFactory, getPages).WillByDefault(testing::Invoke(
+      [&](pdb::PDBLoggerPtr &myLogger, int port, const std::string &address, bool onErr, size_t bytesForRequest,
+          const std::function<bool(pdb::Handle<pdb::BufGetPagesResult>)> &processResponse,
+          const pdb::PDBSetPtr &set, const std::vector<uint64_t> &pageNums) {
+
+        const pdb::UseTemporaryAllocationBlock tempBlock{1024};
+
+        // check the set
+        EXPECT_TRUE(set->getSetName() == "set1");
+        EXPECT_TRUE(set->getDBName() == "DB");
+
+        // the page of a set is at the offset of its number
+        pdb::Handle<pdb::BufGetPagesResult> result = pdb::makeObject<pdb::BufGetPagesResult>(pageNums.size());
+        for (auto pageNum : pageNums) {
+          EXPECT_LT(pageNum, numSetPages);
+          result->addPage(pageNum * pageSize, pageNum, -1, 3, -1);
+        }
+        result->success = true;
+
+        // remember the size of the batch
+        batchSizes.emplace_back(pageNums.size());
+
+        // return true since we assume this succeeded
+        return processResponse(result);
+      }
+  ));
+
+  // the pages are requested in three batches
+  EXPECT_CALL(*MockRequestFactory::_requestFactory, getPages).Times(3);
+
+  /// 2. Mock the get anonymous pages
+
+  ON_CALL(*MockRequestFactory::_requestFactory, getAnonPages).WillByDefault(testing::Invoke(
+      [&](pdb::PDBLoggerPtr &myLogger, int port, const std::string &address, bool onErr, size_t bytesForRequest,
+          const std::function<bool(pdb::Handle<pdb::BufGetPagesResult>)> &processResponse,
+          size_t numRequested, size_t minSize) {
+
+        const pdb::UseTemporaryAllocationBlock tempBlock{1024};
+
+        // the anonymous pages come after the pages of the set
+        pdb::Handle<pdb::BufGetPagesResult> result = pdb::makeObject<pdb::BufGetPagesResult>(numRequested);
+        for (size_t i = 0; i < numRequested; ++i) {
+          int64_t myPage = curPage++;
+          result->addPage(myPage * pageSize, myPage, -1, 3, -1);
+        }
+        result->success = true;
+
+        // remember the size of the batch
+        batchSizes.emplace_back(numRequested);
+
+        // return true since we assume this succeeded
+        return processResponse(result);
+      }
+  ));
+
+  // the pages are requested in two batches
+  EXPECT_CALL(*MockRequestFactory::_requestFactory, getAnonPages).Times(2);
+
+  /// 3. Mock the return page and the return anonymous page
+
+  ON_CALL(*MockRequestFactory::_requestFactory, returnPage).WillByDefault(testing::Invoke(
+      [&](pdb::PDBLoggerPtr &myLogger, int port, const std::string &address, bool onErr, size_t bytesForRequest,
+          const std::function<bool(pdb::Handle<pdb::SimpleRequestResult>)> &processResponse,
+          std::string setName, std::string dbName, size_t pageNum, bool isDirty) {
+
+        const pdb::UseTemporaryAllocationBlock tempBlock{1024};
+
+        // return true since we assume this succeeded
+        pdb::Handle<pdb::SimpleRequestResult> result = pdb::makeObject<pdb::SimpleRequestResult>(true, "");
+        return processResponse(result);
+      }
+  ));
+
+  EXPECT_CALL(*MockRequestFactory::_requestFactory, returnPage).Times(numSetPages);
+
+  ON_CALL(*MockRequestFactory::_requestFactory, returnAnonPage).WillByDefault(testing::Invoke(
+      [&](pdb::PDBLoggerPtr &myLogger, int port, const std::string &address, bool onErr, size_t bytesForRequest,
+          const std::function<bool(pdb::Handle<pdb::SimpleRequestResult>)> &processResponse,
+          size_t pageNum, bool isDirty) {
+
+        const pdb::UseTemporaryAllocationBlock tempBlock{1024};
+
+        // return true since we assume this succeeded
+        pdb::Handle<pdb::SimpleRequestResult> result = pdb::makeObject<pdb::SimpleRequestResult>(true, "");
+        return processResponse(result);
+      }
+  ));
+
+  EXPECT_CALL(*MockRequestFactory::_requestFactory, returnAnonPage).Times(numAnonPages);
+
+  {
+    // get the pages of the set
+    auto set1 = make_shared<PDBSet>("DB", "set1");
+    std::vector<uint64_t> pageNums;
+    for (uint64_t i = 0; i < numSetPages; ++i) {
+      pageNums.emplace_back(i);
+    }
+    auto pages = myMgr.getPages(set1, pageNums);
+
+    // check that we got them in the right order
+    ASSERT_EQ(pages.size(), numSetPages);
+    for (uint64_t i = 0; i < numSetPages; ++i) {
+      EXPECT_EQ(pages[i]->whichPage(), i);
+      EXPECT_EQ(pages[i]->getBytes(), memory.get() + i * pageSize);
+    }
+
+    // the pages are already pinned so getting them again does not make a request
+    auto again = myMgr.getPages(set1, pageNums);
+    for (uint64_t i = 0; i < numSetPages; ++i) {
+      EXPECT_EQ(again[i]->getBytes(), pages[i]->getBytes());
+    }
+
+    // get the anonymous pages
+    auto anonPages = myMgr.getAnonymousPages(numAnonPages, pageSize);
+    ASSERT_EQ(anonPages.size(), numAnonPages);
+    for (size_t i = 0; i < numAnonPages; ++i) {
+      EXPECT_EQ(anonPages[i]->getSet(), nullptr);
+      EXPECT_EQ(anonPages[i]->getBytes(), memory.get() + (numSetPages + i) * pageSize);
+    }
+  }
+
+  // check the batches
+  std::vector<size_t> expected = {16, 16, 8, 16, 4};
+  EXPECT_EQ(batchSizes, expected);
+
+  // just to remove the mock object
+  MockRequestFactory::_requestFactory = nullptr;
+  myMgr.parent = nullptr;
+}
+
 }
\ No newline at end of file
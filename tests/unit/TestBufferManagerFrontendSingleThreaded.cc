@@ -31,6 +31,8 @@ public:
 
   MOCK_METHOD2(sendObject, bool(pdb::Handle<pdb::BufFreezeRequestResult>& res, std::string& errMsg));
 
+  MOCK_METHOD2(sendObject, bool(pdb::Handle<pdb::BufGetPagesResult>& res, std::string& errMsg));
+
 };
 
 auto getRandomIndices(int numRequestsPerPage, int numPages) {
@@ -759,6 +761,88 @@ TEST(BufferManagerFrontendTest, Test5) {
   }
 }
 
+// this tests getting a batch of set pages and a batch of anonymous pages with a single response each
+TEST(BufferManagerFrontendTest, Test9) {
+
+  const int numSetPages = 16;
+  const int numAnonPages = 8;
+  const int pageSize = 64;
+
+  // create the frontend
+  pdb::PDBBufferManagerFrontEnd frontEnd("tempDSFSD", pageSize, 32, "metadata", ".");
+
+  // call the init method the server would usually call
+  frontEnd.init();
+
+  // write the page number into each page of the set
+  std::vector<uint64_t> pageNumbers;
+  for(uint64_t i = 0; i < numSetPages; ++i) {
+    auto page = frontEnd.getPage(make_shared<PDBSet>("db1", "set1"), i);
+    ((uint64_t*) page->getBytes())[0] = i;
+    pageNumbers.emplace_back(i);
+  }
+
+  // make the mock communicator
+  auto comm = std::make_shared<CommunicatorMock>();
+
+  /// 1. Get the set pages
+
+  // check that we got all the pages in the order we asked for them
+  ON_CALL(*comm, sendObject(testing::An<pdb::Handle<pdb::BufGetPagesResult>&>(), testing::An<std::string&>())).WillByDefault(testing::Invoke(
+      [&] (pdb::Handle<pdb::BufGetPagesResult>& res, std::string& errMsg) {
+
+        EXPECT_TRUE(res->success);
+        EXPECT_EQ(res->offsets.size(), numSetPages);
+        for(int i = 0; i < res->offsets.size(); ++i) {
+          auto bytes = (char*) frontEnd.sharedMemory.memory + res->offsets[i];
+          EXPECT_EQ(res->pageNums[i], i);
+          EXPECT_EQ(((uint64_t*) bytes)[0], i);
+          EXPECT_EQ(MIN_PAGE_SIZE << res->numBytes[i], pageSize);
+        }
+
+        // return true since we assume this succeeded
+        return true;
+      }
+  ));
+
+  // it should call send object exactly once
+  EXPECT_CALL(*comm, sendObject(testing::An<pdb::Handle<pdb::BufGetPagesResult>&>(), testing::An<std::string&>())).Times(1);
+
+  // invoke the get pages handler
+  pdb::Handle<pdb::BufGetPagesRequest> pagesRequest = pdb::makeObject<pdb::BufGetPagesRequest>(std::make_shared<pdb::PDBSet>("db1", "set1"), pageNumbers);
+  frontEnd.handleGetPagesRequest(pagesRequest, comm);
+
+  /// 2. Get the anonymous pages
+
+  // check that we got all the pages and that they are all different
+  ON_CALL(*comm, sendObject(testing::An<pdb::Handle<pdb::BufGetPagesResult>&>(), testing::An<std::string&>())).WillByDefault(testing::Invoke(
+      [&] (pdb::Handle<pdb::BufGetPagesResult>& res, std::string& errMsg) {
+
+        EXPECT_TRUE(res->success);
+        EXPECT_EQ(res->offsets.size(), numAnonPages);
+        std::set<uint64_t> offsets;
+        for(int i = 0; i < res->offsets.size(); ++i) {
+          offsets.insert(res->offsets[i]);
+          EXPECT_EQ(MIN_PAGE_SIZE << res->numBytes[i], pageSize);
+        }
+        EXPECT_EQ(offsets.size(), numAnonPages);
+
+        // return true since we assume this succeeded
+        return true;
+      }
+  ));
+
+  // it should call send object exactly once
+  EXPECT_CALL(*comm, sendObject(testing::An<pdb::Handle<pdb::BufGetPagesResult>&>(), testing::An<std::string&>())).Times(1);
+
+  // invoke the get anonymous pages handler
+  pdb::Handle<pdb::BufGetAnonymousPagesRequest> anonRequest = pdb::makeObject<pdb::BufGetAnonymousPagesRequest>(numAnonPages, pageSize);
+  frontEnd.handleGetAnonymousPagesRequest(anonRequest, comm);
+
+  // the frontend keeps all the pages it sent
+  EXPECT_EQ(frontEnd.sentPages.size(), numSetPages + numAnonPages);
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
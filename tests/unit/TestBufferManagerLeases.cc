@@ -0,0 +1,186 @@
+#include <iostream>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <gtest/gtest.h>
+
+#include <PDBBufferManagerLeases.h>
+
+namespace pdb {
+
+// goes through the life of a lease in one process
+TEST(BufferManagerLeasesTest, Test1) {
+
+  PDBBufferManagerLeases leases;
+
+  // grant a lease, it starts pinned
+  auto lease = leases.grant(1024);
+  EXPECT_NE(lease, -1);
+
+  // we can not revoke it while it is pinned
+  bool isDirty = false;
+  EXPECT_FALSE(leases.revoke(lease, isDirty));
+
+  // unpin it and pin it again
+  EXPECT_TRUE(leases.unpin(lease, false));
+  uint64_t offset = 0;
+  EXPECT_TRUE(leases.pin(lease, offset));
+  EXPECT_EQ(offset, 1024);
+
+  // we can not unpin it twice
+  EXPECT_TRUE(leases.unpin(lease, true, PDB_PAGE_HINT_HOT_REUSE));
+  EXPECT_FALSE(leases.unpin(lease, true));
+
+  // revoke it, the dirty bit and the hint have to be there
+  PDBPageAccessHint hint = PDB_PAGE_HINT_NORMAL;
+  EXPECT_TRUE(leases.revoke(lease, isDirty, hint));
+  EXPECT_TRUE(isDirty);
+  EXPECT_EQ(hint, PDB_PAGE_HINT_HOT_REUSE);
+
+  // once it is revoked it is gone
+  EXPECT_FALSE(leases.pin(lease, offset));
+  EXPECT_FALSE(leases.revoke(lease, isDirty));
+
+  // the slot is reused but the old lease can not pin the new one
+  auto newLease = leases.grant(2048);
+  EXPECT_NE(newLease, -1);
+  EXPECT_NE(newLease, lease);
+  EXPECT_TRUE(leases.unpin(newLease, false));
+  EXPECT_FALSE(leases.pin(lease, offset));
+  EXPECT_TRUE(leases.pin(newLease, offset));
+  EXPECT_EQ(offset, 2048);
+
+  // released leases are gone no matter what state they were in
+  leases.release(newLease);
+  EXPECT_FALSE(leases.unpin(newLease, false));
+
+  // take all the leases, after that we get none
+  std::vector<int64_t> all;
+  for (uint32_t i = 0; i < PDB_BUFFER_MANAGER_LEASES; ++i) {
+    all.emplace_back(leases.grant(i));
+    EXPECT_NE(all.back(), -1);
+  }
+  EXPECT_EQ(leases.grant(0), -1);
+
+  // give one back and we have one again
+  leases.release(all.front());
+  EXPECT_NE(leases.grant(0), -1);
+}
+
+// the forked process pins and unpins the leases while this one revokes them
+TEST(BufferManagerLeasesTest, Test2) {
+
+  const int numLeases = 64;
+  const int numRounds = 10000;
+
+  // make the leases before we fork so that both processes share them
+  auto leases = std::make_shared<PDBBufferManagerLeases>();
+  std::vector<int64_t> granted;
+  for (int i = 0; i < numLeases; ++i) {
+    granted.emplace_back(leases->grant(i * 4096));
+  }
+
+  // fork the process that plays the backend
+  pid_t pid = fork();
+  if (pid == 0) {
+
+    // unpin and pin the leases that were not revoked, whenever we have one pinned the offset has to be right
+    bool success = true;
+    std::vector<bool> revoked(numLeases, false);
+    for (int round = 0; round < numRounds && success; ++round) {
+      for (int i = 0; i < numLeases; ++i) {
+
+        // the lease is pinned here
+        if (revoked[i]) {
+          continue;
+        }
+        if (!leases->unpin(granted[i], round % 2 == 0)) {
+          success = false;
+          break;
+        }
+
+        // pin it again unless the frontend took it
+        uint64_t offset;
+        if (!leases->pin(granted[i], offset)) {
+          revoked[i] = true;
+        } else if (offset != i * 4096) {
+          success = false;
+          break;
+        }
+      }
+    }
+
+    // leave the leases we still have unpinned
+    for (int i = 0; success && i < numLeases; ++i) {
+      if (!revoked[i] && !leases->unpin(granted[i], false)) {
+        success = false;
+      }
+    }
+
+    // report through the exit status
+    _exit(success ? 0 : 1);
+  }
+
+  // revoke the leases whenever the backend has them unpinned until it is done
+  std::vector<bool> revoked(numLeases, false);
+  int status;
+  while (waitpid(pid, &status, WNOHANG) == 0) {
+    for (int i = 0; i < numLeases; ++i) {
+      bool isDirty;
+      if (!revoked[i] && leases->revoke(granted[i], isDirty)) {
+        revoked[i] = true;
+      }
+    }
+  }
+  EXPECT_TRUE(WIFEXITED(status));
+  EXPECT_EQ(WEXITSTATUS(status), 0);
+
+  // the backend left the rest unpinned so we get them all
+  for (int i = 0; i < numLeases; ++i) {
+    bool isDirty;
+    EXPECT_TRUE(revoked[i] || leases->revoke(granted[i], isDirty));
+  }
+}
+
+// the leases the backend unpinned are counted so the frontend knows which frames it could take back
+TEST(BufferManagerLeasesTest, Test3) {
+
+  PDBBufferManagerLeases leases;
+  auto first = leases.grant(0);
+  auto second = leases.grant(4096);
+  EXPECT_EQ(leases.getNumUnpinned(), 0);
+  EXPECT_FALSE(leases.isUnpinned(first));
+
+  // unpinning counts them, pinning does not
+  EXPECT_TRUE(leases.unpin(first, false));
+  EXPECT_TRUE(leases.unpin(second, false));
+  EXPECT_TRUE(leases.isUnpinned(first));
+  EXPECT_EQ(leases.getNumUnpinned(), 2);
+  uint64_t offset;
+  EXPECT_TRUE(leases.pin(second, offset));
+  EXPECT_EQ(leases.getNumUnpinned(), 1);
+
+  // a failed unpin does not count
+  EXPECT_FALSE(leases.unpin(first, false));
+  EXPECT_EQ(leases.getNumUnpinned(), 1);
+
+  // revoking or releasing an unpinned lease takes it out, releasing a pinned one does not change anything
+  bool isDirty;
+  EXPECT_TRUE(leases.revoke(first, isDirty));
+  EXPECT_FALSE(leases.isUnpinned(first));
+  EXPECT_EQ(leases.getNumUnpinned(), 0);
+  leases.release(second);
+  EXPECT_EQ(leases.getNumUnpinned(), 0);
+
+  auto third = leases.grant(8192);
+  EXPECT_TRUE(leases.unpin(third, false));
+  EXPECT_EQ(leases.getNumUnpinned(), 1);
+  leases.release(third);
+  EXPECT_EQ(leases.getNumUnpinned(), 0);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+}
@@ -0,0 +1,130 @@
+#include <iostream>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <gtest/gtest.h>
+
+#include <GenericWork.h>
+#include <PDBBufferManagerRing.h>
+#include <BufPinPageRequest.h>
+#include <BufPinPageResult.h>
+
+namespace pdb {
+
+// sends requests through the ring from a forked process and from this one, they are all answered by the workers here
+TEST(BufferManagerRingTest, Test1) {
+
+  const int numServers = 4;
+  const int numParentClients = 2;
+  const int numChildClients = 8;
+  const uint64_t numRequests = 10000;
+
+  // make the ring before we fork so that both processes share it
+  auto ring = std::make_shared<PDBBufferManagerRing>();
+  auto logger = make_shared<PDBLogger>("ring.log");
+
+  // fork the process that plays the backend
+  pid_t pid = fork();
+  bool isChild = pid == 0;
+
+  // init the worker threads of this process
+  auto workers = make_shared<PDBWorkerQueue>(make_shared<PDBLogger>("worker.log"), numServers + numChildClients);
+
+  // create the buzzer
+  atomic_int serversDone;
+  serversDone = 0;
+  atomic_int clientsDone;
+  clientsDone = 0;
+  PDBBuzzerPtr tempBuzzer = make_shared<PDBBuzzer>([&](PDBAlarm myAlarm, atomic_int& cnt) {
+    cnt++;
+  });
+
+  // the parent plays the frontend, it answers every pin request with twice the page number as the offset
+  for(int t = 0; !isChild && t < numServers; ++t) {
+
+    PDBWorkPtr myWork = make_shared<pdb::GenericWork>([&](PDBBuzzerPtr callerBuzzer) {
+
+      int64_t slot;
+      while ((slot = ring->waitForRequest()) != -1) {
+
+        // check the request
+        EXPECT_EQ(ring->getRequestType(slot), BufPinPageRequest_TYPEID);
+        auto request = ring->getRequest<BufPinPageRequest>(slot);
+
+        // make the response
+        const UseTemporaryAllocationBlock tempBlock{1024};
+        Handle<BufPinPageResult> response = makeObject<BufPinPageResult>(request->pageNumber * 2, true);
+
+        // send it
+        std::string errMsg;
+        EXPECT_TRUE(ring->getResponder(slot)->sendObject(response, errMsg));
+        ring->respond(slot);
+      }
+
+      callerBuzzer->buzz(PDBAlarm::WorkAllDone, serversDone);
+    });
+
+    workers->getWorker()->execute(myWork, tempBuzzer);
+  }
+
+  // both processes send requests
+  atomic_bool success;
+  success = true;
+  int numClients = isChild ? numChildClients : numParentClients;
+  for(int t = 0; t < numClients; ++t) {
+
+    // every client requests different pages
+    uint64_t client = isChild ? t : numChildClients + t;
+
+    PDBWorkPtr myWork = make_shared<pdb::GenericWork>([&, client](PDBBuzzerPtr callerBuzzer) {
+
+      for(uint64_t i = 0; i < numRequests; ++i) {
+
+        uint64_t pageNum = i * (numChildClients + numParentClients) + client;
+        PDBSetPtr set = make_shared<PDBSet>("db1", "set1");
+
+        // send the request and check the response
+        bool res = ring->request<BufPinPageRequest, BufPinPageResult, bool>(logger, false, [&](Handle<BufPinPageResult> result) {
+          return result->success && result->offset == pageNum * 2;
+        }, set, pageNum);
+
+        if(!res) {
+          success = false;
+        }
+      }
+
+      callerBuzzer->buzz(PDBAlarm::WorkAllDone, clientsDone);
+    });
+
+    workers->getWorker()->execute(myWork, tempBuzzer);
+  }
+
+  // wait until all the clients are finished
+  while (clientsDone < numClients) {
+    tempBuzzer->wait();
+  }
+
+  // the child reports through its exit status
+  if(isChild) {
+    _exit(success ? 0 : 1);
+  }
+
+  // wait for the child
+  int status;
+  waitpid(pid, &status, 0);
+  EXPECT_TRUE(WIFEXITED(status));
+  EXPECT_EQ(WEXITSTATUS(status), 0);
+  EXPECT_TRUE(success);
+
+  // close the ring and wait for the servers
+  ring->close();
+  while (serversDone < numServers) {
+    tempBuzzer->wait();
+  }
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+}
@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <thread>
+
+#include <PDBCommunicator.h>
+#include <SimpleRequestResult.h>
+#include <StoFeedPageRequest.h>
+
+namespace pdb {
+
+/**
+ * Connects two communicators over the loopback
+ */
+void connect(PDBCommunicatorPtr &client, PDBCommunicatorPtr &server) {
+
+  auto logger = std::make_shared<PDBLogger>("communicator.log");
+
+  // listen on a port the system picks
+  int listenFD = socket(AF_INET, SOCK_STREAM, 0);
+  struct sockaddr_in serverAddress{};
+  serverAddress.sin_family = AF_INET;
+  serverAddress.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  serverAddress.sin_port = 0;
+  ASSERT_EQ(::bind(listenFD, (struct sockaddr *) &serverAddress, sizeof(serverAddress)), 0);
+  ASSERT_EQ(::listen(listenFD, 1), 0);
+  socklen_t length = sizeof(serverAddress);
+  getsockname(listenFD, (struct sockaddr *) &serverAddress, &length);
+
+  // connect and accept
+  std::string errMsg;
+  client = std::make_shared<PDBCommunicator>();
+  ASSERT_TRUE(client->connectToInternetServer(logger, ntohs(serverAddress.sin_port), "127.0.0.1", errMsg));
+  server = std::make_shared<PDBCommunicator>();
+  ASSERT_TRUE(server->pointToInternet(logger, listenFD, errMsg));
+  close(listenFD);
+}
+
+/**
+ * Sends the pages with sendObjectAndBytes followed by a message and checks that the other side gets them the same
+ * way it gets a sendObject followed by sendBytes
+ */
+void sendPages(const PDBCommunicatorPtr &client, const PDBCommunicatorPtr &server, const std::vector<size_t> &sizes) {
+
+  // fill the pages
+  std::vector<std::vector<char>> pages;
+  for (size_t i = 0; i < sizes.size(); ++i) {
+    pages.emplace_back(sizes[i]);
+    for (size_t j = 0; j < sizes[i]; ++j) {
+      pages.back()[j] = (char) ((i + j) % 251);
+    }
+  }
+
+  // send them from another thread, large pages don't fit in the socket buffers
+  std::thread sender([&]() {
+    std::string errMsg;
+    for (auto &page : pages) {
+      const UseTemporaryAllocationBlock tempBlock{1024};
+      Handle<StoFeedPageRequest> request = makeObject<StoFeedPageRequest>(page.size(), true);
+      EXPECT_TRUE(client->sendObjectAndBytes(request, page.data(), page.size(), errMsg));
+    }
+    const UseTemporaryAllocationBlock tempBlock{1024};
+    Handle<SimpleRequestResult> done = makeObject<SimpleRequestResult>(true, "done");
+    EXPECT_TRUE(client->sendObject(done, errMsg));
+  });
+
+  // receive them straight into the destination
+  for (auto &page : pages) {
+
+    bool success;
+    std::string errMsg;
+    ASSERT_EQ(server->getObjectTypeID(), StoFeedPageRequest_TYPEID);
+    auto request = server->getNextObject<StoFeedPageRequest>(success, errMsg);
+    ASSERT_TRUE(success);
+    ASSERT_EQ(request->pageSize, page.size());
+
+    ASSERT_EQ(server->getSizeOfNextObject(), page.size());
+    std::vector<char> received(request->pageSize);
+    ASSERT_TRUE(server->receiveBytes(received.data(), errMsg));
+    EXPECT_TRUE(received == page);
+  }
+
+  // the message after them is intact
+  bool success;
+  std::string errMsg;
+  auto done = server->getNextObject<SimpleRequestResult>(success, errMsg);
+  ASSERT_TRUE(success);
+  EXPECT_EQ(done->getRes().second, "done");
+
+  sender.join();
+}
+
+// the object and the bytes sent together look the same as if they were sent separately
+TEST(CommunicatorTest, Test1) {
+
+  PDBCommunicatorPtr client, server;
+  connect(client, server);
+  sendPages(client, server, {0, 1, 4096, 3 * 1024 * 1024 + 7, 17});
+  EXPECT_EQ(client->getNumZeroCopyWrites(), 0);
+}
+
+// the same with zero copy, if the kernel supports it
+TEST(CommunicatorTest, Test2) {
+
+  PDBCommunicatorPtr client, server;
+  connect(client, server);
+  if (!client->enableZeroCopy()) {
+    return;
+  }
+
+  // over the loopback the kernel copies anyway, so only the first large page is sent with zero copy
+  sendPages(client, server, {1024, 4 * 1024 * 1024, 4 * 1024 * 1024, 100});
+  EXPECT_GE(client->getNumZeroCopyWrites(), 1);
+}
+
+}
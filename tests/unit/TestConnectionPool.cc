@@ -0,0 +1,197 @@
+#include <gtest/gtest.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <atomic>
+
+#include <GenericWork.h>
+#include <HeapRequest.h>
+#include <PDBConnectionPool.h>
+#include <PDBWorker.h>
+#include <SimpleRequestResult.h>
+
+namespace pdb {
+
+/**
+ * Returns the workers of the servers, there can only be one worker queue in a process
+ */
+PDBWorkerQueuePtr getWorkers() {
+  static auto workers = std::make_shared<PDBWorkerQueue>(std::make_shared<PDBLogger>("connectionPool.log"), 16);
+  return workers;
+}
+
+/**
+ * A server that answers every SimpleRequestResult it gets with the same message, every connection is served by
+ * its own worker
+ */
+class EchoServer {
+
+ public:
+
+  explicit EchoServer(bool closeAfterResponse) : closeAfterResponse(closeAfterResponse) {
+
+    // listen on a port the system picks
+    listenFD = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in serverAddress{};
+    serverAddress.sin_family = AF_INET;
+    serverAddress.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    serverAddress.sin_port = 0;
+    EXPECT_EQ(::bind(listenFD, (struct sockaddr *) &serverAddress, sizeof(serverAddress)), 0);
+    EXPECT_EQ(::listen(listenFD, 100), 0);
+
+    // figure out the port
+    socklen_t length = sizeof(serverAddress);
+    getsockname(listenFD, (struct sockaddr *) &serverAddress, &length);
+    port = ntohs(serverAddress.sin_port);
+
+    // accept the connections
+    numRunning++;
+    auto acceptWork = std::make_shared<GenericWork>([&](const PDBBuzzerPtr &callerBuzzer) {
+
+      while (true) {
+
+        // wait for a connection, this fails once we stop
+        std::string errMsg;
+        auto communicator = std::make_shared<PDBCommunicator>();
+        if (!communicator->pointToInternet(logger, listenFD, errMsg)) {
+          break;
+        }
+        numAccepted++;
+
+        // serve it
+        numRunning++;
+        auto serveWork = std::make_shared<GenericWork>([this, communicator](const PDBBuzzerPtr &callerBuzzer) {
+          serve(communicator);
+          callerBuzzer->buzz(PDBAlarm::WorkAllDone);
+        });
+        workers->getWorker()->execute(serveWork, buzzer);
+      }
+
+      callerBuzzer->buzz(PDBAlarm::WorkAllDone);
+    });
+    workers->getWorker()->execute(acceptWork, buzzer);
+  }
+
+  ~EchoServer() {
+
+    // close the connections the pool kept, so that the workers serving them are done
+    PDBConnectionPool::getDefault().clear();
+
+    // stop accepting and wait for the workers
+    shutdown(listenFD, SHUT_RDWR);
+    close(listenFD);
+    while (numDone != numRunning) {
+      buzzer->wait();
+    }
+  }
+
+  void serve(const PDBCommunicatorPtr &communicator) {
+
+    while (communicator->getObjectTypeID() == SimpleRequestResult_TYPEID) {
+
+      // grab the request
+      bool success;
+      std::string errMsg;
+      std::unique_ptr<char[]> memory(new char[communicator->getSizeOfNextObject()]);
+      auto request = communicator->getNextObject<SimpleRequestResult>(memory.get(), success, errMsg);
+      if (!success) {
+        break;
+      }
+
+      // send back the same message
+      const UseTemporaryAllocationBlock tempBlock{1024};
+      Handle<SimpleRequestResult> response = makeObject<SimpleRequestResult>(true, request->getRes().second);
+      if (!communicator->sendObject(response, errMsg) || closeAfterResponse) {
+        break;
+      }
+    }
+  }
+
+  // the port we listen to
+  int port = 0;
+
+  // the number of connections we accepted
+  std::atomic<int> numAccepted{0};
+
+ private:
+
+  // the socket we listen to
+  int listenFD = -1;
+
+  // do we close the connection once we sent the response
+  bool closeAfterResponse;
+
+  // the workers that accept and serve the connections
+  PDBLoggerPtr logger = std::make_shared<PDBLogger>("connectionPool.log");
+  PDBWorkerQueuePtr workers = getWorkers();
+
+  // the number of works we started and the number that are done
+  std::atomic<int> numRunning{0};
+  std::atomic<int> numDone{0};
+  PDBBuzzerPtr buzzer = std::make_shared<PDBBuzzer>([&](PDBAlarm myAlarm) { numDone++; });
+};
+
+/**
+ * Sends the message to the server and returns what it sent back
+ */
+std::string ping(int port, const std::string &message) {
+  auto logger = std::make_shared<PDBLogger>("connectionPool.log");
+  return RequestFactory::heapRequest<SimpleRequestResult, SimpleRequestResult, std::string>(
+      logger, port, "127.0.0.1", "", 1024,
+      [](Handle<SimpleRequestResult> result) { return result->getRes().second; },
+      true, message);
+}
+
+// the requests to the same server go over the same connection
+TEST(ConnectionPoolTest, Test1) {
+
+  EchoServer server(false);
+  auto &pool = PDBConnectionPool::getDefault();
+  auto numConnects = pool.getNumConnects();
+  auto numReuses = pool.getNumReuses();
+
+  for (int i = 0; i < 16; ++i) {
+    EXPECT_EQ(ping(server.port, "ping " + std::to_string(i)), "ping " + std::to_string(i));
+  }
+
+  EXPECT_EQ(server.numAccepted, 1);
+  EXPECT_EQ(pool.getNumConnects() - numConnects, 1);
+  EXPECT_EQ(pool.getNumReuses() - numReuses, 15);
+}
+
+// if the server closes the connection we connect again
+TEST(ConnectionPoolTest, Test2) {
+
+  EchoServer server(true);
+  for (int i = 0; i < 8; ++i) {
+    EXPECT_EQ(ping(server.port, "ping " + std::to_string(i)), "ping " + std::to_string(i));
+  }
+
+  EXPECT_EQ(server.numAccepted, 8);
+}
+
+// the connections are not kept if the pool is disabled or they are idle for too long
+TEST(ConnectionPoolTest, Test3) {
+
+  EchoServer server(false);
+  auto &pool = PDBConnectionPool::getDefault();
+
+  // no pool
+  pool.setMaxIdle(0);
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_EQ(ping(server.port, "ping"), "ping");
+  }
+  EXPECT_EQ(server.numAccepted, 4);
+  pool.setMaxIdle(PDB_CONNECTION_POOL_MAX_IDLE);
+
+  // the connections expire right away
+  pool.setKeepAlive(std::chrono::milliseconds(0));
+  for (int i = 0; i < 4; ++i) {
+    EXPECT_EQ(ping(server.port, "ping"), "ping");
+  }
+  EXPECT_EQ(server.numAccepted, 8);
+  pool.setKeepAlive(std::chrono::milliseconds(PDB_CONNECTION_POOL_KEEP_ALIVE_MS));
+}
+
+}
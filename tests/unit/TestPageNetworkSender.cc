@@ -0,0 +1,244 @@
+#include <gtest/gtest.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <csignal>
+#include <atomic>
+#include <set>
+
+#include <GenericWork.h>
+#include <PDBWorker.h>
+#include <PDBBufferManagerImpl.h>
+#include <PDBPageNetworkSender.h>
+#include <SimpleRequestResult.h>
+#include <StoFeedPageCredits.h>
+#include <StoFeedPageRequest.h>
+#include <StoStartFeedingPageSetRequest.h>
+
+namespace pdb {
+
+/**
+ * Returns the workers of the test, there can only be one worker queue in a process
+ */
+PDBWorkerQueuePtr getWorkers() {
+  static auto workers = std::make_shared<PDBWorkerQueue>(std::make_shared<PDBLogger>("pageNetworkSender.log"), 16);
+  return workers;
+}
+
+/**
+ * A node that is fed the pages, it grants the credits the same way the storage manager does, but waits a bit before
+ * every grant so that the senders run out of them
+ */
+class FeedReceiver {
+
+ public:
+
+  FeedReceiver(uint64_t window, uint64_t batch, bool failAfterSetup) {
+
+    // listen on a port the system picks
+    int listenFD = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in serverAddress{};
+    serverAddress.sin_family = AF_INET;
+    serverAddress.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    serverAddress.sin_port = 0;
+    EXPECT_EQ(::bind(listenFD, (struct sockaddr *) &serverAddress, sizeof(serverAddress)), 0);
+    EXPECT_EQ(::listen(listenFD, 1), 0);
+    socklen_t length = sizeof(serverAddress);
+    getsockname(listenFD, (struct sockaddr *) &serverAddress, &length);
+    port = ntohs(serverAddress.sin_port);
+
+    // receive the pages on a worker
+    auto work = std::make_shared<GenericWork>([=](const PDBBuzzerPtr &callerBuzzer) {
+
+      // accept the connection
+      std::string errMsg;
+      auto communicator = std::make_shared<PDBCommunicator>();
+      EXPECT_TRUE(communicator->pointToInternet(logger, listenFD, errMsg));
+      close(listenFD);
+
+      receive(communicator, window, batch, failAfterSetup);
+      callerBuzzer->buzz(PDBAlarm::WorkAllDone);
+    });
+    getWorkers()->getWorker()->execute(work, buzzer);
+  }
+
+  ~FeedReceiver() {
+    wait();
+  }
+
+  // waits until the receiving is done
+  void wait() {
+    while (!isDone) {
+      buzzer->wait();
+    }
+  }
+
+  void receive(const PDBCommunicatorPtr &communicator, uint64_t window, uint64_t batch, bool failAfterSetup) {
+
+    // grab the request
+    bool success;
+    std::string errMsg;
+    {
+      const UseTemporaryAllocationBlock tempBlock{1024};
+      auto request = communicator->getNextObject<StoStartFeedingPageSetRequest>(success, errMsg);
+      ASSERT_TRUE(success);
+
+      // ack it
+      Handle<SimpleRequestResult> response = makeObject<SimpleRequestResult>(true, "");
+      ASSERT_TRUE(communicator->sendObject(response, errMsg));
+    }
+
+    // grants the credits up to the window
+    uint64_t outstanding = 0;
+    auto grant = [&]() {
+      usleep(1000);
+      const UseTemporaryAllocationBlock tempBlock{1024};
+      Handle<StoFeedPageCredits> credits = makeObject<StoFeedPageCredits>(window - outstanding);
+      outstanding = window;
+      return communicator->sendObject(credits, errMsg);
+    };
+    ASSERT_TRUE(grant());
+
+    // if we are supposed to fail we close the connection
+    if (failAfterSetup) {
+      return;
+    }
+
+    while (true) {
+
+      const UseTemporaryAllocationBlock tempBlock{1024};
+      auto request = communicator->getNextObject<StoFeedPageRequest>(success, errMsg);
+      ASSERT_TRUE(success);
+
+      // if there are no more pages confirm that we got them all
+      if (!request->hasNextPage) {
+        Handle<SimpleRequestResult> response = makeObject<SimpleRequestResult>(true, "");
+        ASSERT_TRUE(communicator->sendObject(response, errMsg));
+        break;
+      }
+
+      // the page has to have a credit
+      EXPECT_GT(outstanding, 0);
+      outstanding--;
+
+      // grab the page and remember which one it was
+      std::vector<char> page(request->pageSize);
+      ASSERT_TRUE(communicator->receiveBytes(page.data(), errMsg));
+      auto numBytes = *((size_t *) page.data());
+      EXPECT_EQ(numBytes, 2 * sizeof(uint64_t));
+      received.push_back(*((uint64_t *) (page.data() + sizeof(size_t))));
+
+      // grant more if a batch of them was used up
+      if (window - outstanding >= batch) {
+        ASSERT_TRUE(grant());
+      }
+    }
+  }
+
+  // the port we listen to
+  int port = 0;
+
+  // the numbers written on the pages we received
+  std::vector<uint64_t> received;
+
+ private:
+
+  PDBLoggerPtr logger = std::make_shared<PDBLogger>("pageNetworkSender.log");
+
+  // set once the receiving is done
+  std::atomic<bool> isDone{false};
+  PDBBuzzerPtr buzzer = std::make_shared<PDBBuzzer>([&](PDBAlarm myAlarm) { isDone = true; });
+};
+
+/**
+ * Sends the pages to the receiver on the given number of threads, returns how many of them succeeded
+ */
+int sendPages(FeedReceiver &receiver, uint64_t numThreads, uint64_t numPages) {
+
+  // create the buffer manager
+  PDBBufferManagerImpl myMgr;
+  myMgr.initialize("tempDSFSD", 64 * 1024, 16, "metadata", ".");
+
+  // set up the sender
+  auto logger = std::make_shared<PDBLogger>("pageNetworkSender.log");
+  auto queue = std::make_shared<PDBPageQueue>();
+  auto sender = std::make_shared<PDBPageNetworkSender>("127.0.0.1", receiver.port, 1, 2, 1, logger,
+                                                       std::make_pair(0, "set"), queue, numThreads);
+  if (!sender->setup()) {
+    return 0;
+  }
+
+  // run the sender threads
+  std::atomic<int> numSucceeded{0};
+  std::atomic<int> numDone{0};
+  auto buzzer = std::make_shared<PDBBuzzer>([&](PDBAlarm myAlarm) { numDone++; });
+  for (uint64_t i = 0; i < numThreads; ++i) {
+    auto work = std::make_shared<GenericWork>([&](const PDBBuzzerPtr &callerBuzzer) {
+      if (sender->run()) {
+        numSucceeded++;
+      }
+      callerBuzzer->buzz(PDBAlarm::WorkAllDone);
+    });
+    getWorkers()->getWorker()->execute(work, buzzer);
+  }
+
+  // make the pages, a record with the number of the page
+  for (uint64_t i = 0; i < numPages; ++i) {
+    auto page = myMgr.getPage();
+    auto bytes = (uint64_t *) page->getBytes();
+    bytes[0] = 2 * sizeof(uint64_t);
+    bytes[1] = i;
+    page->unpin();
+    queue->enqueue(page);
+  }
+  queue->enqueue(nullptr);
+
+  // wait for the senders
+  while (numDone < numThreads) {
+    buzzer->wait();
+  }
+
+  return numSucceeded;
+}
+
+/**
+ * Checks that we received every page exactly once
+ */
+void checkReceived(FeedReceiver &receiver, uint64_t numPages) {
+  receiver.wait();
+  std::set<uint64_t> unique(receiver.received.begin(), receiver.received.end());
+  ASSERT_EQ(receiver.received.size(), numPages);
+  ASSERT_EQ(unique.size(), numPages);
+  EXPECT_EQ(*unique.rbegin(), numPages - 1);
+}
+
+// one thread never has more pages in flight than it was granted
+TEST(PageNetworkSenderTest, Test1) {
+
+  FeedReceiver receiver(4, 2, false);
+  EXPECT_EQ(sendPages(receiver, 1, 100), 1);
+  checkReceived(receiver, 100);
+}
+
+// the threads share the connection and the credits, even if they get them one at a time
+TEST(PageNetworkSenderTest, Test2) {
+
+  FeedReceiver receiver(1, 1, false);
+  EXPECT_EQ(sendPages(receiver, 4, 200), 4);
+  checkReceived(receiver, 200);
+
+  FeedReceiver windowed(8, 4, false);
+  EXPECT_EQ(sendPages(windowed, 4, 200), 4);
+  checkReceived(windowed, 200);
+}
+
+// if the other node goes away none of the threads waits for credits forever
+TEST(PageNetworkSenderTest, Test3) {
+
+  ::signal(SIGPIPE, SIG_IGN);
+  FeedReceiver receiver(2, 1, true);
+  EXPECT_EQ(sendPages(receiver, 4, 100), 0);
+}
+
+}
@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <atomic>
+#include <thread>
+
+#include <GenericWork.h>
+#include <PDBServerReactor.h>
+#include <PDBWorker.h>
+#include <SimpleRequestResult.h>
+
+namespace pdb {
+
+/**
+ * Answers the request that came over the connection with the same message, returns false if the other side closed it
+ */
+bool echo(const PDBCommunicatorPtr &communicator) {
+
+  if (communicator->getObjectTypeID() != SimpleRequestResult_TYPEID) {
+    return false;
+  }
+
+  // grab the request
+  bool success;
+  std::string errMsg;
+  std::unique_ptr<char[]> memory(new char[communicator->getSizeOfNextObject()]);
+  auto request = communicator->getNextObject<SimpleRequestResult>(memory.get(), success, errMsg);
+  if (!success) {
+    return false;
+  }
+
+  // send back the same message
+  const UseTemporaryAllocationBlock tempBlock{1024};
+  Handle<SimpleRequestResult> response = makeObject<SimpleRequestResult>(true, request->getRes().second);
+  return communicator->sendObject(response, errMsg);
+}
+
+// many more connections than workers, the idle connections don't keep the workers busy
+TEST(ServerReactorTest, Test1) {
+
+  const int numConnections = 64;
+  const int numWorkers = 4;
+
+  auto logger = std::make_shared<PDBLogger>("serverReactor.log");
+  auto workers = std::make_shared<PDBWorkerQueue>(logger, numWorkers);
+
+  // listen on a port the system picks
+  int listenFD = socket(AF_INET, SOCK_STREAM, 0);
+  struct sockaddr_in serverAddress{};
+  serverAddress.sin_family = AF_INET;
+  serverAddress.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  serverAddress.sin_port = 0;
+  ASSERT_EQ(::bind(listenFD, (struct sockaddr *) &serverAddress, sizeof(serverAddress)), 0);
+  ASSERT_EQ(::listen(listenFD, numConnections), 0);
+  socklen_t length = sizeof(serverAddress);
+  getsockname(listenFD, (struct sockaddr *) &serverAddress, &length);
+  int port = ntohs(serverAddress.sin_port);
+
+  // every request is handled by a worker just like the PDBServer does it
+  std::atomic<int> numRequests{0};
+  std::atomic<int> numRunning{0};
+  std::atomic<int> maxRunning{0};
+  std::shared_ptr<PDBServerReactor> reactor;
+  reactor = std::make_shared<PDBServerReactor>(2, [&](const PDBCommunicatorPtr &communicator) {
+
+    numRequests++;
+    auto work = std::make_shared<GenericWork>([&, communicator](const PDBBuzzerPtr &callerBuzzer) {
+
+      // remember how many requests were handled at the same time
+      int running = ++numRunning;
+      int max = maxRunning;
+      while (running > max && !maxRunning.compare_exchange_weak(max, running)) {}
+
+      if (echo(communicator)) {
+        numRunning--;
+        reactor->rearm(communicator);
+      } else {
+        numRunning--;
+        reactor->remove(communicator);
+      }
+      callerBuzzer->buzz(PDBAlarm::WorkAllDone);
+    });
+    workers->getWorker()->execute(work, work->getLinkedBuzzer());
+  }, logger);
+
+  // open the connections and accept them
+  std::vector<PDBCommunicatorPtr> clients;
+  for (int i = 0; i < numConnections; ++i) {
+
+    std::string errMsg;
+    auto client = std::make_shared<PDBCommunicator>();
+    ASSERT_TRUE(client->connectToInternetServer(logger, port, "127.0.0.1", errMsg));
+    clients.push_back(client);
+
+    auto server = std::make_shared<PDBCommunicator>();
+    ASSERT_TRUE(server->pointToInternet(logger, listenFD, errMsg));
+    reactor->add(server);
+  }
+  EXPECT_EQ(reactor->getNumConnections(), numConnections);
+
+  // send a request over every connection, then read all the responses, twice
+  for (int round = 0; round < 2; ++round) {
+
+    for (int i = 0; i < numConnections; ++i) {
+      std::string errMsg;
+      const UseTemporaryAllocationBlock tempBlock{1024};
+      Handle<SimpleRequestResult> request = makeObject<SimpleRequestResult>(true, "ping " + std::to_string(i));
+      ASSERT_TRUE(clients[i]->sendObject(request, errMsg));
+    }
+
+    for (int i = 0; i < numConnections; ++i) {
+      bool success;
+      std::string errMsg;
+      std::unique_ptr<char[]> memory(new char[clients[i]->getSizeOfNextObject()]);
+      auto response = clients[i]->getNextObject<SimpleRequestResult>(memory.get(), success, errMsg);
+      ASSERT_TRUE(success);
+      EXPECT_EQ(response->getRes().second, "ping " + std::to_string(i));
+    }
+  }
+
+  EXPECT_EQ(numRequests, 2 * numConnections);
+  EXPECT_LE(maxRunning, numWorkers);
+  EXPECT_EQ(reactor->getNumConnections(), numConnections);
+
+  // close half of the connections, the reactor closes them without a worker
+  for (int i = 0; i < numConnections / 2; ++i) {
+    clients[i].reset();
+  }
+  for (int i = 0; i < 1000 && reactor->getNumConnections() != numConnections / 2; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_EQ(reactor->getNumConnections(), numConnections / 2);
+  EXPECT_EQ(numRequests, 2 * numConnections);
+
+  // stop the reactor and the server
+  reactor.reset();
+  clients.clear();
+  close(listenFD);
+}
+
+}
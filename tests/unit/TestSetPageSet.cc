@@ -0,0 +1,79 @@
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <gtest/gtest.h>
+#include <PDBSetPageSet.h>
+
+#include "PDBBufferManagerImpl.h"
+#include "PDBPageHandle.h"
+#include "PDBSet.h"
+
+namespace pdb {
+
+TEST(SetPageSetTest, TestReadAhead) {
+
+  const uint64_t numThreads = 4;
+  const uint64_t numPages = 200;
+
+  // create the buffer manager
+  auto myMgr = std::make_shared<PDBBufferManagerImpl>();
+  myMgr->initialize("tempDSFSD", 64, 64, "metadata", ".");
+
+  // write the pages of the set, every page stores its number
+  auto set = make_shared<PDBSet>("db", "set");
+  std::vector<uint64_t> pages;
+  for(uint64_t i = 0; i < numPages; ++i) {
+    auto page = myMgr->getPage(set, i);
+    *((uint64_t*) page->getBytes()) = i;
+    page->setDirty();
+    pages.emplace_back(i);
+  }
+
+  // the page set reads 16 pages ahead with two threads
+  auto pageSet = std::make_shared<PDBSetPageSet>("db", "set", pages, myMgr, 16, 2);
+
+  // scan the set twice
+  for(int k = 0; k < 2; ++k) {
+
+    // the sum of the page numbers the workers got
+    std::atomic<uint64_t> sum;
+    sum = 0;
+
+    // run the workers
+    std::vector<std::shared_ptr<std::thread>> threads;
+    for(uint64_t t = 0; t < numThreads; ++t) {
+      threads.emplace_back(std::make_shared<std::thread>([&, t]() {
+
+        PDBPageHandle page;
+        while((page = pageSet->getNextPage(t)) != nullptr) {
+          sum += *((uint64_t*) page->getBytes());
+        }
+      }));
+    }
+
+    // wait to finish
+    for(auto &t : threads){
+      t->join();
+    }
+
+    // every page must be served exactly once
+    EXPECT_EQ(sum, numPages * (numPages - 1) / 2);
+
+    // reset the page set for the next scan
+    pageSet->resetPageSet();
+  }
+
+  // the pages are served in order to a single worker
+  for(uint64_t i = 0; i < numPages; ++i) {
+    auto page = pageSet->getNextPage(0);
+    EXPECT_EQ(*((uint64_t*) page->getBytes()), i);
+  }
+  EXPECT_EQ(pageSet->getNextPage(0), nullptr);
+
+  // remove the page set before the buffer manager
+  pageSet = nullptr;
+  myMgr->clearSet(set);
+}
+
+}
@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+#include <PDBWireCompression.h>
+
+namespace pdb {
+
+/**
+ * Makes a page that compresses well
+ */
+std::vector<char> makeTextPage(size_t numBytes) {
+  std::vector<char> page(numBytes);
+  for (size_t i = 0; i < numBytes; ++i) {
+    page[i] = (char) ('a' + (i / 64) % 4);
+  }
+  return page;
+}
+
+/**
+ * Makes a page that does not compress at all
+ */
+std::vector<char> makeRandomPage(size_t numBytes, int seed) {
+  std::mt19937 gen(seed);
+  std::vector<char> page(numBytes);
+  for (auto &c : page) {
+    c = (char) gen();
+  }
+  return page;
+}
+
+/**
+ * Makes the frame of the page, checks that we get the page back and returns the size of the frame
+ */
+size_t roundTrip(PDBWireCompression &compression, const std::vector<char> &page) {
+
+  std::vector<char> frame(compression.getMaxFrameSize(page.size()));
+  auto frameSize = compression.compress(page.data(), page.size(), frame.data(), frame.size());
+  EXPECT_NE(frameSize, 0);
+
+  size_t numBytes = 0;
+  EXPECT_TRUE(PDBWireCompression::getUncompressedSize(frame.data(), frameSize, numBytes));
+  EXPECT_EQ(numBytes, page.size());
+
+  std::vector<char> out(numBytes);
+  EXPECT_TRUE(PDBWireCompression::decompress(frame.data(), frameSize, out.data(), out.size()));
+  EXPECT_EQ(out, page);
+
+  return frameSize;
+}
+
+// every codec gets the page back, and so does a receiver that uses another codec
+TEST(WireCompressionTest, Test1) {
+
+  auto page = makeTextPage(64 * 1024);
+  for (auto codec : {"none", "snappy", "lz4", "zstd"}) {
+
+    auto compression = PDBWireCompression::make(codec, 0);
+    auto frameSize = roundTrip(*compression, page);
+
+    // if we don't compress the page goes as it is, otherwise it has to shrink
+    if (compression->getCodec() == PDB_PAGE_COMPRESSION_NONE) {
+      EXPECT_GT(frameSize, page.size());
+    } else {
+      EXPECT_LT(frameSize, page.size());
+    }
+  }
+
+  EXPECT_THROW(PDBWireCompression::make("gzip", 0), std::runtime_error);
+}
+
+// a page that would grow is sent as it is
+TEST(WireCompressionTest, Test2) {
+
+  PDBWireCompression compression(PDB_PAGE_COMPRESSION_SNAPPY);
+  auto before = PDBWireCompression::getStats();
+
+  auto page = makeRandomPage(64 * 1024, 1);
+  EXPECT_GT(roundTrip(compression, page), page.size());
+
+  auto after = PDBWireCompression::getStats();
+  EXPECT_EQ(after.numBypassed - before.numBypassed, 1);
+  EXPECT_EQ(after.numBytesIn - before.numBytesIn, page.size());
+  EXPECT_EQ(after.numBytesOut - before.numBytesOut, page.size());
+}
+
+// once a page does not save enough the next ones are sent as they are, then we sample again
+TEST(WireCompressionTest, Test3) {
+
+  PDBWireCompression compression(PDB_PAGE_COMPRESSION_SNAPPY, 0.1);
+  auto text = makeTextPage(64 * 1024);
+
+  // the text is compressed
+  auto before = PDBWireCompression::getStats();
+  roundTrip(compression, text);
+  auto after = PDBWireCompression::getStats();
+  EXPECT_EQ(after.numCompressed - before.numCompressed, 1);
+  EXPECT_GT(after.getBytesSaved(), before.getBytesSaved());
+
+  // a random page makes us skip the next ones, even if they would compress
+  before = PDBWireCompression::getStats();
+  roundTrip(compression, makeRandomPage(64 * 1024, 2));
+  for (int i = 0; i < PDB_WIRE_COMPRESSION_SKIP_PAGES; ++i) {
+    roundTrip(compression, text);
+  }
+  after = PDBWireCompression::getStats();
+  EXPECT_EQ(after.numCompressed - before.numCompressed, 0);
+  EXPECT_EQ(after.numBypassed - before.numBypassed, PDB_WIRE_COMPRESSION_SKIP_PAGES + 1);
+
+  // after that we sample again
+  before = PDBWireCompression::getStats();
+  roundTrip(compression, text);
+  after = PDBWireCompression::getStats();
+  EXPECT_EQ(after.numCompressed - before.numCompressed, 1);
+}
+
+// a frame that is cut short or does not fit is rejected
+TEST(WireCompressionTest, Test4) {
+
+  PDBWireCompression compression(PDB_PAGE_COMPRESSION_NONE);
+  auto page = makeTextPage(1024);
+
+  std::vector<char> frame(compression.getMaxFrameSize(page.size()));
+  auto frameSize = compression.compress(page.data(), page.size(), frame.data(), frame.size());
+  ASSERT_NE(frameSize, 0);
+
+  std::vector<char> out(page.size());
+  EXPECT_FALSE(PDBWireCompression::decompress(frame.data(), frameSize - 1, out.data(), out.size()));
+  EXPECT_FALSE(PDBWireCompression::decompress(frame.data(), frameSize, out.data(), out.size() - 1));
+  EXPECT_FALSE(PDBWireCompression::decompress(frame.data(), 4, out.data(), out.size()));
+
+  // the frame has to fit too
+  EXPECT_EQ(compression.compress(page.data(), page.size(), frame.data(), page.size()), 0);
+}
+
+}